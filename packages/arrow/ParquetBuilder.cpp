@@ -34,9 +34,11 @@
  ******************************************************************************/
 
 #include <iostream>
+#include <arrow/array.h>
 #include <arrow/builder.h>
 #include <arrow/table.h>
-#include <arrow/io/file.h>
+#include <arrow/io/interfaces.h>
+#include <arrow/ipc/writer.h>
 #include <arrow/util/key_value_metadata.h>
 #include <parquet/arrow/writer.h>
 #include <parquet/arrow/schema.h>
@@ -55,13 +57,133 @@ using std::vector;
  * PRIVATE IMPLEMENTATION
  ******************************************************************************/
 
+/*----------------------------------------------------------------------------
+ * ArrowOutputStream
+ *
+ *  buffers the bytes written by the parquet writer into a data record and
+ *  posts the record to the output queue when it is full or flushed
+ *----------------------------------------------------------------------------*/
+class ParquetBuilder::ArrowOutputStream: public arrow::io::OutputStream
+{
+    public:
+
+        explicit ArrowOutputStream (ParquetBuilder* _builder):
+            builder(_builder),
+            dataRecord(dataRecType, 0, false),
+            position(0),
+            fill(0),
+            started(false),
+            isClosed(false)
+        {
+            data = (arrow_file_data_t*)dataRecord.getRecordData();
+            StringLib::copy(&data->filename[0], builder->outFileName, FILE_NAME_MAX_LEN);
+        }
+
+        using arrow::io::OutputStream::Write;
+
+        arrow::Status Write (const void* buffer, int64_t nbytes) override
+        {
+            const uint8_t* src = (const uint8_t*)buffer;
+            while(nbytes > 0)
+            {
+                int64_t bytes_to_copy = MIN(nbytes, FILE_BUFFER_RSPS_SIZE - fill);
+                memcpy(&data->data[fill], src, bytes_to_copy);
+                fill += bytes_to_copy;
+                position += bytes_to_copy;
+                src += bytes_to_copy;
+                nbytes -= bytes_to_copy;
+                if(fill == FILE_BUFFER_RSPS_SIZE)
+                {
+                    ARROW_RETURN_NOT_OK(Flush());
+                }
+            }
+            return arrow::Status::OK();
+        }
+
+        arrow::Status Flush (void) override
+        {
+            if(fill > 0)
+            {
+                /* Send Meta Record ahead of First Data */
+                if(!started)
+                {
+                    RecordObject meta_record(metaRecType);
+                    arrow_file_meta_t* meta = (arrow_file_meta_t*)meta_record.getRecordData();
+                    StringLib::copy(&meta->filename[0], builder->outFileName, FILE_NAME_MAX_LEN);
+                    meta->size = STREAMED_FILE_SIZE;
+                    if(!builder->postRecord(&meta_record)) return arrow::Status::IOError("failed to post meta record");
+                    started = true;
+                }
+
+                /* Send Data Record */
+                if(!builder->postRecord(&dataRecord, offsetof(arrow_file_data_t, data) + fill, RecordObject::ALLOCATE))
+                {
+                    return arrow::Status::IOError("failed to post data record");
+                }
+                fill = 0;
+            }
+            return arrow::Status::OK();
+        }
+
+        arrow::Status Close (void) override
+        {
+            if(isClosed) return arrow::Status::OK();
+            isClosed = true;
+            return Flush();
+        }
+
+        arrow::Result<int64_t> Tell (void) const override
+        {
+            return position;
+        }
+
+        bool closed (void) const override
+        {
+            return isClosed;
+        }
+
+    private:
+
+        ParquetBuilder*     builder;
+        RecordObject        dataRecord;
+        arrow_file_data_t*  data;
+        int64_t             position;
+        int64_t             fill;
+        bool                started;
+        bool                isClosed;
+};
+
+/*----------------------------------------------------------------------------
+ * impl
+ *----------------------------------------------------------------------------*/
 struct ParquetBuilder::impl
 {
-    shared_ptr<arrow::Schema>               schema;
-    unique_ptr<parquet::arrow::FileWriter>  parquetWriter;
+    /* Column
+     *  fixed width fields in native byte order are copied row by row
+     *  straight out of the record (size > 0); all other fields are
+     *  converted through the record accessors into an array builder */
+    typedef struct {
+        RecordObject::field_t   field;
+        int                     offset;     // bytes into row
+        int                     size;       // bytes copied per row, 0 when converted
+    } column_t;
+
+    shared_ptr<arrow::Schema>                   schema;
+    unique_ptr<parquet::arrow::FileWriter>      parquetWriter;
+    shared_ptr<arrow::ipc::RecordBatchWriter>   ipcWriter;
+    shared_ptr<ArrowOutputStream>               outputStream;
+    vector<column_t>                            columns;
+    vector<unique_ptr<arrow::BufferBuilder>>    columnBuffers;
+    vector<unique_ptr<arrow::ArrayBuilder>>     columnBuilders;
+    arrow::BinaryBuilder                        geoBuilder;
+    int64_t                                     numRows; // rows in current row group
 
     static shared_ptr<arrow::Schema> defineTableSchema (field_list_t& field_list, const char* rec_type, bool as_geo);
     static bool addFieldsToSchema (vector<shared_ptr<arrow::Field>>& schema_vector, field_list_t& field_list, const char* rec_type, int offset);
+    void defineColumns (field_list_t& field_list);
+    arrow::Status reserveRows (int num_rows, bool as_geo);
+    arrow::Status appendColumn (int i, RecordObject* record, int num_rows, int row_size);
+    void appendGeometry (RecordObject* record, int num_rows, int row_size, geo_data_t& geo);
 };
 
 /*----------------------------------------------------------------------------
@@ -101,7 +223,7 @@ bool ParquetBuilder::impl::addFieldsToSchema (vector<shared_ptr<arrow::Field>>&
             case RecordObject::UINT64:  schema_vector.push_back(arrow::field(field_names[i], arrow::uint64()));     break;
             case RecordObject::FLOAT:   schema_vector.push_back(arrow::field(field_names[i], arrow::float32()));    break;
             case RecordObject::DOUBLE:  schema_vector.push_back(arrow::field(field_names[i], arrow::float64()));    break;
-            case RecordObject::TIME8:   schema_vector.push_back(arrow::field(field_names[i], arrow::date64()));     break;
+            case RecordObject::TIME8:   schema_vector.push_back(arrow::field(field_names[i], arrow::timestamp(arrow::TimeUnit::MILLI)));     break;
             case RecordObject::STRING:  schema_vector.push_back(arrow::field(field_names[i], arrow::utf8()));       break;
 
             case RecordObject::USER:    addFieldsToSchema(schema_vector, field_list, fields[i]->exttype, fields[i]->offset);
@@ -129,6 +251,157 @@ bool ParquetBuilder::impl::addFieldsToSchema (vector<shared_ptr<arrow::Field>>&
     return true;
 }
 
+/*----------------------------------------------------------------------------
+ * defineColumns
+ *----------------------------------------------------------------------------*/
+void ParquetBuilder::impl::defineColumns (field_list_t& field_list)
+{
+    for(int i = 0; i < field_list.length(); i++)
+    {
+        column_t column;
+        column.field = field_list[i];
+        column.offset = TOBYTES(column.field.offset);
+        column.size = 0;
+
+        /* Determine if Column can be Copied */
+        bool native = (column.field.flags & RecordObject::BIGENDIAN) == NATIVE_FLAGS;
+        bool pointer = (column.field.flags & RecordObject::POINTER) != 0;
+        if(native && !pointer)
+        {
+            switch(column.field.type)
+            {
+                case RecordObject::INT8:
+                case RecordObject::INT16:
+                case RecordObject::INT32:
+                case RecordObject::INT64:
+                case RecordObject::UINT8:
+                case RecordObject::UINT16:
+                case RecordObject::UINT32:
+                case RecordObject::UINT64:
+                case RecordObject::FLOAT:
+                case RecordObject::DOUBLE:  column.size = RecordObject::FIELD_TYPE_BYTES[column.field.type];
+                                            break;
+                default:                    break;
+            }
+        }
+
+        /* Create Column Builder */
+        unique_ptr<arrow::ArrayBuilder> builder;
+        if(column.size == 0)
+        {
+            (void)arrow::MakeBuilder(arrow::default_memory_pool(), schema->field(i)->type(), &builder);
+        }
+
+        columns.push_back(column);
+        columnBuffers.push_back(unique_ptr<arrow::BufferBuilder>(new arrow::BufferBuilder()));
+        columnBuilders.push_back(std::move(builder));
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * reserveRows
+ *
+ *  reserves room for the rows in every column ahead of appending any of
+ *  them, so that a failed allocation leaves all of the columns unchanged
+ *----------------------------------------------------------------------------*/
+arrow::Status ParquetBuilder::impl::reserveRows (int num_rows, bool as_geo)
+{
+    for(size_t i = 0; i < columns.size(); i++)
+    {
+        if(columns[i].size > 0) ARROW_RETURN_NOT_OK(columnBuffers[i]->Reserve(num_rows * columns[i].size));
+        else                    ARROW_RETURN_NOT_OK(columnBuilders[i]->Reserve(num_rows));
+    }
+
+    if(as_geo)
+    {
+        ARROW_RETURN_NOT_OK(geoBuilder.Reserve(num_rows));
+        ARROW_RETURN_NOT_OK(geoBuilder.ReserveData(num_rows * sizeof(wkbpoint_t)));
+    }
+
+    return arrow::Status::OK();
+}
+
+/*----------------------------------------------------------------------------
+ * appendColumn
+ *
+ *  Note: room for the rows must already be reserved with reserveRows
+ *----------------------------------------------------------------------------*/
+arrow::Status ParquetBuilder::impl::appendColumn (int i, RecordObject* record, int num_rows, int row_size)
+{
+    column_t& column = columns[i];
+
+    /* Copy Values Straight out of Record */
+    if(column.size > 0)
+    {
+        arrow::BufferBuilder& buffer = *columnBuffers[i];
+        const uint8_t* src = record->getRecordData() + column.offset;
+        for(int row = 0; row < num_rows; row++)
+        {
+            buffer.UnsafeAppend(src, column.size);
+            src += row_size;
+        }
+        return arrow::Status::OK();
+    }
+
+    /* Convert Values */
+    RecordObject::field_t field = column.field;
+    arrow::ArrayBuilder* builder = columnBuilders[i].get();
+    for(int row = 0; row < num_rows; row++)
+    {
+        switch(field.type)
+        {
+            case RecordObject::DOUBLE:  static_cast<arrow::DoubleBuilder*>(builder)->UnsafeAppend((double)record->getValueReal(field));       break;
+            case RecordObject::FLOAT:   static_cast<arrow::FloatBuilder*>(builder)->UnsafeAppend((float)record->getValueReal(field));        break;
+            case RecordObject::INT8:    static_cast<arrow::Int8Builder*>(builder)->UnsafeAppend((int8_t)record->getValueInteger(field));     break;
+            case RecordObject::INT16:   static_cast<arrow::Int16Builder*>(builder)->UnsafeAppend((int16_t)record->getValueInteger(field));   break;
+            case RecordObject::INT32:   static_cast<arrow::Int32Builder*>(builder)->UnsafeAppend((int32_t)record->getValueInteger(field));   break;
+            case RecordObject::INT64:   static_cast<arrow::Int64Builder*>(builder)->UnsafeAppend((int64_t)record->getValueInteger(field));   break;
+            case RecordObject::UINT8:   static_cast<arrow::UInt8Builder*>(builder)->UnsafeAppend((uint8_t)record->getValueInteger(field));   break;
+            case RecordObject::UINT16:  static_cast<arrow::UInt16Builder*>(builder)->UnsafeAppend((uint16_t)record->getValueInteger(field)); break;
+            case RecordObject::UINT32:  static_cast<arrow::UInt32Builder*>(builder)->UnsafeAppend((uint32_t)record->getValueInteger(field)); break;
+            case RecordObject::UINT64:  static_cast<arrow::UInt64Builder*>(builder)->UnsafeAppend((uint64_t)record->getValueInteger(field)); break;
+            case RecordObject::TIME8:   static_cast<arrow::TimestampBuilder*>(builder)->UnsafeAppend((int64_t)(record->getValueReal(field) * 1000.0));  break;
+            case RecordObject::STRING:
+            {
+                const char* str = record->getValueText(field);
+                ARROW_RETURN_NOT_OK(static_cast<arrow::StringBuilder*>(builder)->Append(str, StringLib::size(str)));
+                break;
+            }
+            default: break;
+        }
+        field.offset += row_size * 8;
+    }
+
+    return arrow::Status::OK();
+}
+
+/*----------------------------------------------------------------------------
+ * appendGeometry
+ *
+ *  Note: room for the rows must already be reserved with reserveRows
+ *----------------------------------------------------------------------------*/
+void ParquetBuilder::impl::appendGeometry (RecordObject* record, int num_rows, int row_size, geo_data_t& geo)
+{
+    RecordObject::field_t lon_field = geo.lon_field;
+    RecordObject::field_t lat_field = geo.lat_field;
+    for(int row = 0; row < num_rows; row++)
+    {
+        wkbpoint_t point = {
+            #ifdef __be__
+            .byteOrder = 0,
+            #else
+            .byteOrder = 1,
+            #endif
+            .wkbType = 1,
+            .x = record->getValueReal(lon_field),
+            .y = record->getValueReal(lat_field)
+        };
+        geoBuilder.UnsafeAppend((uint8_t*)&point, sizeof(wkbpoint_t));
+        lon_field.offset += row_size * 8;
+        lat_field.offset += row_size * 8;
+    }
+}
+
 /******************************************************************************
  * STATIC DATA
  ******************************************************************************/
@@ -150,14 +423,22 @@ const RecordObject::fieldDef_t ParquetBuilder::dataRecDef[] = {
     {"data",       RecordObject::UINT8,    offsetof(arrow_file_data_t, data),                      0,  NULL, NATIVE_FLAGS} // variable length
 };
 
-const char* ParquetBuilder::TMP_FILE_PREFIX = "/tmp/";
+const char* ParquetBuilder::eofRecType = "arrowrec.eof";
+const RecordObject::fieldDef_t ParquetBuilder::eofRecDef[] = {
+    {"filename",   RecordObject::STRING,   offsetof(arrow_file_eof_t, filename),   FILE_NAME_MAX_LEN,  NULL, NATIVE_FLAGS},
+    {"size",       RecordObject::INT64,    offsetof(arrow_file_eof_t, size),                       1,  NULL, NATIVE_FLAGS}
+};
 
 /******************************************************************************
  * PUBLIC METHODS
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * luaCreate - :arrow(<filename>, <outq name>, <rec_type>, <id>, <lon_key>, <lat_key>)
+ * luaCreate - :parquet(<filename>, <outq name>, <rec_type>, <id>, [<lon_key>, <lat_key>], [<row group size>], [<format>])
+ *
+ *  format is one of "parquet" (default), "feather", or "arrow"; the row group
+ *  size sets the size of the record batches for the arrow formats and defaults
+ *  to a record batch per record received
  *----------------------------------------------------------------------------*/
 int ParquetBuilder::luaCreate (lua_State* L)
 {
@@ -167,9 +448,29 @@ int ParquetBuilder::luaCreate (lua_State* L)
         const char* filename        = getLuaString(L, 1);
         const char* outq_name       = getLuaString(L, 2);
         const char* rec_type        = getLuaString(L, 3);
-        const char* id              = getLuaString(L, 4);
+        const char* id              = getLuaString(L, 4); // not needed since no temporary file is created
         const char* lat_key         = getLuaString(L, 5, true, NULL);
         const char* lon_key         = getLuaString(L, 6, true, NULL);
+        long        row_group_size  = getLuaInteger(L, 7, true, -1);
+        const char* format_str      = getLuaString(L, 8, true, "parquet");
+        (void)id;
+
+        /* Check Format */
+        format_t format = str2format(format_str);
+        if(format == UNSUPPORTED)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Unsupported format: %s", format_str);
+        }
+
+        /* Check Row Group Size */
+        if(row_group_size == -1)
+        {
+            row_group_size = (format == PARQUET) ? DEFAULT_ROW_GROUP_SIZE : DEFAULT_RECORD_BATCH_SIZE;
+        }
+        else if(row_group_size < 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Invalid row group size: %ld", row_group_size);
+        }
 
         /* Build Geometry Fields */
         geo_data_t geo;
@@ -192,7 +493,7 @@ int ParquetBuilder::luaCreate (lua_State* L)
         }
 
         /* Create Dispatch */
-        return createLuaObject(L, new ParquetBuilder(L, filename, outq_name, rec_type, id, geo));
+        return createLuaObject(L, new ParquetBuilder(L, filename, outq_name, rec_type, geo, row_group_size, format));
     }
     catch(const RunTimeException& e)
     {
@@ -208,6 +509,7 @@ void ParquetBuilder::init (void)
 {
     RECDEF(metaRecType, metaRecDef, sizeof(arrow_file_meta_t), NULL);
     RECDEF(dataRecType, dataRecDef, sizeof(arrow_file_data_t), NULL);
+    RECDEF(eofRecType, eofRecDef, sizeof(arrow_file_eof_t), NULL);
 }
 
 /*----------------------------------------------------------------------------
@@ -217,6 +519,17 @@ void ParquetBuilder::deinit (void)
 {
 }
 
+/*----------------------------------------------------------------------------
+ * str2format
+ *----------------------------------------------------------------------------*/
+ParquetBuilder::format_t ParquetBuilder::str2format (const char* fmt_str)
+{
+    if     (StringLib::match(fmt_str, "parquet"))   return PARQUET;
+    else if(StringLib::match(fmt_str, "feather"))   return FEATHER;
+    else if(StringLib::match(fmt_str, "arrow"))     return ARROW_STREAM;
+    else                                            return UNSUPPORTED;
+}
+
 /******************************************************************************
  * PRIVATE METHODS
  *******************************************************************************/
@@ -224,16 +537,16 @@ void ParquetBuilder::deinit (void)
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-ParquetBuilder::ParquetBuilder (lua_State* L, const char* filename, const char* outq_name, const char* rec_type, const char* id, geo_data_t geo):
+ParquetBuilder::ParquetBuilder (lua_State* L, const char* filename, const char* outq_name, const char* rec_type, geo_data_t geo, long row_group_size, format_t _format):
     DispatchObject(L, LuaMetaName, LuaMetaTable)
 {
     assert(filename);
     assert(outq_name);
     assert(rec_type);
-    assert(id);
 
     /* Allocate Private Implementation */
     pimpl = new ParquetBuilder::impl;
+    pimpl->numRows = 0;
 
     /* Save Output Filename */
     outFileName = StringLib::duplicate(filename);
@@ -243,29 +556,21 @@ ParquetBuilder::ParquetBuilder (lua_State* L, const char* filename, const char*
 
     /* Row Size */
     rowSizeBytes = RecordObject::getRecordDataSize(rec_type);
+    rowGroupRows = MAX(row_group_size / MAX(rowSizeBytes, 1), 1);
 
     /* Initialize GeoParquet Option */
     geoData = geo;
 
+    /* Output Format */
+    format = _format;
+
     /* Define Table Schema */
     pimpl->schema = pimpl->defineTableSchema(fieldList, rec_type, geoData.as_geo);
     fieldIterator = new field_iterator_t(fieldList);
-
-    /* Create Unique Temporary Filename */
-    SafeString tmp_file("%s%s.parquet", TMP_FILE_PREFIX, id);
-    fileName = tmp_file.getString(true);
+    pimpl->defineColumns(fieldList);
 
     /* Create Arrow Output Stream */
-    shared_ptr<arrow::io::FileOutputStream> file_output_stream;
-    PARQUET_ASSIGN_OR_THROW(file_output_stream, arrow::io::FileOutputStream::Open(fileName));
-
-    /* Create Writer Properties */
-    parquet::WriterProperties::Builder writer_props_builder;
-    writer_props_builder.compression(parquet::Compression::GZIP);
-    shared_ptr<parquet::WriterProperties> writer_props = writer_props_builder.build();
-
-    /* Create Arrow Writer Properties */
-    auto arrow_writer_props = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+    pimpl->outputStream = make_shared<ArrowOutputStream>(this);
 
     /* Build GeoParquet MetaData */
     if(geoData.as_geo)
@@ -277,22 +582,35 @@ ParquetBuilder::ParquetBuilder (lua_State* L, const char* filename, const char*
         delete [] metadata_str;
     }
 
-    /* Create Parquet Writer */
-    #ifdef APACHE_ARROW_10_COMPAT
-        (void)parquet::arrow::FileWriter::Open(*pimpl->schema, ::arrow::default_memory_pool(), file_output_stream, writer_props, arrow_writer_props, &pimpl->parquetWriter);
-    #elif 0 // alternative method of creating file writer
-        std::shared_ptr<parquet::SchemaDescriptor> parquet_schema;
-        (void)parquet::arrow::ToParquetSchema(pimpl->schema.get(), *writer_props, *arrow_writer_props, &parquet_schema);
-        auto schema_node = std::static_pointer_cast<parquet::schema::GroupNode>(parquet_schema->schema_root());
-        std::unique_ptr<parquet::ParquetFileWriter> base_writer;
-        base_writer = parquet::ParquetFileWriter::Open(std::move(file_output_stream), schema_node, std::move(writer_props), metadata);
-        auto schema_ptr = std::make_shared<::arrow::Schema>(*pimpl->schema);
-        (void)parquet::arrow::FileWriter::Make(::arrow::default_memory_pool(), std::move(base_writer), std::move(schema_ptr), std::move(arrow_writer_props), &pimpl->parquetWriter);
-    #else
-        arrow::Result<std::unique_ptr<parquet::arrow::FileWriter>> result = parquet::arrow::FileWriter::Open(*pimpl->schema, ::arrow::default_memory_pool(), file_output_stream, writer_props, arrow_writer_props);
-        if(result.ok()) pimpl->parquetWriter = std::move(result).ValueOrDie();
-        else mlog(CRITICAL, "Failed to open parquet writer: %s", result.status().ToString().c_str());
-    #endif
+    /* Create Writer */
+    if(format == PARQUET)
+    {
+        /* Create Writer Properties */
+        parquet::WriterProperties::Builder writer_props_builder;
+        writer_props_builder.compression(parquet::Compression::GZIP);
+        shared_ptr<parquet::WriterProperties> writer_props = writer_props_builder.build();
+
+        /* Create Arrow Writer Properties */
+        auto arrow_writer_props = parquet::ArrowWriterProperties::Builder().store_schema()->build();
+
+        /* Create Parquet Writer */
+        #ifdef APACHE_ARROW_10_COMPAT
+            (void)parquet::arrow::FileWriter::Open(*pimpl->schema, ::arrow::default_memory_pool(), pimpl->outputStream, writer_props, arrow_writer_props, &pimpl->parquetWriter);
+        #else
+            arrow::Result<std::unique_ptr<parquet::arrow::FileWriter>> result = parquet::arrow::FileWriter::Open(*pimpl->schema, ::arrow::default_memory_pool(), pimpl->outputStream, writer_props, arrow_writer_props);
+            if(result.ok()) pimpl->parquetWriter = std::move(result).ValueOrDie();
+            else mlog(CRITICAL, "Failed to open parquet writer: %s", result.status().ToString().c_str());
+        #endif
+    }
+    else
+    {
+        /* Create Arrow IPC Writer (file format for feather) */
+        arrow::Result<shared_ptr<arrow::ipc::RecordBatchWriter>> result = (format == FEATHER) ?
+            arrow::ipc::MakeFileWriter(pimpl->outputStream, pimpl->schema) :
+            arrow::ipc::MakeStreamWriter(pimpl->outputStream, pimpl->schema);
+        if(result.ok()) pimpl->ipcWriter = result.ValueOrDie();
+        else mlog(CRITICAL, "Failed to open arrow ipc writer: %s", result.status().ToString().c_str());
+    }
 }
 
 /*----------------------------------------------------------------------------
@@ -300,11 +618,10 @@ ParquetBuilder::ParquetBuilder (lua_State* L, const char* filename, const char*
  *----------------------------------------------------------------------------*/
 ParquetBuilder::~ParquetBuilder(void)
 {
-    delete [] fileName;
+    delete pimpl; // deleted ahead of the output queue and name used by its output stream
     delete outQ;
     delete [] outFileName;
     delete fieldIterator;
-    delete pimpl;
 }
 
 /*----------------------------------------------------------------------------
@@ -313,6 +630,7 @@ ParquetBuilder::~ParquetBuilder(void)
 bool ParquetBuilder::processRecord (RecordObject* record, okey_t key)
 {
     (void)key;
+    bool status = true;
 
     /* Determine Number of Rows in Record */
     int record_size_bytes = record->getAllocatedDataSize();
@@ -324,224 +642,42 @@ bool ParquetBuilder::processRecord (RecordObject* record, okey_t key)
         return false;
     }
 
-    /* Loop Through Fields in Schema */
-    vector<shared_ptr<arrow::Array>> columns;
-    for(int i = 0; i < fieldIterator->length; i++)
+    tableMut.lock();
     {
-        RecordObject::field_t field = (*fieldIterator)[i];
-        shared_ptr<arrow::Array> column;
+        /* Reserve Rows in Columns */
+        arrow::Status append_status = pimpl->reserveRows(num_rows, geoData.as_geo);
 
-        /* Loop Through Each Row */
-        switch(field.type)
+        /* Append Rows to Columns */
+        for(int i = 0; append_status.ok() && i < fieldIterator->length; i++)
         {
-            case RecordObject::DOUBLE:
-            {
-                arrow::DoubleBuilder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((double)record->getValueReal(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::FLOAT:
-            {
-                arrow::FloatBuilder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((float)record->getValueReal(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::INT8:
-            {
-                arrow::Int8Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((int8_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::INT16:
-            {
-                arrow::Int16Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((int16_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::INT32:
-            {
-                arrow::Int32Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((int32_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::INT64:
-            {
-                arrow::Int64Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((int64_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::UINT8:
-            {
-                arrow::UInt8Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((uint8_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::UINT16:
-            {
-                arrow::UInt16Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((uint16_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::UINT32:
-            {
-                arrow::UInt32Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((uint32_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::UINT64:
-            {
-                arrow::UInt64Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((uint64_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
-
-            case RecordObject::TIME8:
-            {
-                arrow::Date64Builder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    builder.UnsafeAppend((int64_t)record->getValueInteger(field));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
-            }
+            append_status = pimpl->appendColumn(i, record, num_rows, rowSizeBytes);
+        }
 
-            case RecordObject::STRING:
+        if(append_status.ok())
+        {
+            /* Append Geometry (if GeoParquet) */
+            if(geoData.as_geo)
             {
-                arrow::StringBuilder builder;
-                (void)builder.Reserve(num_rows);
-                for(int row = 0; row < num_rows; row++)
-                {
-                    const char* str = record->getValueText(field);
-                    builder.UnsafeAppend(str, StringLib::size(str));
-                    field.offset += rowSizeBytes * 8;
-                }
-                (void)builder.Finish(&column);
-                break;
+                pimpl->appendGeometry(record, num_rows, rowSizeBytes, geoData);
             }
 
-            default:
+            /* Write Row Group when Full */
+            pimpl->numRows += num_rows;
+            if(pimpl->numRows >= rowGroupRows)
             {
-                break;
+                status = writeRowGroup();
             }
         }
-
-        /* Add Column to Columns */
-        columns.push_back(column);
-    }
-
-    /* Add Geometry Column (if GeoParquet) */
-    if(geoData.as_geo)
-    {
-        RecordObject::field_t lon_field = geoData.lon_field;
-        RecordObject::field_t lat_field = geoData.lat_field;
-        shared_ptr<arrow::Array> column;
-        arrow::BinaryBuilder builder;
-        for(int row = 0; row < num_rows; row++)
-        {
-            wkbpoint_t point = {
-                #ifdef __be__
-                .byteOrder = 0,
-                #else
-                .byteOrder = 1,
-                #endif
-                .wkbType = 1,
-                .x = record->getValueReal(lon_field),
-                .y = record->getValueReal(lat_field)
-            };
-            (void)builder.Append((uint8_t*)&point, sizeof(wkbpoint_t));
-            lon_field.offset += rowSizeBytes * 8;
-            lat_field.offset += rowSizeBytes * 8;
-        }
-        (void)builder.Finish(&column);
-        columns.push_back(column);
-    }
-
-    /* Write Table */
-    if(pimpl->parquetWriter)
-    {
-        tableMut.lock();
+        else
         {
-            /* Build and Write Table */
-            shared_ptr<arrow::Table> table = arrow::Table::Make(pimpl->schema, columns);
-            (void)pimpl->parquetWriter->WriteTable(*table, num_rows);
+            mlog(CRITICAL, "Failed to append rows of %s to %s: %s", record->getRecordType(), outFileName, append_status.ToString().c_str());
+            status = false;
         }
-        tableMut.unlock();
     }
+    tableMut.unlock();
 
-    /* Return Success */
-    return true;
+    /* Return Status */
+    return status;
 }
 
 /*----------------------------------------------------------------------------
@@ -562,91 +698,126 @@ bool ParquetBuilder::processTermination (void)
     bool status = true;
 
     /* Early Exit on No Writer */
-    if(!pimpl->parquetWriter) return false;
-
-    /* Close Parquet Writer */
-    (void)pimpl->parquetWriter->Close();
+    if(!pimpl->parquetWriter && !pimpl->ipcWriter) return false;
 
-    /* Reopen Parquet File to Stream Back as Response */
-    FILE* fp = fopen(fileName, "r");
-    if(fp)
+    tableMut.lock();
     {
-        /* Get Size of File */
-        fseek(fp, 0L, SEEK_END);
-        long file_size = ftell(fp);
-        fseek(fp, 0L, SEEK_SET);
-
-        do
+        /* Write Last Row Group */
+        if(pimpl->numRows > 0)
         {
-            /* Send Meta Record */
-            RecordObject meta_record(metaRecType);
-            arrow_file_meta_t* meta = (arrow_file_meta_t*)meta_record.getRecordData();
-            StringLib::copy(&meta->filename[0], outFileName, FILE_NAME_MAX_LEN);
-            meta->size = file_size;
-            if(!postRecord(&meta_record))
-            {
-                status = false;
-                break; // early exit on error
-            }
-
-            /* Send Data Records */
-            long offset = 0;
-            while(offset < file_size)
-            {
-                RecordObject data_record(dataRecType, 0, false);
-                arrow_file_data_t* data = (arrow_file_data_t*)data_record.getRecordData();
-                StringLib::copy(&data->filename[0], outFileName, FILE_NAME_MAX_LEN);
-                size_t bytes_read = fread(data->data, 1, FILE_BUFFER_RSPS_SIZE, fp);
-                if(!postRecord(&data_record, offsetof(arrow_file_data_t, data) + bytes_read))
-                {
-                    status = false;
-                    break; // early exit on error
-                }
-                offset += bytes_read;
-            }
-        } while(false);
+            status = writeRowGroup();
+        }
 
-        /* Close File */
-        int rc1 = fclose(fp);
-        if(rc1 != 0)
+        /* Close Writer (writes footer or end of stream marker) */
+        arrow::Status close_status = pimpl->parquetWriter ? pimpl->parquetWriter->Close() : pimpl->ipcWriter->Close();
+        if(!close_status.ok())
         {
+            mlog(CRITICAL, "Failed to close writer for %s: %s", outFileName, close_status.ToString().c_str());
             status = false;
-            mlog(CRITICAL, "Failed (%d) to close file %s: %s", rc1, fileName, strerror(errno));
         }
 
-        /* Remove File */
-        int rc2 = remove(fileName);
-        if(rc2 != 0)
+        /* Send Remainder of File */
+        arrow::Status flush_status = pimpl->outputStream->Close();
+        if(!flush_status.ok())
         {
+            mlog(CRITICAL, "Failed to stream file %s: %s", outFileName, flush_status.ToString().c_str());
             status = false;
-            mlog(CRITICAL, "Failed (%d) to delete file %s: %s", rc2, fileName, strerror(errno));
+        }
+
+        /* Send EOF Record with Final Size of File */
+        if(status)
+        {
+            RecordObject eof_record(eofRecType);
+            arrow_file_eof_t* eof = (arrow_file_eof_t*)eof_record.getRecordData();
+            StringLib::copy(&eof->filename[0], outFileName, FILE_NAME_MAX_LEN);
+            eof->size = pimpl->outputStream->Tell().ValueOrDie();
+            status = postRecord(&eof_record);
         }
     }
-    else // unable to open file
-    {
-        status = false;
-        mlog(CRITICAL, "Failed (%d) to read parquet file %s: %s", errno, fileName, strerror(errno));
-    }
+    tableMut.unlock();
 
     /* Return Status */
     return status;
 }
 
+/*----------------------------------------------------------------------------
+ * writeRowGroup
+ *
+ *  Note: must be called with tableMut locked; for the arrow formats the rows
+ *  are written as a record batch instead of a row group
+ *----------------------------------------------------------------------------*/
+bool ParquetBuilder::writeRowGroup (void)
+{
+    int64_t num_rows = pimpl->numRows;
+    pimpl->numRows = 0;
+
+    /* Finish Columns */
+    vector<shared_ptr<arrow::Array>> columns;
+    for(int i = 0; i < fieldIterator->length; i++)
+    {
+        shared_ptr<arrow::Array> column;
+        if(pimpl->columns[i].size > 0)
+        {
+            shared_ptr<arrow::Buffer> values;
+            (void)pimpl->columnBuffers[i]->Finish(&values);
+            column = arrow::MakeArray(arrow::ArrayData::Make(pimpl->schema->field(i)->type(), num_rows, {nullptr, values}, 0));
+        }
+        else
+        {
+            (void)pimpl->columnBuilders[i]->Finish(&column);
+        }
+        columns.push_back(column);
+    }
+
+    /* Finish Geometry Column (if GeoParquet) */
+    if(geoData.as_geo)
+    {
+        shared_ptr<arrow::Array> column;
+        (void)pimpl->geoBuilder.Finish(&column);
+        columns.push_back(column);
+    }
+
+    /* Write Row Group (or Record Batch) and Stream it Out */
+    arrow::Status write_status;
+    if(pimpl->parquetWriter)
+    {
+        shared_ptr<arrow::Table> table = arrow::Table::Make(pimpl->schema, columns, num_rows);
+        write_status = pimpl->parquetWriter->WriteTable(*table, num_rows);
+    }
+    else if(pimpl->ipcWriter)
+    {
+        shared_ptr<arrow::RecordBatch> batch = arrow::RecordBatch::Make(pimpl->schema, num_rows, columns);
+        write_status = pimpl->ipcWriter->WriteRecordBatch(*batch);
+    }
+    else
+    {
+        return false; // no writer
+    }
+    if(write_status.ok()) write_status = pimpl->outputStream->Flush();
+    if(!write_status.ok())
+    {
+        mlog(CRITICAL, "Failed to write row group to %s: %s", outFileName, write_status.ToString().c_str());
+        return false;
+    }
+
+    return true;
+}
+
 /*----------------------------------------------------------------------------
  * postRecord
  *
  *  The while loop should not be an infinite loop because when the output queue
  *  is cleaned up, the call to postRef should fail with no subscribers
  *----------------------------------------------------------------------------*/
-bool ParquetBuilder::postRecord (RecordObject* record, int data_size)
+bool ParquetBuilder::postRecord (RecordObject* record, int data_size, RecordObject::serialMode_t mode)
 {
     uint8_t* rec_buf = NULL;
-    int rec_bytes = record->serialize(&rec_buf, RecordObject::TAKE_OWNERSHIP, data_size);
+    int rec_bytes = record->serialize(&rec_buf, mode, data_size);
     int post_status = MsgQ::STATE_TIMEOUT;
     while((post_status = outQ->postRef(rec_buf, rec_bytes, SYS_TIMEOUT)) == MsgQ::STATE_TIMEOUT);
     if(post_status <= 0)
     {
-        delete [] rec_buf; // we've taken ownership
+        delete [] rec_buf; // we've taken ownership or allocated a copy
         mlog(ERROR, "Parquet builder failed to post %s to stream %s: %d", record->getRecordType(), outQ->getName(), post_status);
         return false;
     }
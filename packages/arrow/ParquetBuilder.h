@@ -38,6 +38,19 @@
  * then it expects to receive records that are arrays (or batches) of that record
  * type.  The field defined as an array is transparent to this class - it just
  * expects the record to be a single array.
+ *
+ * Rows are accumulated into columns until a row group of the configured size
+ * is complete; the row group is then written through an output stream that
+ * posts the bytes of the file to the output queue as they are produced, so the
+ * file is streamed back while the records are still being processed.  Since
+ * the size of the file is not known until the last row group is written, the
+ * size in the meta record sent ahead of the data is set to -1.
+ *
+ * The same columns can instead be written out as an Arrow IPC stream (or as
+ * an Arrow IPC file, a.k.a. Feather V2), in which case each completed batch of
+ * rows is written as a record batch; by default every record received is sent
+ * out as its own record batch so that clients receive results as they are
+ * produced and can load them without any conversion.
  */
 
 /******************************************************************************
@@ -66,6 +79,9 @@ class ParquetBuilder: public DispatchObject
         static const int LIST_BLOCK_SIZE = 32;
         static const int FILE_NAME_MAX_LEN = 128;
         static const int FILE_BUFFER_RSPS_SIZE = 0x1000000; // 16MB
+        static const int DEFAULT_ROW_GROUP_SIZE = 0x800000; // 8MB
+        static const int DEFAULT_RECORD_BATCH_SIZE = 0; // a record batch per record
+        static const long STREAMED_FILE_SIZE = -1; // size in the meta record, final size follows in the eof record
 
         static const char* LuaMetaName;
         static const struct luaL_Reg LuaMetaTable[];
@@ -76,12 +92,20 @@ class ParquetBuilder: public DispatchObject
         static const char* dataRecType;
         static const RecordObject::fieldDef_t dataRecDef[];
 
-        static const char* TMP_FILE_PREFIX;
+        static const char* eofRecType;
+        static const RecordObject::fieldDef_t eofRecDef[];
 
         /*--------------------------------------------------------------------
          * Types
          *--------------------------------------------------------------------*/
 
+        typedef enum {
+            PARQUET = 0,
+            FEATHER = 1,        // arrow ipc file format
+            ARROW_STREAM = 2,   // arrow ipc stream format
+            UNSUPPORTED = 3
+        } format_t;
+
         typedef struct {
             char    filename[FILE_NAME_MAX_LEN];
             long    size;
@@ -92,13 +116,19 @@ class ParquetBuilder: public DispatchObject
             uint8_t data[FILE_BUFFER_RSPS_SIZE];
         } arrow_file_data_t;
 
+        typedef struct {
+            char    filename[FILE_NAME_MAX_LEN];
+            long    size;
+        } arrow_file_eof_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
-        static int  luaCreate   (lua_State* L);
-        static void init        (void);
-        static void deinit      (void);
+        static int      luaCreate   (lua_State* L);
+        static void     init        (void);
+        static void     deinit      (void);
+        static format_t str2format  (const char* fmt_str);
 
     private:
 
@@ -131,24 +161,28 @@ class ParquetBuilder: public DispatchObject
         Mutex               tableMut;
         Publisher*          outQ;
         int                 rowSizeBytes;
-        const char*         fileName; // used locally to build file
+        int                 rowGroupRows;
+        format_t            format;
         const char*         outFileName; // name to send back to client
         geo_data_t          geoData;
 
         struct impl; // arrow implementation
         impl* pimpl; // private arrow data
 
+        class ArrowOutputStream; // arrow output stream to the output queue
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
-                            ParquetBuilder          (lua_State* L, const char* filename, const char* outq_name, const char* rec_type, const char* id, geo_data_t geo);
+                            ParquetBuilder          (lua_State* L, const char* filename, const char* outq_name, const char* rec_type, geo_data_t geo, long row_group_size, format_t _format);
                             ~ParquetBuilder         (void);
 
         bool                processRecord           (RecordObject* record, okey_t key) override;
         bool                processTimeout          (void) override;
         bool                processTermination      (void) override;
-        bool                postRecord              (RecordObject* record, int data_size=0);
+        bool                writeRowGroup           (void);
+        bool                postRecord              (RecordObject* record, int data_size=0, RecordObject::serialMode_t mode=RecordObject::TAKE_OWNERSHIP);
         const char*         buildGeoMetaData        (void);
 };
 
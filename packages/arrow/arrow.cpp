@@ -33,6 +33,13 @@
  *INCLUDES
  ******************************************************************************/
 
+#include <arrow/array.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/record_batch.h>
+#include <arrow/table.h>
+#include <parquet/arrow/reader.h>
+
 #include "core.h"
 #include "arrow.h"
 
@@ -46,6 +53,207 @@
  * LOCAL FUNCTIONS
  ******************************************************************************/
 
+/*----------------------------------------------------------------------------
+ * appendValues
+ *----------------------------------------------------------------------------*/
+template<typename T>
+static void appendValues (lua_State* L, const arrow::Array& array, long& num_values)
+{
+    const T& values = static_cast<const T&>(array);
+    for(int64_t i = 0; i < values.length(); i++)
+    {
+        lua_pushnumber(L, (double)values.Value(i));
+        lua_rawseti(L, -2, ++num_values);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * appendColumn
+ *
+ *  appends the values of a numeric column to the table on the top of the
+ *  stack, starting after the num_values already in it
+ *----------------------------------------------------------------------------*/
+static void appendColumn (lua_State* L, const arrow::Array& array, long& num_values)
+{
+    switch(array.type_id())
+    {
+        case arrow::Type::INT8:     appendValues<arrow::Int8Array>(L, array, num_values);     break;
+        case arrow::Type::INT16:    appendValues<arrow::Int16Array>(L, array, num_values);    break;
+        case arrow::Type::INT32:    appendValues<arrow::Int32Array>(L, array, num_values);    break;
+        case arrow::Type::INT64:    appendValues<arrow::Int64Array>(L, array, num_values);    break;
+        case arrow::Type::UINT8:    appendValues<arrow::UInt8Array>(L, array, num_values);    break;
+        case arrow::Type::UINT16:   appendValues<arrow::UInt16Array>(L, array, num_values);   break;
+        case arrow::Type::UINT32:   appendValues<arrow::UInt32Array>(L, array, num_values);   break;
+        case arrow::Type::UINT64:   appendValues<arrow::UInt64Array>(L, array, num_values);   break;
+        case arrow::Type::FLOAT:    appendValues<arrow::FloatArray>(L, array, num_values);    break;
+        case arrow::Type::DOUBLE:   appendValues<arrow::DoubleArray>(L, array, num_values);   break;
+        case arrow::Type::TIMESTAMP: appendValues<arrow::TimestampArray>(L, array, num_values); break;
+        default: throw RunTimeException(CRITICAL, RTE_ERROR, "Unsupported column type: %s", array.type()->ToString().c_str());
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * arrow_readparquet - readparquet(<filename>, [<column>])
+ *
+ *  reads back a parquet file and returns a table with the number of rows,
+ *  row groups, and columns in it, along with the values of the column when
+ *  one is named
+ *----------------------------------------------------------------------------*/
+int arrow_readparquet (lua_State* L)
+{
+    try
+    {
+        /* Get Parameters */
+        const char* filename = LuaObject::getLuaString(L, 1);
+        const char* column_name = LuaObject::getLuaString(L, 2, true, NULL);
+
+        /* Open File */
+        arrow::Result<std::shared_ptr<arrow::io::ReadableFile>> file_result = arrow::io::ReadableFile::Open(filename);
+        if(!file_result.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Failed to open %s: %s", filename, file_result.status().ToString().c_str());
+        }
+
+        /* Create Parquet Reader */
+        std::unique_ptr<parquet::arrow::FileReader> reader;
+        #ifdef APACHE_ARROW_10_COMPAT
+            arrow::Status open_status = parquet::arrow::OpenFile(file_result.ValueOrDie(), arrow::default_memory_pool(), &reader);
+        #else
+            arrow::Result<std::unique_ptr<parquet::arrow::FileReader>> reader_result = parquet::arrow::OpenFile(file_result.ValueOrDie(), arrow::default_memory_pool());
+            arrow::Status open_status = reader_result.status();
+            if(reader_result.ok()) reader = std::move(reader_result).ValueOrDie();
+        #endif
+        if(!open_status.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Failed to read %s: %s", filename, open_status.ToString().c_str());
+        }
+
+        /* Read Table (the status form is deprecated from arrow 24) */
+        std::shared_ptr<arrow::Table> table;
+        #if ARROW_VERSION_MAJOR >= 24
+            arrow::Result<std::shared_ptr<arrow::Table>> table_result = reader->ReadTable();
+            arrow::Status read_status = table_result.status();
+            if(table_result.ok()) table = table_result.ValueOrDie();
+        #else
+            arrow::Status read_status = reader->ReadTable(&table);
+        #endif
+        if(!read_status.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Failed to read table from %s: %s", filename, read_status.ToString().c_str());
+        }
+
+        /* Return Contents */
+        lua_newtable(L);
+        LuaEngine::setAttrInt(L, "rows", table->num_rows());
+        LuaEngine::setAttrInt(L, "row_groups", reader->num_row_groups());
+        LuaEngine::setAttrInt(L, "columns", table->num_columns());
+        if(column_name)
+        {
+            std::shared_ptr<arrow::ChunkedArray> column = table->GetColumnByName(column_name);
+            if(!column)
+            {
+                throw RunTimeException(CRITICAL, RTE_ERROR, "Column %s not found in %s", column_name, filename);
+            }
+
+            long num_values = 0;
+            lua_pushstring(L, "values");
+            lua_newtable(L);
+            for(int i = 0; i < column->num_chunks(); i++)
+            {
+                appendColumn(L, *column->chunk(i), num_values);
+            }
+            lua_settable(L, -3);
+        }
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error reading parquet file: %s", e.what());
+        return LuaObject::returnLuaStatus(L, false);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * arrow_readipc - readipc(<filename>)
+ *
+ *  reads back an arrow ipc stream or file (feather) and returns a table with
+ *  the number of rows, record batches, and columns in it
+ *----------------------------------------------------------------------------*/
+int arrow_readipc (lua_State* L)
+{
+    try
+    {
+        /* Get Parameters */
+        const char* filename = LuaObject::getLuaString(L, 1);
+
+        /* Open File */
+        arrow::Result<std::shared_ptr<arrow::io::ReadableFile>> file_result = arrow::io::ReadableFile::Open(filename);
+        if(!file_result.ok())
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Failed to open %s: %s", filename, file_result.status().ToString().c_str());
+        }
+        std::shared_ptr<arrow::io::ReadableFile> file = file_result.ValueOrDie();
+
+        long num_rows = 0;
+        long num_batches = 0;
+        long num_columns = 0;
+
+        /* Read as IPC File */
+        arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchFileReader>> file_reader = arrow::ipc::RecordBatchFileReader::Open(file);
+        if(file_reader.ok())
+        {
+            std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader = file_reader.ValueOrDie();
+            num_columns = reader->schema()->num_fields();
+            for(int i = 0; i < reader->num_record_batches(); i++)
+            {
+                arrow::Result<std::shared_ptr<arrow::RecordBatch>> batch = reader->ReadRecordBatch(i);
+                if(!batch.ok())
+                {
+                    throw RunTimeException(CRITICAL, RTE_ERROR, "Failed to read record batch %d of %s: %s", i, filename, batch.status().ToString().c_str());
+                }
+                num_rows += batch.ValueOrDie()->num_rows();
+                num_batches++;
+            }
+        }
+        /* Read as IPC Stream */
+        else
+        {
+            (void)file->Seek(0);
+            arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchStreamReader>> stream_reader = arrow::ipc::RecordBatchStreamReader::Open(file);
+            if(!stream_reader.ok())
+            {
+                throw RunTimeException(CRITICAL, RTE_ERROR, "Failed to read %s: %s", filename, stream_reader.status().ToString().c_str());
+            }
+            std::shared_ptr<arrow::ipc::RecordBatchStreamReader> reader = stream_reader.ValueOrDie();
+            num_columns = reader->schema()->num_fields();
+            while(true)
+            {
+                std::shared_ptr<arrow::RecordBatch> batch;
+                arrow::Status status = reader->ReadNext(&batch);
+                if(!status.ok())
+                {
+                    throw RunTimeException(CRITICAL, RTE_ERROR, "Failed to read record batch %ld of %s: %s", num_batches, filename, status.ToString().c_str());
+                }
+                if(!batch) break; // end of stream
+                num_rows += batch->num_rows();
+                num_batches++;
+            }
+        }
+
+        /* Return Contents */
+        lua_newtable(L);
+        LuaEngine::setAttrInt(L, "rows", num_rows);
+        LuaEngine::setAttrInt(L, "batches", num_batches);
+        LuaEngine::setAttrInt(L, "columns", num_columns);
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error reading arrow ipc data: %s", e.what());
+        return LuaObject::returnLuaStatus(L, false);
+    }
+}
+
 /*----------------------------------------------------------------------------
  * arrow_open
  *----------------------------------------------------------------------------*/
@@ -53,6 +261,8 @@ int arrow_open (lua_State* L)
 {
     static const struct luaL_Reg arrow_functions[] = {
         {"parquet",     ParquetBuilder::luaCreate},
+        {"readipc",     arrow_readipc},
+        {"readparquet", arrow_readparquet},
         {NULL,          NULL}
     };
 
@@ -38,6 +38,7 @@
 #include "CredentialStore.h"
 #include "OsApi.h"
 #include "Asset.h"
+#include "FileIODriver.h"
 
 #include <assert.h>
 #include <sys/stat.h>
@@ -190,6 +191,15 @@ int64_t S3CacheIODriver::ioRead (uint8_t* data, int64_t size, uint64_t pos)
     return fread(data, 1, size, ioFile);
 }
 
+/*----------------------------------------------------------------------------
+ * ioReadv
+ *----------------------------------------------------------------------------*/
+int64_t S3CacheIODriver::ioReadv (extent_t* extents, int num_extents)
+{
+    /* Read from Cached File (not S3) */
+    return FileIODriver::readv(fileno(ioFile), extents, num_extents);
+}
+
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
@@ -69,6 +69,7 @@ class S3CacheIODriver: public S3CurlIODriver
         static int          luaCreateCache  (lua_State* L);
         static int          createCache     (const char* cache_root=DEFAULT_CACHE_ROOT, int max_files=DEFAULT_MAX_CACHE_FILES);
         int64_t             ioRead          (uint8_t* data, int64_t size, uint64_t pos);
+        int64_t             ioReadv         (extent_t* extents, int num_extents) override;
 
     private:
 
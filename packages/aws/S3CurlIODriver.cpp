@@ -39,6 +39,7 @@
 
 #include <curl/curl.h>
 #include <openssl/hmac.h>
+#include <strings.h>
 
 
 /******************************************************************************
@@ -61,10 +62,44 @@ typedef struct {
     long        size;
 } file_data_t;
 
+typedef struct {
+    char*       tag;
+    int         size;
+    bool        found;
+} tag_data_t;
+
 typedef struct curl_slist* headers_t;
 
+
 typedef size_t (*write_cb_t)(void*, size_t, size_t, void*);
 
+struct S3CurlIODriver::range_request_t {
+    vectored_read_t*            read;
+    Asset::IODriver::extent_t*  extent;
+    fixed_data_t                info;
+    headers_t                   headers;
+    CURL*                       curl;
+    long                        attempts;
+    double                      retry_time; // latch time at which a failed request is resubmitted, 0 when not waiting
+};
+
+struct S3CurlIODriver::vectored_read_t: public Asset::IODriver::IOHandle {
+                                vectored_read_t     (extent_t* _extents, int _num_extents);
+                                ~vectored_read_t    (void);
+
+    SafeString                  url;
+    char*                       bucket;
+    char*                       key;
+    CredentialStore::Credential* credentials; // owned by caller, must outlive the read
+    CURLM*                      multi;      // submitting thread's, not owned
+    range_request_t*            requests;
+    int                         next;       // index of next request to start
+    int                         active;     // requests started and not yet complete
+    int                         waiting;    // active requests waiting out a retry backoff
+    double                      next_retry; // earliest retry time of the waiting requests
+    bool                        status;     // false once any request has failed
+};
+
 /******************************************************************************
  * LOCAL FUNCTIONS
  ******************************************************************************/
@@ -123,6 +158,28 @@ static size_t curlReadFile(void* buffer, size_t size, size_t nmemb, void *userp)
     return bytes_read;
 }
 
+/*----------------------------------------------------------------------------
+ * curlHeaderTag
+ *----------------------------------------------------------------------------*/
+static size_t curlHeaderTag(char* buffer, size_t size, size_t nitems, void *userp)
+{
+    tag_data_t* data = (tag_data_t*)userp;
+    size_t header_size = size * nitems;
+    if(header_size > 5 && strncasecmp(buffer, "ETag:", 5) == 0)
+    {
+        /* Copy Value without Quotes or Whitespace */
+        int t = 0;
+        for(size_t i = 5; i < header_size && t < (data->size - 1); i++)
+        {
+            char c = buffer[i];
+            if(c != '"' && c != ' ' && c != '\t' && c != '\r' && c != '\n') data->tag[t++] = c;
+        }
+        data->tag[t] = '\0';
+        data->found = t > 0;
+    }
+    return header_size;
+}
+
 /*----------------------------------------------------------------------------
  * buildReadHeaders
  *----------------------------------------------------------------------------*/
@@ -200,22 +257,17 @@ static headers_t buildWriteHeaders (const char* bucket, const char* key, Credent
 
 /*----------------------------------------------------------------------------
  * initializeReadRequest
+ *
+ *  sets the per-request options on a handle acquired from the pool; the
+ *  options common to all requests are set when the handle is created
  *----------------------------------------------------------------------------*/
-static CURL* initializeReadRequest (SafeString& url, headers_t headers, write_cb_t write_cb, void* write_parm)
+static CURL* initializeReadRequest (CURL* curl, SafeString& url, headers_t headers, write_cb_t write_cb, void* write_parm)
 {
-    /* Initialize cURL */
-    CURL* curl = curl_easy_init();
     if(curl)
     {
         /* Set Options */
         curl_easy_setopt(curl, CURLOPT_URL, url.getString());
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, S3CurlIODriver::READ_TIMEOUT);
-        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, S3CurlIODriver::CONNECTION_TIMEOUT);
-        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, S3CurlIODriver::LOW_SPEED_TIME);
-        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, S3CurlIODriver::LOW_SPEED_LIMIT);
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, S3CurlIODriver::SSL_VERIFYPEER);
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, S3CurlIODriver::SSL_VERIFYHOST);
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_cb);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, write_parm);
     }
@@ -260,6 +312,38 @@ static CURL* initializeWriteRequest (SafeString& url, headers_t headers, write_c
     return curl;
 }
 
+/*----------------------------------------------------------------------------
+ * buildUrl
+ *
+ *  path-style by default: <endpoint>/<bucket>/<key>; if the endpoint has a
+ *  {bucket} placeholder (e.g. https://{bucket}.s3.us-west-2.amazonaws.com)
+ *  the bucket is substituted into it instead: <endpoint>/<key>; with no
+ *  endpoint the regional AWS endpoint is used
+ *----------------------------------------------------------------------------*/
+static SafeString buildUrl (const char* endpoint, const char* region, const char* bucket, const char* key)
+{
+    if(endpoint == NULL || endpoint[0] == '\0')
+    {
+        return SafeString("https://s3.%s.amazonaws.com/%s/%s", region, bucket, key);
+    }
+
+    /* Avoid Doubling Separator */
+    int endpoint_len = StringLib::size(endpoint);
+    const char* sep = (endpoint[endpoint_len - 1] == '/') ? "" : "/";
+
+    /* Build Virtual-Host or Path Style URL */
+    if(StringLib::find(endpoint, "{bucket}"))
+    {
+        SafeString url("%s%s%s", endpoint, sep, key);
+        url.replace("{bucket}", bucket);
+        return url;
+    }
+    else
+    {
+        return SafeString("%s%s%s/%s", endpoint, sep, bucket, key);
+    }
+}
+
 /******************************************************************************
  * STATIC DATA
  ******************************************************************************/
@@ -268,10 +352,83 @@ const char* S3CurlIODriver::DEFAULT_REGION = "us-west-2";
 const char* S3CurlIODriver::DEFAULT_ASSET_NAME = "iam-role";
 const char* S3CurlIODriver::FORMAT = "s3";
 
+CURLSH* S3CurlIODriver::curlShare = NULL;
+Mutex S3CurlIODriver::shareMut[CURL_LOCK_DATA_LAST];
+Thread::key_t S3CurlIODriver::handleKey;
+Thread::key_t S3CurlIODriver::multiKey;
+long S3CurlIODriver::maxPooledHandles = S3CurlIODriver::DEFAULT_MAX_POOLED_HANDLES;
+int32_t S3CurlIODriver::createMetricId = EventLib::INVALID_METRIC;
+int32_t S3CurlIODriver::reuseMetricId = EventLib::INVALID_METRIC;
+int32_t S3CurlIODriver::connectMetricId = EventLib::INVALID_METRIC;
+int32_t S3CurlIODriver::connectTimeMetricId = EventLib::INVALID_METRIC;
+
 /******************************************************************************
  * AWS S3 cURL I/O DRIVER CLASS
  ******************************************************************************/
 
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::init (void)
+{
+    /* Keep Idle Handles and Multi Handle per Thread */
+    handleKey = Thread::createGlobal(freeHandles);
+    multiKey = Thread::createGlobal(freeMulti);
+
+    /*
+     * Share DNS and TLS Sessions Across Handles
+     *  the connection cache is not shared; each handle keeps its own
+     *  connections alive, and handles stay with the thread that uses them
+     */
+    curlShare = curl_share_init();
+    if(curlShare)
+    {
+        curl_share_setopt(curlShare, CURLSHOPT_LOCKFUNC, lockShare);
+        curl_share_setopt(curlShare, CURLSHOPT_UNLOCKFUNC, unlockShare);
+        curl_share_setopt(curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+    else
+    {
+        mlog(CRITICAL, "Failed to initialize cURL share, DNS lookups and TLS sessions will not be shared across handles");
+    }
+
+    /* Register Metrics */
+    createMetricId = EventLib::registerMetric(FORMAT, EventLib::COUNTER, "%s", "handles_created");
+    reuseMetricId = EventLib::registerMetric(FORMAT, EventLib::COUNTER, "%s", "handles_reused");
+    connectMetricId = EventLib::registerMetric(FORMAT, EventLib::COUNTER, "%s", "connections");
+    connectTimeMetricId = EventLib::registerMetric(FORMAT, EventLib::COUNTER, "%s", "connect_time");
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *
+ *  threads clean up their own idle and multi handles when they exit; this
+ *  cleans up the calling thread's, and the share is left in place if handles
+ *  that still use it remain
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::deinit (void)
+{
+    void* handles = Thread::getGlobal(handleKey);
+    if(handles)
+    {
+        Thread::setGlobal(handleKey, NULL);
+        freeHandles(handles);
+    }
+
+    void* multi = Thread::getGlobal(multiKey);
+    if(multi)
+    {
+        Thread::setGlobal(multiKey, NULL);
+        freeMulti(multi);
+    }
+
+    if(curlShare && curl_share_cleanup(curlShare) == CURLSHE_OK)
+    {
+        curlShare = NULL;
+    }
+}
+
 /*----------------------------------------------------------------------------
  * create
  *----------------------------------------------------------------------------*/
@@ -285,11 +442,47 @@ Asset::IODriver* S3CurlIODriver::create (const Asset* _asset, const char* resour
  *----------------------------------------------------------------------------*/
 int64_t S3CurlIODriver::ioRead (uint8_t* data, int64_t size, uint64_t pos)
 {
-    return get(data, size, pos, ioBucket, ioKey, asset->getRegion(), &latestCredentials);
+    return get(data, size, pos, ioBucket, ioKey, asset->getRegion(), &latestCredentials, asset->getEndpoint());
+}
+
+/*----------------------------------------------------------------------------
+ * ioReadv
+ *----------------------------------------------------------------------------*/
+int64_t S3CurlIODriver::ioReadv (extent_t* extents, int num_extents)
+{
+    return get(extents, num_extents, ioBucket, ioKey, asset->getRegion(), &latestCredentials, asset->getEndpoint());
+}
+
+/*----------------------------------------------------------------------------
+ * ioSubmit
+ *
+ *  the ranges are left in flight on the calling thread's multi handle; the
+ *  read must be waited on from the same thread, and the driver must outlive
+ *  the read
+ *----------------------------------------------------------------------------*/
+Asset::IODriver::IOHandle* S3CurlIODriver::ioSubmit (extent_t* extents, int num_extents)
+{
+    return submit(extents, num_extents, ioBucket, ioKey, asset->getRegion(), &latestCredentials, asset->getEndpoint());
+}
+
+/*----------------------------------------------------------------------------
+ * ioWait
+ *----------------------------------------------------------------------------*/
+int64_t S3CurlIODriver::ioWait (IOHandle* handle)
+{
+    return wait(static_cast<vectored_read_t*>(handle));
 }
 
 /*----------------------------------------------------------------------------
- * luaGet - s3get(<bucket>, <key>, [<region>], [<asset>]) -> contents
+ * ioTag
+ *----------------------------------------------------------------------------*/
+bool S3CurlIODriver::ioTag (char* tag, int size)
+{
+    return getTag(tag, size, ioBucket, ioKey, asset->getRegion(), &latestCredentials, asset->getEndpoint());
+}
+
+/*----------------------------------------------------------------------------
+ * luaGet - s3get(<bucket>, <key>, [<region>], [<asset>], [<endpoint>]) -> contents
  *----------------------------------------------------------------------------*/
 int S3CurlIODriver::luaGet(lua_State* L)
 {
@@ -303,13 +496,14 @@ int S3CurlIODriver::luaGet(lua_State* L)
         const char* key         = LuaObject::getLuaString(L, 2);
         const char* region      = LuaObject::getLuaString(L, 3, true, S3CurlIODriver::DEFAULT_REGION);
         const char* asset_name  = LuaObject::getLuaString(L, 4, true, S3CurlIODriver::DEFAULT_ASSET_NAME);
+        const char* endpoint    = LuaObject::getLuaString(L, 5, true, NULL);
 
         /* Get Credentials */
         CredentialStore::Credential credentials = CredentialStore::get(asset_name);
 
         /* Make Request */
         uint8_t* rsps_data = NULL;
-        int64_t rsps_size = get(&rsps_data, bucket, key, region, &credentials);
+        int64_t rsps_size = get(&rsps_data, bucket, key, region, &credentials, endpoint);
 
         /* Push Contents */
         if(rsps_data)
@@ -335,7 +529,7 @@ int S3CurlIODriver::luaGet(lua_State* L)
 }
 
 /*----------------------------------------------------------------------------
- * luaDownload - s3download(<bucket>, <key>, [<region>], [<asset>]) -> file
+ * luaDownload - s3download(<bucket>, <key>, [<region>], [<asset>], [<filename>], [<endpoint>]) -> file
  *----------------------------------------------------------------------------*/
 int S3CurlIODriver::luaDownload(lua_State* L)
 {
@@ -349,12 +543,13 @@ int S3CurlIODriver::luaDownload(lua_State* L)
         const char* region      = LuaObject::getLuaString(L, 3, true, S3CurlIODriver::DEFAULT_REGION);
         const char* asset_name  = LuaObject::getLuaString(L, 4, true, S3CurlIODriver::DEFAULT_ASSET_NAME);
         const char* filename    = LuaObject::getLuaString(L, 5, true, key);
+        const char* endpoint    = LuaObject::getLuaString(L, 6, true, NULL);
 
         /* Get Credentials */
         CredentialStore::Credential credentials = CredentialStore::get(asset_name);
 
         /* Make Request */
-        int64_t rsps_size = get(filename, bucket, key, region, &credentials);
+        int64_t rsps_size = get(filename, bucket, key, region, &credentials, endpoint);
 
         /* Push Contents */
         if(rsps_size > 0)   status = true;
@@ -371,7 +566,7 @@ int S3CurlIODriver::luaDownload(lua_State* L)
 }
 
 /*----------------------------------------------------------------------------
- * luaRead - s3read(<bucket>, <key>, <size>, <pos>, [<region>], [<asset>]) -> contents
+ * luaRead - s3read(<bucket>, <key>, <size>, <pos>, [<region>], [<asset>], [<endpoint>]) -> contents
  *----------------------------------------------------------------------------*/
 int S3CurlIODriver::luaRead(lua_State* L)
 {
@@ -387,6 +582,7 @@ int S3CurlIODriver::luaRead(lua_State* L)
         long pos                = LuaObject::getLuaInteger(L, 4);
         const char* region      = LuaObject::getLuaString(L, 5, true, S3CurlIODriver::DEFAULT_REGION);
         const char* asset_name  = LuaObject::getLuaString(L, 6, true, S3CurlIODriver::DEFAULT_ASSET_NAME);
+        const char* endpoint    = LuaObject::getLuaString(L, 7, true, NULL);
 
         /* Check Parameters */
         if(size <= 0) throw RunTimeException(CRITICAL, RTE_ERROR, "Invalid size: %ld", size);
@@ -397,7 +593,7 @@ int S3CurlIODriver::luaRead(lua_State* L)
 
         /* Make Request */
         uint8_t* rsps_data = new uint8_t [size];
-        int64_t rsps_size = get(rsps_data, size, pos, bucket, key, region, &credentials);
+        int64_t rsps_size = get(rsps_data, size, pos, bucket, key, region, &credentials, endpoint);
 
         /* Push Contents */
         if(rsps_size > 0)
@@ -435,6 +631,32 @@ S3CurlIODriver::S3CurlIODriver (const Asset* _asset):
     latestCredentials = CredentialStore::get(asset->getName());
 }
 
+/*----------------------------------------------------------------------------
+ * luaPool - s3pool(<max handles>) -> previous max handles
+ *
+ *  sets the maximum number of idle handles each thread keeps for reuse;
+ *  zero disables reuse, so that every request makes its own connection;
+ *  threads trim their idle handles to the new maximum as they release them
+ *----------------------------------------------------------------------------*/
+int S3CurlIODriver::luaPool (lua_State* L)
+{
+    long prev_max_handles = maxPooledHandles;
+
+    try
+    {
+        long max_handles = LuaObject::getLuaInteger(L, 1);
+        if(max_handles < 0) throw RunTimeException(CRITICAL, RTE_ERROR, "invalid number of handles: %ld", max_handles);
+        maxPooledHandles = max_handles;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error setting S3 handle pool: %s", e.what());
+    }
+
+    lua_pushinteger(L, prev_max_handles);
+    return 1;
+}
+
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
@@ -475,10 +697,229 @@ S3CurlIODriver::~S3CurlIODriver (void)
     if(ioBucket) delete [] ioBucket;
 }
 
+/*----------------------------------------------------------------------------
+ * Constructor - vectored_read_t
+ *----------------------------------------------------------------------------*/
+S3CurlIODriver::vectored_read_t::vectored_read_t (extent_t* _extents, int _num_extents):
+    IOHandle(_extents, _num_extents)
+{
+    bucket = NULL;
+    key = NULL;
+    credentials = NULL;
+    multi = NULL;
+    requests = NULL;
+    next = 0;
+    active = 0;
+    waiting = 0;
+    next_retry = 0.0;
+    status = true;
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor - vectored_read_t
+ *
+ *  requests are only outstanding when the read failed (or was never waited
+ *  on to completion), in which case they are abandoned
+ *----------------------------------------------------------------------------*/
+S3CurlIODriver::vectored_read_t::~vectored_read_t (void)
+{
+    if(requests)
+    {
+        for(int i = 0; i < numExtents; i++)
+        {
+            if(requests[i].curl)
+            {
+                curl_multi_remove_handle(multi, requests[i].curl);
+                releaseHandle(requests[i].curl);
+            }
+            if(requests[i].headers)
+            {
+                curl_slist_free_all(requests[i].headers);
+            }
+        }
+        delete [] requests;
+    }
+    if(bucket) delete [] bucket;
+    if(key) delete [] key;
+}
+
+/*----------------------------------------------------------------------------
+ * acquireHandle
+ *
+ *  returns one of the calling thread's idle handles when one is available,
+ *  keeping the connection it last used alive; otherwise a new handle is
+ *  created
+ *----------------------------------------------------------------------------*/
+CURL* S3CurlIODriver::acquireHandle (void)
+{
+    CURL* curl = NULL;
+
+    /* Get Idle Handle */
+    List<CURL*>* handles = (List<CURL*>*)Thread::getGlobal(handleKey);
+    if(handles)
+    {
+        int last = handles->length() - 1;
+        if(last >= 0)
+        {
+            curl = handles->get(last);
+            handles->remove(last);
+        }
+    }
+
+    /* Reuse Handle */
+    if(curl)
+    {
+        EventLib::incrementMetric(reuseMetricId);
+        return curl;
+    }
+
+    /* Create Handle */
+    curl = curl_easy_init();
+    if(curl)
+    {
+        EventLib::incrementMetric(createMetricId);
+
+        /* Set Options Common to All Reads */
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, READ_TIMEOUT);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, CONNECTION_TIMEOUT);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME);
+        curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, LOW_SPEED_LIMIT);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, SSL_VERIFYPEER);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, SSL_VERIFYHOST);
+        curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(curl, CURLOPT_DNS_CACHE_TIMEOUT, DNS_CACHE_TIMEOUT);
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+        if(curlShare)
+        {
+            curl_easy_setopt(curl, CURLOPT_SHARE, curlShare);
+        }
+    }
+
+    return curl;
+}
+
+/*----------------------------------------------------------------------------
+ * releaseHandle
+ *
+ *  records the connections the handle had to make for its last request and
+ *  keeps it on the calling thread for its next request, or cleans it up if
+ *  the thread already has as many idle handles as allowed
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::releaseHandle (CURL* curl)
+{
+    /* Count New Connections */
+    long num_connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &num_connects);
+    if(num_connects > 0)
+    {
+        double connect_time = 0.0;
+        double appconnect_time = 0.0; // includes TLS handshake
+        curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect_time);
+        curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME, &appconnect_time);
+        EventLib::incrementMetric(connectMetricId, num_connects);
+        EventLib::incrementMetric(connectTimeMetricId, MAX(connect_time, appconnect_time));
+    }
+
+    /* Clear References to Request Memory */
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, NULL);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, NULL);
+    curl_easy_setopt(curl, CURLOPT_PRIVATE, NULL);
+
+    /* Get Thread's Idle Handles */
+    List<CURL*>* handles = (List<CURL*>*)Thread::getGlobal(handleKey);
+    if(!handles && maxPooledHandles > 0)
+    {
+        handles = new List<CURL*>;
+        Thread::setGlobal(handleKey, handles);
+    }
+
+    /* Trim to Maximum (which may have been lowered) */
+    while(handles && handles->length() > maxPooledHandles)
+    {
+        int last = handles->length() - 1;
+        curl_easy_cleanup(handles->get(last));
+        handles->remove(last);
+    }
+
+    /* Keep Handle for Reuse or Clean Up */
+    if(handles && handles->length() < maxPooledHandles)  handles->add(curl);
+    else                                                curl_easy_cleanup(curl);
+}
+
+/*----------------------------------------------------------------------------
+ * freeHandles
+ *
+ *  called when a thread exits with the list of its idle handles
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::freeHandles (void* parm)
+{
+    List<CURL*>* handles = (List<CURL*>*)parm;
+    for(int i = 0; i < handles->length(); i++)
+    {
+        curl_easy_cleanup(handles->get(i));
+    }
+    delete handles;
+}
+
+/*----------------------------------------------------------------------------
+ * acquireMulti
+ *
+ *  returns the calling thread's multi handle, creating it on first use; the
+ *  multi handle lives as long as the thread so that the connections made by
+ *  its vectored reads are kept for the next one
+ *----------------------------------------------------------------------------*/
+CURLM* S3CurlIODriver::acquireMulti (void)
+{
+    CURLM* multi = (CURLM*)Thread::getGlobal(multiKey);
+    if(!multi)
+    {
+        multi = curl_multi_init();
+        if(multi)
+        {
+            curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+            curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, MAX_CONCURRENT_REQUESTS); // otherwise scaled to (and trimmed with) the handles attached
+            Thread::setGlobal(multiKey, multi);
+        }
+    }
+    return multi;
+}
+
+/*----------------------------------------------------------------------------
+ * freeMulti
+ *
+ *  called when a thread exits with its multi handle
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::freeMulti (void* parm)
+{
+    curl_multi_cleanup((CURLM*)parm);
+}
+
+/*----------------------------------------------------------------------------
+ * lockShare
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::lockShare (CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+    (void)handle;
+    (void)access;
+    (void)userptr;
+    shareMut[data].lock();
+}
+
+/*----------------------------------------------------------------------------
+ * unlockShare
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::unlockShare (CURL* handle, curl_lock_data data, void* userptr)
+{
+    (void)handle;
+    (void)userptr;
+    shareMut[data].unlock();
+}
+
 /*----------------------------------------------------------------------------
  * get - fixed
  *----------------------------------------------------------------------------*/
-int64_t S3CurlIODriver::get (uint8_t* data, int64_t size, uint64_t pos, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials)
+int64_t S3CurlIODriver::get (uint8_t* data, int64_t size, uint64_t pos, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials, const char* endpoint)
 {
     bool status = false;
 
@@ -487,7 +928,7 @@ int64_t S3CurlIODriver::get (uint8_t* data, int64_t size, uint64_t pos, const ch
     if(key_ptr[0] == '/') key_ptr++;
 
     /* Build URL */
-    SafeString url("https://s3.%s.amazonaws.com/%s/%s", region, bucket, key_ptr);
+    SafeString url = buildUrl(endpoint, region, bucket, key_ptr);
 
     /* Setup Buffer for Callback */
     fixed_data_t info = {
@@ -511,7 +952,7 @@ int64_t S3CurlIODriver::get (uint8_t* data, int64_t size, uint64_t pos, const ch
         headers = curl_slist_append(headers, rangeHeader.getString());
 
         /* Initialize cURL Request */
-        CURL* curl = initializeReadRequest(url, headers, curlWriteFixed, &info);
+        CURL* curl = initializeReadRequest(acquireHandle(), url, headers, curlWriteFixed, &info);
         if(curl)
         {
             while(!rqst_complete && (attempts-- > 0))
@@ -556,7 +997,7 @@ int64_t S3CurlIODriver::get (uint8_t* data, int64_t size, uint64_t pos, const ch
             }
 
             /* Clean Up cURL */
-            curl_easy_cleanup(curl);
+            releaseHandle(curl);
         }
         else
         {
@@ -578,10 +1019,320 @@ int64_t S3CurlIODriver::get (uint8_t* data, int64_t size, uint64_t pos, const ch
     return size;
 }
 
+/*----------------------------------------------------------------------------
+ * get - vectored
+ *
+ *  issues a range request for each extent and waits for them to complete
+ *----------------------------------------------------------------------------*/
+int64_t S3CurlIODriver::get (extent_t* extents, int num_extents, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials, const char* endpoint)
+{
+    return wait(submit(extents, num_extents, bucket, key, region, credentials, endpoint));
+}
+
+/*----------------------------------------------------------------------------
+ * submit - vectored
+ *
+ *  starts a range request for each extent, keeping up to
+ *  MAX_CONCURRENT_REQUESTS of them in flight at once on the calling thread's
+ *  cURL multi handle; the requests progress when the returned read is waited
+ *  on, which must be done from the same thread
+ *----------------------------------------------------------------------------*/
+S3CurlIODriver::vectored_read_t* S3CurlIODriver::submit (extent_t* extents, int num_extents, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials, const char* endpoint)
+{
+    vectored_read_t* read = new vectored_read_t(extents, num_extents);
+
+    /* Massage Key */
+    const char* key_ptr = key;
+    if(key_ptr[0] == '/') key_ptr++;
+
+    /* Set Request */
+    read->url = buildUrl(endpoint, region, bucket, key_ptr);
+    read->bucket = StringLib::duplicate(bucket);
+    read->key = StringLib::duplicate(key_ptr);
+    read->credentials = credentials;
+
+    /* Get Thread's cURL Multi Handle */
+    read->multi = acquireMulti();
+    if(!read->multi)
+    {
+        mlog(CRITICAL, "Failed to initialize cURL multi request for: %s", key_ptr);
+        read->status = false;
+        return read;
+    }
+
+    /* Allocate Requests */
+    read->requests = new range_request_t [num_extents];
+    for(int i = 0; i < num_extents; i++)
+    {
+        read->requests[i].read = read;
+        read->requests[i].extent = &extents[i];
+        read->requests[i].info.buffer = extents[i].data;
+        read->requests[i].info.size = extents[i].size;
+        read->requests[i].info.index = 0;
+        read->requests[i].headers = NULL;
+        read->requests[i].curl = NULL;
+        read->requests[i].attempts = ATTEMPTS_PER_REQUEST;
+        read->requests[i].retry_time = 0.0;
+        extents[i].bytes = 0;
+    }
+
+    /* Start Requests */
+    startRanges(read);
+    if(read->status)
+    {
+        int running = 0;
+        if(curl_multi_perform(read->multi, &running) != CURLM_OK)
+        {
+            mlog(CRITICAL, "cURL multi request failed for: %s", read->key);
+            read->status = false;
+        }
+    }
+
+    return read;
+}
+
+/*----------------------------------------------------------------------------
+ * wait - vectored
+ *
+ *  drives the multi handle until all of the read's requests complete, then
+ *  frees the read; each range is retried the same way a fixed request is.
+ *  Transfers of other reads submitted on the thread progress as well, and
+ *  their completions are recorded with the read they belong to
+ *----------------------------------------------------------------------------*/
+int64_t S3CurlIODriver::wait (vectored_read_t* read)
+{
+    while(read->status && (read->next < read->numExtents || read->active > 0))
+    {
+        /* Resubmit Failed Requests whose Backoff has Elapsed */
+        double now = TimeLib::latchtime();
+        read->next_retry = 0.0;
+        for(int i = 0; i < read->next && read->waiting > 0; i++)
+        {
+            range_request_t* rqst = &read->requests[i];
+            if(rqst->retry_time <= 0.0) continue;
+            if(rqst->retry_time <= now)
+            {
+                rqst->retry_time = 0.0;
+                curl_multi_add_handle(read->multi, rqst->curl);
+                read->waiting--;
+            }
+            else if(read->next_retry <= 0.0 || rqst->retry_time < read->next_retry)
+            {
+                read->next_retry = rqst->retry_time;
+            }
+        }
+
+        /* Start Requests up to Concurrency Limit */
+        startRanges(read);
+        if(!read->status) break;
+
+        /* Drive Transfers */
+        int running = 0;
+        if(curl_multi_perform(read->multi, &running) != CURLM_OK)
+        {
+            mlog(CRITICAL, "cURL multi request failed for: %s", read->key);
+            read->status = false;
+            break;
+        }
+
+        /* Process Completed Transfers */
+        int msgs_left = 0;
+        CURLMsg* msg = NULL;
+        while((msg = curl_multi_info_read(read->multi, &msgs_left)) != NULL)
+        {
+            if(msg->msg != CURLMSG_DONE) continue;
+            completeRange(read->multi, msg->easy_handle, msg->data.result);
+        }
+
+        /* Wait for Activity (or the Next Retry) */
+        if(read->status && read->active > 0)
+        {
+            int timeout_ms = 1000;
+            if(read->next_retry > 0.0) timeout_ms = MAX(MIN(timeout_ms, (int)((read->next_retry - TimeLib::latchtime()) * 1000.0)), 0);
+            if(read->active > read->waiting)    curl_multi_wait(read->multi, NULL, 0, timeout_ms, NULL);
+            else                                LocalLib::sleep(timeout_ms / 1000.0);
+        }
+    }
+
+    /* Free Read */
+    bool status = read->status;
+    int64_t total_bytes = read->bytesRead;
+    delete read;
+
+    /* Throw Exception on Failure */
+    if(!status)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "cURL vectored request to S3 failed");
+    }
+
+    /* Return Total Bytes Read */
+    return total_bytes;
+}
+
+/*----------------------------------------------------------------------------
+ * startRanges
+ *
+ *  starts the read's next requests until MAX_CONCURRENT_REQUESTS are active
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::startRanges (vectored_read_t* read)
+{
+    while(read->next < read->numExtents && read->active < MAX_CONCURRENT_REQUESTS)
+    {
+        range_request_t* rqst = &read->requests[read->next++];
+
+        /* Build Standard and Range Headers */
+        rqst->headers = buildReadHeaders(read->bucket, read->key, read->credentials);
+        unsigned long start_byte = rqst->extent->pos;
+        unsigned long end_byte = rqst->extent->pos + rqst->extent->size - 1;
+        SafeString rangeHeader("Range: bytes=%lu-%lu", start_byte, end_byte);
+        rqst->headers = curl_slist_append(rqst->headers, rangeHeader.getString());
+
+        /* Initialize cURL Request */
+        rqst->curl = initializeReadRequest(acquireHandle(), read->url, rqst->headers, curlWriteFixed, &rqst->info);
+        if(!rqst->curl)
+        {
+            read->status = false;
+            break;
+        }
+
+        /* Add to Multi Handle */
+        curl_easy_setopt(rqst->curl, CURLOPT_PRIVATE, rqst);
+        curl_multi_add_handle(read->multi, rqst->curl);
+        read->active++;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * completeRange
+ *
+ *  records the result of a finished transfer with the read it belongs to,
+ *  scheduling a retry of the range after a backoff when attempts remain
+ *----------------------------------------------------------------------------*/
+void S3CurlIODriver::completeRange (CURLM* multi, CURL* curl, CURLcode res)
+{
+    range_request_t* rqst = NULL;
+    curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&rqst);
+    curl_multi_remove_handle(multi, curl);
+    vectored_read_t* read = rqst->read;
+    rqst->attempts--;
+
+    bool rqst_complete = false;
+    if(res == CURLE_OK)
+    {
+        /* Get HTTP Code */
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        if(http_code < 300)
+        {
+            /* Request Succeeded */
+            rqst->extent->bytes = rqst->info.index;
+            read->bytesRead += rqst->info.index;
+        }
+        else
+        {
+            /* Request Failed */
+            StringLib::printify((char*)rqst->info.buffer, rqst->info.index);
+            mlog(INFO, "%s", rqst->info.buffer);
+            mlog(CRITICAL, "S3 get returned http error <%ld>", http_code);
+            read->status = false;
+        }
+
+        /* Get Request Completed */
+        rqst_complete = true;
+    }
+    else if(rqst->info.index > 0)
+    {
+        mlog(CRITICAL, "cURL error (%d) encountered after partial response (%ld): %s", res, rqst->info.index, read->key);
+        read->status = false;
+        rqst_complete = true;
+    }
+    else if(rqst->attempts <= 0)
+    {
+        mlog(CRITICAL, "cURL call failed (%d) for request: %s", res, read->key);
+        read->status = false;
+        rqst_complete = true;
+    }
+    else
+    {
+        /* Retry Request after Backoff */
+        long backoff = RETRY_BACKOFF_MS << (ATTEMPTS_PER_REQUEST - rqst->attempts - 1);
+        mlog(CRITICAL, "cURL call failed (%d) for request, retrying in %ldms: %s", res, backoff, read->key);
+        rqst->retry_time = TimeLib::latchtime() + (backoff / 1000.0);
+        if(read->next_retry <= 0.0 || rqst->retry_time < read->next_retry) read->next_retry = rqst->retry_time;
+        read->waiting++;
+    }
+
+    /* Clean Up Completed Request */
+    if(rqst_complete)
+    {
+        releaseHandle(curl);
+        curl_slist_free_all(rqst->headers);
+        rqst->curl = NULL;
+        rqst->headers = NULL;
+        read->active--;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * getTag
+ *----------------------------------------------------------------------------*/
+bool S3CurlIODriver::getTag (char* tag, int size, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials, const char* endpoint)
+{
+    /* Massage Key */
+    const char* key_ptr = key;
+    if(key_ptr[0] == '/') key_ptr++;
+
+    /* Build URL */
+    SafeString url = buildUrl(endpoint, region, bucket, key_ptr);
+
+    /* Setup Buffers for Callbacks */
+    uint8_t byte;
+    fixed_data_t info = {
+        .buffer = &byte,
+        .size = 1,
+        .index = 0
+    };
+    tag_data_t tag_data = {
+        .tag = tag,
+        .size = size,
+        .found = false
+    };
+
+    /* Build Headers (Request Only First Byte) */
+    struct curl_slist* headers = buildReadHeaders(bucket, key_ptr, credentials);
+    headers = curl_slist_append(headers, "Range: bytes=0-0");
+
+    /* Issue Request */
+    CURL* curl = initializeReadRequest(acquireHandle(), url, headers, curlWriteFixed, &info);
+    if(curl)
+    {
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curlHeaderTag);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &tag_data);
+
+        CURLcode res = curl_easy_perform(curl);
+        long http_code = 0;
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+        if(res != CURLE_OK || http_code >= 300)
+        {
+            mlog(CRITICAL, "Failed to get ETag of %s (%d, %ld)", key_ptr, res, http_code);
+            tag_data.found = false;
+        }
+
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, NULL);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, NULL);
+        releaseHandle(curl);
+    }
+
+    /* Clean Up Headers */
+    curl_slist_free_all(headers);
+
+    return tag_data.found;
+}
+
 /*----------------------------------------------------------------------------
  * get - streaming
  *----------------------------------------------------------------------------*/
-int64_t S3CurlIODriver::get (uint8_t** data, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials)
+int64_t S3CurlIODriver::get (uint8_t** data, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials, const char* endpoint)
 {
     /* Initialize Function Parameters */
     bool status = false;
@@ -599,12 +1350,12 @@ int64_t S3CurlIODriver::get (uint8_t** data, const char* bucket, const char* key
     List<streaming_data_t> rsps_set;
 
     /* Build URL */
-    SafeString url("https://s3.%s.amazonaws.com/%s/%s", region, bucket, key_ptr);
+    SafeString url = buildUrl(endpoint, region, bucket, key_ptr);
 
     /* Initialize cURL Request */
     bool rqst_complete = false;
     int attempts = ATTEMPTS_PER_REQUEST;
-    CURL* curl = initializeReadRequest(url, headers, curlWriteStreaming, &rsps_set);
+    CURL* curl = initializeReadRequest(acquireHandle(), url, headers, curlWriteStreaming, &rsps_set);
     if(curl)
     {
         while(!rqst_complete && (attempts-- > 0))
@@ -668,7 +1419,7 @@ int64_t S3CurlIODriver::get (uint8_t** data, const char* bucket, const char* key
         }
 
         /* Clean Up cURL */
-        curl_easy_cleanup(curl);
+        releaseHandle(curl);
     }
 
     /* Clean Up Headers */
@@ -693,7 +1444,7 @@ int64_t S3CurlIODriver::get (uint8_t** data, const char* bucket, const char* key
 /*----------------------------------------------------------------------------
  * get - file
  *----------------------------------------------------------------------------*/
-int64_t S3CurlIODriver::get (const char* filename, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials)
+int64_t S3CurlIODriver::get (const char* filename, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials, const char* endpoint)
 {
     bool status = false;
 
@@ -711,12 +1462,12 @@ int64_t S3CurlIODriver::get (const char* filename, const char* bucket, const cha
     if(data.fd)
     {
         /* Build URL */
-        SafeString url("https://s3.%s.amazonaws.com/%s/%s", region, bucket, key_ptr);
+        SafeString url = buildUrl(endpoint, region, bucket, key_ptr);
 
         /* Initialize cURL Request */
         bool rqst_complete = false;
         int attempts = ATTEMPTS_PER_REQUEST;
-        CURL* curl = initializeReadRequest(url, headers, curlWriteFile, &data);
+        CURL* curl = initializeReadRequest(acquireHandle(), url, headers, curlWriteFile, &data);
         if(curl)
         {
             while(!rqst_complete && (attempts-- > 0))
@@ -759,7 +1510,7 @@ int64_t S3CurlIODriver::get (const char* filename, const char* bucket, const cha
             }
 
             /* Clean Up cURL */
-            curl_easy_cleanup(curl);
+            releaseHandle(curl);
         }
 
         /* Close File */
@@ -786,7 +1537,7 @@ int64_t S3CurlIODriver::get (const char* filename, const char* bucket, const cha
 /*----------------------------------------------------------------------------
  * put - file
  *----------------------------------------------------------------------------*/
-int64_t S3CurlIODriver::put (const char* filename, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials)
+int64_t S3CurlIODriver::put (const char* filename, const char* bucket, const char* key, const char* region, CredentialStore::Credential* credentials, const char* endpoint)
 {
     bool status = false;
 
@@ -804,7 +1555,7 @@ int64_t S3CurlIODriver::put (const char* filename, const char* bucket, const cha
     if(data.fd)
     {
         /* Build URL */
-        SafeString url("https://s3.%s.amazonaws.com/%s/%s", region, bucket, key_ptr);
+        SafeString url = buildUrl(endpoint, region, bucket, key_ptr);
 
         /* Initialize cURL Request */
         bool rqst_complete = false;
@@ -38,9 +38,12 @@
 
 #include "OsApi.h"
 #include "Dictionary.h"
+#include "List.h"
 #include "Asset.h"
 #include "CredentialStore.h"
 
+#include <curl/curl.h>
+
 /******************************************************************************
  * AWS S3 CLIENT CLASS
  ******************************************************************************/
@@ -58,6 +61,10 @@ class S3CurlIODriver: public Asset::IODriver
         static const long LOW_SPEED_LIMIT = 32768; // 32 KB/s
         static const long LOW_SPEED_TIME = 5; // seconds
         static const long ATTEMPTS_PER_REQUEST = 3;
+        static const long MAX_CONCURRENT_REQUESTS = 16; // per vectored read
+        static const long RETRY_BACKOFF_MS = 100; // doubled on each retry of a range in a vectored read
+        static const long DEFAULT_MAX_POOLED_HANDLES = MAX_CONCURRENT_REQUESTS; // idle handles kept per thread
+        static const long DNS_CACHE_TIMEOUT = 300; // seconds
         static const long SSL_VERIFYPEER = 0;
         static const long SSL_VERIFYHOST = 0;
         static const char* DEFAULT_REGION;
@@ -68,15 +75,29 @@ class S3CurlIODriver: public Asset::IODriver
          * Methods
          *--------------------------------------------------------------------*/
 
+        static void         init            (void);
+        static void         deinit          (void);
         static IODriver*    create          (const Asset* _asset, const char* resource);
         virtual int64_t     ioRead          (uint8_t* data, int64_t size, uint64_t pos) override;
+        virtual int64_t     ioReadv         (extent_t* extents, int num_extents) override;
+        virtual IOHandle*   ioSubmit        (extent_t* extents, int num_extents) override;
+        virtual int64_t     ioWait          (IOHandle* handle) override;
+        virtual bool        ioTag           (char* tag, int size) override;
 
         static int          luaGet          (lua_State* L);
         static int          luaDownload     (lua_State* L);
         static int          luaRead         (lua_State* L);
+        static int          luaPool         (lua_State* L);
 
     protected:
 
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        struct range_request_t; // a single range of a vectored read
+        struct vectored_read_t; // a vectored read in flight on a cURL multi handle
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -85,30 +106,65 @@ class S3CurlIODriver: public Asset::IODriver
                             S3CurlIODriver      (const Asset* _asset, const char* resource);
         virtual             ~S3CurlIODriver     (void);
 
+        static CURL*        acquireHandle       (void);
+        static void         releaseHandle       (CURL* curl);
+        static void         freeHandles         (void* parm);
+        static CURLM*       acquireMulti        (void);
+        static void         freeMulti           (void* parm);
+        static void         lockShare           (CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+        static void         unlockShare         (CURL* handle, curl_lock_data data, void* userptr);
+
         // fixed GET - memory preallocated
         static int64_t      get                 (uint8_t* data, int64_t size, uint64_t pos,
                                                  const char* bucket, const char* key, const char* region,
-                                                 CredentialStore::Credential* credentials);
+                                                 CredentialStore::Credential* credentials, const char* endpoint=NULL);
+
+        // vectored GET - concurrent ranges into preallocated memory
+        static int64_t      get                 (extent_t* extents, int num_extents,
+                                                 const char* bucket, const char* key, const char* region,
+                                                 CredentialStore::Credential* credentials, const char* endpoint=NULL);
+
+        static vectored_read_t* submit          (extent_t* extents, int num_extents,
+                                                 const char* bucket, const char* key, const char* region,
+                                                 CredentialStore::Credential* credentials, const char* endpoint=NULL);
+        static int64_t      wait                (vectored_read_t* read);
+        static void         startRanges         (vectored_read_t* read);
+        static void         completeRange       (CURLM* multi, CURL* curl, CURLcode res);
+
+        // ETag - from the headers of a single byte GET
+        static bool         getTag              (char* tag, int size,
+                                                 const char* bucket, const char* key, const char* region,
+                                                 CredentialStore::Credential* credentials, const char* endpoint=NULL);
 
         // streaming GET - memory allocated and returned
         static int64_t      get                 (uint8_t** data,
                                                  const char* bucket, const char* key, const char* region,
-                                                 CredentialStore::Credential* credentials);
+                                                 CredentialStore::Credential* credentials, const char* endpoint=NULL);
 
         // file GET - data written directly to file
         static int64_t      get                 (const char* filename,
                                                  const char* bucket, const char* key, const char* region,
-                                                 CredentialStore::Credential* credentials);
+                                                 CredentialStore::Credential* credentials, const char* endpoint=NULL);
 
         // file PUT - data read directly from file
         static int64_t      put                 (const char* filename,
                                                  const char* bucket, const char* key, const char* region,
-                                                 CredentialStore::Credential* credentials);
+                                                 CredentialStore::Credential* credentials, const char* endpoint=NULL);
 
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
+        static CURLSH*              curlShare;
+        static Mutex                shareMut[CURL_LOCK_DATA_LAST];
+        static Thread::key_t        handleKey; // each thread's idle handles
+        static Thread::key_t        multiKey; // each thread's multi handle, which keeps the connections of its vectored reads
+        static long                 maxPooledHandles;
+        static int32_t              createMetricId;
+        static int32_t              reuseMetricId;
+        static int32_t              connectMetricId;
+        static int32_t              connectTimeMetricId;
+
         const Asset*                asset;
         CredentialStore::Credential latestCredentials;
         char*                       ioBucket;
@@ -58,6 +58,7 @@ int aws_open (lua_State *L)
         {"s3download",  S3CurlIODriver::luaDownload},
         {"s3read",      S3CurlIODriver::luaRead},
         {"s3cache",     S3CacheIODriver::luaCreateCache},
+        {"s3pool",      S3CurlIODriver::luaPool},
         {NULL,          NULL}
     };
 
@@ -76,6 +77,7 @@ void initaws (void)
 {
     /* Initialize Modules */
     CredentialStore::init();
+    S3CurlIODriver::init();
 
     /* Register I/O Drivers */
     Asset::registerDriver(S3CacheIODriver::FORMAT, S3CacheIODriver::create);
@@ -94,6 +96,7 @@ void initaws (void)
 void deinitaws (void)
 {
     /* Uninitialize Modules */
+    S3CurlIODriver::deinit();
     CredentialStore::deinit();
 }
 }
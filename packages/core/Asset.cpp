@@ -50,6 +50,7 @@ const char* Asset::LuaMetaName = "Asset";
 const struct luaL_Reg Asset::LuaMetaTable[] = {
     {"info",        luaInfo},
     {"load",        luaLoad},
+    {"read",        luaRead},
     {NULL,          NULL}
 };
 
@@ -347,3 +348,175 @@ int Asset::luaLoad (lua_State* L)
     /* Return Status */
     return returnLuaStatus(L, status);
 }
+
+/*----------------------------------------------------------------------------
+ * luaRead - :read(<resource>, <table of {pos, size}>) --> table of strings
+ *
+ *  reads each extent of the resource in a single vectored read through the
+ *  asset's I/O driver; an extent that runs past the end of the resource
+ *  comes back short
+ *----------------------------------------------------------------------------*/
+int Asset::luaRead (lua_State* L)
+{
+    IODriver* io_driver = NULL;
+    IODriver::extent_t* extents = NULL;
+    int num_extents = 0;
+    bool status = false;
+
+    try
+    {
+        /* Get Self */
+        Asset* lua_obj = (Asset*)getLuaSelf(L, 1);
+
+        /* Get Resource */
+        const char* resource_name = getLuaString(L, 2);
+
+        /* Get Extents */
+        if(!lua_istable(L, 3)) throw RunTimeException(CRITICAL, RTE_ERROR, "must supply a table of extents");
+        num_extents = lua_rawlen(L, 3);
+        extents = new IODriver::extent_t [num_extents];
+        for(int i = 0; i < num_extents; i++) extents[i].data = NULL;
+        for(int i = 0; i < num_extents; i++)
+        {
+            lua_rawgeti(L, 3, i + 1);
+            lua_rawgeti(L, -1, 1);
+            long pos = getLuaInteger(L, -1);
+            lua_rawgeti(L, -2, 2);
+            long size = getLuaInteger(L, -1);
+            lua_pop(L, 3);
+
+            if(pos < 0 || size <= 0) throw RunTimeException(CRITICAL, RTE_ERROR, "invalid extent %d: %ld bytes at %ld", i + 1, size, pos);
+            extents[i].data = new uint8_t [size];
+            extents[i].size = size;
+            extents[i].pos = pos;
+            extents[i].bytes = 0;
+        }
+
+        /* Read Extents */
+        io_driver = lua_obj->createDriver(resource_name);
+        if(!io_driver) throw RunTimeException(CRITICAL, RTE_ERROR, "failed to create I/O driver for %s", resource_name);
+        io_driver->ioWait(io_driver->ioSubmit(extents, num_extents));
+
+        /* Return Contents */
+        lua_newtable(L);
+        for(int i = 0; i < num_extents; i++)
+        {
+            lua_pushlstring(L, (const char*)extents[i].data, extents[i].bytes);
+            lua_rawseti(L, -2, i + 1);
+        }
+        status = true;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error reading resource: %s", e.what());
+    }
+
+    /* Clean Up */
+    if(io_driver) delete io_driver;
+    if(extents)
+    {
+        for(int i = 0; i < num_extents; i++)
+        {
+            if(extents[i].data) delete [] extents[i].data;
+        }
+        delete [] extents;
+    }
+
+    /* Return Contents */
+    if(status) return 1;
+    return returnLuaStatus(L, false);
+}
+
+/******************************************************************************
+ * IO DRIVER METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * Constructor - IOHandle
+ *----------------------------------------------------------------------------*/
+Asset::IODriver::IOHandle::IOHandle (extent_t* _extents, int _num_extents):
+    extents(_extents),
+    numExtents(_num_extents),
+    bytesRead(0),
+    error(NULL)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor - IOHandle
+ *----------------------------------------------------------------------------*/
+Asset::IODriver::IOHandle::~IOHandle (void)
+{
+    if(error) delete [] error;
+}
+
+/*----------------------------------------------------------------------------
+ * ioReadv
+ *
+ *  default vectored read for drivers that can only read one extent at a
+ *  time; drivers that can keep multiple reads in flight override this
+ *----------------------------------------------------------------------------*/
+int64_t Asset::IODriver::ioReadv (extent_t* extents, int num_extents)
+{
+    int64_t total_bytes = 0;
+    for(int i = 0; i < num_extents; i++)
+    {
+        extents[i].bytes = ioRead(extents[i].data, extents[i].size, extents[i].pos);
+        total_bytes += extents[i].bytes;
+    }
+    return total_bytes;
+}
+
+/*----------------------------------------------------------------------------
+ * ioSubmit
+ *
+ *  default submission for drivers that cannot leave reads in flight; the
+ *  read is performed synchronously through ioReadv and the returned handle
+ *  is already complete
+ *----------------------------------------------------------------------------*/
+Asset::IODriver::IOHandle* Asset::IODriver::ioSubmit (extent_t* extents, int num_extents)
+{
+    IOHandle* handle = new IOHandle(extents, num_extents);
+    try
+    {
+        handle->bytesRead = ioReadv(extents, num_extents);
+    }
+    catch(const RunTimeException& e)
+    {
+        handle->error = StringLib::duplicate(e.what());
+    }
+    return handle;
+}
+
+/*----------------------------------------------------------------------------
+ * ioWait
+ *
+ *  waits for a submitted read to complete and frees its handle; returns the
+ *  total number of bytes read, or throws if the read failed
+ *----------------------------------------------------------------------------*/
+int64_t Asset::IODriver::ioWait (IOHandle* handle)
+{
+    int64_t bytes_read = handle->bytesRead;
+    if(handle->error)
+    {
+        char error[MAX_STR_SIZE];
+        StringLib::copy(error, handle->error, MAX_STR_SIZE);
+        delete handle;
+        throw RunTimeException(CRITICAL, RTE_ERROR, "%s", error);
+    }
+    delete handle;
+    return bytes_read;
+}
+
+/*----------------------------------------------------------------------------
+ * ioTag
+ *
+ *  provides a tag (e.g. an ETag) that changes whenever the contents of the
+ *  resource change; returns false if the driver cannot provide one
+ *----------------------------------------------------------------------------*/
+bool Asset::IODriver::ioTag (char* tag, int size)
+{
+    (void)tag;
+    (void)size;
+    return false;
+}
@@ -67,10 +67,40 @@ class Asset: public LuaObject
         class IODriver
         {
             public:
+
+                /* A single read within a vectored request */
+                typedef struct {
+                    uint8_t*    data;   // caller supplied buffer
+                    int64_t     size;   // number of bytes requested
+                    uint64_t    pos;    // position in resource
+                    int64_t     bytes;  // number of bytes read, set on completion
+                } extent_t;
+
+                /*
+                 * A vectored read that was submitted to the driver; the
+                 * extents must remain valid until the read is waited on,
+                 * and every submitted read must be waited on (which frees it)
+                 */
+                class IOHandle
+                {
+                    public:
+                                        IOHandle    (extent_t* _extents, int _num_extents);
+                        virtual         ~IOHandle   (void);
+
+                        extent_t*       extents;
+                        int             numExtents;
+                        int64_t         bytesRead;  // total bytes read, set on completion
+                        char*           error;      // set when the read failed
+                };
+
                                 IODriver    (void) {};
                 virtual         ~IODriver   (void) {};
 
-                virtual int64_t ioRead      (uint8_t* data, int64_t size, uint64_t pos) = 0;
+                virtual int64_t     ioRead      (uint8_t* data, int64_t size, uint64_t pos) = 0;
+                virtual int64_t     ioReadv     (extent_t* extents, int num_extents);
+                virtual IOHandle*   ioSubmit    (extent_t* extents, int num_extents);
+                virtual int64_t     ioWait      (IOHandle* handle);
+                virtual bool        ioTag       (char* tag, int size);
         };
 
         /*--------------------------------------------------------------------
@@ -156,6 +186,7 @@ class Asset: public LuaObject
 
         static int      luaInfo     (lua_State* L);
         static int      luaLoad     (lua_State* L);
+        static int      luaRead     (lua_State* L);
 };
 
 #endif  /* __asset__ */
@@ -59,6 +59,31 @@ DispatchObject::DispatchObject (lua_State* L, const char* meta_name, const struc
 {
 }
 
+/*----------------------------------------------------------------------------
+ * processRecordBatch
+ *
+ *  called with consecutive records of the same type; dispatches that can
+ *  handle a run of records more efficiently than one at a time override it;
+ *  a record that throws does not keep the rest of the batch from processing
+ *----------------------------------------------------------------------------*/
+bool DispatchObject::processRecordBatch (RecordObject** records, okey_t* keys, int num_records)
+{
+    bool status = true;
+    for(int i = 0; i < num_records; i++)
+    {
+        try
+        {
+            status = processRecord(records[i], keys[i]) && status;
+        }
+        catch(RunTimeException& e)
+        {
+            (void)e;
+            status = false;
+        }
+    }
+    return status;
+}
+
 /*----------------------------------------------------------------------------
  * processTimeout
  *----------------------------------------------------------------------------*/
@@ -61,6 +61,7 @@ class DispatchObject: public LuaObject
         virtual         ~DispatchObject     (void) = 0;
 
         virtual bool    processRecord      (RecordObject* record, okey_t key) = 0;
+        virtual bool    processRecordBatch (RecordObject** records, okey_t* keys, int num_records);
         virtual bool    processTimeout     (void);
         virtual bool    processTermination (void);
 
@@ -37,6 +37,11 @@
 #include "OsApi.h"
 #include "Asset.h"
 
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <unistd.h>
+
 /******************************************************************************
  * STATIC DATA
  ******************************************************************************/
@@ -55,6 +60,78 @@ Asset::IODriver* FileIODriver::create (const Asset* _asset, const char* resource
     return new FileIODriver(_asset, resource);
 }
 
+/*----------------------------------------------------------------------------
+ * readv
+ *
+ *  reads a batch of extents from an open file descriptor using positional
+ *  reads, so the batch does not disturb (or depend on) the stream position;
+ *  extents that are contiguous in the file are read with a single preadv,
+ *  and a short read is continued from where it stopped so that extents
+ *  only come back short at the end of the file
+ *----------------------------------------------------------------------------*/
+int64_t FileIODriver::readv (int fd, extent_t* extents, int num_extents)
+{
+    int64_t total_bytes = 0;
+
+    int start = 0;
+    while(start < num_extents)
+    {
+        /* Gather Contiguous Extents */
+        struct iovec iov[IOV_MAX];
+        int64_t span = extents[start].size;
+        iov[0].iov_base = extents[start].data;
+        iov[0].iov_len = extents[start].size;
+        extents[start].bytes = 0;
+        int end = start + 1;
+        while( (end < num_extents) &&
+               ((end - start) < IOV_MAX) &&
+               (extents[end].pos == extents[start].pos + span) )
+        {
+            iov[end - start].iov_base = extents[end].data;
+            iov[end - start].iov_len = extents[end].size;
+            extents[end].bytes = 0;
+            span += extents[end].size;
+            end++;
+        }
+
+        /* Read Extents (retrying short reads until end of file) */
+        int first = 0;
+        uint64_t pos = extents[start].pos;
+        while(span > 0)
+        {
+            int64_t bytes = preadv(fd, &iov[first], end - start - first, pos);
+            if(bytes < 0)
+            {
+                if(errno == EINTR) continue;
+                throw RunTimeException(CRITICAL, RTE_ERROR, "failed to read %ld bytes at I/O position 0x%lx: %s", span, pos, LocalLib::err2str(errno));
+            }
+            else if(bytes == 0)
+            {
+                break; // end of file
+            }
+
+            /* Distribute Bytes Read and Advance Past Them */
+            total_bytes += bytes;
+            span -= bytes;
+            pos += bytes;
+            while(bytes > 0)
+            {
+                int64_t n = MIN(bytes, (int64_t)iov[first].iov_len);
+                extents[start + first].bytes += n;
+                iov[first].iov_base = (uint8_t*)iov[first].iov_base + n;
+                iov[first].iov_len -= n;
+                bytes -= n;
+                if(iov[first].iov_len == 0) first++;
+            }
+        }
+
+        /* Goto Next Set of Extents */
+        start = end;
+    }
+
+    return total_bytes;
+}
+
 /*----------------------------------------------------------------------------
  * ioRead
  *----------------------------------------------------------------------------*/
@@ -70,6 +147,27 @@ int64_t FileIODriver::ioRead (uint8_t* data, int64_t size, uint64_t pos)
     return fread(data, 1, size, ioFile);
 }
 
+/*----------------------------------------------------------------------------
+ * ioReadv
+ *----------------------------------------------------------------------------*/
+int64_t FileIODriver::ioReadv (extent_t* extents, int num_extents)
+{
+    return readv(fileno(ioFile), extents, num_extents);
+}
+
+/*----------------------------------------------------------------------------
+ * ioTag
+ *
+ *  built from the inode, size, and modification time of the file
+ *----------------------------------------------------------------------------*/
+bool FileIODriver::ioTag (char* tag, int size)
+{
+    struct stat st;
+    if(fstat(fileno(ioFile), &st) != 0) return false;
+    StringLib::format(tag, size, "%lx-%lx-%lx", (unsigned long)st.st_ino, (unsigned long)st.st_size, (unsigned long)st.st_mtime);
+    return true;
+}
+
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
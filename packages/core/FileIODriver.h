@@ -58,7 +58,10 @@ class FileIODriver: Asset::IODriver
          *--------------------------------------------------------------------*/
 
         static IODriver*    create  (const Asset* _asset, const char* resource);
+        static int64_t      readv   (int fd, extent_t* extents, int num_extents);
         int64_t             ioRead  (uint8_t* data, int64_t size, uint64_t pos);
+        int64_t             ioReadv (extent_t* extents, int num_extents) override;
+        bool                ioTag   (char* tag, int size) override;
 
     private:
 
@@ -94,6 +94,7 @@ HttpClient::HttpClient(lua_State* L, const char* _ip_addr, int _port):
     port = _port;
     sock = initializeSocket(ipAddr, port);
     requestPub = new Publisher(NULL);
+    requestSub = NULL;
     requestPid = NULL;
 }
 
@@ -143,6 +144,7 @@ HttpClient::HttpClient(lua_State* L, const char* url):
 
     // Create Request Queue and Thread
     requestPub = new Publisher(NULL);
+    requestSub = NULL;
     requestPid = NULL;
 }
 
@@ -153,6 +155,7 @@ HttpClient::~HttpClient(void)
 {
     active = false;
     if(requestPid) delete requestPid;
+    if(requestSub) delete requestSub;
     if(requestPub) delete requestPub;
     if(ipAddr) delete [] ipAddr;
     if(sock) delete sock;
@@ -179,6 +182,40 @@ HttpClient::rsps_t HttpClient::request (EndpointObject::verb_t verb, const char*
     }
 }
 
+/*----------------------------------------------------------------------------
+ * abort
+ *
+ *  stops a request in progress on another thread within one read timeout;
+ *  the client cannot be used for any further requests
+ *----------------------------------------------------------------------------*/
+void HttpClient::abort (void)
+{
+    active = false;
+}
+
+/*----------------------------------------------------------------------------
+ * isConnected
+ *
+ *  a kept alive connection that the server has since closed still holds a
+ *  valid socket, so the socket is also checked without blocking; an idle
+ *  connection has nothing to read, anything else (a shutdown, an error, or
+ *  stray bytes) means it can no longer carry a request and it is closed
+ *----------------------------------------------------------------------------*/
+bool HttpClient::isConnected (void)
+{
+    if(!sock || !sock->isConnected()) return false;
+
+    char c;
+    int status = sock->readBuffer(&c, 1, IO_CHECK);
+    if(status != TIMEOUT_RC)
+    {
+        sock->closeConnection();
+        return false;
+    }
+
+    return true;
+}
+
 /*----------------------------------------------------------------------------
  * getIpAddr
  *----------------------------------------------------------------------------*/
@@ -313,6 +350,7 @@ HttpClient::rsps_t HttpClient::parseResponse (Publisher* outq, int timeout)
     bool    chunk_header_complete   = false;
     bool    chunk_payload_complete  = false;
     bool    chunk_trailer_complete  = false;
+    bool    last_chunk              = false;
     bool    headers_complete        = false;
     bool    response_complete       = false;
 
@@ -328,7 +366,7 @@ HttpClient::rsps_t HttpClient::parseResponse (Publisher* outq, int timeout)
                 int line_term = 0;
                 bytes_read += rsps_buf_index;
                 rsps_buf_index = 0;
-                while(line_start < bytes_read)
+                while(line_start < bytes_read && !response_complete)
                 {
                     //////////////////////////
                     // Process Headers
@@ -408,6 +446,7 @@ HttpClient::rsps_t HttpClient::parseResponse (Publisher* outq, int timeout)
                             if(StringLib::str2long(chunk_length_str, &chunk_remaining, 16))
                             {
                                 rsps.size = chunk_remaining;
+                                last_chunk = (chunk_remaining == 0);
                                 chunk_header_complete = true;
                                 chunk_payload_complete = false;
                                 line_start = line_term;
@@ -506,6 +545,7 @@ HttpClient::rsps_t HttpClient::parseResponse (Publisher* outq, int timeout)
                                     throw RunTimeException(CRITICAL, RTE_ERROR, "failed to post response: %d", post_status);
                                 }
                             }
+                            if(post_status == MsgQ::STATE_TIMEOUT) delete [] rsps.response; // aborted before posted
 
                             /* Reset Response */
                             rsps.response = NULL;
@@ -529,6 +569,13 @@ HttpClient::rsps_t HttpClient::parseResponse (Publisher* outq, int timeout)
                             chunk_header_complete = false;
                             line_start += 2;
                             line_term = line_start;
+
+                            /* A Zero Length Chunk Ends the Response */
+                            if(last_chunk)
+                            {
+                                rsps.size = 0;
+                                response_complete = true;
+                            }
                         }
                         else if(line_term > 0) // chunk invalid
                         {
@@ -565,7 +612,18 @@ HttpClient::rsps_t HttpClient::parseResponse (Publisher* outq, int timeout)
     catch(const RunTimeException& e)
     {
         mlog(CRITICAL, "Failed to process response: %s", e.what());
-        rsps.code = EndpointObject::Internal_Server_Error;
+        if(rsps.code == EndpointObject::OK) rsps.code = EndpointObject::Internal_Server_Error; // keep error returned by server
+    }
+
+    /* Check for Aborted Response */
+    if(!response_complete && rsps.code == EndpointObject::OK)
+    {
+        if(chunk_encoding && rsps.response)
+        {
+            delete [] rsps.response; // partial chunk is never posted
+            rsps.response = NULL;
+        }
+        rsps.code = EndpointObject::Service_Unavailable;
     }
 
     /* Return Response */
@@ -700,7 +758,7 @@ const char* HttpClient::parseChunkHeaderLine (int start, int term)
 void* HttpClient::requestThread(void* parm)
 {
     HttpClient* client = (HttpClient*)parm;
-    Subscriber* request_sub = new Subscriber(*(client->requestPub));
+    Subscriber* request_sub = client->requestSub;
 
     while(client->active)
     {
@@ -785,13 +843,13 @@ int HttpClient::luaRequest (lua_State* L)
                 .outq = new Publisher(outq_name)
             };
 
-            /* Create Request Thread Upon First Request */
+            /* Create Request Thread Upon First Request
+             *  (subscribed here so the post below is not dropped
+             *   before the thread gets going) */
             if(!lua_obj->requestPid)
             {
+                lua_obj->requestSub = new Subscriber(*(lua_obj->requestPub));
                 lua_obj->requestPid = new Thread(requestThread, lua_obj);
-                // TODO: need signaling for when subscriber comes up...
-                // otherwise the post below will return error that there
-                // are no subscribers
             }
 
             /* Post Request */
@@ -820,10 +878,7 @@ int HttpClient::luaConnected (lua_State* L)
         HttpClient* lua_obj = (HttpClient*)getLuaSelf(L, 1);
 
         /* Determine Connection Status */
-        if(lua_obj->sock)
-        {
-            status = lua_obj->sock->isConnected();
-        }
+        status = lua_obj->isConnected();
     }
     catch(const RunTimeException& e)
     {
@@ -89,6 +89,8 @@ class HttpClient: public LuaObject
                         ~HttpClient     (void);
 
         rsps_t          request         (EndpointObject::verb_t verb, const char* resource, const char* data, bool keep_alive, Publisher* outq, int timeout=SYS_TIMEOUT);
+        void            abort           (void);
+        bool            isConnected     (void);
         const char*     getIpAddr       (void);
         int             getPort         (void);
 
@@ -122,6 +124,7 @@ class HttpClient: public LuaObject
         bool                            active;
         Thread*                         requestPid;
         Publisher*                      requestPub;
+        Subscriber*                     requestSub;
         TcpSocket*                      sock;
         char*                           ipAddr;
         int                             port;
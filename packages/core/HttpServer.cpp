@@ -60,7 +60,7 @@ std::atomic<uint64_t> HttpServer::requestId{0};
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * luaCreate - server(<ip_addr>, <port>, [<max connections>])
+ * luaCreate - server(<port>, [<ip_addr>], [<max connections>], [<reactors>])
  *----------------------------------------------------------------------------*/
 int HttpServer::luaCreate (lua_State* L)
 {
@@ -70,6 +70,7 @@ int HttpServer::luaCreate (lua_State* L)
         int         port            = (int)getLuaInteger(L, 1);
         const char* ip_addr         = getLuaString(L, 2, true, NULL);
         int         max_connections = (int)getLuaInteger(L, 3, true, DEFAULT_MAX_CONNECTIONS);
+        int         num_reactors    = (int)getLuaInteger(L, 4, true, DEFAULT_NUM_REACTORS);
 
         /* Get Server Parameter */
         if( ip_addr && (StringLib::match(ip_addr, "0.0.0.0") || StringLib::match(ip_addr, "*")) )
@@ -78,7 +79,7 @@ int HttpServer::luaCreate (lua_State* L)
         }
 
         /* Return File Device Object */
-        return createLuaObject(L, new HttpServer(L, ip_addr, port, max_connections));
+        return createLuaObject(L, new HttpServer(L, ip_addr, port, max_connections, num_reactors));
     }
     catch(const RunTimeException& e)
     {
@@ -90,18 +91,39 @@ int HttpServer::luaCreate (lua_State* L)
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-HttpServer::HttpServer(lua_State* L, const char* _ip_addr, int _port, int max_connections):
+HttpServer::HttpServer(lua_State* L, const char* _ip_addr, int _port, int max_connections, int num_reactors):
     LuaObject(L, OBJECT_TYPE, LuaMetaName, LuaMetaTable),
-    connections(max_connections)
+    numConnections(0)
 {
     ipAddr = StringLib::duplicate(_ip_addr);
     port = _port;
 
+    maxConnections = max_connections;
+    if(num_reactors < 1) numReactors = 1;
+    else if(num_reactors > MAX_NUM_REACTORS) numReactors = MAX_NUM_REACTORS;
+    else numReactors = num_reactors;
+
+    metricId = EventLib::INVALID_METRIC;
+
     active = true;
     listening = false;
-    listenerPid = new Thread(listenerThread, this);
 
-    metricId = EventLib::INVALID_METRIC;
+    /* Start Reactors - connections are sharded across reactors by socket */
+    reactors = new reactor_t [numReactors];
+    for(int r = 0; r < numReactors; r++)
+    {
+        reactor_t* reactor = &reactors[r];
+        reactor->server = this;
+        reactor->fd = SockLib::sockreactor();
+        reactor->handoffMut = new Mutex();
+        reactor->handoffs = new List<connection_t*>;
+        reactor->connections = new Table<connection_t*, int>(maxConnections);
+        reactor->closed = new List<connection_t*>;
+        reactor->pid = new Thread(reactorThread, reactor);
+    }
+
+    /* Start Listener */
+    listenerPid = new Thread(listenerThread, this);
 }
 
 /*----------------------------------------------------------------------------
@@ -112,6 +134,19 @@ HttpServer::~HttpServer(void)
     active = false;
     delete listenerPid;
 
+    /* Stop Reactors - each disconnects its connections on exit */
+    for(int r = 0; r < numReactors; r++)
+    {
+        reactor_t* reactor = &reactors[r];
+        delete reactor->pid;
+        if(reactor->fd >= 0) close(reactor->fd);
+        delete reactor->handoffMut;
+        delete reactor->handoffs;
+        delete reactor->connections;
+        delete reactor->closed;
+    }
+    delete [] reactors;
+
     if(ipAddr) delete [] ipAddr;
 
     EndpointObject* endpoint;
@@ -121,15 +156,6 @@ HttpServer::~HttpServer(void)
         endpoint->releaseLuaObject();
         key = routeTable.next(&endpoint);
     }
-
-    connection_t* connection = NULL;
-    int fd = connections.first(&connection);
-    while(fd != (int)INVALID_KEY)
-    {
-        deinitConnection(connection);
-        delete connection;
-        fd = connections.next(&connection);
-    }
 }
 
 /*----------------------------------------------------------------------------
@@ -169,15 +195,12 @@ void HttpServer::initConnection (connection_t* connection)
  *----------------------------------------------------------------------------*/
 void HttpServer::deinitConnection (connection_t* connection)
 {
-    /* Free Stream Buffer */
-    if(connection->rsps_state.stream_buf) delete [] connection->rsps_state.stream_buf;
-
     /* Free Message Queue */
-    if(connection->rsps_state.ref_status > 0)
+    for(int i = 0; i < connection->rsps_state.num_refs; i++)
     {
-        connection->rsps_state.rspq->dereference(connection->rsps_state.ref);
-        connection->rsps_state.ref_status = 0;
+        connection->rsps_state.rspq->dereference(connection->rsps_state.refs[i]);
     }
+    connection->rsps_state.num_refs = 0;
     delete connection->rsps_state.rspq;
 
     /* Free Id */
@@ -294,6 +317,9 @@ bool HttpServer::processHttpHeader (char* buf, EndpointObject::Request* request)
 
 /*----------------------------------------------------------------------------
  * listenerThread
+ *
+ *  accepts connections and hands each one to the reactor selected by its
+ *  socket; the reactors do all of the reading and writing
  *----------------------------------------------------------------------------*/
 void* HttpServer::listenerThread(void* parm)
 {
@@ -302,77 +328,289 @@ void* HttpServer::listenerThread(void* parm)
     while(s->active)
     {
         /* Start Http Server */
-        int status = SockLib::startserver(s->getIpAddr(), s->getPort(), DEFAULT_MAX_CONNECTIONS, pollHandler, activeHandler, &s->active, (void*)s, &(s->listening));
-        if(status < 0)
+        int listen_fd = SockLib::socklisten(s->ipAddr, s->port, LISTEN_BACKLOG);
+        int wait_fd = (listen_fd >= 0) ? SockLib::sockreactor() : INVALID_RC;
+        if(listen_fd >= 0 && wait_fd >= 0 && SockLib::sockwatch(wait_fd, listen_fd) == 0)
         {
-            mlog(CRITICAL, "Http server on %s:%d returned error: %d", s->getIpAddr(), s->getPort(), status);
+            s->listening = true;
+            while(s->active)
+            {
+                /* Accept All Pending Connections
+                 *  done on every pass so that connections left waiting
+                 *  while at the maximum are accepted as others close */
+                SockLib::sockevent_t event;
+                SockLib::sockwait(wait_fd, &event, 1, IDLE_POLL_TIMEOUT);
+                if(s->acceptConnections(listen_fd) < 0) break;
+            }
             s->listening = false;
+        }
+
+        if(wait_fd >= 0) close(wait_fd);
+        if(listen_fd >= 0) SockLib::sockclose(listen_fd);
+
+        /* Restart Http Server */
+        if(s->active)
+        {
+            mlog(CRITICAL, "Http server on %s:%d stopped listening", s->getIpAddr(), s->getPort());
+            mlog(INFO, "Attempting to restart http server: %s", s->getName());
+            LocalLib::sleep(5.0); // wait five seconds to prevent spin
+        }
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * reactorThread
+ *
+ *  sockets are watched edge triggered, so an event only marks the connection
+ *  readable or writable; every connection is then serviced until it has
+ *  nothing left to read, nothing left to write, or its socket is full
+ *----------------------------------------------------------------------------*/
+void* HttpServer::reactorThread(void* parm)
+{
+    reactor_t* reactor = (reactor_t*)parm;
+    HttpServer* s = reactor->server;
+
+    SockLib::sockevent_t events[SockLib::MAX_REACTOR_EVENTS];
+    int timeout = IDLE_POLL_TIMEOUT;
+
+    while(s->active)
+    {
+        /* Wait for Socket Activity */
+        int num_events = SockLib::sockwait(reactor->fd, events, SockLib::MAX_REACTOR_EVENTS, timeout);
+        if(num_events < 0)
+        {
+            mlog(CRITICAL, "Http server reactor failed, exiting");
+            break;
+        }
+
+        /* Take Ownership of New Connections
+         *  the listener hands off a connection and watches its socket
+         *  under the same lock, so any event for a socket is preceded
+         *  by its handoff */
+        reactor->handoffMut->lock();
+        {
+            for(int i = 0; i < reactor->handoffs->length(); i++)
+            {
+                connection_t* connection = reactor->handoffs->get(i);
+                reactor->connections->add(connection->fd, connection, false);
+            }
+            reactor->handoffs->clear();
+        }
+        reactor->handoffMut->unlock();
 
-            /* Restart Http Server */
-            if(s->active)
+        /* Mark Connections with Activity */
+        for(int i = 0; i < num_events; i++)
+        {
+            connection_t* connection = NULL;
+            if(!reactor->connections->find(events[i].fd, Table<connection_t*, int>::MATCH_EXACTLY, &connection)) continue;
+            if(events[i].flags & IO_READ_FLAG)          connection->readable = true;
+            if(events[i].flags & IO_WRITE_FLAG)         connection->writable = true;
+            if(events[i].flags & IO_DISCONNECT_FLAG)
+            {
+                connection->closing = true;
+                reactor->closed->add(connection);
+            }
+        }
+
+        /* Service Connections */
+        timeout = IDLE_POLL_TIMEOUT;
+        connection_t* connection = NULL;
+        int fd = reactor->connections->first(&connection);
+        while(fd != (int)INVALID_KEY)
+        {
+            if(connection->closing)
             {
-                mlog(INFO, "Attempting to restart http server: %s", s->getName());
-                LocalLib::sleep(5.0); // wait five seconds to prevent spin
+                /* Hung Up - skip */
             }
+            else if(!s->serviceConnection(connection))
+            {
+                connection->closing = true;
+                reactor->closed->add(connection);
+            }
+            else if(!connection->request && !connection->rsps_state.response_complete && connection->writable)
+            {
+                /* Waiting on Response Queue - check it again soon */
+                timeout = RESPONSE_POLL_TIMEOUT;
+            }
+            fd = reactor->connections->next(&connection);
+        }
+
+        /* Remove Closed Connections */
+        for(int i = 0; i < reactor->closed->length(); i++)
+        {
+            connection_t* closed = reactor->closed->get(i);
+            reactor->connections->remove(closed->fd);
+            s->onDisconnect(closed);
+        }
+        reactor->closed->clear();
+    }
+
+    /* Disconnect Existing Connections */
+    reactor->handoffMut->lock();
+    {
+        for(int i = 0; i < reactor->handoffs->length(); i++)
+        {
+            connection_t* connection = reactor->handoffs->get(i);
+            reactor->connections->add(connection->fd, connection, false);
         }
+        reactor->handoffs->clear();
     }
+    reactor->handoffMut->unlock();
+
+    connection_t* connection = NULL;
+    int fd = reactor->connections->first(&connection);
+    while(fd != (int)INVALID_KEY)
+    {
+        s->onDisconnect(connection);
+        fd = reactor->connections->next(&connection);
+    }
+    reactor->connections->clear();
 
     return NULL;
 }
 
 /*----------------------------------------------------------------------------
- * pollHandler
+ * acceptConnections
  *
- *  Notes: provides the events back to the poll function
+ *  returns number of connections accepted, or a negative value if the
+ *  listen socket failed; when out of descriptors or buffers the pending
+ *  connections are left in the backlog and retried after a short backoff
  *----------------------------------------------------------------------------*/
-int HttpServer::pollHandler(int fd, short* events, void* parm)
+int HttpServer::acceptConnections(int listen_fd)
 {
-    HttpServer* s = (HttpServer*)parm;
+    int accepted = 0;
 
-    /* Get Connection */
-    connection_t* connection = s->connections[fd];
-    rsps_state_t* state = &connection->rsps_state;
+    while(numConnections < maxConnections)
+    {
+        /* Accept Next Connection */
+        int fd = SockLib::sockaccept(listen_fd);
+        if(fd == WOULDBLOCK_RC)
+        {
+            break;
+        }
+        else if(fd == RES_ERR_RC)
+        {
+            LocalLib::sleep(ACCEPT_BACKOFF / 1000.0);
+            break;
+        }
+        else if(fd < 0)
+        {
+            return fd;
+        }
+
+        /* Hand Off Connection to Reactor */
+        if(onConnect(fd) < 0)
+        {
+            SockLib::sockclose(fd);
+        }
+        else
+        {
+            accepted++;
+        }
+    }
 
-    /* Set Read Polling Flag (if request is ready) */
-    if(connection->request) *events |= IO_READ_FLAG;
-    else *events &= ~IO_READ_FLAG;
+    return accepted;
+}
+
+/*----------------------------------------------------------------------------
+ * serviceConnection
+ *
+ *  returns false if the connection is to be closed
+ *----------------------------------------------------------------------------*/
+bool HttpServer::serviceConnection(connection_t* connection)
+{
+    /* Read Request */
+    while(connection->readable && connection->request)
+    {
+        if(onRead(connection) < 0) return false;
+    }
 
-    /* Set Write Polling Flag (if data to write) */
-    if(state->ref_status > 0) *events |= IO_WRITE_FLAG;
-    else *events &= ~IO_WRITE_FLAG;
+    /* Write Response */
+    if(connection->writable)
+    {
+        if(onWrite(connection) < 0) return false;
 
-    return 0;
+        /* Read Next Request on Kept Alive Connection */
+        while(connection->readable && connection->request)
+        {
+            if(onRead(connection) < 0) return false;
+        }
+    }
+
+    return true;
 }
 
 /*----------------------------------------------------------------------------
- * activeHandler
+ * gatherResponse
+ *
+ *  builds the vectors for as many queued messages as can be written
+ *  together; when streaming, each message after the http header is framed
+ *  as a chunk by vectors pointing at its chunk header and trailer so that
+ *  the message itself is written straight out of the queue
  *
- *  Notes: performed on activity returned from poll
+ *  returns false if there was nothing on the queue
  *----------------------------------------------------------------------------*/
-int HttpServer::activeHandler(int fd, int flags, void* parm)
+bool HttpServer::gatherResponse(connection_t* connection)
 {
-    HttpServer* s = (HttpServer*)parm;
+    static const char* CHUNK_TRAILER = "\r\n";
+    static const char* LAST_CHUNK = "0\r\n\r\n";
 
-    int rc = 0;
+    rsps_state_t* state = &connection->rsps_state;
+    bool streaming = (connection->response_type == EndpointObject::STREAMING);
+    int bytes_gathered = 0;
+
+    state->num_refs = 0;
+    state->num_vecs = 0;
+    state->vec_index = 0;
+
+    while(!state->response_complete && (state->num_refs < MAX_COALESCED_REFS) && (bytes_gathered < COALESCE_SIZE))
+    {
+        /* Get Next Message */
+        Subscriber::msgRef_t* ref = &state->refs[state->num_refs];
+        if(state->rspq->receiveRef(*ref, IO_CHECK) <= 0) break;
+        state->num_refs++;
+        bytes_gathered += ref->size;
 
-    if((flags & IO_READ_FLAG)       && (s->onRead(fd)       < 0))   rc = INVALID_RC;
-    if((flags & IO_WRITE_FLAG)      && (s->onWrite(fd)      < 0))   rc = INVALID_RC;
-    if((flags & IO_ALIVE_FLAG)      && (s->onAlive(fd)      < 0))   rc = INVALID_RC;
-    if((flags & IO_CONNECT_FLAG)    && (s->onConnect(fd)    < 0))   rc = INVALID_RC;
-    if((flags & IO_DISCONNECT_FLAG) && (s->onDisconnect(fd) < 0))   rc = INVALID_RC;
+        if(ref->size == 0)
+        {
+            /* A Message of Size Zero Completes the Response */
+            state->response_complete = true;
+            if(state->header_sent && streaming)
+            {
+                state->vecs[state->num_vecs++] = {LAST_CHUNK, 5};
+            }
+        }
+        else if(!state->header_sent || !streaming)
+        {
+            /* Write Message As Is */
+            state->vecs[state->num_vecs++] = {ref->data, ref->size};
+            state->header_sent = true;
+        }
+        else
+        {
+            /* Write Message As Chunk */
+            char* chunk_hdr = state->chunk_hdrs[state->num_refs - 1];
+            StringLib::format(chunk_hdr, CHUNK_HEADER_SIZE, "%X\r\n", ref->size);
+            state->vecs[state->num_vecs++] = {chunk_hdr, (int)StringLib::size(chunk_hdr, CHUNK_HEADER_SIZE)};
+            state->vecs[state->num_vecs++] = {ref->data, ref->size};
+            state->vecs[state->num_vecs++] = {CHUNK_TRAILER, 2};
+        }
+    }
 
-    return rc;
+    return state->num_refs > 0;
 }
 
 /*----------------------------------------------------------------------------
  * onRead
  *
- *  Notes: performed for every connection that is ready to have data read from it
+ *  Notes: performed for every connection that is ready to have data read from it,
+ *         until nothing is left to read
  *----------------------------------------------------------------------------*/
-int HttpServer::onRead(int fd)
+int HttpServer::onRead(connection_t* connection)
 {
     int status = 0;
-    connection_t* connection = connections[fd];
     rqst_state_t* state = &connection->rqst_state;
 
 
@@ -396,8 +634,13 @@ int HttpServer::onRead(int fd)
     }
 
     /* Socket Read */
-    int bytes = SockLib::sockrecv(fd, buf, buf_available - 1, IO_CHECK);
-    if(bytes > 0)
+    int bytes = SockLib::sockrecv(connection->fd, buf, buf_available - 1, IO_CHECK);
+    if(bytes == TIMEOUT_RC)
+    {
+        /* Nothing Left to Read - wait for next edge */
+        connection->readable = false;
+    }
+    else if(bytes > 0)
     {
         status = bytes;
 
@@ -505,175 +748,133 @@ int HttpServer::onRead(int fd)
 /*----------------------------------------------------------------------------
  * onWrite
  *
- *  Notes: performed for every request that is ready to have data written to it
+ *  Notes: performed for every connection that can be written to, until the
+ *         socket is full or there is nothing left on the response queue
  *----------------------------------------------------------------------------*/
-int HttpServer::onWrite(int fd)
+int HttpServer::onWrite(connection_t* connection)
 {
     int status = 0;
-    connection_t* connection = connections[fd];
     rsps_state_t* state = &connection->rsps_state;
-    bool ref_complete = false;
-
-    uint8_t* buffer;
-    int bytes_left;
 
-    /* If Something to Send */
-    if(state->ref_status > 0)
+    while(connection->writable)
     {
-        if(state->header_sent && connection->response_type == EndpointObject::STREAMING) /* Setup Streaming */
+        /* Gather Next Messages (if previous ones written) */
+        if(state->num_refs == 0)
         {
-            /* Allocate Streaming Buffer (if necessary) */
-            if(state->ref.size + STREAM_OVERHEAD_SIZE > state->stream_mem_size)
-            {
-                /* Delete Old Buffer */
-                if(state->stream_buf) delete [] state->stream_buf;
+            if(!gatherResponse(connection)) break;
+        }
 
-                /* Allocate New Buffer */
-                state->stream_mem_size = state->ref.size + STREAM_OVERHEAD_SIZE;
-                state->stream_buf = new uint8_t [state->stream_mem_size];
+        /* Write Data to Socket */
+        if(state->vec_index < state->num_vecs)
+        {
+            int bytes = SockLib::socksendv(connection->fd, &state->vecs[state->vec_index], state->num_vecs - state->vec_index);
+            if(bytes == TIMEOUT_RC)
+            {
+                /* Socket Full - wait for next edge */
+                connection->writable = false;
+                break;
             }
-
-            /* Build Stream Buffer */
-            if(state->stream_buf_size == 0)
+            else if(bytes < 0)
             {
-                /* Write Chunk Header - HTTP */
-                unsigned long chunk_size = state->ref.size > 0 ? state->ref.size : 0;
-                StringLib::format((char*)state->stream_buf, STREAM_OVERHEAD_SIZE, "%lX\r\n", chunk_size);
-                state->stream_buf_size = StringLib::size((const char*)state->stream_buf, state->stream_mem_size);
+                /* Failed to Write Ready Socket */
+                return INVALID_RC; // will close socket
+            }
 
-                if(state->ref.size > 0)
+            /* Update Status */
+            status += bytes;
+
+            /* Skip Past Written Vectors */
+            while(bytes > 0)
+            {
+                SockLib::sockvec_t* vec = &state->vecs[state->vec_index];
+                if(bytes >= vec->size)
                 {
-                    /* Write Message Data */
-                    LocalLib::copy(&state->stream_buf[state->stream_buf_size], state->ref.data, state->ref.size);
-                    state->stream_buf_size += state->ref.size;
+                    bytes -= vec->size;
+                    state->vec_index++;
+                }
+                else
+                {
+                    vec->data = (const uint8_t*)vec->data + bytes;
+                    vec->size -= bytes;
+                    bytes = 0;
                 }
-
-                /* Write Chunk Trailer - HTTP */
-                StringLib::format((char*)&state->stream_buf[state->stream_buf_size], STREAM_OVERHEAD_SIZE, "\r\n");
-                state->stream_buf_size += 2;
             }
-
-            /* Setup Write State */
-            buffer = &state->stream_buf[state->stream_buf_index];
-            bytes_left = state->stream_buf_size - state->stream_buf_index;
-        }
-        else /* Setup Normal */
-        {
-            /* Setup Write State */
-            buffer = ((uint8_t*)state->ref.data) + state->ref_index;
-            bytes_left = state->ref.size - state->ref_index;
         }
 
-        /* If Anything Left to Send */
-        if(bytes_left > 0)
+        /* Release Written Messages */
+        if(state->vec_index == state->num_vecs)
         {
-            /* Write Data to Socket */
-            int bytes = SockLib::socksend(fd, buffer, bytes_left, IO_CHECK);
-            if(bytes >= 0)
+            for(int i = 0; i < state->num_refs; i++)
             {
-                /* Update Status */
-                status += bytes;
+                state->rspq->dereference(state->refs[i]);
+            }
+            state->num_refs = 0;
+            state->num_vecs = 0;
+            state->vec_index = 0;
 
-                /* Update Write State */
-                if(state->header_sent && connection->response_type == EndpointObject::STREAMING)
+            /* Check if Done with Entire Response */
+            if(state->response_complete)
+            {
+                if(connection->keep_alive)
                 {
-                    /* Update Streaming Write State */
-                    state->stream_buf_index += bytes;
-                    if(state->stream_buf_index == state->stream_buf_size)
-                    {
-                        state->stream_buf_index = 0;
-                        state->stream_buf_size = 0;
-                        ref_complete = true;
-                    }
+                    deinitConnection(connection);
+                    initConnection(connection);
+                    break; // ready for next request
                 }
                 else
                 {
-                    /* Update Normal Write State
-                    *  note that this code will be executed once for the
-                    *  header of a streaming write as well */
-                    state->ref_index += bytes;
-                    if(state->ref_index == state->ref.size)
-                    {
-                        state->header_sent = true;
-                        ref_complete = true;
-                    }
+                    return INVALID_RC; // will close socket
                 }
             }
-            else
-            {
-                /* Failed to Write Ready Socket */
-                status = INVALID_RC; // will close socket
-            }
-        }
-
-        /* Check if Done with Entire Response
-         *  a valid reference of size zero indicates that
-         *  the response is complete */
-        if(state->ref.size == 0)
-        {
-            ref_complete = true; // logic is skipped above on terminating message
-            state->response_complete = true; // prevent further messages received
-            status = INVALID_RC; // will close socket
-        }
-
-        /* Reset State */
-        if(ref_complete)
-        {
-            state->rspq->dereference(state->ref);
-            state->ref_status = 0;
-            state->ref_index = 0;
-            state->ref.size = 0;
-        }
-
-        /* Check for Keep Alive */
-        if(state->response_complete && connection->keep_alive)
-        {
-            deinitConnection(connection);
-            initConnection(connection);
-            status = 0; // will keep socket open
         }
     }
 
     return status;
 }
 
-/*----------------------------------------------------------------------------
- * onAlive
- *
- *  Notes: Performed for every existing connection
- *----------------------------------------------------------------------------*/
-int HttpServer::onAlive(int fd)
-{
-    connection_t* connection = connections[fd];
-    rsps_state_t* state = &connection->rsps_state;
-
-    if(!state->response_complete && state->ref_status <= 0)
-    {
-        state->ref_status = state->rspq->receiveRef(state->ref, IO_CHECK);
-    }
-
-    return 0;
-}
-
 /*----------------------------------------------------------------------------
  * onConnect
  *
- *  Notes: performed on new connections when the connection is made
+ *  Notes: performed on new connections when the connection is made; the
+ *         connection is handed off to the reactor that owns its socket
  *----------------------------------------------------------------------------*/
 int HttpServer::onConnect(int fd)
 {
-    int status = 0;
-
     /* Create and Initialize New Request */
     connection_t* connection = new connection_t;
     initConnection(connection);
     LocalLib::set(&connection->rqst_state, 0, sizeof(rqst_state_t));
+    connection->fd = fd;
+    connection->readable = false;
+    connection->writable = false;
+    connection->closing = false;
+
+    /* Hand Off Connection and Watch Socket
+     *  both are done under the lock so that the reactor never
+     *  sees an event for a socket it has not been handed */
+    int status = 0;
+    reactor_t* reactor = &reactors[fd % numReactors];
+    reactor->handoffMut->lock();
+    {
+        reactor->handoffs->add(connection);
+        if(SockLib::sockwatch(reactor->fd, fd) < 0)
+        {
+            mlog(CRITICAL, "HTTP server at %s failed to register connection", connection->id);
+            reactor->handoffs->remove(reactor->handoffs->length() - 1);
+            status = INVALID_RC; // will close socket
+        }
+    }
+    reactor->handoffMut->unlock();
 
-    /* Register Connection */
-    if(!connections.add(fd, connection, false))
+    /* Count or Free Connection */
+    if(status == 0)
+    {
+        numConnections++;
+    }
+    else
     {
-        mlog(CRITICAL, "HTTP server at %s failed to register connection due to duplicate entry", connection->id);
-        status = INVALID_RC; // will disconnect and free connection
+        deinitConnection(connection);
+        delete connection;
     }
 
     return status;
@@ -682,14 +883,10 @@ int HttpServer::onConnect(int fd)
 /*----------------------------------------------------------------------------
  * onDisconnect
  *
- *  Notes: performed on disconnected connections
+ *  Notes: performed on disconnected connections by the reactor that owns them
  *----------------------------------------------------------------------------*/
-int HttpServer::onDisconnect(int fd)
+void HttpServer::onDisconnect(connection_t* connection)
 {
-    int status = 0;
-
-    connection_t* connection = connections[fd];
-
     /* Update Metrics */
     if(metricId != EventLib::INVALID_METRIC)
     {
@@ -697,20 +894,13 @@ int HttpServer::onDisconnect(int fd)
         EventLib::incrementMetric(metricId, duration);
     }
 
-    /* Remove Connection */
-    if(connections.remove(fd))
-    {
-        /* Free Connection */
-        deinitConnection(connection);
-        delete connection;
-    }
-    else
-    {
-        mlog(CRITICAL, "HTTP server at %s failed to release connection", connection->id);
-        status = INVALID_RC;
-    }
+    /* Close Socket */
+    SockLib::sockclose(connection->fd);
+    numConnections--;
 
-    return status;
+    /* Free Connection */
+    deinitConnection(connection);
+    delete connection;
 }
 
 /*----------------------------------------------------------------------------
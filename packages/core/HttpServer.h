@@ -39,6 +39,7 @@
 #include <atomic>
 
 #include "MsgQ.h"
+#include "List.h"
 #include "Table.h"
 #include "OsApi.h"
 #include "StringLib.h"
@@ -60,9 +61,16 @@ class HttpServer: public LuaObject
         static const int HEADER_BUF_LEN             = MAX_STR_SIZE;
         static const int REQUEST_ID_LEN             = 128;
         static const int CONNECTION_TIMEOUT         = 5; // seconds
-        static const int INITIAL_POLL_SIZE          = 16;
         static const int DEFAULT_MAX_CONNECTIONS    = 256;
-        static const int STREAM_OVERHEAD_SIZE       = 128; // chunk size, record size, and line breaks
+        static const int DEFAULT_NUM_REACTORS       = 4;
+        static const int MAX_NUM_REACTORS           = 64;
+        static const int LISTEN_BACKLOG             = 256;
+        static const int IDLE_POLL_TIMEOUT          = 100; // ms, nothing waiting on a response
+        static const int ACCEPT_BACKOFF             = 50; // ms, out of descriptors or buffers to accept with
+        static const int RESPONSE_POLL_TIMEOUT      = 10; // ms, a connection is waiting on its response queue
+        static const int MAX_COALESCED_REFS         = 64; // messages gathered into a single write
+        static const int COALESCE_SIZE              = 0x40000; // bytes gathered before a write is started
+        static const int CHUNK_HEADER_SIZE          = 16; // chunk size and line break
 
         static const char* DURATION_METRIC;
 
@@ -76,7 +84,7 @@ class HttpServer: public LuaObject
 
         static int          luaCreate       (lua_State* L);
 
-                            HttpServer      (lua_State* L, const char* _ip_addr, int _port, int max_connections);
+                            HttpServer      (lua_State* L, const char* _ip_addr, int _port, int max_connections, int num_reactors=DEFAULT_NUM_REACTORS);
                             ~HttpServer     (void);
 
         const char*         getIpAddr       (void);
@@ -99,18 +107,21 @@ class HttpServer: public LuaObject
         typedef struct {
             bool                        header_sent;
             bool                        response_complete;
-            Subscriber::msgRef_t        ref;
-            int                         ref_status;
-            int                         ref_index;
+            Subscriber::msgRef_t        refs[MAX_COALESCED_REFS];                   // messages being written
+            int                         num_refs;
+            SockLib::sockvec_t          vecs[MAX_COALESCED_REFS * 3];               // chunk header, message, chunk trailer
+            int                         num_vecs;
+            int                         vec_index;                                  // next vector to write
+            char                        chunk_hdrs[MAX_COALESCED_REFS][CHUNK_HEADER_SIZE];
             Subscriber*                 rspq;
-            uint8_t*                    stream_buf;
-            int                         stream_buf_index;
-            int                         stream_buf_size;
-            int                         stream_mem_size;
         } rsps_state_t;
 
         typedef struct {
             char*                       id;
+            int                         fd;
+            bool                        readable;   // edge seen, read until nothing left
+            bool                        writable;   // edge seen, write until socket is full
+            bool                        closing;    // on reactor's closed list
             rqst_state_t                rqst_state;
             rsps_state_t                rsps_state;
             double                      start_time;
@@ -119,6 +130,16 @@ class HttpServer: public LuaObject
             EndpointObject::Request*    request;
         } connection_t;
 
+        typedef struct {
+            HttpServer*                 server;
+            int                         fd;                 // event queue of the reactor
+            Thread*                     pid;
+            Mutex*                      handoffMut;
+            List<connection_t*>*        handoffs;           // accepted, not yet owned by reactor
+            Table<connection_t*, int>*  connections;        // owned by reactor, keyed by socket
+            List<connection_t*>*        closed;
+        } reactor_t;
+
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
@@ -128,7 +149,10 @@ class HttpServer: public LuaObject
         bool                            active;
         bool                            listening;
         Thread*                         listenerPid;
-        Table<connection_t*, int>       connections;
+        reactor_t*                      reactors;
+        int                             numReactors;
+        int                             maxConnections;
+        std::atomic<int>                numConnections;
 
         Dictionary<EndpointObject*>     routeTable;
 
@@ -147,13 +171,14 @@ class HttpServer: public LuaObject
         bool                processHttpHeader   (char* buf, EndpointObject::Request* request);
 
         static void*        listenerThread      (void* parm);
-        static int          pollHandler         (int fd, short* events, void* parm);
-        static int          activeHandler       (int fd, int flags, void* parm);
-        int                 onRead              (int fd);
-        int                 onWrite             (int fd);
-        int                 onAlive             (int fd);
+        static void*        reactorThread       (void* parm);
+        int                 acceptConnections   (int listen_fd);
+        bool                serviceConnection   (connection_t* connection);
+        bool                gatherResponse      (connection_t* connection);
+        int                 onRead              (connection_t* connection);
+        int                 onWrite             (connection_t* connection);
         int                 onConnect           (int fd);
-        int                 onDisconnect        (int fd);
+        void                onDisconnect        (connection_t* connection);
 
         static int          luaAttach           (lua_State* L);
         static int          luaMetric           (lua_State* L);
@@ -44,6 +44,7 @@ const char* LuaEndpoint::LuaMetaName = "LuaEndpoint";
 const struct luaL_Reg LuaEndpoint::LuaMetaTable[] = {
     {"metric",      luaMetric},
     {"auth",        luaAuth},
+    {"fanout",      luaFanout},
     {NULL,          NULL}
 };
 
@@ -117,7 +118,12 @@ bool LuaEndpoint::init (void)
 }
 
 /*----------------------------------------------------------------------------
- * luaCreate - endpoint([<normal memory threshold>], [<stream memory threshold>])
+ * luaCreate - endpoint([<normal memory threshold>], [<stream memory threshold>], [<log level>], [<max concurrent requests>])
+ *
+ *  requests beyond the maximum number of concurrent requests are queued until
+ *  a worker is free; endpoints registered with :fanout() are serviced by a
+ *  separate pool with the same maximum, so that requests waiting on the
+ *  requests they proxy never hold up the workers those requests need
  *----------------------------------------------------------------------------*/
 int LuaEndpoint::luaCreate (lua_State* L)
 {
@@ -127,9 +133,16 @@ int LuaEndpoint::luaCreate (lua_State* L)
         double normal_mem_thresh = getLuaFloat(L, 1, true, DEFAULT_NORMAL_REQUEST_MEMORY_THRESHOLD);
         double stream_mem_thresh = getLuaFloat(L, 2, true, DEFAULT_STREAM_REQUEST_MEMORY_THRESHOLD);
         event_level_t lvl = (event_level_t)getLuaInteger(L, 3, true, INFO);
+        long max_workers = getLuaInteger(L, 4, true, DEFAULT_MAX_WORKERS);
+
+        /* Check Parameters */
+        if(max_workers <= 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid maximum number of concurrent requests: %ld", max_workers);
+        }
 
         /* Create Lua Endpoint */
-        return createLuaObject(L, new LuaEndpoint(L, normal_mem_thresh, stream_mem_thresh, lvl));
+        return createLuaObject(L, new LuaEndpoint(L, normal_mem_thresh, stream_mem_thresh, lvl, (int)max_workers));
     }
     catch(const RunTimeException& e)
     {
@@ -175,14 +188,37 @@ void LuaEndpoint::generateExceptionStatus (int code, event_level_t level, Publis
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-LuaEndpoint::LuaEndpoint(lua_State* L, double normal_mem_thresh, double stream_mem_thresh, event_level_t lvl):
+LuaEndpoint::LuaEndpoint(lua_State* L, double normal_mem_thresh, double stream_mem_thresh, event_level_t lvl, int max_workers):
     EndpointObject(L, LuaMetaName, LuaMetaTable),
     metricIds(INITIAL_NUM_ENDPOINTS),
     normalRequestMemoryThreshold(normal_mem_thresh),
     streamRequestMemoryThreshold(stream_mem_thresh),
     logLevel(lvl),
-    authenticator(NULL)
+    authenticator(NULL),
+    requestSync(NUM_POOL_SIGNALS)
 {
+    active = true;
+
+    /* Initialize Pools */
+    requestPool.endpoint = this;
+    requestPool.signal = REQUEST_SIGNAL;
+    requestPool.maxWorkers = max_workers;
+    requestPool.idleWorkers = 0;
+
+    fanoutPool.endpoint = this;
+    fanoutPool.signal = FANOUT_SIGNAL;
+    fanoutPool.maxWorkers = max_workers;
+    fanoutPool.idleWorkers = 0;
+
+    /* Start Warm Workers */
+    requestSync.lock();
+    {
+        while(requestPool.workers.length() < MIN(NUM_WARM_WORKERS, requestPool.maxWorkers))
+        {
+            startWorker(&requestPool);
+        }
+    }
+    requestSync.unlock();
 }
 
 /*----------------------------------------------------------------------------
@@ -190,28 +226,119 @@ LuaEndpoint::LuaEndpoint(lua_State* L, double normal_mem_thresh, double stream_m
  *----------------------------------------------------------------------------*/
 LuaEndpoint::~LuaEndpoint(void)
 {
+    /* Stop Workers */
+    requestSync.lock();
+    {
+        active = false;
+        requestSync.signal(REQUEST_SIGNAL, Cond::NOTIFY_ALL);
+        requestSync.signal(FANOUT_SIGNAL, Cond::NOTIFY_ALL);
+    }
+    requestSync.unlock();
+
+    stopPool(&fanoutPool);
+    stopPool(&requestPool);
+}
+
+/*----------------------------------------------------------------------------
+ * workerThread
+ *
+ *  each worker owns a resident lua engine that is reused for every request
+ *  it services, so the cost of creating the lua state and compiling the
+ *  endpoint scripts is only paid once per worker
+ *----------------------------------------------------------------------------*/
+void* LuaEndpoint::workerThread (void* parm)
+{
+    pool_t* pool = (pool_t*)parm;
+    LuaEndpoint* lua_endpoint = pool->endpoint;
+
+    /* Create Engine */
+    LuaEngine* engine = new LuaEngine(lua_endpoint->getTraceId());
+
+    lua_endpoint->requestSync.lock();
+    while(lua_endpoint->active)
+    {
+        /* Wait for Request */
+        if(pool->requestQ.length() == 0)
+        {
+            lua_endpoint->requestSync.wait(pool->signal, SYS_TIMEOUT);
+            continue;
+        }
+
+        /* Take Request off of Queue */
+        Request* request = pool->requestQ[0];
+        pool->requestQ.remove(0);
+        pool->idleWorkers--;
+
+        /* Process Request without Holding the Queue */
+        lua_endpoint->requestSync.unlock();
+        {
+            lua_endpoint->processRequest(request, engine);
+        }
+        lua_endpoint->requestSync.lock();
+
+        pool->idleWorkers++;
+    }
+    lua_endpoint->requestSync.unlock();
+
+    /* Clean Up */
+    delete engine;
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * startWorker
+ *
+ *  Note: must be called with requestSync locked
+ *----------------------------------------------------------------------------*/
+void LuaEndpoint::startWorker (pool_t* pool)
+{
+    pool->idleWorkers++;
+    Thread* pid = new Thread(workerThread, pool);
+    pool->workers.add(pid);
 }
 
 /*----------------------------------------------------------------------------
- * requestThread
+ * stopPool
+ *
+ *  joins the workers of the pool and fails any requests still queued to it;
+ *  the workers must already have been told to stop
  *----------------------------------------------------------------------------*/
-void* LuaEndpoint::requestThread (void* parm)
+void LuaEndpoint::stopPool (pool_t* pool)
 {
-    EndpointObject::info_t* info = (EndpointObject::info_t*)parm;
-    EndpointObject::Request* request = info->request;
-    LuaEndpoint* lua_endpoint = (LuaEndpoint*)info->endpoint;
+    for(int i = 0; i < pool->workers.length(); i++)
+    {
+        delete pool->workers[i];
+    }
+
+    for(int i = 0; i < pool->requestQ.length(); i++)
+    {
+        Request* request = pool->requestQ[i];
+        Publisher rspq(request->id);
+        char header[MAX_HDR_SIZE];
+        int header_length = buildheader(header, Service_Unavailable);
+        rspq.postCopy(header, header_length);
+        rspq.postCopy("", 0);
+        delete request;
+    }
+}
 
+/*----------------------------------------------------------------------------
+ * processRequest
+ *----------------------------------------------------------------------------*/
+void LuaEndpoint::processRequest (Request* request, LuaEngine* engine)
+{
     /* Get Request Script */
     const char* script_pathname = LuaEngine::sanitize(request->resource);
 
     /* Start Trace */
-    uint32_t trace_id = start_trace(INFO, lua_endpoint->getTraceId(), "lua_endpoint", "{\"rqst_id\":\"%s\", \"verb\":\"%s\", \"resource\":\"%s\"}", request->id, verb2str(request->verb), request->resource);
+    uint32_t trace_id = start_trace(INFO, getTraceId(), "lua_endpoint", "{\"rqst_id\":\"%s\", \"verb\":\"%s\", \"resource\":\"%s\"}", request->id, verb2str(request->verb), request->resource);
 
     /* Log Request */
-    mlog(lua_endpoint->logLevel, "%s %s: %s", verb2str(request->verb), request->resource, request->body);
+    mlog(logLevel, "%s %s: %s", verb2str(request->verb), request->resource, request->body);
 
     /* Update Metrics */
-    int32_t metric_id = lua_endpoint->getMetricId(request->resource);
+    int32_t metric_id = getMetricId(request->resource);
     if(metric_id != EventLib::INVALID_METRIC)
     {
         increment_metric(DEBUG, metric_id);
@@ -222,7 +349,7 @@ void* LuaEndpoint::requestThread (void* parm)
 
     /* Check Authentication */
     bool authorized = false;
-    if(lua_endpoint->authenticator)
+    if(authenticator)
     {
         char* bearer_token = NULL;
 
@@ -235,7 +362,7 @@ void* LuaEndpoint::requestThread (void* parm)
         }
 
         /* Validate Bearer Token */
-        authorized = lua_endpoint->authenticator->isValid(bearer_token);
+        authorized = authenticator->isValid(bearer_token);
     }
     else // no authentication required
     {
@@ -247,8 +374,8 @@ void* LuaEndpoint::requestThread (void* parm)
     {
         switch(request->verb)
         {
-            case GET:   lua_endpoint->normalResponse(script_pathname, request, rspq, trace_id); break;
-            case POST:  lua_endpoint->streamResponse(script_pathname, request, rspq, trace_id); break;
+            case GET:   normalResponse(script_pathname, request, rspq, trace_id, engine); break;
+            case POST:  streamResponse(script_pathname, request, rspq, trace_id, engine); break;
             default:    break;
         }
     }
@@ -266,13 +393,9 @@ void* LuaEndpoint::requestThread (void* parm)
     delete rspq;
     delete [] script_pathname;
     delete request;
-    delete info;
 
     /* Stop Trace */
     stop_trace(INFO, trace_id);
-
-    /* Return */
-    return NULL;
 }
 
 /*----------------------------------------------------------------------------
@@ -280,35 +403,45 @@ void* LuaEndpoint::requestThread (void* parm)
  *----------------------------------------------------------------------------*/
 EndpointObject::rsptype_t LuaEndpoint::handleRequest (Request* request)
 {
-    EndpointObject::info_t* info = new EndpointObject::info_t;
-    info->endpoint = this;
-    info->request = request;
+    /* Determine Response Type (request is owned by worker once queued) */
+    rsptype_t rsptype = (request->verb == POST) ? STREAMING : NORMAL;
+
+    /* Select Pool (fanoutEndpoints is not modified once the endpoint is attached) */
+    pool_t* pool = fanoutEndpoints.find(request->resource) ? &fanoutPool : &requestPool;
 
-    /* Start Thread */
-    Thread pid(requestThread, info, false);
+    /* Queue Request */
+    requestSync.lock();
+    {
+        pool->requestQ.add(request);
+
+        /* Start Another Worker if All are Busy */
+        if(pool->requestQ.length() > pool->idleWorkers && pool->workers.length() < pool->maxWorkers)
+        {
+            startWorker(pool);
+        }
+
+        requestSync.signal(pool->signal, Cond::NOTIFY_ONE);
+    }
+    requestSync.unlock();
 
     /* Return Response Type */
-    if(request->verb == POST)   return STREAMING;
-    else                        return NORMAL;
+    return rsptype;
 }
 
 /*----------------------------------------------------------------------------
  * normalResponse
  *----------------------------------------------------------------------------*/
-void LuaEndpoint::normalResponse (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id)
+void LuaEndpoint::normalResponse (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id, LuaEngine* engine)
 {
     char header[MAX_HDR_SIZE];
     double mem;
 
-    LuaEngine* engine = NULL;
-
     /* Check Memory */
     if( (normalRequestMemoryThreshold >= 1.0) ||
         ((mem = LocalLib::memusage()) < normalRequestMemoryThreshold) )
     {
-        /* Launch Engine */
-        engine = new LuaEngine(scriptpath, (const char*)request->body, trace_id, NULL, true);
-        bool status = engine->executeEngine(MAX_RESPONSE_TIME_MS);
+        /* Run Script */
+        bool status = engine->runScript(scriptpath, (const char*)request->body, trace_id, MAX_RESPONSE_TIME_MS);
 
         /* Send Response */
         if(status)
@@ -340,21 +473,16 @@ void LuaEndpoint::normalResponse (const char* scriptpath, Request* request, Publ
         int header_length = buildheader(header, Service_Unavailable);
         rspq->postCopy(header, header_length);
     }
-
-    /* Clean Up */
-    if(engine) delete engine;
 }
 
 /*----------------------------------------------------------------------------
  * streamResponse
  *----------------------------------------------------------------------------*/
-void LuaEndpoint::streamResponse (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id)
+void LuaEndpoint::streamResponse (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id, LuaEngine* engine)
 {
     char header[MAX_HDR_SIZE];
     double mem;
 
-    LuaEngine* engine = NULL;
-
     /* Check Memory */
     if( (streamRequestMemoryThreshold >= 1.0) ||
         ((mem = LocalLib::memusage()) < streamRequestMemoryThreshold) )
@@ -363,17 +491,18 @@ void LuaEndpoint::streamResponse (const char* scriptpath, Request* request, Publ
         int header_length = buildheader(header, OK, "application/octet-stream", 0, "chunked", serverHead.getString());
         rspq->postCopy(header, header_length);
 
-        /* Create Engine */
-        engine = new LuaEngine(scriptpath, (const char*)request->body, trace_id, NULL, true);
-
         /* Supply Global Variables to Script */
         engine->setString(LUA_RESPONSE_QUEUE, rspq->getName());
         engine->setString(LUA_REQUEST_ID, request->id);
 
-        /* Execute Engine
-        *  The call to execute the script blocks on completion of the script. The lua state context
+        /* Run Script
+        *  The call to run the script blocks on completion of the script. The lua state context
         *  is locked and cannot be accessed until the script completes */
-        engine->executeEngine(IO_PEND);
+        engine->runScript(scriptpath, (const char*)request->body, trace_id);
+
+        /* Clear Global Variables */
+        engine->setString(LUA_RESPONSE_QUEUE, NULL);
+        engine->setString(LUA_REQUEST_ID, NULL);
     }
     else
     {
@@ -381,9 +510,6 @@ void LuaEndpoint::streamResponse (const char* scriptpath, Request* request, Publ
         int header_length = buildheader(header, Service_Unavailable);
         rspq->postCopy(header, header_length);
     }
-
-    /* Clean Up */
-    if(engine) delete engine;
 }
 
 /*----------------------------------------------------------------------------
@@ -490,3 +616,42 @@ int LuaEndpoint::luaAuth (lua_State* L)
     /* Return Status */
     return returnLuaStatus(L, status);
 }
+
+/*----------------------------------------------------------------------------
+ * luaFanout - :fanout(<endpoint name>)
+ *
+ *  marks the endpoint as one that proxies requests back to servers which
+ *  may include this one, so that it is serviced by the fan-out pool
+ *
+ * Note: NOT thread safe, must be called prior to attaching endpoint to server
+ *----------------------------------------------------------------------------*/
+int LuaEndpoint::luaFanout (lua_State* L)
+{
+    bool status = false;
+
+    try
+    {
+        /* Get Self */
+        LuaEndpoint* lua_obj = (LuaEndpoint*)getLuaSelf(L, 1);
+
+        /* Get Endpoint Name */
+        const char* endpoint_name = getLuaString(L, 2);
+
+        /* Add to Fan-Out Endpoints */
+        bool fanout = true;
+        if(!lua_obj->fanoutEndpoints.add(endpoint_name, fanout))
+        {
+            throw RunTimeException(ERROR, RTE_ERROR, "Could not register fan-out endpoint %s", endpoint_name);
+        }
+
+        /* Set return Status */
+        status = true;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error registering fan-out endpoint: %s", e.what());
+    }
+
+    /* Return Status */
+    return returnLuaStatus(L, status);
+}
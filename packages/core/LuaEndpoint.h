@@ -42,7 +42,9 @@
 #include "Dictionary.h"
 #include "MsgQ.h"
 #include "LuaObject.h"
+#include "LuaEngine.h"
 #include "RecordObject.h"
+#include "List.h"
 
 /******************************************************************************
  * PISTACHE SERVER CLASS
@@ -66,9 +68,11 @@ class LuaEndpoint: public EndpointObject
         static const double DEFAULT_STREAM_REQUEST_MEMORY_THRESHOLD;
 
         static const int MAX_SOURCED_RESPONSE_SIZE = 1048576; // 1M
-        static const int MAX_RESPONSE_TIME_MS = 5000;
+        static const int MAX_RESPONSE_TIME_MS = 5000; // checked between lua instructions, not inside C calls
         static const int INITIAL_NUM_ENDPOINTS = 32;
         static const int MAX_EXCEPTION_TEXT_SIZE = 256;
+        static const int DEFAULT_MAX_WORKERS = 128; // per pool
+        static const int NUM_WARM_WORKERS = 4;
         static const char* LUA_RESPONSE_QUEUE;
         static const char* LUA_REQUEST_ID;
         static const char* UNREGISTERED_ENDPOINT;
@@ -118,24 +122,50 @@ class LuaEndpoint: public EndpointObject
 
     protected:
 
+        /*--------------------------------------------------------------------
+         * Typedefs
+         *--------------------------------------------------------------------*/
+
+        /* Pool of Workers Servicing a Request Queue */
+        typedef struct {
+            LuaEndpoint*    endpoint;
+            int             signal;
+            List<Request*>  requestQ;
+            List<Thread*>   workers;
+            int             maxWorkers;
+            int             idleWorkers;
+        } pool_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
-                            LuaEndpoint     (lua_State* L, double normal_mem_thresh, double stream_mem_thresh, event_level_t lvl);
+                            LuaEndpoint     (lua_State* L, double normal_mem_thresh, double stream_mem_thresh, event_level_t lvl, int max_workers=DEFAULT_MAX_WORKERS);
         virtual             ~LuaEndpoint    (void);
 
-        static void*        requestThread   (void* parm);
+        static void*        workerThread    (void* parm);
+        void                startWorker     (pool_t* pool);
+        void                stopPool        (pool_t* pool);
+        void                processRequest  (Request* request, LuaEngine* engine);
 
         rsptype_t           handleRequest   (Request* request) override;
 
-        void                normalResponse  (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id);
-        void                streamResponse  (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id);
+        void                normalResponse  (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id, LuaEngine* engine);
+        void                streamResponse  (const char* scriptpath, Request* request, Publisher* rspq, uint32_t trace_id, LuaEngine* engine);
 
         int32_t             getMetricId     (const char* endpoint);
 
         static int          luaMetric       (lua_State* L);
         static int          luaAuth         (lua_State* L);
+        static int          luaFanout       (lua_State* L);
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int REQUEST_SIGNAL = 0;
+        static const int FANOUT_SIGNAL = 1;
+        static const int NUM_POOL_SIGNALS = 2;
 
         /*--------------------------------------------------------------------
          * Data
@@ -147,6 +177,12 @@ class LuaEndpoint: public EndpointObject
         double              streamRequestMemoryThreshold;
         event_level_t       logLevel;
         Authenticator*      authenticator;
+        Dictionary<bool>    fanoutEndpoints;
+
+        bool                active;
+        Cond                requestSync;
+        pool_t              requestPool;
+        pool_t              fanoutPool;
 };
 
 #endif  /* __lua_endpoint__ */
@@ -36,6 +36,8 @@
 #include "LuaEngine.h"
 #include "core.h"
 
+#include <sys/stat.h>
+
 /******************************************************************************
  * STATIC DATA
  ******************************************************************************/
@@ -43,6 +45,7 @@
 const char* LuaEngine::LUA_SELFKEY = "__this";
 const char* LuaEngine::LUA_TRACEID = "__traceid";
 const char* LuaEngine::LUA_CONFDIR = "__confdir";
+const char* LuaEngine::LUA_SCRIPTS = "__scripts";
 
 List<LuaEngine::libInitEntry_t> LuaEngine::libInitTable;
 Mutex LuaEngine::libInitTableMutex;
@@ -123,6 +126,32 @@ LuaEngine::LuaEngine(const char* script, const char* arg, uint32_t trace_id, lua
     }
 }
 
+/*----------------------------------------------------------------------------
+ * Constructor
+ *
+ *  RESIDENT_MODE - the state is kept between scripts which are run in the
+ *  calling thread via runScript; each script is compiled once and cached
+ *  until the file on disk changes
+ *----------------------------------------------------------------------------*/
+LuaEngine::LuaEngine(uint32_t trace_id)
+{
+    /* Initialize Parameters */
+    engineId        = engineIds++;
+    mode            = RESIDENT_MODE;
+    traceId         = start_trace(CRITICAL, trace_id, "lua_engine", "{\"resident\":true}");
+    pInfo           = NULL;
+    dInfo           = NULL;
+    engineActive    = false;
+    engineThread    = NULL;
+    deadline        = 0.0;
+    deadlineExpired = false;
+    L               = createState(NULL);
+
+    /* Create Script Cache */
+    lua_newtable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, LUA_SCRIPTS);
+}
+
 /*----------------------------------------------------------------------------
  * Destructor
  *----------------------------------------------------------------------------*/
@@ -254,6 +283,7 @@ LuaEngine::mode_t LuaEngine::str2mode(const char* str)
 {
     if(StringLib::match(str, "PROTECTED"))      return PROTECTED_MODE;
     if(StringLib::match(str, "DIRECT"))         return DIRECT_MODE;
+    if(StringLib::match(str, "RESIDENT"))       return RESIDENT_MODE;
 
     return INVALID_MODE;
 }
@@ -267,6 +297,7 @@ const char* LuaEngine::mode2str(mode_t _mode)
     {
         case PROTECTED_MODE:    return "PROTECTED";
         case DIRECT_MODE:       return "DIRECT";
+        case RESIDENT_MODE:     return "RESIDENT";
         default:                return "INVALID";
     }
 }
@@ -284,7 +315,7 @@ void LuaEngine::setAttrBool (lua_State* l, const char* name, bool val)
 /*----------------------------------------------------------------------------
  * setAttrInt
  *----------------------------------------------------------------------------*/
-void LuaEngine::setAttrInt (lua_State* l, const char* name, int val)
+void LuaEngine::setAttrInt (lua_State* l, const char* name, long val)
 {
     lua_pushstring(l, name);
     lua_pushinteger(l, val);
@@ -414,6 +445,95 @@ bool LuaEngine::executeEngine(int timeout_ms)
     return status;
 }
 
+/*----------------------------------------------------------------------------
+ * runScript
+ *
+ *  RESIDENT_MODE only; runs the script in the calling thread with its own
+ *  global environment that falls through to the shared globals, so that
+ *  nothing the script defines is visible to the next one.  Returns false
+ *  if the script did not complete within the timeout (when one is given).
+ *
+ *  The timeout is checked by a count hook, which only runs between lua
+ *  instructions; a script blocked inside a C function (waiting on a queue,
+ *  reading an h5 file, etc.) is not stopped until that function returns.
+ *----------------------------------------------------------------------------*/
+bool LuaEngine::runScript (const char* script, const char* arg, uint32_t trace_id, int timeout_ms)
+{
+    bool status = false;
+
+    if(mode != RESIDENT_MODE) return false;
+
+    engineSignal.lock();
+    {
+        /* Start Trace */
+        uint32_t run_trace_id = start_trace(CRITICAL, trace_id, "lua_engine", "{\"script\":\"%s\"}", script);
+
+        /* Clear Results of Last Script */
+        lua_settop(L, 0);
+
+        /* Set Trace ID */
+        lua_pushnumber(L, run_trace_id);
+        lua_setglobal(L, LUA_TRACEID);
+
+        /* Create Arg Table */
+        lua_createtable(L, 1, 0);
+        lua_pushstring(L, arg);
+        lua_rawseti(L, -2, 1);
+        lua_setglobal(L, "arg");
+
+        /* Execute Script */
+        if(loadScript(script))
+        {
+            /* Create Script Environment */
+            lua_newtable(L);
+            lua_newtable(L);
+            lua_pushglobaltable(L);
+            lua_setfield(L, -2, "__index");
+            lua_setmetatable(L, -2);
+            lua_setupvalue(L, -2, 1); // _ENV
+
+            /* Set Deadline */
+            deadlineExpired = false;
+            if(timeout_ms > 0)
+            {
+                deadline = TimeLib::latchtime() + (timeout_ms / 1000.0);
+                lua_sethook(L, deadlineHook, LUA_MASKCOUNT, DEADLINE_HOOK_COUNT);
+            }
+
+            /* Call Script */
+            engineActive = true;
+            if(lua_pcall(L, 0, LUA_MULTRET, 0) != LUA_OK)
+            {
+                logErrorMessage();
+            }
+            engineActive = false;
+            lua_sethook(L, NULL, 0, 0);
+            status = !deadlineExpired;
+
+            /* Detach Script Environment */
+            lua_getfield(L, LUA_REGISTRYINDEX, LUA_SCRIPTS);
+            lua_getfield(L, -1, script);
+            lua_rawgeti(L, -1, 1);
+            lua_pushglobaltable(L);
+            lua_setupvalue(L, -2, 1);
+            lua_pop(L, 3);
+        }
+
+        /* Clear Arguments */
+        lua_pushnil(L);
+        lua_setglobal(L, "arg");
+
+        /* Free Objects Created by Script */
+        lua_gc(L, LUA_GCCOLLECT, 0);
+
+        /* Stop Trace */
+        stop_trace(CRITICAL, run_trace_id);
+    }
+    engineSignal.unlock();
+
+    return status;
+}
+
 /*----------------------------------------------------------------------------
  * isActive
  *----------------------------------------------------------------------------*/
@@ -591,6 +711,25 @@ void* LuaEngine::directThread (void* parm)
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * deadlineHook
+ *----------------------------------------------------------------------------*/
+void LuaEngine::deadlineHook (lua_State* l, lua_Debug* ar)
+{
+    (void)ar;
+
+    lua_pushstring(l, LUA_SELFKEY);
+    lua_gettable(l, LUA_REGISTRYINDEX);
+    LuaEngine* engine = (LuaEngine*)lua_touserdata(l, -1);
+    lua_pop(l, 1);
+
+    if(engine && TimeLib::latchtime() > engine->deadline)
+    {
+        engine->deadlineExpired = true;
+        luaL_error(l, "script exceeded its time limit");
+    }
+}
+
 /*----------------------------------------------------------------------------
  * createState
  *----------------------------------------------------------------------------*/
@@ -656,6 +795,60 @@ lua_State* LuaEngine::createState(luaStepHook hook)
     return l;
 }
 
+/*----------------------------------------------------------------------------
+ * loadScript
+ *
+ *  pushes the compiled script onto the stack, compiling it only if it is not
+ *  in the script cache or has been modified since it was cached
+ *----------------------------------------------------------------------------*/
+bool LuaEngine::loadScript (const char* script)
+{
+    /* Get Modification Time */
+    struct stat st;
+    if(stat(script, &st) != 0)
+    {
+        mlog(CRITICAL, "Unable to open script %s: %s", script, LocalLib::err2str(errno));
+        return false;
+    }
+    lua_Integer mtime = (lua_Integer)st.st_mtime;
+
+    /* Check Script Cache */
+    lua_getfield(L, LUA_REGISTRYINDEX, LUA_SCRIPTS);
+    if(lua_getfield(L, -1, script) == LUA_TTABLE)
+    {
+        lua_rawgeti(L, -1, 2);
+        bool current = lua_tointeger(L, -1) == mtime;
+        lua_pop(L, 1);
+        if(current)
+        {
+            lua_rawgeti(L, -1, 1);
+            lua_replace(L, -3);
+            lua_pop(L, 1);
+            return true;
+        }
+    }
+    lua_pop(L, 1);
+
+    /* Compile Script */
+    if(luaL_loadfile(L, script) != LUA_OK)
+    {
+        lua_remove(L, -2);
+        logErrorMessage();
+        return false;
+    }
+
+    /* Cache Compiled Script */
+    lua_createtable(L, 2, 0);
+    lua_pushvalue(L, -2);
+    lua_rawseti(L, -2, 1);
+    lua_pushinteger(L, mtime);
+    lua_rawseti(L, -2, 2);
+    lua_setfield(L, -3, script);
+    lua_remove(L, -2);
+
+    return true;
+}
+
 /*----------------------------------------------------------------------------
  * logErrorMessage
  *----------------------------------------------------------------------------*/
@@ -74,6 +74,7 @@ class LuaEngine
         typedef enum {
             PROTECTED_MODE,
             DIRECT_MODE,
+            RESIDENT_MODE,
             INVALID_MODE
         } mode_t;
 
@@ -87,6 +88,7 @@ class LuaEngine
 
                             LuaEngine       (const char* name, int lua_argc, char lua_argv[][MAX_LUA_ARG], uint32_t trace_id=ORIGIN, luaStepHook hook=NULL, bool paused=false); // protected mode
                             LuaEngine       (const char* script, const char* arg, uint32_t trace_id=ORIGIN, luaStepHook hook=NULL, bool paused=false); // direct mode
+                            LuaEngine       (uint32_t trace_id); // resident mode
                             ~LuaEngine      (void);
 
         static void         init            (void);
@@ -97,7 +99,7 @@ class LuaEngine
         static mode_t       str2mode        (const char* str);
         static const char*  mode2str        (mode_t _mode);
         static void         setAttrBool     (lua_State* l, const char* name, bool val);
-        static void         setAttrInt      (lua_State* l, const char* name, int val);
+        static void         setAttrInt      (lua_State* l, const char* name, long val);
         static void         setAttrNum      (lua_State* l, const char* name, double val);
         static void         setAttrStr      (lua_State* l, const char* name, const char* val, int size=0);
         static void         setAttrFunc     (lua_State* l, const char* name, lua_CFunction val);
@@ -106,6 +108,7 @@ class LuaEngine
 
         uint64_t            getEngineId     (void);
         bool                executeEngine   (int timeout_ms);
+        bool                runScript       (const char* script, const char* arg, uint32_t trace_id, int timeout_ms=IO_PEND);
         bool                isActive        (void);
         void                setBoolean      (const char* name, bool val);
         void                setInteger      (const char* name, int val);
@@ -122,6 +125,8 @@ class LuaEngine
          *--------------------------------------------------------------------*/
 
         static const int ENGINE_EXIT_SIGNAL = 0;
+        static const int DEADLINE_HOOK_COUNT = 1000; // instructions between deadline checks
+        static const char* LUA_SCRIPTS;
 
         /*--------------------------------------------------------------------
          * Types
@@ -173,13 +178,18 @@ class LuaEngine
         protectedThread_t*              pInfo;
         directThread_t*                 dInfo;
 
+        double                          deadline;
+        bool                            deadlineExpired;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
         static void*    protectedThread     (void* parm);
         static void*    directThread        (void* parm);
+        static void     deadlineHook        (lua_State* l, lua_Debug* ar);
         lua_State*      createState         (luaStepHook hook);
+               bool     loadScript          (const char* script);
                void     logErrorMessage     (void);
 
         /* Interpreter */
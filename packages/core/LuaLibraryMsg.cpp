@@ -594,7 +594,18 @@ int LuaLibraryMsg::lmsg_recvrecord (lua_State* L)
                 }
                 else
                 {
-                    record = new RecordObject((unsigned char*)ref.data, ref.size);
+                    /* Wrap in place when posted as a shared buffer */
+                    SharedBuffer* buffer = msg_data->sub->retain(ref);
+                    try
+                    {
+                        record = new RecordObject(buffer);
+                    }
+                    catch (const RunTimeException& e)
+                    {
+                        buffer->release();
+                        throw;
+                    }
+                    buffer->release();
                 }
             }
             catch (const RunTimeException& e)
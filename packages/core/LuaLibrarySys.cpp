@@ -65,6 +65,7 @@ const struct luaL_Reg LuaLibrarySys::sysLibs [] = {
     {"lsrec",       LuaLibrarySys::lsys_lsrec},
     {"cwd",         LuaLibrarySys::lsys_cwd},
     {"memu",        LuaLibrarySys::lsys_memu},
+    {"nproc",       LuaLibrarySys::lsys_nproc},
     {"lsdev",       DeviceObject::luaList},
     {NULL,          NULL}
 };
@@ -540,3 +541,12 @@ int LuaLibrarySys::lsys_memu (lua_State* L)
     lua_pushnumber(L, m);
     return 1;
 }
+
+/*----------------------------------------------------------------------------
+ * lsys_nproc - number of processors
+ *----------------------------------------------------------------------------*/
+int LuaLibrarySys::lsys_nproc (lua_State* L)
+{
+    lua_pushinteger(L, LocalLib::nproc());
+    return 1;
+}
@@ -90,6 +90,7 @@ class LuaLibrarySys
         static int      lsys_lsrec          (lua_State* L);
         static int      lsys_cwd            (lua_State* L);
         static int      lsys_memu           (lua_State* L);
+        static int      lsys_nproc          (lua_State* L);
 
         /*--------------------------------------------------------------------
          * Data
@@ -427,3 +427,179 @@ double MathLib::getPolarPhase(double ReX, double ImX)
 	/* Phase Calculation */
 	return atan(ImX/ReX) + offset;
 }
+
+/******************************************************************************
+ * POLYGON INDEX PUBLIC METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * PolygonIndex Constructor
+ *
+ *  when the number of slabs is not supplied, one slab per vertex is used
+ *  (up to MAX_SLABS); the number is halved until the edges that span more
+ *  than one slab fit within MAX_EDGES_PER_VERTEX copies per vertex
+ *----------------------------------------------------------------------------*/
+PolygonIndex::PolygonIndex (const MathLib::point_t* poly, int len, int num_slabs)
+{
+    assert(poly);
+
+    /* Calculate Bounding Box */
+    minX = maxX = (len > 0) ? poly[0].x : 0.0;
+    minY = maxY = (len > 0) ? poly[0].y : 0.0;
+    for(int i = 1; i < len; i++)
+    {
+        if(poly[i].x < minX) minX = poly[i].x;
+        if(poly[i].x > maxX) maxX = poly[i].x;
+        if(poly[i].y < minY) minY = poly[i].y;
+        if(poly[i].y > maxY) maxY = poly[i].y;
+    }
+
+    /* Size Slabs */
+    numSlabs = (num_slabs > 0) ? num_slabs : MAX(1, len);
+    numSlabs = MIN(numSlabs, MAX_SLABS);
+    if(maxY <= minY) numSlabs = 1;
+    slabOffsets = NULL;
+    int num_edges = countEdges(poly, len, numSlabs);
+    while(num_slabs <= 0 && numSlabs > 1 && num_edges > (len * MAX_EDGES_PER_VERTEX))
+    {
+        numSlabs /= 2;
+        num_edges = countEdges(poly, len, numSlabs);
+    }
+
+    /* Populate Slabs */
+    slabEdges = new edge_t [MAX(num_edges, 1)];
+    int* next_edge = new int [numSlabs];
+    LocalLib::copy(next_edge, slabOffsets, numSlabs * sizeof(int));
+    for(int i = 0, j = len - 1; i < len; j = i++)
+    {
+        if(poly[i].y == poly[j].y) continue; // horizontal edges are never crossed
+        int s0 = slab(MIN(poly[i].y, poly[j].y));
+        int s1 = slab(MAX(poly[i].y, poly[j].y));
+        for(int s = s0; s <= s1; s++)
+        {
+            edge_t& edge = slabEdges[next_edge[s]++];
+            edge.p0 = poly[i];
+            edge.p1 = poly[j];
+        }
+    }
+    delete [] next_edge;
+}
+
+/*----------------------------------------------------------------------------
+ * PolygonIndex Destructor
+ *----------------------------------------------------------------------------*/
+PolygonIndex::~PolygonIndex (void)
+{
+    delete [] slabOffsets;
+    delete [] slabEdges;
+}
+
+/*----------------------------------------------------------------------------
+ * contains
+ *
+ *  the bounding box test is written so that NaN coordinates are rejected,
+ *  matching MathLib::inpoly which finds no crossings for them
+ *----------------------------------------------------------------------------*/
+bool PolygonIndex::contains (MathLib::point_t point) const
+{
+    /* Bounding Box Reject */
+    if(!(point.y >= minY && point.y < maxY && point.x >= minX && point.x <= maxX))
+    {
+        return false;
+    }
+
+    /* Count Crossings of Edges in Slab */
+    int c = 0;
+    int s = slab(point.y);
+    for(int e = slabOffsets[s]; e < slabOffsets[s + 1]; e++)
+    {
+        const MathLib::point_t& pi = slabEdges[e].p0;
+        const MathLib::point_t& pj = slabEdges[e].p1;
+        double x_extent = (pj.x - pi.x) * (point.y - pi.y) / (pj.y - pi.y) + pi.x;
+        if( ((pi.y > point.y) != (pj.y > point.y)) && (point.x < x_extent) ) c = !c;
+    }
+
+    /* Return Inclusion */
+    return c == 1;
+}
+
+/*----------------------------------------------------------------------------
+ * contains
+ *
+ *  sets the mask entry of each point to its inclusion and returns the number
+ *  of points inside the polygon
+ *----------------------------------------------------------------------------*/
+int PolygonIndex::contains (const MathLib::point_t* points, int num_points, bool* mask) const
+{
+    int num_inside = 0;
+    for(int i = 0; i < num_points; i++)
+    {
+        mask[i] = contains(points[i]);
+        num_inside += mask[i];
+    }
+    return num_inside;
+}
+
+/*----------------------------------------------------------------------------
+ * getNumSlabs
+ *----------------------------------------------------------------------------*/
+int PolygonIndex::getNumSlabs (void) const
+{
+    return numSlabs;
+}
+
+/******************************************************************************
+ * POLYGON INDEX PRIVATE METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * slab
+ *
+ *  non-decreasing in y, so an edge placed in every slab between those of its
+ *  two end points is found from any y the edge can be crossed at
+ *----------------------------------------------------------------------------*/
+int PolygonIndex::slab (double y) const
+{
+    int s = (int)((y - minY) / slabHeight);
+    if(s < 0) return 0;
+    if(s >= numSlabs) return numSlabs - 1;
+    return s;
+}
+
+/*----------------------------------------------------------------------------
+ * countEdges
+ *
+ *  sets the slab height and offsets for the number of slabs and returns the
+ *  total number of edges held across all slabs
+ *----------------------------------------------------------------------------*/
+int PolygonIndex::countEdges (const MathLib::point_t* poly, int len, int slabs)
+{
+    numSlabs = slabs;
+    slabHeight = (maxY > minY) ? (maxY - minY) / numSlabs : 1.0;
+
+    /* Count Edges Starting and Ending in Each Slab */
+    delete [] slabOffsets;
+    slabOffsets = new int [numSlabs + 1];
+    int* delta = new int [numSlabs + 1];
+    LocalLib::set(delta, 0, (numSlabs + 1) * sizeof(int));
+    for(int i = 0, j = len - 1; i < len; j = i++)
+    {
+        if(poly[i].y == poly[j].y) continue;
+        delta[slab(MIN(poly[i].y, poly[j].y))]++;
+        delta[slab(MAX(poly[i].y, poly[j].y)) + 1]--;
+    }
+
+    /* Accumulate Offsets */
+    int active_edges = 0;
+    int num_edges = 0;
+    for(int s = 0; s < numSlabs; s++)
+    {
+        active_edges += delta[s];
+        slabOffsets[s] = num_edges;
+        num_edges += active_edges;
+    }
+    slabOffsets[numSlabs] = num_edges;
+    delete [] delta;
+
+    return num_edges;
+}
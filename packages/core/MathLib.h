@@ -45,6 +45,7 @@ class MathLib
         static const int MAXFREQSPEC = 8192;
         static const int LOG2DATASIZE = 13;
         static const double EARTHRADIUS;
+        static const int NUM_PROJECTIONS = 3; // number of proj_t values
 
         /*--------------------------------------------------------------------
          * Types
@@ -97,4 +98,69 @@ class MathLib
         static double   getPolarPhase       (double ReX, double ImX);
 };
 
+/******************************************************************************
+ * POLYGON INDEX CLASS
+ *
+ *  a projected polygon prepared once for repeated inclusion tests; the
+ *  polygon's y extent is divided into horizontal slabs that each hold the
+ *  edges crossing them, so a point is only tested against the edges of its
+ *  own slab (after a bounding box reject) instead of every edge of the
+ *  polygon; the crossing test is the one used by MathLib::inpoly, so the
+ *  results are the same
+ ******************************************************************************/
+
+class PolygonIndex
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int MAX_SLABS = 4096;
+        static const int MAX_EDGES_PER_VERTEX = 16; // bounds memory used by edges spanning many slabs
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+                PolygonIndex    (const MathLib::point_t* poly, int len, int num_slabs=0);
+                ~PolygonIndex   (void);
+
+        bool    contains        (MathLib::point_t point) const;
+        int     contains        (const MathLib::point_t* points, int num_points, bool* mask) const;
+        int     getNumSlabs     (void) const;
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            MathLib::point_t    p0; // poly[i] in MathLib::inpoly
+            MathLib::point_t    p1; // poly[j] in MathLib::inpoly
+        } edge_t;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        double      minX;
+        double      maxX;
+        double      minY;
+        double      maxY;
+        double      slabHeight;
+        int         numSlabs;
+        int*        slabOffsets;    // first edge of each slab, numSlabs + 1 entries
+        edge_t*     slabEdges;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        int     slab            (double y) const;
+        int     countEdges      (const MathLib::point_t* poly, int len, int slabs);
+};
+
 #endif /* __math_lib__ */
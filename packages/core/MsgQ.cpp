@@ -39,6 +39,8 @@
 #include "StringLib.h"
 
 #include <cstdarg>
+#include <new>
+#include <thread>
 
 /******************************************************************************
  * STATIC DATA
@@ -55,7 +57,7 @@ Mutex MsgQ::listmut;
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-MsgQ::MsgQ(const char* name, MsgQ::free_func_t free_func, int depth, int data_size)
+MsgQ::MsgQ(const char* name, MsgQ::free_func_t free_func, int depth, int data_size, queue_type_t queue_type)
 {
     /* Create Queue */
     listmut.lock();
@@ -85,11 +87,40 @@ MsgQ::MsgQ(const char* name, MsgQ::free_func_t free_func, int depth, int data_si
             msgQ->subscriptions     = 0;
             msgQ->max_subscribers   = MSGQ_DEFAULT_SUBSCRIBERS;
             msgQ->free_blocks       = 0;
+            msgQ->slab_bytes        = 0;
+
+            // Initialize slab free lists
+            for(int c = 0; c < MSGQ_SLAB_CLASSES; c++) msgQ->slab_free[c] = NULL;
 
             // Set depth
             if(depth == CFG_DEPTH_STANDARD) msgQ->depth = StandardQueueDepth;
             else                            msgQ->depth = depth;
 
+            // Create ring
+            msgQ->ring = NULL;
+            if(queue_type == RING_QUEUE)
+            {
+                ring_queue_t* ring = new ring_queue_t;
+                ring->capacity = 1;
+                int min_capacity = (msgQ->depth == CFG_DEPTH_INFINITY) ? MSGQ_RING_DEFAULT_DEPTH : msgQ->depth;
+                while(ring->capacity < (uint64_t)min_capacity) ring->capacity <<= 1;
+                ring->slots = new queue_node_t* [ring->capacity];
+                ring->head.store(0);
+                ring->tail.store(0);
+                ring->subscriptions.store(0);
+                ring->recv_waiters.store(0);
+                ring->post_waiters.store(0);
+                ring->posting.clear();
+                for(int i = 0; i < MSGQ_RING_MAX_SUBSCRIBERS; i++)
+                {
+                    ring->cursors[i].read.store(0);
+                    ring->cursors[i].released.store(0);
+                    ring->cursors[i].active.store(false);
+                }
+                msgQ->depth = (int)ring->capacity;
+                msgQ->ring = ring;
+            }
+
             // Allocate free block stack
             msgQ->free_block_stack = new char* [MAX_FREE_STACK_SIZE];
 
@@ -142,6 +173,8 @@ MsgQ::~MsgQ()
             if(msgQ->name) queues.remove(msgQ->name);
 
             /* Free message queue resources */
+            freeRing(msgQ);
+            freeSlab(msgQ);
             delete msgQ->locknblock;
             if(msgQ->name) delete [] msgQ->name;
             delete [] msgQ->free_block_stack;
@@ -160,6 +193,7 @@ MsgQ::~MsgQ()
  *----------------------------------------------------------------------------*/
 int MsgQ::getCount(void)
 {
+    if(msgQ->ring) return (int)(msgQ->ring->head.load() - minReleased());
     return msgQ->len;
 }
 
@@ -184,6 +218,7 @@ const char* MsgQ::getName(void)
  *----------------------------------------------------------------------------*/
 int MsgQ::getSubCnt(void)
 {
+    if(msgQ->ring) return msgQ->ring->subscriptions.load();
     return msgQ->subscriptions;
 }
 
@@ -200,7 +235,11 @@ int MsgQ::getState(void)
  *----------------------------------------------------------------------------*/
 bool MsgQ::isFull(void)
 {
-    if(msgQ->depth == CFG_DEPTH_INFINITY)
+    if(msgQ->ring)
+    {
+        return (msgQ->ring->head.load() - msgQ->ring->tail.load()) >= msgQ->ring->capacity;
+    }
+    else if(msgQ->depth == CFG_DEPTH_INFINITY)
     {
         return false;
     }
@@ -214,6 +253,14 @@ bool MsgQ::isFull(void)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * isRing
+ *----------------------------------------------------------------------------*/
+bool MsgQ::isRing(void)
+{
+    return msgQ->ring != NULL;
+}
+
 /*----------------------------------------------------------------------------
  * init
  *
@@ -235,6 +282,8 @@ void MsgQ::deinit(void)
     const char* curr_name = queues.first(&curr_q);
     while(curr_name)
     {
+        freeRing(curr_q);
+        freeSlab(curr_q);
         delete [] curr_q->name;
         delete [] curr_q->free_block_stack;
         delete [] curr_q->subscriber_type;
@@ -272,8 +321,16 @@ int MsgQ::listQ(queueDisplay_t* list, int list_size)
     {
         if(j >= list_size) break;
         list[j].name = curr_q->name;
-        list[j].len = curr_q->len;
-        list[j].subscriptions = curr_q->subscriptions;
+        if(curr_q->ring)
+        {
+            list[j].len = (int)(curr_q->ring->head.load() - curr_q->ring->tail.load());
+            list[j].subscriptions = curr_q->ring->subscriptions.load();
+        }
+        else
+        {
+            list[j].len = curr_q->len;
+            list[j].subscriptions = curr_q->subscriptions;
+        }
         switch(curr_q->state)
         {
             case STATE_OKAY         : list[j].state = "OKAY";       break;
@@ -306,6 +363,188 @@ bool MsgQ::setStdQDepth(int depth)
     }
 }
 
+/******************************************************************************
+ * PROTECTED METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * allocNode
+ *
+ *  Notes
+ *  1. must be called with the queue locked
+ *  2. nodes are drawn from the queue's free list for the smallest size class
+ *     that holds the memory needed; nodes too big for any class are allocated
+ *     outright and deleted when reclaimed
+ *----------------------------------------------------------------------------*/
+MsgQ::queue_node_t* MsgQ::allocNode(int memory_needed)
+{
+    queue_node_t* node = NULL;
+
+    /* Determine Size Class */
+    int slab = 0;
+    int class_size = MSGQ_SLAB_MIN_SIZE;
+    while(class_size < memory_needed && slab < MSGQ_SLAB_CLASSES)
+    {
+        class_size <<= 1;
+        slab++;
+    }
+
+    /* Allocate Node */
+    if(slab >= MSGQ_SLAB_CLASSES)
+    {
+        node = (queue_node_t*) new char [memory_needed];
+        node->slab = -1;
+    }
+    else if(msgQ->slab_free[slab])
+    {
+        node = msgQ->slab_free[slab];
+        msgQ->slab_free[slab] = node->next;
+        msgQ->slab_bytes -= class_size;
+    }
+    else
+    {
+        node = (queue_node_t*) new char [class_size];
+        node->slab = slab;
+    }
+
+    return node;
+}
+
+/*----------------------------------------------------------------------------
+ * freeNode
+ *
+ *  Notes
+ *  1. must be called with the queue locked
+ *  2. nodes are kept for reuse until the queue holds MSGQ_SLAB_MAX_BYTES
+ *----------------------------------------------------------------------------*/
+void MsgQ::freeNode(queue_node_t* node)
+{
+    int class_size = (node->slab >= 0) ? (MSGQ_SLAB_MIN_SIZE << node->slab) : 0;
+    if(class_size > 0 && (msgQ->slab_bytes + class_size) <= MSGQ_SLAB_MAX_BYTES)
+    {
+        node->next = msgQ->slab_free[node->slab];
+        msgQ->slab_free[node->slab] = node;
+        msgQ->slab_bytes += class_size;
+    }
+    else
+    {
+        delete [] (char*)node;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * freeSlab
+ *----------------------------------------------------------------------------*/
+void MsgQ::freeSlab(message_queue_t* q)
+{
+    for(int c = 0; c < MSGQ_SLAB_CLASSES; c++)
+    {
+        queue_node_t* node = q->slab_free[c];
+        while(node)
+        {
+            queue_node_t* next = node->next;
+            delete [] (char*)node;
+            node = next;
+        }
+        q->slab_free[c] = NULL;
+    }
+    q->slab_bytes = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * freeRing
+ *
+ *  Notes
+ *  1. frees the nodes still held by the ring along with the ring itself;
+ *     called once the last publisher and subscriber have detached
+ *----------------------------------------------------------------------------*/
+void MsgQ::freeRing(message_queue_t* q)
+{
+    ring_queue_t* ring = q->ring;
+    if(!ring) return;
+
+    uint64_t head = ring->head.load();
+    for(uint64_t i = ring->tail.load(); i < head; i++)
+    {
+        queue_node_t* node = ring->slots[i & (ring->capacity - 1)];
+        if(node->buffer)                            node->buffer->release();
+        else if((node->mask & MSGQ_COPYQ_MASK) == 0 && q->free_func && !node->keep.load()) (*q->free_func)(node->data, NULL);
+        delete [] (char*)node;
+    }
+
+    delete [] ring->slots;
+    delete ring;
+    q->ring = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * reclaimRing
+ *
+ *  Notes
+ *  1. only called by the publisher, which is the only thread that touches
+ *     the slab of a ring queue
+ *  2. nodes are reclaimed once every subscriber has released them; the
+ *     ring's mutex keeps a subscriber that is joining from being missed
+ *----------------------------------------------------------------------------*/
+void MsgQ::reclaimRing(void)
+{
+    ring_queue_t* ring = msgQ->ring;
+
+    ring->mut.lock();
+    {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t released = minReleased();
+        while(tail < released)
+        {
+            queue_node_t* node = ring->slots[tail & (ring->capacity - 1)];
+            freeData(node, !node->keep.load(std::memory_order_relaxed));
+            tail++;
+        }
+        ring->tail.store(tail);
+    }
+    ring->mut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * freeData
+ *
+ *  Notes
+ *  1. releases what a node holds and returns the node to the slab
+ *----------------------------------------------------------------------------*/
+void MsgQ::freeData(queue_node_t* node, bool delete_data)
+{
+    if(node->buffer)
+    {
+        node->buffer->release();
+    }
+    else if((node->mask & MSGQ_COPYQ_MASK) == 0)
+    {
+        if(msgQ->free_func && delete_data)  (*msgQ->free_func)(node->data, NULL);
+        else                                assert(msgQ->free_func);
+    }
+    freeNode(node);
+}
+
+/*----------------------------------------------------------------------------
+ * minReleased
+ *
+ *  returns the index of the oldest message not yet released by a subscriber
+ *----------------------------------------------------------------------------*/
+uint64_t MsgQ::minReleased(void)
+{
+    ring_queue_t* ring = msgQ->ring;
+    uint64_t released = ring->head.load();
+    for(int i = 0; i < MSGQ_RING_MAX_SUBSCRIBERS; i++)
+    {
+        if(ring->cursors[i].active.load())
+        {
+            uint64_t cursor_released = ring->cursors[i].released.load();
+            if(cursor_released < released) released = cursor_released;
+        }
+    }
+    return released;
+}
+
 /******************************************************************************
  * PUBLISHER METHODS
  ******************************************************************************/
@@ -313,7 +552,7 @@ bool MsgQ::setStdQDepth(int depth)
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-Publisher::Publisher(const char* name, MsgQ::free_func_t free_func, int depth, int data_size): MsgQ(name, free_func, depth, data_size)
+Publisher::Publisher(const char* name, MsgQ::free_func_t free_func, int depth, int data_size, queue_type_t queue_type): MsgQ(name, free_func, depth, data_size, queue_type)
 {
 }
 
@@ -344,6 +583,28 @@ int Publisher::postRef(void* data, int size, int timeout)
     return post(data, ((unsigned int)size) & ~MSGQ_COPYQ_MASK, NULL, 0, timeout);
 }
 
+/*----------------------------------------------------------------------------
+ * postBuffer
+ *
+ *  Assumptions:
+ *  1. buffer != NULL
+ *
+ *  Notes:
+ *  1. the data is shared by every subscriber without being copied
+ *  2. the queue takes over the caller's reference to the buffer when the
+ *     post succeeds (or when there are no subscribers, in which case the
+ *     buffer is released); on any other failure the caller still owns it
+ *----------------------------------------------------------------------------*/
+int Publisher::postBuffer(SharedBuffer* buffer, int timeout)
+{
+    assert(buffer);
+
+    int size = buffer->getSize();
+    int status = post(buffer->getData(), ((unsigned int)size) & ~MSGQ_COPYQ_MASK, NULL, 0, timeout, buffer);
+    if(status == STATE_OKAY)    return size;
+    else                        return status;
+}
+
 /*----------------------------------------------------------------------------
  * postCopy
  *
@@ -426,12 +687,15 @@ void Publisher::defaultFree(void* obj, void* parm)
 /*----------------------------------------------------------------------------
  * post
  *----------------------------------------------------------------------------*/
-int Publisher::post(void* data, unsigned int mask, void* secondary_data, unsigned int secondary_size, int timeout)
+int Publisher::post(void* data, unsigned int mask, void* secondary_data, unsigned int secondary_size, int timeout, SharedBuffer* buffer)
 {
     int     post_state  = STATE_OKAY;
     bool    copy        = (mask & MSGQ_COPYQ_MASK) != 0;
     int     data_size   = mask & ~MSGQ_COPYQ_MASK;
 
+    /* ring queues do not take the lock */
+    if(msgQ->ring) return postRing(data, mask, secondary_data, secondary_size, timeout, buffer);
+
     /* post data */
     msgQ->locknblock->lock();
     {
@@ -480,7 +744,7 @@ int Publisher::post(void* data, unsigned int mask, void* secondary_data, unsigne
             }
 
             /* create temp node */
-            queue_node_t* temp = (queue_node_t*) new char [memory_needed];
+            queue_node_t* temp = allocNode(memory_needed);
 
             /* perform copy if queue is a copy queue */
             if(copy)
@@ -501,6 +765,7 @@ int Publisher::post(void* data, unsigned int mask, void* secondary_data, unsigne
             temp->mask = mask + secondary_size;
             temp->next = NULL; // for queue
             temp->refs = msgQ->subscriptions;
+            temp->buffer = buffer;
 
             /* place temp node into queue */
             if(msgQ->back == NULL)  msgQ->front = temp;
@@ -524,6 +789,14 @@ int Publisher::post(void* data, unsigned int mask, void* secondary_data, unsigne
             /* trigger ready */
             msgQ->locknblock->signal(READY2RECV);
         }
+        else if(post_state == STATE_NO_SUBSCRIBERS && buffer)
+        {
+            /* Shared buffers are handed to the queue the same as copies
+             * are, so a post with no one to receive it is not an error
+             * and the reference taken over from the poster is dropped */
+            buffer->release();
+            post_state = STATE_OKAY;
+        }
         else if(post_state == STATE_NO_SUBSCRIBERS && copy)
         {
             /* The STATE_NO_SUBSCRIBERS error is only raised when passing by
@@ -551,6 +824,176 @@ int Publisher::post(void* data, unsigned int mask, void* secondary_data, unsigne
     return post_state;
 }
 
+/*----------------------------------------------------------------------------
+ * postRing
+ *
+ *  Notes
+ *  1. lock-free unless the ring is full and the call is blocking, in which
+ *     case the publisher waits on the queue's condition until a subscriber
+ *     releases a message
+ *  2. only one publisher may post to a ring queue at a time; a concurrent
+ *     post waits for the one in progress like it would for room in the
+ *     ring, and returns STATE_FULL or STATE_TIMEOUT if it cannot
+ *----------------------------------------------------------------------------*/
+int Publisher::postRing(void* data, unsigned int mask, void* secondary_data, unsigned int secondary_size, int timeout, SharedBuffer* buffer)
+{
+    ring_queue_t*   ring        = msgQ->ring;
+    int             post_state  = STATE_OKAY;
+    bool            copy        = (mask & MSGQ_COPYQ_MASK) != 0;
+    int             data_size   = mask & ~MSGQ_COPYQ_MASK;
+
+    /* check ability to queue */
+    if(msgQ->max_data_size != CFG_SIZE_INFINITY &&
+       (data_size + secondary_size) > (unsigned int)msgQ->max_data_size)
+    {
+        return STATE_SIZE_ERROR;
+    }
+
+    /* wait for a concurrent post to finish */
+    if(ring->posting.test_and_set())
+    {
+        if(timeout == IO_CHECK) return STATE_FULL;
+
+        bool posting = true;
+        for(int spin = 0; spin < MSGQ_RING_SPIN && posting; spin++)
+        {
+            std::this_thread::yield();
+            posting = ring->posting.test_and_set();
+        }
+
+        if(posting)
+        {
+            msgQ->locknblock->lock();
+            {
+                ring->post_waiters++;
+                while(ring->posting.test_and_set())
+                {
+                    if(!msgQ->locknblock->wait(READY2POST, timeout))
+                    {
+                        post_state = MsgQ::STATE_TIMEOUT;
+                        break;
+                    }
+                }
+                ring->post_waiters--;
+            }
+            msgQ->locknblock->unlock();
+        }
+
+        if(post_state != STATE_OKAY) return post_state;
+    }
+
+    if(ring->subscriptions.load() <= 0)
+    {
+        /* don't post messages to a queue with no subscribers */
+        post_state = STATE_NO_SUBSCRIBERS;
+    }
+    else if(isFull())
+    {
+        /* reclaim what subscribers have released */
+        reclaimRing();
+
+        /* spin briefly before blocking */
+        if(timeout != IO_CHECK)
+        {
+            for(int spin = 0; spin < MSGQ_RING_SPIN && isFull(); spin++)
+            {
+                std::this_thread::yield();
+                reclaimRing();
+            }
+        }
+
+        /* wait for room in ring */
+        if(isFull())
+        {
+            if(timeout == IO_CHECK)
+            {
+                post_state = STATE_FULL;
+            }
+            else
+            {
+                msgQ->locknblock->lock();
+                {
+                    ring->post_waiters++;
+                    reclaimRing();
+                    while(isFull())
+                    {
+                        if(!msgQ->locknblock->wait(READY2POST, timeout))
+                        {
+                            post_state = MsgQ::STATE_TIMEOUT;
+                            break;
+                        }
+                        reclaimRing();
+                    }
+                    ring->post_waiters--;
+                }
+                msgQ->locknblock->unlock();
+            }
+        }
+    }
+
+    /* if state is okay proceed with enqueue */
+    if(post_state == STATE_OKAY)
+    {
+        /* create node */
+        int memory_needed = sizeof(queue_node_t) + (copy ? (data_size + (secondary_data ? secondary_size : 0)) : 0);
+        queue_node_t* node = allocNode(memory_needed);
+        if(copy)
+        {
+            node->data = ((char*)node) + sizeof(queue_node_t);
+            LocalLib::copy(node->data, data, data_size);
+            if(secondary_data)
+            {
+                LocalLib::copy(node->data + data_size, secondary_data, secondary_size);
+            }
+        }
+        else
+        {
+            node->data = (char*)data;
+        }
+        node->mask = mask + secondary_size;
+        node->next = NULL;
+        node->refs = 0;
+        node->buffer = buffer;
+        node->keep.store(false, std::memory_order_relaxed);
+
+        /* publish node */
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        ring->slots[head & (ring->capacity - 1)] = node;
+        ring->head.store(head + 1);
+
+        /* wake blocked subscribers */
+        if(ring->recv_waiters.load() > 0)
+        {
+            msgQ->locknblock->lock();
+            msgQ->locknblock->signal(READY2RECV);
+            msgQ->locknblock->unlock();
+        }
+    }
+    else if(post_state == STATE_NO_SUBSCRIBERS && buffer)
+    {
+        buffer->release();
+        post_state = STATE_OKAY;
+    }
+    else if(post_state == STATE_NO_SUBSCRIBERS && copy)
+    {
+        post_state = STATE_OKAY;
+    }
+
+    /* set queue state */
+    msgQ->state = post_state;
+    ring->posting.clear();
+
+    /* wake publishers waiting on this post */
+    if(ring->post_waiters.load() > 0)
+    {
+        msgQ->locknblock->lock();
+        msgQ->locknblock->signal(READY2POST);
+        msgQ->locknblock->unlock();
+    }
+
+    return post_state;
+}
+
 /******************************************************************************
  * SUBSCRIBER METHODS
  ******************************************************************************/
@@ -558,9 +1001,10 @@ int Publisher::post(void* data, unsigned int mask, void* secondary_data, unsigne
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-Subscriber::Subscriber(const char* name, subscriber_type_t type, int depth, int data_size): MsgQ(name, NULL, depth, data_size)
+Subscriber::Subscriber(const char* name, subscriber_type_t type, int depth, int data_size, queue_type_t queue_type): MsgQ(name, NULL, depth, data_size, queue_type)
 {
-    init_subscriber(type);
+    if(msgQ->ring)  init_ring(type);
+    else            init_subscriber(type);
 }
 
 /*----------------------------------------------------------------------------
@@ -568,7 +1012,8 @@ Subscriber::Subscriber(const char* name, subscriber_type_t type, int depth, int
  *----------------------------------------------------------------------------*/
 Subscriber::Subscriber(const MsgQ& existing_q, subscriber_type_t type): MsgQ(existing_q, NULL)
 {
-    init_subscriber(type);
+    if(msgQ->ring)  init_ring(type);
+    else            init_subscriber(type);
 }
 
 /*----------------------------------------------------------------------------
@@ -578,6 +1023,24 @@ Subscriber::~Subscriber()
 {
     bool space_reclaimed = false;
 
+    /* Detach from Ring */
+    if(msgQ->ring)
+    {
+        ring_queue_t* ring = msgQ->ring;
+        ring->mut.lock();
+        {
+            ring->cursors[id].active.store(false);
+            ring->subscriptions--;
+        }
+        ring->mut.unlock();
+
+        /* Messages this subscriber held up can now be reclaimed */
+        msgQ->locknblock->lock();
+        msgQ->locknblock->signal(READY2POST);
+        msgQ->locknblock->unlock();
+        return;
+    }
+
     msgQ->locknblock->lock();
     {
         /* Dereference All Nodes */
@@ -597,12 +1060,9 @@ Subscriber::~Subscriber()
                 for(int i = msgQ->free_blocks - 1; i >= 0; i--)
                 {
                     queue_node_t* temp = (queue_node_t*)msgQ->free_block_stack[i];
-                    if((temp->mask & MSGQ_COPYQ_MASK) == 0)
-                    {
-                        if(msgQ->free_func) (*msgQ->free_func)(temp->data, NULL);
-                        else                assert(msgQ->free_func);
-                    }
-                    delete [] msgQ->free_block_stack[i];
+                    if(msgQ->free_func) (*msgQ->free_func)(temp->data, NULL);
+                    else                assert(msgQ->free_func);
+                    freeNode(temp);
                 }
                 msgQ->free_blocks = 0;
             }
@@ -632,6 +1092,21 @@ bool Subscriber::dereference(msgRef_t& ref, bool with_delete)
 
     queue_node_t* node = (queue_node_t*)ref._handle;
 
+    /* messages on a ring are released in the order they were received */
+    if(msgQ->ring)
+    {
+        ring_queue_t* ring = msgQ->ring;
+        ring_cursor_t* cursor = &ring->cursors[id];
+        uint64_t released = cursor->released.load(std::memory_order_relaxed);
+        if(released >= cursor->read.load(std::memory_order_relaxed) || ring->slots[released & (ring->capacity - 1)] != node)
+        {
+            /* not the oldest message this subscriber holds */
+            return false;
+        }
+        releaseRing(1, with_delete);
+        return true;
+    }
+
     msgQ->locknblock->lock();
     {
         node->refs--;
@@ -652,6 +1127,16 @@ bool Subscriber::dereference(msgRef_t& ref, bool with_delete)
  *----------------------------------------------------------------------------*/
 void Subscriber::drain(bool with_delete)
 {
+    if(msgQ->ring)
+    {
+        ring_cursor_t* cursor = &msgQ->ring->cursors[id];
+        uint64_t read = cursor->read.load(std::memory_order_relaxed);
+        uint64_t head = msgQ->ring->head.load();
+        cursor->read.store(head, std::memory_order_relaxed);
+        releaseRing(head - read, with_delete);
+        return;
+    }
+
     msgQ->locknblock->lock();
     {
         /* Dereference All Nodes */
@@ -677,7 +1162,8 @@ void Subscriber::drain(bool with_delete)
  *----------------------------------------------------------------------------*/
 bool Subscriber::isEmpty(void)
 {
-    if(msgQ->curr_nodes[id] == NULL)    return true;
+    if(msgQ->ring)                      return msgQ->ring->cursors[id].read.load(std::memory_order_relaxed) >= msgQ->ring->head.load();
+    else if(msgQ->curr_nodes[id] == NULL) return true;
     else                                return false;
 }
 
@@ -696,6 +1182,27 @@ void* Subscriber::getData(void* _handle, int* size)
     return (void*)node->data;
 }
 
+/*----------------------------------------------------------------------------
+ * retain
+ *
+ *  Notes
+ *  1. must be called prior to call to dereference
+ *  2. returns a reference to the shared buffer the message was posted in,
+ *     or a new shared buffer holding a copy of the message if it was posted
+ *     by copy or by reference; either way the caller must release it
+ *----------------------------------------------------------------------------*/
+SharedBuffer* Subscriber::retain(msgRef_t& ref)
+{
+    assert(ref._handle);
+    queue_node_t* node = (queue_node_t*)ref._handle;
+    if(node->buffer) return node->buffer->retain();
+
+    int size = node->mask & ~MSGQ_COPYQ_MASK;
+    SharedBuffer* buffer = SharedBuffer::create(size);
+    LocalLib::copy(buffer->getData(), node->data, size);
+    return buffer;
+}
+
 /*----------------------------------------------------------------------------
  * receiveRef
  *
@@ -738,6 +1245,9 @@ int Subscriber::receive(msgRef_t& ref, int size, int timeout, bool copy)
 {
     bool space_reclaimed = false;
 
+    /* ring queues do not take the lock */
+    if(msgQ->ring) return receiveRing(ref, size, timeout, copy);
+
     /* initialize reference structure */
     ref.state = STATE_OKAY;
     ref.size = size;
@@ -812,6 +1322,114 @@ int Subscriber::receive(msgRef_t& ref, int size, int timeout, bool copy)
     return ref.state;
 }
 
+/*----------------------------------------------------------------------------
+ * receiveRing
+ *
+ *  Notes
+ *  1. lock-free unless the ring is empty and the call is blocking, in which
+ *     case the subscriber waits on the queue's condition until a message
+ *     is posted
+ *----------------------------------------------------------------------------*/
+int Subscriber::receiveRing(msgRef_t& ref, int size, int timeout, bool copy)
+{
+    ring_queue_t* ring = msgQ->ring;
+    ring_cursor_t* cursor = &ring->cursors[id];
+    uint64_t read = cursor->read.load(std::memory_order_relaxed);
+
+    /* initialize reference structure */
+    ref.state = STATE_OKAY;
+    ref.size = size;
+    ref._handle = 0;
+
+    /* spin briefly before blocking */
+    if(timeout != IO_CHECK)
+    {
+        for(int spin = 0; spin < MSGQ_RING_SPIN && read >= ring->head.load(); spin++)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /* wait for message to be posted */
+    if(read >= ring->head.load())
+    {
+        if(timeout == IO_CHECK)
+        {
+            ref.state = STATE_EMPTY;
+        }
+        else
+        {
+            msgQ->locknblock->lock();
+            {
+                ring->recv_waiters++;
+                while(read >= ring->head.load())
+                {
+                    if(!msgQ->locknblock->wait(READY2RECV, timeout))
+                    {
+                        ref.state = MsgQ::STATE_TIMEOUT;
+                        break;
+                    }
+                }
+                ring->recv_waiters--;
+            }
+            msgQ->locknblock->unlock();
+        }
+    }
+
+    /* dequeue data */
+    if(ref.state == STATE_OKAY)
+    {
+        queue_node_t* node = ring->slots[read & (ring->capacity - 1)];
+        int node_size = node->mask & ~MSGQ_COPYQ_MASK;
+        cursor->read.store(read + 1, std::memory_order_relaxed);
+
+        if(copy == false)
+        {
+            ref.data = node->data;
+            ref.size = node_size;
+            ref._handle = (void*)node;
+        }
+        else
+        {
+            if(node_size <= size)   LocalLib::copy(ref.data, node->data, node_size);
+            else                    ref.state = STATE_SIZE_ERROR;
+            ref.size = node_size;
+            releaseRing(1);
+        }
+    }
+
+    return ref.state;
+}
+
+/*----------------------------------------------------------------------------
+ * releaseRing
+ *----------------------------------------------------------------------------*/
+void Subscriber::releaseRing(uint64_t count, bool with_delete)
+{
+    ring_queue_t* ring = msgQ->ring;
+    ring_cursor_t* cursor = &ring->cursors[id];
+    uint64_t released = cursor->released.load(std::memory_order_relaxed);
+
+    /* leave the data to the subscriber when any subscriber asks to keep it */
+    if(!with_delete)
+    {
+        for(uint64_t i = released; i < released + count; i++)
+        {
+            ring->slots[i & (ring->capacity - 1)]->keep.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    cursor->released.store(released + count);
+
+    /* wake a blocked publisher */
+    if(ring->post_waiters.load() > 0)
+    {
+        msgQ->locknblock->lock();
+        msgQ->locknblock->signal(READY2POST);
+        msgQ->locknblock->unlock();
+    }
+}
+
 /*----------------------------------------------------------------------------
  * reclaim_nodes
  *----------------------------------------------------------------------------*/
@@ -860,21 +1478,31 @@ bool Subscriber::reclaim_nodes(bool delete_data)
         if(msgQ->front == msgQ->back)   msgQ->front = msgQ->back = NULL;
         else                            msgQ->front = msgQ->front->next;
 
-        /* deallocate memory block and free data */
-        msgQ->free_block_stack[msgQ->free_blocks++] = (char*)node;
-        if(msgQ->free_blocks == MAX_FREE_STACK_SIZE)
+        /* recycle copies and shared buffers immediately */
+        if(node->buffer)
+        {
+            node->buffer->release();
+            freeNode(node);
+        }
+        else if(node->mask & MSGQ_COPYQ_MASK)
+        {
+            freeNode(node);
+        }
+        else
         {
-            for(int i = msgQ->free_blocks - 1; i >= 0; i--)
+            /* free referenced data in groups */
+            msgQ->free_block_stack[msgQ->free_blocks++] = (char*)node;
+            if(msgQ->free_blocks == MAX_FREE_STACK_SIZE)
             {
-                queue_node_t* temp = (queue_node_t*)msgQ->free_block_stack[i];
-                if((temp->mask & MSGQ_COPYQ_MASK) == 0)
+                for(int i = msgQ->free_blocks - 1; i >= 0; i--)
                 {
+                    queue_node_t* temp = (queue_node_t*)msgQ->free_block_stack[i];
                     if(msgQ->free_func && delete_data)  (*msgQ->free_func)(temp->data, NULL);
                     else                                assert(msgQ->free_func);
+                    freeNode(temp);
                 }
-                delete [] msgQ->free_block_stack[i];
+                msgQ->free_blocks = 0;
             }
-            msgQ->free_blocks = 0;
         }
 
         /* decrement queue length */
@@ -948,3 +1576,138 @@ void Subscriber::init_subscriber(subscriber_type_t type)
     }
     msgQ->locknblock->unlock();
 }
+
+/*----------------------------------------------------------------------------
+ * init_ring
+ *
+ *  Notes
+ *  1. every subscriber of a ring queue is treated as a subscriber of
+ *     confidence; the publisher never skips past a slow subscriber
+ *  2. the cursor starts at the next message to be posted
+ *----------------------------------------------------------------------------*/
+void Subscriber::init_ring(subscriber_type_t type)
+{
+    (void)type;
+
+    ring_queue_t* ring = msgQ->ring;
+    id = -1;
+
+    ring->mut.lock();
+    {
+        for(int i = 0; i < MSGQ_RING_MAX_SUBSCRIBERS; i++)
+        {
+            if(!ring->cursors[i].active.load())
+            {
+                id = i;
+                uint64_t head = ring->head.load();
+                ring->cursors[id].read.store(head);
+                ring->cursors[id].released.store(head);
+                ring->cursors[id].active.store(true);
+                ring->subscriptions++;
+                break;
+            }
+        }
+    }
+    ring->mut.unlock();
+
+    if(id < 0)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "Exceeded maximum number of subscribers (%d) on ring queue %s", MSGQ_RING_MAX_SUBSCRIBERS, msgQ->name);
+    }
+}
+
+/******************************************************************************
+ * SHARED BUFFER METHODS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * create
+ *
+ *  Notes
+ *  1. the buffer and its data are allocated in a single block
+ *  2. the caller holds the only reference
+ *----------------------------------------------------------------------------*/
+SharedBuffer* SharedBuffer::create(int size)
+{
+    int header_size = (sizeof(SharedBuffer) + 15) & ~15; // keeps data 16 byte aligned
+    char* block = new char [header_size + size];
+    return new (block) SharedBuffer((unsigned char*)&block[header_size], size, false);
+}
+
+/*----------------------------------------------------------------------------
+ * adopt
+ *
+ *  Notes
+ *  1. the data must have been allocated with new [] and is deleted when the
+ *     last reference is released
+ *  2. the caller holds the only reference
+ *----------------------------------------------------------------------------*/
+SharedBuffer* SharedBuffer::adopt(unsigned char* data, int size)
+{
+    char* block = new char [sizeof(SharedBuffer)];
+    return new (block) SharedBuffer(data, size, true);
+}
+
+/*----------------------------------------------------------------------------
+ * retain
+ *----------------------------------------------------------------------------*/
+SharedBuffer* SharedBuffer::retain(void)
+{
+    refs.fetch_add(1, std::memory_order_relaxed);
+    return this;
+}
+
+/*----------------------------------------------------------------------------
+ * release
+ *----------------------------------------------------------------------------*/
+void SharedBuffer::release(void)
+{
+    if(refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        this->~SharedBuffer();
+        delete [] (char*)this;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * getData
+ *----------------------------------------------------------------------------*/
+unsigned char* SharedBuffer::getData(void)
+{
+    return data;
+}
+
+/*----------------------------------------------------------------------------
+ * getSize
+ *----------------------------------------------------------------------------*/
+int SharedBuffer::getSize(void)
+{
+    return size;
+}
+
+/*----------------------------------------------------------------------------
+ * getRefs
+ *----------------------------------------------------------------------------*/
+int SharedBuffer::getRefs(void)
+{
+    return refs.load(std::memory_order_relaxed);
+}
+
+/*----------------------------------------------------------------------------
+ * Constructor
+ *----------------------------------------------------------------------------*/
+SharedBuffer::SharedBuffer(unsigned char* _data, int _size, bool _adopted):
+    refs(1),
+    data(_data),
+    size(_size),
+    adopted(_adopted)
+{
+}
+
+/*----------------------------------------------------------------------------
+ * Destructor
+ *----------------------------------------------------------------------------*/
+SharedBuffer::~SharedBuffer(void)
+{
+    if(adopted) delete [] data;
+}
@@ -39,6 +39,8 @@
 #include "OsApi.h"
 #include "Dictionary.h"
 
+#include <atomic>
+
 /******************************************************************************
  * DEFINES
  ******************************************************************************/
@@ -47,6 +49,59 @@
 #define MAX_FREE_STACK_SIZE 4096
 #endif
 
+#ifndef MSGQ_SLAB_CLASSES
+#define MSGQ_SLAB_CLASSES 12 // 64 bytes to 128KB
+#endif
+
+#ifndef MSGQ_SLAB_MAX_BYTES
+#define MSGQ_SLAB_MAX_BYTES 0x400000 // per queue
+#endif
+
+#ifndef MSGQ_RING_MAX_SUBSCRIBERS
+#define MSGQ_RING_MAX_SUBSCRIBERS 32
+#endif
+
+#ifndef MSGQ_RING_SPIN
+#define MSGQ_RING_SPIN 64 // times a ring publisher or subscriber yields before blocking
+#endif
+
+#ifndef MSGQ_RING_DEFAULT_DEPTH
+#define MSGQ_RING_DEFAULT_DEPTH 1024 // used when ring queues are created with infinite depth
+#endif
+
+/******************************************************************************
+ * SHARED BUFFER CLASS
+ ******************************************************************************/
+
+/*
+ * Reference counted block of memory that can be posted to a message queue once
+ * and then held by any number of subscribers (and RecordObjects) without
+ * being copied; the memory is freed when the last reference is released
+ */
+class SharedBuffer
+{
+    public:
+
+        static  SharedBuffer*   create      (int size);
+        static  SharedBuffer*   adopt       (unsigned char* data, int size); // takes ownership of memory allocated with new []
+
+                SharedBuffer*   retain      (void);
+                void            release     (void);
+                unsigned char*  getData     (void);
+                int             getSize     (void);
+                int             getRefs     (void);
+
+    private:
+
+                                SharedBuffer    (unsigned char* _data, int _size, bool _adopted);
+                                ~SharedBuffer   (void);
+
+        std::atomic<int>        refs;
+        unsigned char*          data;
+        int                     size;
+        bool                    adopted;
+};
+
 /******************************************************************************
  * MSGQ CLASS
  ******************************************************************************/
@@ -66,6 +121,12 @@ class MsgQ
             SUBSCRIBER_OF_CONFIDENCE
         } subscriber_type_t;
 
+        /* queue implementations */
+        typedef enum {
+            LIST_QUEUE = 0,                 // linked list, any number of publishers
+            RING_QUEUE = 1                  // bounded lock-free ring, publishers take turns
+        } queue_type_t;
+
         typedef struct {
             const char* name;
             int         len;
@@ -94,7 +155,7 @@ class MsgQ
          * Methods
          *--------------------------------------------------------------------*/
 
-                        MsgQ            (const char* name, free_func_t free_func=NULL, int depth=CFG_DEPTH_STANDARD, int data_size=CFG_SIZE_INFINITY);
+                        MsgQ            (const char* name, free_func_t free_func=NULL, int depth=CFG_DEPTH_STANDARD, int data_size=CFG_SIZE_INFINITY, queue_type_t queue_type=LIST_QUEUE);
                         MsgQ            (const MsgQ& existing_q, free_func_t free_func=NULL);
                         ~MsgQ           (void);
 
@@ -104,6 +165,7 @@ class MsgQ
                 int     getSubCnt       (void);
                 int     getState        (void);
                 bool    isFull          (void);
+                bool    isRing          (void);
 
         static  void    init            (void);
         static  void    deinit          (void);
@@ -119,6 +181,7 @@ class MsgQ
          *--------------------------------------------------------------------*/
 
         static const int MSGQ_DEFAULT_SUBSCRIBERS = 2;
+        static const int MSGQ_SLAB_MIN_SIZE = 64;
         static const unsigned int MSGQ_COPYQ_MASK = 1 << ((sizeof(unsigned int) * 8) - 1);
 
         /*--------------------------------------------------------------------
@@ -138,8 +201,34 @@ class MsgQ
             struct queue_node_s*    next;                               // used for FIFO message queue
             unsigned int            mask;                               // msb is type, rest is size
             int                     refs;                               // reference count used for dynamic deallocation
+            int                     slab;                               // size class node was drawn from, -1 if allocated outright
+            SharedBuffer*           buffer;                             // shared buffer held by node, NULL if copied or referenced
+            std::atomic<bool>       keep;                               // ring only, a subscriber dereferenced without delete
         } queue_node_t;
 
+        /* ring_cursor_t */
+        typedef struct {
+            std::atomic<uint64_t>   read;                               // index of next message to receive
+            std::atomic<uint64_t>   released;                           // number of messages dereferenced
+            std::atomic<bool>       active;                             // cursor belongs to a subscriber
+            char                    pad[64 - (2 * sizeof(uint64_t)) - sizeof(bool)]; // keeps subscribers off each other's cache lines
+        } ring_cursor_t;
+
+        /* ring_queue_t */
+        typedef struct {
+            queue_node_t**          slots;                              // [capacity] posted nodes
+            uint64_t                capacity;                           // power of two
+            std::atomic<uint64_t>   head;                               // index of next message to post (written by publisher)
+            char                    pad[64 - sizeof(uint64_t)];
+            std::atomic<uint64_t>   tail;                               // index of next message to reclaim (written by publisher)
+            std::atomic<int>        subscriptions;                      // number of active cursors
+            std::atomic<int>        recv_waiters;                       // number of subscribers blocked on an empty ring
+            std::atomic<int>        post_waiters;                       // number of publishers blocked on a full ring or another post
+            std::atomic_flag        posting;                            // held by the publisher that is posting
+            Mutex                   mut;                                // serializes subscriptions with reclamation
+            ring_cursor_t           cursors[MSGQ_RING_MAX_SUBSCRIBERS];
+        } ring_queue_t;
+
         /* message_queue_t */
         typedef struct {
             queue_node_t*           front;                              // queue out
@@ -159,6 +248,9 @@ class MsgQ
             queue_node_t**          curr_nodes;                         // [max_subscribers] used for subscriptions
             char**                  free_block_stack;                   // [free_stack_size] optimization of memory usage: deallocate in groups
             int                     free_blocks;                        // current number of blocks of free_block_stack
+            queue_node_t*           slab_free[MSGQ_SLAB_CLASSES];       // free lists of recycled nodes by size class
+            long                    slab_bytes;                         // number of bytes held in the free lists
+            ring_queue_t*           ring;                               // used in place of the linked list by ring queues
         } message_queue_t;
 
         /*--------------------------------------------------------------------
@@ -170,6 +262,18 @@ class MsgQ
         static Mutex                        listmut;
 
         message_queue_t* msgQ;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        queue_node_t*   allocNode       (int memory_needed);
+        void            freeNode        (queue_node_t* node);
+        static void     freeSlab        (message_queue_t* q);
+        static void     freeRing        (message_queue_t* q);
+        void            reclaimRing     (void);
+        void            freeData        (queue_node_t* node, bool delete_data);
+        uint64_t        minReleased     (void);
 };
 
 /******************************************************************************
@@ -182,12 +286,13 @@ class Publisher: public MsgQ
 
         static const int MAX_POSTED_STR = 1024;
 
-                Publisher       (const char* name, MsgQ::free_func_t free_func=defaultFree, int depth=CFG_DEPTH_STANDARD, int data_size=CFG_SIZE_INFINITY);
+                Publisher       (const char* name, MsgQ::free_func_t free_func=defaultFree, int depth=CFG_DEPTH_STANDARD, int data_size=CFG_SIZE_INFINITY, queue_type_t queue_type=LIST_QUEUE);
                 Publisher       (const MsgQ& existing_q, MsgQ::free_func_t free_func=defaultFree);
                 ~Publisher      (void);
 
 
         int     postRef         (void* data, int size, int timeout=IO_CHECK);
+        int     postBuffer      (SharedBuffer* buffer, int timeout=IO_CHECK);
         int     postCopy        (const void* data, int size, int timeout=IO_CHECK);
         int     postCopy        (const void* data, int size, const void* secondary_data, int secondary_size, int timeout=IO_CHECK);
         int     postString      (const char* format_string, ...) VARG_CHECK(printf, 2, 3); // "this" is 1
@@ -196,7 +301,8 @@ class Publisher: public MsgQ
 
     private:
 
-        int     post            (void* data, unsigned int mask, void* secondary_data, unsigned int secondary_size, int timeout);
+        int     post            (void* data, unsigned int mask, void* secondary_data, unsigned int secondary_size, int timeout, SharedBuffer* buffer=NULL);
+        int     postRing        (void* data, unsigned int mask, void* secondary_data, unsigned int secondary_size, int timeout, SharedBuffer* buffer);
 
 };
 
@@ -215,7 +321,7 @@ class Subscriber: public MsgQ
             void*   _handle;
         } msgRef_t;
 
-                Subscriber      (const char* name, subscriber_type_t type=SUBSCRIBER_OF_CONFIDENCE, int depth=CFG_DEPTH_STANDARD, int data_size=CFG_SIZE_INFINITY);
+                Subscriber      (const char* name, subscriber_type_t type=SUBSCRIBER_OF_CONFIDENCE, int depth=CFG_DEPTH_STANDARD, int data_size=CFG_SIZE_INFINITY, queue_type_t queue_type=LIST_QUEUE);
                 Subscriber      (const MsgQ& existing_q, subscriber_type_t type=SUBSCRIBER_OF_CONFIDENCE);
                 ~Subscriber     (void);
 
@@ -223,6 +329,7 @@ class Subscriber: public MsgQ
         void    drain           (bool with_delete=true);
         bool    isEmpty         (void);
         void*   getData         (void* _handle, int* size=NULL);
+        SharedBuffer* retain    (msgRef_t& ref);
 
         int     receiveRef      (msgRef_t& ref, int timeout);
         int     receiveCopy     (void* data, int size, int timeout);
@@ -232,8 +339,11 @@ class Subscriber: public MsgQ
         int id;                 // index into current node table
 
         int     receive         (msgRef_t& ref, int size, int timeout, bool copy=false);
+        int     receiveRing     (msgRef_t& ref, int size, int timeout, bool copy);
+        void    releaseRing     (uint64_t count, bool with_delete=true);
         bool    reclaim_nodes   (bool delete_data);
         void    init_subscriber (subscriber_type_t type);
+        void    init_ring       (subscriber_type_t type);
 };
 
 #endif  /* __msgq__ */
@@ -161,6 +161,9 @@ RecordDispatcher::RecordDispatcher( lua_State* L, const char* inputq_name,
     numThreads      = num_threads;
     threadsComplete = 0;
     recError        = false;
+    internTable     = NULL;
+    internSize      = 0;
+    internMisses    = false;
 
     /* Create Subscriber */
     inQ = new Subscriber(inputq_name, type);
@@ -187,6 +190,7 @@ RecordDispatcher::~RecordDispatcher(void)
     delete inQ;
 
     if (keyField) delete [] keyField;
+    if (internTable) delete [] internTable;
 
     dispatch_t dispatch;
     const char* key = dispatchTable.first(&dispatch);
@@ -221,6 +225,12 @@ int RecordDispatcher::luaRun(lua_State* L)
         /* Get Self */
         RecordDispatcher* lua_obj = (RecordDispatcher*)getLuaSelf(L, 1);
 
+        /* Intern Dispatch Table (left alone for threads already running) */
+        if(!lua_obj->dispatcherActive)
+        {
+            lua_obj->internDispatches();
+        }
+
         /* Start Threads */
         lua_obj->dispatcherActive = true;
         for(int i = 0; i < lua_obj->numThreads; i++)
@@ -425,26 +435,36 @@ void* RecordDispatcher::dispatcherThread(void* parm)
 {
     RecordDispatcher* dispatcher = (RecordDispatcher*)parm;
 
+    Subscriber::msgRef_t refs[DISPATCH_BATCH_SIZE];
+    RecordObject* records[DISPATCH_BATCH_SIZE];
+
     /* Loop Forever */
     while(dispatcher->dispatcherActive)
     {
         /* Receive Message */
-        Subscriber::msgRef_t ref;
-        int recv_status = dispatcher->inQ->receiveRef(ref, SYS_TIMEOUT);
+        int recv_status = dispatcher->inQ->receiveRef(refs[0], SYS_TIMEOUT);
         if(recv_status > 0)
         {
-            unsigned char* msg = (unsigned char*)ref.data;
-            int len = ref.size;
+            /* Drain Up To a Batch of Messages Already Queued */
+            int num_refs = 1;
+            bool terminator = (refs[0].size <= 0);
+            while(!terminator && num_refs < DISPATCH_BATCH_SIZE)
+            {
+                if(dispatcher->inQ->receiveRef(refs[num_refs], IO_CHECK) <= 0) break;
+                terminator = (refs[num_refs].size <= 0);
+                num_refs++;
+            }
 
-            /* Dispatch Record */
-            if(len > 0)
+            /* Create Records */
+            int num_records = 0;
+            for(int r = 0; r < num_refs && refs[r].size > 0; r++)
             {
+                unsigned char* msg = (unsigned char*)refs[r].data;
+                int len = refs[r].size;
                 try
                 {
-                    /* Create & Dispatch Record */
-                    RecordObject* record = dispatcher->createRecord(msg, len);
-                    dispatcher->dispatchRecord(record);
-                    delete record;
+                    records[num_records] = dispatcher->createRecord(msg, len);
+                    num_records++;
                 }
                 catch (const RunTimeException& e)
                 {
@@ -468,15 +488,26 @@ void* RecordDispatcher::dispatcherThread(void* parm)
                     dispatcher->recError = true;
                 }
             }
-            else
+
+            /* Dispatch Records */
+            dispatcher->dispatchBatch(records, num_records);
+            for(int r = 0; r < num_records; r++)
+            {
+                delete records[r];
+            }
+
+            /* Terminating Message */
+            if(terminator)
             {
-                /* Terminating Message */
                 mlog(DEBUG, "Terminator received on %s, exiting dispatcher", dispatcher->inQ->getName());
                 dispatcher->dispatcherActive = false; // breaks out of loop
             }
 
-            /* Dereference Message */
-            dispatcher->inQ->dereference(ref);
+            /* Dereference Messages (in order received) */
+            for(int r = 0; r < num_refs; r++)
+            {
+                dispatcher->inQ->dereference(refs[r]);
+            }
         }
         else if(recv_status == MsgQ::STATE_TIMEOUT)
         {
@@ -533,6 +564,188 @@ void* RecordDispatcher::dispatcherThread(void* parm)
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * internDispatches
+ *
+ *  builds a table of dispatch lists indexed by record type id so that the
+ *  dispatcher threads do not perform a string lookup per record; record types
+ *  attached before they are defined cannot be interned and leave the
+ *  dispatcher falling back to the dispatch table for anything not found
+ *----------------------------------------------------------------------------*/
+void RecordDispatcher::internDispatches (void)
+{
+    if(internTable) delete [] internTable;
+
+    internSize = RecordObject::getNumRecordTypes();
+    internMisses = false;
+    internTable = new interned_t [internSize];
+    for(int i = 0; i < internSize; i++)
+    {
+        internTable[i].dispatch.list = NULL;
+        internTable[i].dispatch.size = 0;
+        internTable[i].key_valid = false;
+    }
+
+    dispatch_t dispatch;
+    const char* rec_type = dispatchTable.first(&dispatch);
+    while(rec_type != NULL)
+    {
+        int type_id = RecordObject::getRecordTypeId(rec_type);
+        if(type_id >= 0 && type_id < internSize)
+        {
+            interned_t* entry = &internTable[type_id];
+            entry->dispatch = dispatch;
+
+            /* Resolve Key Field */
+            if(keyMode == FIELD_KEY_MODE)
+            {
+                try
+                {
+                    if(keyField[0] == RecordObject::IMMEDIATE_FIELD_SYMBOL)
+                    {
+                        entry->key_field = RecordObject::parseImmediateField(keyField);
+                    }
+                    else
+                    {
+                        entry->key_field = RecordObject::getDefinedField(rec_type, keyField);
+                    }
+                    entry->key_valid = entry->key_field.type != RecordObject::INVALID_FIELD;
+                }
+                catch(const RunTimeException& e)
+                {
+                    (void)e;
+                }
+            }
+        }
+        else
+        {
+            internMisses = true;
+        }
+        rec_type = dispatchTable.next(&dispatch);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * dispatchBatch
+ *
+ *  keys are assigned in the order the records were received, and consecutive
+ *  records of the same type are handed to each dispatch as a single batch;
+ *  like dispatchRecord, exceptions from a dispatch are caught here so that
+ *  the caller always gets to free the batch and dereference its messages
+ *----------------------------------------------------------------------------*/
+void RecordDispatcher::dispatchBatch (RecordObject** records, int num_records)
+{
+    okey_t keys[DISPATCH_BATCH_SIZE];
+    interned_t* entries[DISPATCH_BATCH_SIZE];
+
+    /* Look Up Dispatches */
+    for(int r = 0; r < num_records; r++)
+    {
+        int type_id = records[r]->getRecordTypeId();
+        if(type_id >= 0 && type_id < internSize && internTable[type_id].dispatch.size > 0)
+        {
+            entries[r] = &internTable[type_id];
+        }
+        else
+        {
+            entries[r] = NULL;
+        }
+    }
+
+    /* Get Keys */
+    if(keyMode == FIELD_KEY_MODE)
+    {
+        for(int r = 0; r < num_records; r++)
+        {
+            if(entries[r] && entries[r]->key_valid)
+            {
+                try
+                {
+                    keys[r] = (okey_t)records[r]->getValueInteger(entries[r]->key_field);
+                }
+                catch(RunTimeException& e)
+                {
+                    (void)e;
+                    entries[r] = NULL; // key cannot be determined
+                }
+            }
+            else
+            {
+                entries[r] = NULL; // key cannot be determined
+            }
+        }
+    }
+    else if(keyMode == RECEIPT_KEY_MODE)
+    {
+        int num_keyed = 0;
+        for(int r = 0; r < num_records; r++)
+        {
+            if(entries[r]) num_keyed++;
+        }
+
+        okey_t key = 0;
+        dispatchMutex.lock();
+        {
+            key = keyRecCnt;
+            keyRecCnt += num_keyed;
+        }
+        dispatchMutex.unlock();
+
+        for(int r = 0; r < num_records; r++)
+        {
+            if(entries[r]) keys[r] = key++;
+        }
+    }
+    else if(keyMode == CALCULATED_KEY_MODE)
+    {
+        for(int r = 0; r < num_records; r++)
+        {
+            if(entries[r]) keys[r] = keyFunc(records[r]->getRecordData(), records[r]->getRecordDataSize());
+        }
+    }
+    else
+    {
+        for(int r = 0; r < num_records; r++)
+        {
+            keys[r] = 0;
+        }
+    }
+
+    /* Process Runs of Same Type */
+    int r = 0;
+    while(r < num_records)
+    {
+        if(entries[r] == NULL)
+        {
+            /* Not Interned */
+            if(internMisses) dispatchRecord(records[r]);
+            r++;
+            continue;
+        }
+
+        int run = 1;
+        while(r + run < num_records && entries[r + run] == entries[r])
+        {
+            run++;
+        }
+
+        dispatch_t& dis = entries[r]->dispatch;
+        for(int i = 0; i < dis.size; i++)
+        {
+            try
+            {
+                dis.list[i]->processRecordBatch(&records[r], &keys[r], run);
+            }
+            catch(RunTimeException& e)
+            {
+                (void)e;
+            }
+        }
+
+        r += run;
+    }
+}
+
 /*----------------------------------------------------------------------------
  * dispatchRecord
  *----------------------------------------------------------------------------*/
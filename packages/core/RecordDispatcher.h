@@ -70,6 +70,7 @@ class RecordDispatcher: public LuaObject
          *--------------------------------------------------------------------*/
 
         static const int DISPATCH_TIMEOUT = 1000; // milliseconds
+        static const int DISPATCH_BATCH_SIZE = 64; // maximum messages received per wakeup
 
         /*--------------------------------------------------------------------
          * Methods
@@ -123,6 +124,12 @@ class RecordDispatcher: public LuaObject
             int                 size;
         } dispatch_t;
 
+        typedef struct {
+            dispatch_t              dispatch;
+            RecordObject::field_t   key_field;  // resolved once for FIELD_KEY_MODE
+            bool                    key_valid;  // false if key field not in record type
+        } interned_t;
+
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
@@ -136,6 +143,9 @@ class RecordDispatcher: public LuaObject
         Subscriber*             inQ;
         List<DispatchObject*>   dispatchList;   // for processTimeout
         Dictionary<dispatch_t>  dispatchTable;  // for processRecord
+        interned_t*             internTable;    // dispatchTable indexed by record type id, built on run
+        int                     internSize;
+        bool                    internMisses;   // attached record types not yet defined on run
         Mutex                   dispatchMutex;
         keyMode_t               keyMode;        // determines key of metric
         okey_t                  keyRecCnt;      // used with RECEIPT_KEY_MODE
@@ -149,6 +159,8 @@ class RecordDispatcher: public LuaObject
 
         static void*    dispatcherThread    (void* parm);
         void            dispatchRecord      (RecordObject* record);
+        void            dispatchBatch       (RecordObject** records, int num_records);
+        void            internDispatches    (void);
 
         void            startThreads        (void);
         void            stopThreads         (void);
@@ -53,6 +53,7 @@
 
 MgDictionary<RecordObject::definition_t*> RecordObject::definitions;
 Mutex RecordObject::defMut;
+int RecordObject::numDefinitions = 0;
 
 const char* RecordObject::DEFAULT_DOUBLE_FORMAT = "%.6lf";
 const char* RecordObject::DEFAULT_LONG_FORMAT = "%ld";
@@ -220,6 +221,7 @@ RecordObject::RecordObject(const char* rec_type, int allocated_memory, bool clea
 
         /* Allocate Record Memory */
         memoryOwner = true;
+        sharedBuffer = NULL;
         recordMemory = new unsigned char[memoryAllocated];
 
         /* Populate Header */
@@ -266,6 +268,7 @@ RecordObject::RecordObject(unsigned char* buffer, int size)
         {
             /* Set Record Memory */
             memoryOwner = true;
+            sharedBuffer = NULL;
             memoryAllocated = size;
             recordMemory = new unsigned char[memoryAllocated];
             LocalLib::copy(recordMemory, buffer, memoryAllocated);
@@ -284,12 +287,50 @@ RecordObject::RecordObject(unsigned char* buffer, int size)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * Constructor
+ *
+ *  Assumes a shared buffer holding a serialized record <type string><binary data>
+ *  which is wrapped in place (no copy is made); the record takes its own
+ *  reference to the buffer, and since the memory is seen by every holder of
+ *  the buffer, the record is copied out of it the first time it is written
+ *----------------------------------------------------------------------------*/
+RecordObject::RecordObject(SharedBuffer* buffer)
+{
+    assert(buffer);
+
+    recordDefinition = getDefinition(buffer->getData(), buffer->getSize());
+    if(recordDefinition != NULL)
+    {
+        if (buffer->getSize() >= recordDefinition->record_size)
+        {
+            /* Set Record Memory */
+            memoryOwner = false;
+            sharedBuffer = buffer->retain();
+            memoryAllocated = buffer->getSize();
+            recordMemory = buffer->getData();
+
+            /* Set Record Data */
+            recordData = (unsigned char*)&recordMemory[sizeof(rec_hdr_t) + recordDefinition->type_size];
+        }
+        else
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "buffer passed in not large enough to populate record");
+        }
+    }
+    else
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "buffer did not contain defined record");
+    }
+}
+
 /*----------------------------------------------------------------------------
  * Denstructor
  *----------------------------------------------------------------------------*/
 RecordObject::~RecordObject(void)
 {
     if(memoryOwner) delete [] recordMemory;
+    if(sharedBuffer) sharedBuffer->release();
 }
 
 /*----------------------------------------------------------------------------
@@ -319,6 +360,7 @@ bool RecordObject::deserialize(unsigned char* buffer, int size)
     }
 
     /* Copy Data and Return */
+    unshare();
     LocalLib::copy(recordMemory, buffer, size);
     return true;
 }
@@ -332,6 +374,9 @@ int RecordObject::serialize(unsigned char** buffer, serialMode_t mode, int size)
     int bufsize = memoryAllocated;
     uint32_t datasize = 0;
 
+    /* Size is Written into Record Header when Referenced */
+    if(size > 0 && mode == REFERENCE) unshare();
+
     /* Determine Buffer Size */
     rec_hdr_t* rechdr = (rec_hdr_t*)(recordMemory);
     if(size > 0)
@@ -356,6 +401,13 @@ int RecordObject::serialize(unsigned char** buffer, serialMode_t mode, int size)
     {
         *buffer = recordMemory;
     }
+    else if (mode == TAKE_OWNERSHIP && sharedBuffer)
+    {
+        /* Shared memory cannot be handed off */
+        *buffer = new unsigned char[bufsize];
+        uint32_t bytes_to_copy = MIN(bufsize, memoryAllocated);
+        LocalLib::copy(*buffer, recordMemory, bytes_to_copy);
+    }
     else if (mode == TAKE_OWNERSHIP)
     {
         *buffer = recordMemory;
@@ -383,6 +435,38 @@ int RecordObject::serialize(unsigned char** buffer, serialMode_t mode, int size)
     return bufsize;
 }
 
+/*----------------------------------------------------------------------------
+ * share
+ *
+ *  Notes
+ *  1. returns a reference to a shared buffer holding the serialized record,
+ *     suitable for posting with Publisher::postBuffer
+ *  2. memory owned by the record is adopted by the buffer without a copy;
+ *     memory the record does not own is copied into a new buffer once
+ *  3. the record keeps its own reference; writing to the record afterwards
+ *     copies it out of the buffer, leaving what was posted unchanged
+ *----------------------------------------------------------------------------*/
+SharedBuffer* RecordObject::share(void)
+{
+    if(!sharedBuffer)
+    {
+        if(memoryOwner)
+        {
+            sharedBuffer = SharedBuffer::adopt(recordMemory, memoryAllocated);
+            memoryOwner = false;
+        }
+        else
+        {
+            sharedBuffer = SharedBuffer::create(memoryAllocated);
+            LocalLib::copy(sharedBuffer->getData(), recordMemory, memoryAllocated);
+            recordData = sharedBuffer->getData() + (recordData - recordMemory);
+            recordMemory = sharedBuffer->getData();
+        }
+    }
+
+    return sharedBuffer->retain();
+}
+
 /*----------------------------------------------------------------------------
  * isRecordType
  *----------------------------------------------------------------------------*/
@@ -399,6 +483,14 @@ const char* RecordObject::getRecordType(void)
     return recordDefinition->type_name;
 }
 
+/*----------------------------------------------------------------------------
+ * getRecordTypeId
+ *----------------------------------------------------------------------------*/
+int RecordObject::getRecordTypeId(void)
+{
+    return recordDefinition->type_id;
+}
+
 /*----------------------------------------------------------------------------
  * getRecordId
  *----------------------------------------------------------------------------*/
@@ -569,6 +661,8 @@ RecordObject::Field RecordObject::field(const char* field_name)
  *----------------------------------------------------------------------------*/
 void RecordObject::setValueText(const field_t& f, const char* val, int element)
 {
+    unshare();
+
     valType_t val_type = getValueType(f);
 
     if(f.flags & POINTER)
@@ -622,6 +716,8 @@ void RecordObject::setValueText(const field_t& f, const char* val, int element)
  *----------------------------------------------------------------------------*/
 void RecordObject::setValueReal(const field_t& f, const double val, int element)
 {
+    unshare();
+
     if(f.elements > 0 && element > 0 && element >= f.elements) throw RunTimeException(CRITICAL, RTE_ERROR, "Out of range access");
     uint32_t elem_offset = TOBYTES(f.offset) + (element * FIELD_TYPE_BYTES[f.type]);
 
@@ -693,6 +789,8 @@ void RecordObject::setValueReal(const field_t& f, const double val, int element)
  *----------------------------------------------------------------------------*/
 void RecordObject::setValueInteger(const field_t& f, const long val, int element)
 {
+    unshare();
+
     if(f.elements > 0 && element > 0 && element >= f.elements) throw RunTimeException(CRITICAL, RTE_ERROR, "Out of range access");
     uint32_t elem_offset = TOBYTES(f.offset) + (element * FIELD_TYPE_BYTES[f.type]);
 
@@ -1033,6 +1131,24 @@ const char* RecordObject::getRecordIdField(const char* rec_type)
     return def->id_field;
 }
 
+/*----------------------------------------------------------------------------
+ * getRecordTypeId
+ *----------------------------------------------------------------------------*/
+int RecordObject::getRecordTypeId(const char* rec_type)
+{
+    definition_t* def = getDefinition(rec_type);
+    if(def == NULL) return -1;
+    return def->type_id;
+}
+
+/*----------------------------------------------------------------------------
+ * getNumRecordTypes
+ *----------------------------------------------------------------------------*/
+int RecordObject::getNumRecordTypes(void)
+{
+    return numDefinitions;
+}
+
 /*----------------------------------------------------------------------------
  * getRecordSize
  *----------------------------------------------------------------------------*/
@@ -1437,6 +1553,28 @@ RecordObject::RecordObject(void)
     recordData = NULL;
     memoryAllocated = 0;
     memoryOwner = false;
+    sharedBuffer = NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * unshare
+ *
+ *  a record wrapping a shared buffer takes its own copy of the memory before
+ *  it is written to, so that the write is not seen by other holders of the
+ *  buffer; the record's memory is not shared afterwards
+ *----------------------------------------------------------------------------*/
+void RecordObject::unshare(void)
+{
+    if(sharedBuffer)
+    {
+        unsigned char* memory = new unsigned char[memoryAllocated];
+        LocalLib::copy(memory, recordMemory, memoryAllocated);
+        recordData = memory + (recordData - recordMemory);
+        recordMemory = memory;
+        memoryOwner = true;
+        sharedBuffer->release();
+        sharedBuffer = NULL;
+    }
 }
 
 /*----------------------------------------------------------------------------
@@ -1608,12 +1746,17 @@ RecordObject::recordDefErr_t RecordObject::addDefinition(definition_t** rec_def,
         {
             assert(data_size > 0);
             def = new definition_t(rec_type, id_field, data_size, max_fields);
+            def->type_id = numDefinitions;
             if(!definitions.add(rec_type, def))
             {
                 delete def;
                 def = NULL;
                 status = REGERR_DEF;
             }
+            else
+            {
+                numDefinitions++;
+            }
         }
         else
         {
@@ -191,15 +191,18 @@ class RecordObject
 
                                 RecordObject        (const char* rec_type, int allocated_memory=0, bool clear=true); // must include the record type
                                 RecordObject        (unsigned char* buffer, int size);
+                                RecordObject        (SharedBuffer* buffer); // wraps serialized record in place, copied on first write
         virtual                 ~RecordObject       (void);
 
         /* Overloaded Methods */
         virtual bool            deserialize         (unsigned char* buffer, int size);
         virtual int             serialize           (unsigned char** buffer, serialMode_t mode=ALLOCATE, int size=0);
+        SharedBuffer*           share               (void); // caller must release returned buffer
 
         /* Attribute Methods */
         bool                    isRecordType        (const char* rec_type);
         const char*             getRecordType       (void); // used to identify type of records (used for parsing)
+        int                     getRecordTypeId     (void); // small integer interned when the type was defined
         long                    getRecordId         (void); // used to identify records of the same type (used for filtering))
         unsigned char*          getRecordData       (void);
         int                     getRecordTypeSize   (void);
@@ -233,6 +236,8 @@ class RecordObject
         static bool             isType              (unsigned char* buffer, int size, const char* rec_type);
         static int              getRecords          (char*** rec_types);
         static const char*      getRecordIdField    (const char* rec_type); // returns name of field
+        static int              getRecordTypeId     (const char* rec_type); // returns -1 if not defined
+        static int              getNumRecordTypes   (void); // all type ids are less than this
         static int              getRecordSize       (const char* rec_type);
         static int              getRecordDataSize   (const char* rec_type);
         static int              getRecordMaxFields  (const char* rec_type);
@@ -273,6 +278,7 @@ class RecordObject
             int                     type_size;      // size in bytes of type name string including null termination
             int                     data_size;      // number of bytes of binary data
             int                     record_size;    // total size of memory allocated for record
+            int                     type_id;        // interned index of the type, assigned in the order types are defined
             Dictionary<field_t>     fields;
 
             definition_t(const char* _type_name, const char* _id_field, int _data_size, int _max_fields):
@@ -281,6 +287,7 @@ class RecordObject
                   type_size = (int)StringLib::size(_type_name) + 1;
                   id_field = StringLib::duplicate(_id_field);
                   data_size = _data_size;
+                  type_id = -1;
                   record_size = sizeof(rec_hdr_t) + type_size + _data_size; }
             ~definition_t(void)
                 { if(type_name) delete [] type_name;
@@ -293,12 +300,14 @@ class RecordObject
 
         static MgDictionary<definition_t*>  definitions;
         static Mutex                        defMut;
+        static int                          numDefinitions;
 
         definition_t*   recordDefinition;
         unsigned char*  recordMemory;       // block of allocated memory <record type as null terminated string><record data as binary>
         unsigned char*  recordData;         // pointer to binary data in recordMemory
         int             memoryAllocated;    // number of bytes allocated by object and pointed to by recordMemory
         bool            memoryOwner;        // true if object owns (and therefore must free) memory allocated
+        SharedBuffer*   sharedBuffer;       // shared buffer holding recordMemory, NULL if not shared
 
         /*--------------------------------------------------------------------
          * Methods
@@ -308,6 +317,7 @@ class RecordObject
                                 RecordObject        (void);
 
         /* Regular Methods */
+        void                    unshare             (void); // copies record out of its shared buffer prior to a write
         field_t                 getPointedToField   (field_t field, bool allow_null, int element=0);
         static field_t          getUserField        (definition_t* def, const char* field_name);
         static recordDefErr_t   addDefinition       (definition_t** rec_def, const char* rec_type, const char* id_field, int data_size, const fieldDef_t* fields, int num_fields, int max_fields);
@@ -58,6 +58,8 @@ struct GeoJsonRaster::impl
         OGRCoordinateTransformation *latlon2xy;
         OGRSpatialReference source;
         OGRSpatialReference target;
+        bool identity; // raster is in the photon CRS, no transformation needed
+        Mutex transformMut; // coordinate transformations are not thread safe
 };
 
 /******************************************************************************
@@ -70,6 +72,7 @@ const struct luaL_Reg GeoJsonRaster::LuaMetaTable[] = {
     {"bbox",        luaBoundingBox},
     {"cell",        luaCellSize},
     {"pixel",       luaPixel},
+    {"subset",      luaSubset},
     {NULL,          NULL}
 };
 
@@ -131,26 +134,21 @@ GeoJsonRaster* GeoJsonRaster::create (lua_State* L, int index)
  *----------------------------------------------------------------------------*/
 bool GeoJsonRaster::subset (double lon, double lat)
 {
-    OGRPoint p  = {lon, lat};
-
-    if(p.transform(pimpl->latlon2xy) == OGRERR_NONE)
+    /* Raster in Photon CRS */
+    if(pimpl->identity)
     {
-        lon = p.getX();
-        lat = p.getY();
+        return checkPixel(lon, lat);
+    }
 
-        if ((lon >= bbox.lon_min) &&
-            (lon <= bbox.lon_max) &&
-            (lat >= bbox.lat_min) &&
-            (lat <= bbox.lat_max))
-        {
-            uint32_t row = (bbox.lat_max - lat) / cellsize;
-            uint32_t col = (lon - bbox.lon_min) / cellsize;
+    OGRPoint p  = {lon, lat};
 
-            if ((row < rows) && (col < cols))
-            {
-                return rawPixel(row, col);
-            }
-        }
+    pimpl->transformMut.lock();
+    OGRErr ogrerr = p.transform(pimpl->latlon2xy);
+    pimpl->transformMut.unlock();
+
+    if(ogrerr == OGRERR_NONE)
+    {
+        return checkPixel(p.getX(), p.getY());
     }
     else
     {
@@ -163,6 +161,53 @@ bool GeoJsonRaster::subset (double lon, double lat)
     return false;
 }
 
+/*----------------------------------------------------------------------------
+ * subset
+ *
+ *  sets the mask entry of each coordinate to its inclusion and returns the
+ *  number of coordinates included; coordinates are transformed a batch at
+ *  a time, or not at all when the raster is in the photon CRS
+ *----------------------------------------------------------------------------*/
+int GeoJsonRaster::subset (const double* lon, const double* lat, int num_points, bool* mask)
+{
+    int num_included = 0;
+
+    /* Raster in Photon CRS */
+    if(pimpl->identity)
+    {
+        for(int i = 0; i < num_points; i++)
+        {
+            mask[i] = checkPixel(lon[i], lat[i]);
+            num_included += mask[i];
+        }
+        return num_included;
+    }
+
+    /* Transform and Check Each Batch */
+    double x[SUBSET_BATCH_SIZE];
+    double y[SUBSET_BATCH_SIZE];
+    int success[SUBSET_BATCH_SIZE];
+    for(int i = 0; i < num_points; i += SUBSET_BATCH_SIZE)
+    {
+        int batch_size = MIN(SUBSET_BATCH_SIZE, num_points - i);
+        LocalLib::copy(x, &lon[i], batch_size * sizeof(double));
+        LocalLib::copy(y, &lat[i], batch_size * sizeof(double));
+        LocalLib::set(success, 0, batch_size * sizeof(int));
+
+        pimpl->transformMut.lock();
+        pimpl->latlon2xy->Transform(batch_size, x, y, NULL, success);
+        pimpl->transformMut.unlock();
+
+        for(int b = 0; b < batch_size; b++)
+        {
+            mask[i + b] = success[b] && checkPixel(x[b], y[b]);
+            num_included += mask[i + b];
+        }
+    }
+
+    return num_included;
+}
+
 /*----------------------------------------------------------------------------
  * Destructor
  *----------------------------------------------------------------------------*/
@@ -223,6 +268,7 @@ GeoJsonRaster::GeoJsonRaster(lua_State *L, const char *file, long filelength, do
     bbox = {0.0, 0.0, 0.0, 0.0};
     cellsize = 0.0;
     pimpl->latlon2xy = NULL;
+    pimpl->identity = false;
     pimpl->source.Clear();
     pimpl->target.Clear();
 
@@ -326,6 +372,11 @@ GeoJsonRaster::GeoJsonRaster(lua_State *L, const char *file, long filelength, do
         pimpl->latlon2xy = OGRCreateCoordinateTransformation(&pimpl->source, &pimpl->target);
         CHECKPTR(pimpl->latlon2xy);
 
+        /* Skip Transformation When Raster Is Already in Photon CRS (both are lon,lat from above) */
+        const char* const same_options[] = {"IGNORE_DATA_AXIS_TO_SRS_AXIS_MAPPING=YES", "CRITERION=EQUIVALENT_EXCEPT_AXIS_ORDER_GEOGCRS", NULL};
+        pimpl->identity = pimpl->target.IsSame(&pimpl->source, same_options);
+        mlog(DEBUG, "geojson raster %s transformation", pimpl->identity ? "skips" : "requires");
+
         rasterCreated = true;
     }
     catch(const RunTimeException& e)
@@ -348,6 +399,30 @@ GeoJsonRaster::GeoJsonRaster(lua_State *L, const char *file, long filelength, do
  * PRIVATE METHODS
  ******************************************************************************/
 
+/*----------------------------------------------------------------------------
+ * checkPixel
+ *
+ *  x and y are in the raster's CRS
+ *----------------------------------------------------------------------------*/
+bool GeoJsonRaster::checkPixel (double x, double y)
+{
+    if ((x >= bbox.lon_min) &&
+        (x <= bbox.lon_max) &&
+        (y >= bbox.lat_min) &&
+        (y <= bbox.lat_max))
+    {
+        uint32_t row = (bbox.lat_max - y) / cellsize;
+        uint32_t col = (x - bbox.lon_min) / cellsize;
+
+        if ((row < rows) && (col < cols))
+        {
+            return rawPixel(row, col);
+        }
+    }
+
+    return false;
+}
+
 /*----------------------------------------------------------------------------
  * luaDimensions - :dim() --> rows, cols
  *----------------------------------------------------------------------------*/
@@ -481,28 +556,76 @@ int GeoJsonRaster::luaPixel(lua_State *L)
 
 /*----------------------------------------------------------------------------
  * luaSubset - :subset(lon, lat) --> in|out
+ *             :subset({lon1, lon2, ...}, {lat1, lat2, ...}) --> {in|out, ...}, number in
  *----------------------------------------------------------------------------*/
 int GeoJsonRaster::luaSubset(lua_State *L)
 {
     bool status = false;
+    int num_ret = 1;
+    double* lon = NULL;
+    double* lat = NULL;
+    bool* mask = NULL;
 
     try
     {
         /* Get Self */
         GeoJsonRaster *lua_obj = (GeoJsonRaster *)getLuaSelf(L, 1);
 
-        /* Get Coordinates */
-        double lon = getLuaFloat(L, 2);
-        double lat = getLuaFloat(L, 3);
+        if(lua_istable(L, 2))
+        {
+            /* Get Coordinates */
+            int num_points = lua_rawlen(L, 2);
+            if(!lua_istable(L, 3) || (int)lua_rawlen(L, 3) != num_points)
+            {
+                throw RunTimeException(CRITICAL, RTE_ERROR, "longitudes and latitudes must be tables of the same length");
+            }
+            lon = new double [num_points];
+            lat = new double [num_points];
+            mask = new bool [num_points];
+            for(int i = 0; i < num_points; i++)
+            {
+                lua_rawgeti(L, 2, i + 1);
+                lon[i] = getLuaFloat(L, -1);
+                lua_pop(L, 1);
+                lua_rawgeti(L, 3, i + 1);
+                lat[i] = getLuaFloat(L, -1);
+                lua_pop(L, 1);
+            }
+
+            /* Get Inclusion Mask */
+            int num_included = lua_obj->subset(lon, lat, num_points, mask);
 
-        /* Get Inclusion */
-        status = lua_obj->subset(lon, lat);
+            /* Set Return Values */
+            lua_createtable(L, num_points, 0);
+            for(int i = 0; i < num_points; i++)
+            {
+                lua_pushboolean(L, mask[i]);
+                lua_rawseti(L, -2, i + 1);
+            }
+            lua_pushinteger(L, num_included);
+            num_ret += 2;
+            status = true;
+        }
+        else
+        {
+            /* Get Coordinates */
+            double _lon = getLuaFloat(L, 2);
+            double _lat = getLuaFloat(L, 3);
+
+            /* Get Inclusion */
+            status = lua_obj->subset(_lon, _lat);
+        }
     }
     catch (const RunTimeException &e)
     {
         mlog(e.level(), "Error subsetting: %s", e.what());
     }
 
+    /* Clean Up */
+    delete [] lon;
+    delete [] lat;
+    delete [] mask;
+
     /* Return Status */
-    return returnLuaStatus(L, status);
+    return returnLuaStatus(L, status, num_ret);
 }
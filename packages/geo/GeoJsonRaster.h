@@ -55,6 +55,7 @@ class GeoJsonRaster: public LuaObject
         static const int   RASTER_NODATA_VALUE = 200;
         static const int   RASTER_PIXEL_ON = 1;
         static const int   RASTER_MAX_IMAGE_SIZE = 4194304; // 4MB
+        static const int   SUBSET_BATCH_SIZE = 256; // points transformed at a time
 
         static const char* FILEDATA_KEY;
         static const char* FILELENGTH_KEY;
@@ -73,6 +74,7 @@ class GeoJsonRaster: public LuaObject
         static GeoJsonRaster* create         (lua_State* L, int index);
 
         bool                  subset         (double lon, double lat);
+        int                   subset         (const double* lon, const double* lat, int num_points, bool* mask);
         virtual              ~GeoJsonRaster  (void);
 
         /*--------------------------------------------------------------------
@@ -131,6 +133,8 @@ class GeoJsonRaster: public LuaObject
         static int luaBoundingBox   (lua_State* L);
         static int luaCellSize      (lua_State* L);
         static int luaPixel         (lua_State* L);
+        bool       checkPixel       (double x, double y);
+
         static int luaSubset        (lua_State* L);
 };
 
@@ -176,6 +176,86 @@ int VrtRaster::sample (double lon, double lat, List<sample_t> &slist, void* para
     return slist.length();
 }
 
+/*----------------------------------------------------------------------------
+ * sample
+ *
+ *  samples each point into its own list and returns the total number of
+ *  samples; points are taken a batch at a time, the rasters needed by the
+ *  batch are found first, and then each raster reads all of the batch's
+ *  points inside it on a reader thread
+ *----------------------------------------------------------------------------*/
+int VrtRaster::sample (const MathLib::coord_t* points, int num_points, List<sample_t>* slists)
+{
+    int num_samples = 0;
+
+    samplingMutex.lock(); /* Serialize sampling on the same object */
+
+    for (int i = 0; i < num_points; i++)
+    {
+        slists[i].clear();
+    }
+
+    for (int start = 0; start < num_points; start += SAMPLE_BATCH_SIZE)
+    {
+        int batch_size = MIN(SAMPLE_BATCH_SIZE, num_points - start);
+
+        try
+        {
+            invalidateRastersCache();
+
+            /* Find rasters with points in them */
+            for (int i = 0; i < batch_size; i++)
+            {
+                try
+                {
+                    selectRasters(points[start + i].lon, points[start + i].lat, i);
+                }
+                catch (const RunTimeException &e)
+                {
+                    mlog(e.level(), "Error finding rasters for point: %s", e.what());
+                }
+            }
+
+            /* Read points from rasters */
+            sampleRasters();
+
+            /* Collect samples in raster order, same as for a single point */
+            raster_t *raster = NULL;
+            const char *key = rasterDict.first(&raster);
+            while (key != NULL)
+            {
+                assert(raster);
+                if (raster->enabled)
+                {
+                    for (int i = 0; i < raster->batch.length(); i++)
+                    {
+                        point_sample_t& ps = raster->batch.get(i);
+                        if (ps.sampled)
+                        {
+                            slists[start + ps.index].add(ps.sample);
+                            num_samples++;
+                        }
+                    }
+                }
+                key = rasterDict.next(&raster);
+            }
+        }
+        catch (const RunTimeException &e)
+        {
+            mlog(e.level(), "Error getting samples: %s", e.what());
+        }
+
+        /* Every raster of the batch stays enabled until it is sampled, so
+         * the cache is only brought back down once the batch is collected */
+        invalidateRastersCache();
+        trimRastersCache();
+    }
+
+    samplingMutex.unlock();
+
+    return num_samples;
+}
+
 
 /*----------------------------------------------------------------------------
  * Destructor
@@ -183,21 +263,19 @@ int VrtRaster::sample (double lon, double lat, List<sample_t> &slist, void* para
 VrtRaster::~VrtRaster(void)
 {
     /* Terminate all reader threads */
+    readerSync.lock();
+    {
+        readersActive = false;
+        readerSync.signal(WORK_SIGNAL, Cond::NOTIFY_ALL);
+    }
+    readerSync.unlock();
+
     for (uint32_t i=0; i < readerCount; i++)
     {
         reader_t *reader = &rasterRreader[i];
         if (reader->thread != NULL)
         {
-            reader->sync->lock();
-            {
-                reader->raster = NULL; /* No raster to read     */
-                reader->run = false;   /* Set run flag to false */
-                reader->sync->signal(0, Cond::NOTIFY_ONE);
-            }
-            reader->sync->unlock();
-
             delete reader->thread;  /* delte thread waits on thread to join */
-            delete reader->sync;
         }
     }
 
@@ -228,7 +306,19 @@ VrtRaster::~VrtRaster(void)
 int VrtRaster::sample(double lon, double lat)
 {
     invalidateRastersCache();
+    selectRasters(lon, lat, 0);
+    sampleRasters();
+
+    return getSampledRastersCount();
+}
 
+/*----------------------------------------------------------------------------
+ * selectRasters
+ *
+ *  adds the point to the batch of each raster it needs to be read from
+ *----------------------------------------------------------------------------*/
+void VrtRaster::selectRasters(double lon, double lat, uint32_t index)
+{
     /* Initial call, open vrt file if not already opened */
     if (vrt.dset == NULL)
     {
@@ -254,8 +344,7 @@ int VrtRaster::sample(double lon, double lat)
         raster_t *raster = NULL;
         if (findCachedRasterWithPoint(p, &raster))
         {
-            raster->enabled = true;
-            raster->point = p;
+            addToBatch(raster, p, index);
 
             /* Found raster with point in cache, no need to look for new tif file */
             findNewTifFiles = false;
@@ -264,12 +353,8 @@ int VrtRaster::sample(double lon, double lat)
 
     if (findNewTifFiles && findTIFfilesWithPoint(p))
     {
-        updateRastersCache(p);
+        updateRastersCache(p, index);
     }
-
-    sampleRasters();
-
-    return getSampledRastersCount();
 }
 
 /******************************************************************************
@@ -280,7 +365,8 @@ int VrtRaster::sample(double lon, double lat)
  * Constructor
  *----------------------------------------------------------------------------*/
 VrtRaster::VrtRaster(lua_State *L, const char *dem_sampling, const int sampling_radius):
-    LuaObject(L, OBJECT_TYPE, LuaMetaName, LuaMetaTable)
+    LuaObject(L, OBJECT_TYPE, LuaMetaName, LuaMetaTable),
+    readerSync(NUM_READER_SIGNALS)
 {
     CHECKPTR(dem_sampling);
 
@@ -308,6 +394,8 @@ VrtRaster::VrtRaster(lua_State *L, const char *dem_sampling, const int sampling_
     rasterRreader = new reader_t[MAX_READER_THREADS];
     bzero(rasterRreader, sizeof(reader_t)*MAX_READER_THREADS);
     readerCount = 0;
+    pendingReads = 0;
+    readersActive = true;
     checkCacheFirst = false;
 }
 
@@ -527,6 +615,7 @@ void VrtRaster::invalidateRastersCache(void)
         raster->point.empty();
         raster->sample.value = INVALID_SAMPLE_VALUE;
         raster->sample.time = 0.0;
+        raster->batch.clear();
         key = rasterDict.next(&raster);
     }
 }
@@ -534,7 +623,7 @@ void VrtRaster::invalidateRastersCache(void)
 /*----------------------------------------------------------------------------
  * updateRastersCache
  *----------------------------------------------------------------------------*/
-void VrtRaster::updateRastersCache(OGRPoint& p)
+void VrtRaster::updateRastersCache(OGRPoint& p, uint32_t index)
 {
     if (tifList->length() == 0)
         return;
@@ -552,8 +641,7 @@ void VrtRaster::updateRastersCache(OGRPoint& p)
         {
             /* Update point to be sampled, mark raster enabled for next sampling */
             assert(raster);
-            raster->enabled = true;
-            raster->point = p;
+            addToBatch(raster, p, index);
         }
         else
         {
@@ -561,16 +649,27 @@ void VrtRaster::updateRastersCache(OGRPoint& p)
             raster = new raster_t;
             assert(raster);
             clearRaster(raster);
-            raster->enabled = true;
-            raster->point = p;
             raster->sample.value = INVALID_SAMPLE_VALUE;
             raster->fileName = fileName;
+            addToBatch(raster, p, index);
             rasterDict.add(key, raster);
         }
     }
 
     /* Maintain cache from getting too big */
-    key = rasterDict.first(&raster);
+    trimRastersCache();
+}
+
+/*----------------------------------------------------------------------------
+ * trimRastersCache
+ *
+ *  closes rasters which are not enabled until the cache is back down to
+ *  MAX_CACHED_RASTERS; rasters still to be sampled are kept
+ *----------------------------------------------------------------------------*/
+void VrtRaster::trimRastersCache(void)
+{
+    raster_t *raster = NULL;
+    const char *key = rasterDict.first(&raster);
     while (key != NULL)
     {
         if (rasterDict.length() <= MAX_CACHED_RASTERS)
@@ -591,91 +690,62 @@ void VrtRaster::updateRastersCache(OGRPoint& p)
 
 /*----------------------------------------------------------------------------
  * createReaderThreads
+ *
+ *  grows the pool of reader threads to one per raster to be read, up to
+ *  MAX_READER_THREADS; with more rasters than that, readers take the
+ *  remaining rasters off the read queue as they finish
  *----------------------------------------------------------------------------*/
 void VrtRaster::createReaderThreads(void)
 {
-    uint32_t threadsNeeded = rasterDict.length();
-    if (threadsNeeded <= readerCount)
-        return;
-
-    uint32_t newThreadsCnt = threadsNeeded - readerCount;
-    // print2term("Creating %d new threads, readerCount: %d, neededThreads: %d\n", newThreadsCnt, readerCount, threadsNeeded);
-
-    for (uint32_t i=0; i < newThreadsCnt; i++)
+    uint32_t threadsNeeded = MIN((uint32_t)rasterDict.length(), (uint32_t)MAX_READER_THREADS);
+    while (readerCount < threadsNeeded)
     {
-        if (readerCount < MAX_READER_THREADS)
-        {
-            reader_t *reader = &rasterRreader[readerCount];
-            reader->raster = NULL;
-            reader->run = true;
-            reader->sync = new Cond();
-            reader->obj = this;
-            reader->sync->lock();
-            {
-                reader->thread = new Thread(readingThread, reader);
-            }
-            reader->sync->unlock();
-            readerCount++;
-        }
-        else
-        {
-            throw RunTimeException(CRITICAL, RTE_ERROR,
-                                   "number of rasters to read: %d, is greater than max reading threads %d\n",
-                                   rasterDict.length(), MAX_READER_THREADS);
-        }
+        reader_t *reader = &rasterRreader[readerCount];
+        reader->obj = this;
+        reader->thread = new Thread(readingThread, reader);
+        readerCount++;
     }
-    assert(readerCount == threadsNeeded);
 }
 
 
 /*----------------------------------------------------------------------------
  * sampleRasters
+ *
+ *  queues each raster with points to read and waits for the readers to
+ *  signal that the last one has been read
  *----------------------------------------------------------------------------*/
 void VrtRaster::sampleRasters(void)
 {
     /* Create additional reader threads if needed */
     createReaderThreads();
 
-    /* For each raster which is marked to be sampled, give it to the reader thread */
-    int signaledReaders = 0;
-    raster_t *raster = NULL;
-    const char *key = rasterDict.first(&raster);
-    int i = 0;
-    while (key != NULL)
+    readerSync.lock();
     {
-        assert(raster);
-        if (raster->enabled)
+        /* Queue each raster which is marked to be sampled */
+        raster_t *raster = NULL;
+        const char *key = rasterDict.first(&raster);
+        while (key != NULL)
         {
-            reader_t *reader = &rasterRreader[i++];
-            reader->sync->lock();
+            assert(raster);
+            if (raster->enabled && raster->batch.length() > 0)
             {
-                reader->raster = raster;
-                reader->sync->signal(0, Cond::NOTIFY_ONE);
-                signaledReaders++;
+                readQ.add(raster);
+                pendingReads++;
             }
-            reader->sync->unlock();
+            key = rasterDict.next(&raster);
         }
-        key = rasterDict.next(&raster);
-    }
-
-    /* Did not signal any reader threads, don't wait */
-    if (signaledReaders == 0)
-        return;
 
-    /* Wait for all reader threads to finish sampling */
-    for (uint32_t j=0; j<readerCount; j++)
-    {
-        reader_t *reader = &rasterRreader[j];
-        raster = NULL;
-        do
+        /* Wait for all queued rasters to be read */
+        if (pendingReads > 0)
         {
-            reader->sync->lock();
+            readerSync.signal(WORK_SIGNAL, Cond::NOTIFY_ALL);
+            while (pendingReads > 0)
             {
-                raster = reader->raster;
+                readerSync.wait(DONE_SIGNAL, SYS_TIMEOUT);
             }
-            reader->sync->unlock();
-        } while (raster != NULL);
+        }
     }
+    readerSync.unlock();
 }
 
 /*----------------------------------------------------------------------------
@@ -684,31 +754,85 @@ void VrtRaster::sampleRasters(void)
 void* VrtRaster::readingThread(void *param)
 {
     reader_t *reader = (reader_t*)param;
-    bool run = true;
+    VrtRaster *obj = reader->obj;
 
-    while (run)
+    obj->readerSync.lock();
+    while (obj->readersActive)
     {
-        reader->sync->lock();
+        /* Wait for raster to work on */
+        if (obj->readQ.length() == 0)
         {
-            /* Wait for raster to work on */
-            while ((reader->raster == NULL) && reader->run)
-                reader->sync->wait(0, SYS_TIMEOUT);
+            obj->readerSync.wait(WORK_SIGNAL, SYS_TIMEOUT);
+            continue;
+        }
 
-            if(reader->raster != NULL)
-            {
-                reader->obj->processRaster(reader->raster, reader->obj);
-                reader->raster = NULL; /* Done with this raster */
-            }
+        /* Take raster off of queue */
+        int last = obj->readQ.length() - 1;
+        raster_t *raster = obj->readQ[last];
+        obj->readQ.remove(last);
+
+        /* Read raster without holding the queue */
+        obj->readerSync.unlock();
+        {
+            obj->processBatch(raster);
+        }
+        obj->readerSync.lock();
 
-            run = reader->run;
+        /* Signal when last raster is read */
+        obj->pendingReads--;
+        if (obj->pendingReads == 0)
+        {
+            obj->readerSync.signal(DONE_SIGNAL, Cond::NOTIFY_ONE);
         }
-        reader->sync->unlock();
     }
+    obj->readerSync.unlock();
 
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * processBatch
+ *
+ *  reads each point of the batch from the raster; the raster's point and
+ *  sample are left with those of the last point, which for a single point
+ *  is what the raster is sampled for
+ *----------------------------------------------------------------------------*/
+void VrtRaster::processBatch(raster_t* raster)
+{
+    for (int i = 0; i < raster->batch.length(); i++)
+    {
+        point_sample_t& ps = raster->batch.get(i);
+
+        raster->point.setX(ps.x);
+        raster->point.setY(ps.y);
+        raster->sampled = false;
+        raster->sample.value = INVALID_SAMPLE_VALUE;
+        raster->sample.time = 0.0;
+
+        processRaster(raster, this);
+
+        ps.sampled = raster->sampled;
+        ps.sample = raster->sample;
+    }
+}
 
+/*----------------------------------------------------------------------------
+ * addToBatch
+ *----------------------------------------------------------------------------*/
+void VrtRaster::addToBatch(raster_t* raster, OGRPoint& p, uint32_t index)
+{
+    point_sample_t ps = {
+        .index = index,
+        .x = p.getX(),
+        .y = p.getY(),
+        .sampled = false,
+        .sample = {INVALID_SAMPLE_VALUE, 0.0}
+    };
+
+    raster->enabled = true;
+    raster->point = p;
+    raster->batch.add(ps);
+}
 
 /*----------------------------------------------------------------------------
  * processRaster
@@ -1151,6 +1275,7 @@ int VrtRaster::getSampledRastersCount(void)
 
 /*----------------------------------------------------------------------------
  * luaSamples - :sample(lon, lat) --> in|out
+ *              :sample({lon, ...}, {lat, ...}) --> {{{value, time}, ...}, ...}, in|out
  *----------------------------------------------------------------------------*/
 int VrtRaster::luaSamples(lua_State *L)
 {
@@ -1164,6 +1289,12 @@ int VrtRaster::luaSamples(lua_State *L)
         /* Get Self */
         lua_obj = (VrtRaster *)getLuaSelf(L, 1);
 
+        /* Sample batch of points */
+        if (lua_istable(L, 2))
+        {
+            return luaBatchSamples(L, lua_obj);
+        }
+
         lua_obj->samplingMutex.lock(); /* Serialize sampling on the same object */
 
         /* Get Coordinates */
@@ -1211,4 +1342,70 @@ int VrtRaster::luaSamples(lua_State *L)
     return returnLuaStatus(L, status, num_ret);
 }
 
+/*----------------------------------------------------------------------------
+ * luaBatchSamples
+ *----------------------------------------------------------------------------*/
+int VrtRaster::luaBatchSamples(lua_State *L, VrtRaster* lua_obj)
+{
+    bool status = false;
+    int num_ret = 1;
+
+    MathLib::coord_t* points = NULL;
+    List<sample_t>* slists = NULL;
+
+    try
+    {
+        /* Get Coordinates */
+        if (!lua_istable(L, 3))
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Latitudes must be supplied as a table");
+
+        int num_points = lua_rawlen(L, 2);
+        if (lua_rawlen(L, 3) != (size_t)num_points)
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Mismatched number of longitudes and latitudes");
+
+        points = new MathLib::coord_t[num_points];
+        for (int i = 0; i < num_points; i++)
+        {
+            lua_rawgeti(L, 2, i + 1);
+            points[i].lon = getLuaFloat(L, -1);
+            lua_pop(L, 1);
+
+            lua_rawgeti(L, 3, i + 1);
+            points[i].lat = getLuaFloat(L, -1);
+            lua_pop(L, 1);
+        }
+
+        /* Get samples */
+        slists = new List<sample_t>[num_points];
+        int num_samples = lua_obj->sample(points, num_points, slists);
+
+        /* Create return table, one table of samples per point */
+        lua_createtable(L, num_points, 0);
+        for (int i = 0; i < num_points; i++)
+        {
+            lua_createtable(L, slists[i].length(), 0);
+            for (int j = 0; j < slists[i].length(); j++)
+            {
+                sample_t& sample = slists[i].get(j);
+                lua_createtable(L, 0, 2);
+                LuaEngine::setAttrNum(L, "value", sample.value);
+                LuaEngine::setAttrNum(L, "time", sample.time);
+                lua_rawseti(L, -2, j + 1);
+            }
+            lua_rawseti(L, -2, i + 1);
+        }
 
+        num_ret++;
+        status = num_samples > 0;
+    }
+    catch (const RunTimeException &e)
+    {
+        mlog(e.level(), "Error getting batch samples: %s", e.what());
+    }
+
+    delete [] points;
+    delete [] slists;
+
+    /* Return Status */
+    return returnLuaStatus(L, status, num_ret);
+}
@@ -38,6 +38,8 @@
 
 #include "LuaObject.h"
 #include "OsApi.h"
+#include "List.h"
+#include "MathLib.h"
 #include "GeoRaster.h"
 #include <ogr_geometry.h>
 #include <ogrsf_frmts.h>
@@ -58,6 +60,7 @@ class VrtRaster: public LuaObject
         static const int   INVALID_SAMPLE_VALUE = -1000000;
         static const int   MAX_READER_THREADS = 200;
         static const int   MAX_CACHED_RASTERS = 10;
+        static const int   SAMPLE_BATCH_SIZE = 4096; // points grouped by raster at a time
 
         static const char* OBJECT_TYPE;
         static const char* LuaMetaName;
@@ -73,6 +76,15 @@ class VrtRaster: public LuaObject
         } sample_t;
 
 
+        typedef struct {
+            uint32_t        index;      // point within the batch being sampled
+            double          x;          // point in the raster's CRS
+            double          y;
+            bool            sampled;
+            sample_t        sample;
+        } point_sample_t;
+
+
         typedef struct {
             std::string     fileName;
             VRTDataset*     dset;
@@ -109,15 +121,15 @@ class VrtRaster: public LuaObject
             /* Last sample information */
             OGRPoint point;
             sample_t sample;
+
+            /* Points of the batch inside this raster */
+            List<point_sample_t> batch;
         } raster_t;
 
 
         typedef struct {
             VrtRaster*      obj;
             Thread*         thread;
-            raster_t*       raster;
-            Cond*           sync;
-            bool            run;
         } reader_t;
 
 
@@ -132,6 +144,7 @@ class VrtRaster: public LuaObject
         static int              luaCreate       (lua_State* L);
         static bool             registerRaster  (const char* _name, factory_t create);
         int                     sample          (double lon, double lat, List<sample_t> &slist, void* param=NULL);
+        int                     sample          (const MathLib::coord_t* points, int num_points, List<sample_t>* slists);
         virtual                ~VrtRaster       (void);
 
     protected:
@@ -157,6 +170,12 @@ class VrtRaster: public LuaObject
          * Data
          *--------------------------------------------------------------------*/
 
+        typedef enum {
+            WORK_SIGNAL = 0,
+            DONE_SIGNAL = 1,
+            NUM_READER_SIGNALS = 2
+        } reader_signal_t;
+
         static Mutex factoryMut;
         static Dictionary<factory_t> factories;
 
@@ -168,6 +187,11 @@ class VrtRaster: public LuaObject
         reader_t*             rasterRreader;
         uint32_t              readerCount;
 
+        Cond                  readerSync;     // guards the read queue below
+        List<raster_t*>       readQ;          // rasters waiting for a reader
+        int                   pendingReads;   // rasters queued or being read
+        bool                  readersActive;
+
         GDALRIOResampleAlg    sampleAlg;
         int32_t radius;
 
@@ -179,19 +203,24 @@ class VrtRaster: public LuaObject
         static int luaBoundingBox(lua_State *L);
         static int luaCellSize(lua_State *L);
         static int luaSamples(lua_State *L);
+        static int luaBatchSamples(lua_State *L, VrtRaster* lua_obj);
 
         static void* readingThread (void *param);
 
         void createReaderThreads      (void);
         void processRaster            (raster_t* raster, VrtRaster* obj);
+        void processBatch             (raster_t* raster);
+        void selectRasters            (double lon, double lat, uint32_t index);
+        void addToBatch               (raster_t* raster, OGRPoint &p, uint32_t index);
         bool findTIFfilesWithPoint    (OGRPoint &p);
-        void updateRastersCache       (OGRPoint &p);
+        void updateRastersCache       (OGRPoint &p, uint32_t index);
         bool vrtContainsPoint         (OGRPoint &p);
         bool rasterContainsPoint      (raster_t *raster, OGRPoint &p);
         bool findCachedRasterWithPoint(OGRPoint &p, raster_t **raster);
         int  sample                   (double lon, double lat);
         void sampleRasters            (void);
         void invalidateRastersCache   (void);
+        void trimRastersCache         (void);
         int  getSampledRastersCount   (void);
         void clearRaster              (raster_t *raster);
         void clearVrt                 (vrt_t *_vrt);
@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "H5BlockCache.h"
+#include "OsApi.h"
+#include "EventLib.h"
+#include "StringLib.h"
+#include "List.h"
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* H5BlockCache::METRIC_CATEGORY = "h5";
+
+H5BlockCache::stripe_t H5BlockCache::stripes[NUM_STRIPES];
+Mutex H5BlockCache::configMut;
+int64_t H5BlockCache::maxBytes = 0;
+int32_t H5BlockCache::hitMetricId = EventLib::INVALID_METRIC;
+int32_t H5BlockCache::missMetricId = EventLib::INVALID_METRIC;
+int32_t H5BlockCache::waitMetricId = EventLib::INVALID_METRIC;
+int32_t H5BlockCache::evictMetricId = EventLib::INVALID_METRIC;
+
+/******************************************************************************
+ * H5 BLOCK CACHE CLASS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::init (int64_t max_bytes)
+{
+    for(int s = 0; s < NUM_STRIPES; s++)
+    {
+        stripes[s].head = NULL;
+        stripes[s].tail = NULL;
+        stripes[s].bytes = 0;
+        stripes[s].budget = 0;
+    }
+
+    hitMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "cache_hits");
+    missMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "cache_misses");
+    waitMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "cache_waits");
+    evictMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "cache_evictions");
+
+    configure(max_bytes);
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::deinit (void)
+{
+    configure(0);
+}
+
+/*----------------------------------------------------------------------------
+ * configure
+ *
+ *  sets the byte budget of the cache; zero disables the cache and frees
+ *  every block not currently in use
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::configure (int64_t max_bytes)
+{
+    configMut.lock();
+    {
+        maxBytes = MAX(max_bytes, 0);
+        for(int s = 0; s < NUM_STRIPES; s++)
+        {
+            stripes[s].cond.lock();
+            {
+                stripes[s].budget = maxBytes / NUM_STRIPES;
+                evict(&stripes[s]);
+            }
+            stripes[s].cond.unlock();
+        }
+    }
+    configMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * enabled
+ *----------------------------------------------------------------------------*/
+bool H5BlockCache::enabled (void)
+{
+    configMut.lock();
+    bool is_enabled = maxBytes > 0;
+    configMut.unlock();
+    return is_enabled;
+}
+
+/*----------------------------------------------------------------------------
+ * read - single
+ *----------------------------------------------------------------------------*/
+int64_t H5BlockCache::read (const char* resource_key, Asset::IODriver* driver, uint8_t* data, int64_t size, uint64_t pos)
+{
+    Asset::IODriver::extent_t extent = {
+        .data = data,
+        .size = size,
+        .pos = pos,
+        .bytes = 0
+    };
+
+    read(resource_key, driver, &extent, 1);
+    return extent.bytes;
+}
+
+/*----------------------------------------------------------------------------
+ * read - vectored
+ *
+ *  fills the extents from the cached blocks of the resource; the blocks that
+ *  no other reader has are fetched from the driver with a single vectored
+ *  read, and the blocks another reader is already fetching are waited on
+ *----------------------------------------------------------------------------*/
+int64_t H5BlockCache::read (const char* resource_key, Asset::IODriver* driver, Asset::IODriver::extent_t* extents, int num_extents)
+{
+    int64_t total_bytes = 0;
+
+    /* Determine Blocks Needed */
+    List<uint64_t> indices;
+    for(int i = 0; i < num_extents; i++)
+    {
+        if(extents[i].size <= 0) continue;
+        uint64_t first = extents[i].pos / BLOCK_SIZE;
+        uint64_t last = (extents[i].pos + extents[i].size - 1) / BLOCK_SIZE;
+        for(uint64_t b = first; b <= last; b++) indices.add(b);
+    }
+    indices.sort();
+
+    /* Pin Blocks (in Index Order, Once Each) */
+    pin_t* pins = new pin_t [indices.length()];
+    int num_pins = 0;
+    for(int i = 0; i < indices.length(); i++)
+    {
+        if(num_pins > 0 && pins[num_pins - 1].block->index == indices[i]) continue;
+        SafeString key("%s:%lu", resource_key, indices[i]);
+        pins[num_pins].stripe = getStripe(key.getString());
+        pins[num_pins].block = pin(pins[num_pins].stripe, key.getString(), indices[i], &pins[num_pins].owner);
+        num_pins++;
+    }
+
+    try
+    {
+        /* Fetch Blocks Owned by this Reader */
+        fetch(driver, pins, num_pins);
+
+        /* Wait on Blocks Fetched by other Readers */
+        for(int p = 0; p < num_pins; p++)
+        {
+            if(pins[p].owner) continue;
+
+            stripe_t* stripe = pins[p].stripe;
+            state_t state;
+            stripe->cond.lock();
+            {
+                while(pins[p].block->state == PENDING) stripe->cond.wait(0, SYS_TIMEOUT);
+                state = pins[p].block->state;
+            }
+            stripe->cond.unlock();
+
+            if(state == FAILED)
+            {
+                throw RunTimeException(CRITICAL, RTE_ERROR, "failed to read block %lu of %s", pins[p].block->index, resource_key);
+            }
+        }
+
+        /* Copy Blocks into Extents */
+        int p = 0;
+        for(int i = 0; i < num_extents; i++)
+        {
+            extents[i].bytes = 0;
+            if(extents[i].size <= 0) continue;
+
+            uint64_t extent_end = extents[i].pos + extents[i].size;
+            uint64_t first = extents[i].pos / BLOCK_SIZE;
+            uint64_t last = (extent_end - 1) / BLOCK_SIZE;
+            for(uint64_t b = first; b <= last; b++)
+            {
+                /* Find Pinned Block (pins are in index order) */
+                if(pins[p].block->index > b) p = 0;
+                while(pins[p].block->index < b) p++;
+                block_t* block = pins[p].block;
+
+                /* Copy Overlap */
+                uint64_t block_start = b * BLOCK_SIZE;
+                uint64_t copy_start = MAX(extents[i].pos, block_start);
+                uint64_t copy_end = MIN(extent_end, block_start + block->size);
+                if(copy_end <= copy_start) break; // end of resource
+                LocalLib::copy(&extents[i].data[copy_start - extents[i].pos], &block->data[copy_start - block_start], copy_end - copy_start);
+                extents[i].bytes += copy_end - copy_start;
+                if(block->size < BLOCK_SIZE) break; // end of resource
+            }
+
+            total_bytes += extents[i].bytes;
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        for(int p = 0; p < num_pins; p++) unpin(pins[p].stripe, pins[p].block);
+        delete [] pins;
+        throw;
+    }
+
+    /* Unpin Blocks */
+    for(int p = 0; p < num_pins; p++) unpin(pins[p].stripe, pins[p].block);
+    delete [] pins;
+
+    return total_bytes;
+}
+
+/*----------------------------------------------------------------------------
+ * luaCache - cache([<max bytes>]) -> max bytes, bytes in use
+ *----------------------------------------------------------------------------*/
+int H5BlockCache::luaCache (lua_State* L)
+{
+    try
+    {
+        /* Set Byte Budget */
+        if(lua_gettop(L) >= 1)
+        {
+            long max_bytes = LuaObject::getLuaInteger(L, 1);
+            configure(max_bytes);
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error configuring block cache: %s", e.what());
+    }
+
+    /* Sum Bytes in Use */
+    int64_t bytes = 0;
+    for(int s = 0; s < NUM_STRIPES; s++)
+    {
+        stripes[s].cond.lock();
+        {
+            bytes += stripes[s].bytes;
+        }
+        stripes[s].cond.unlock();
+    }
+
+    configMut.lock();
+    int64_t max_bytes = maxBytes;
+    configMut.unlock();
+
+    lua_pushinteger(L, max_bytes);
+    lua_pushinteger(L, bytes);
+    return 2;
+}
+
+/*----------------------------------------------------------------------------
+ * getStripe
+ *----------------------------------------------------------------------------*/
+H5BlockCache::stripe_t* H5BlockCache::getStripe (const char* key)
+{
+    /* FNV-1a Hash of Key */
+    uint32_t hash = 2166136261U;
+    for(const char* c = key; *c != '\0'; c++)
+    {
+        hash ^= (uint8_t)*c;
+        hash *= 16777619U;
+    }
+    return &stripes[hash % NUM_STRIPES];
+}
+
+/*----------------------------------------------------------------------------
+ * pin
+ *
+ *  returns the block for the key with a reference held on it; if the block
+ *  is not in the cache a pending block is created and the caller becomes
+ *  its owner, responsible for fetching it
+ *----------------------------------------------------------------------------*/
+H5BlockCache::block_t* H5BlockCache::pin (stripe_t* stripe, const char* key, uint64_t index, bool* owner)
+{
+    block_t* block = NULL;
+    int32_t metric_id;
+
+    stripe->cond.lock();
+    {
+        if(stripe->lookup.find(key, &block))
+        {
+            /* Use Existing Block */
+            block->refs++;
+            touch(stripe, block);
+            metric_id = (block->state == READY) ? hitMetricId : waitMetricId;
+            *owner = false;
+        }
+        else
+        {
+            /* Create Pending Block */
+            block = new block_t;
+            block->index = index;
+            block->data = new uint8_t [BLOCK_SIZE];
+            block->size = 0;
+            block->refs = 1;
+            block->linked = true;
+            block->state = PENDING;
+            block->prev = NULL;
+            block->next = stripe->head;
+            block->key = StringLib::duplicate(key);
+            if(stripe->head) stripe->head->prev = block;
+            else stripe->tail = block;
+            stripe->head = block;
+            stripe->lookup.add(key, block);
+            stripe->bytes += BLOCK_SIZE;
+            evict(stripe);
+            metric_id = missMetricId;
+            *owner = true;
+        }
+    }
+    stripe->cond.unlock();
+
+    EventLib::incrementMetric(metric_id);
+    return block;
+}
+
+/*----------------------------------------------------------------------------
+ * unpin
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::unpin (stripe_t* stripe, block_t* block)
+{
+    bool free_block = false;
+
+    stripe->cond.lock();
+    {
+        block->refs--;
+        if(block->refs == 0)
+        {
+            if(!block->linked) free_block = true; // already evicted or failed
+            else evict(stripe); // may have been held over budget
+        }
+    }
+    stripe->cond.unlock();
+
+    if(free_block)
+    {
+        delete [] block->data;
+        delete [] block->key;
+        delete block;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * unlink - stripe must be locked
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::unlink (stripe_t* stripe, block_t* block)
+{
+    if(!block->linked) return;
+
+    if(block->prev) block->prev->next = block->next;
+    else stripe->head = block->next;
+    if(block->next) block->next->prev = block->prev;
+    else stripe->tail = block->prev;
+    block->prev = NULL;
+    block->next = NULL;
+
+    stripe->lookup.remove(block->key);
+    stripe->bytes -= BLOCK_SIZE;
+    block->linked = false;
+}
+
+/*----------------------------------------------------------------------------
+ * touch - stripe must be locked
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::touch (stripe_t* stripe, block_t* block)
+{
+    if(stripe->head == block) return;
+
+    /* Remove from Current Position */
+    block->prev->next = block->next;
+    if(block->next) block->next->prev = block->prev;
+    else stripe->tail = block->prev;
+
+    /* Insert at Head */
+    block->prev = NULL;
+    block->next = stripe->head;
+    stripe->head->prev = block;
+    stripe->head = block;
+}
+
+/*----------------------------------------------------------------------------
+ * evict - stripe must be locked
+ *
+ *  frees least recently used blocks until the stripe is within its share
+ *  of the budget; blocks in use (including pending ones) are skipped
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::evict (stripe_t* stripe)
+{
+    block_t* block = stripe->tail;
+    while(block && stripe->bytes > stripe->budget)
+    {
+        block_t* prev = block->prev;
+        if(block->refs == 0)
+        {
+            unlink(stripe, block);
+            delete [] block->data;
+            delete [] block->key;
+            delete block;
+            EventLib::incrementMetric(evictMetricId);
+        }
+        block = prev;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * fetch
+ *
+ *  reads the blocks owned by the caller in one vectored read and wakes any
+ *  readers waiting on them; on failure the blocks are dropped from the
+ *  cache so that a later read tries again
+ *----------------------------------------------------------------------------*/
+void H5BlockCache::fetch (Asset::IODriver* driver, pin_t* pins, int num_pins)
+{
+    /* Build Extents for Owned Blocks */
+    Asset::IODriver::extent_t* extents = new Asset::IODriver::extent_t [num_pins];
+    int num_extents = 0;
+    for(int p = 0; p < num_pins; p++)
+    {
+        if(!pins[p].owner) continue;
+        extents[num_extents].data = pins[p].block->data;
+        extents[num_extents].size = BLOCK_SIZE;
+        extents[num_extents].pos = pins[p].block->index * BLOCK_SIZE;
+        extents[num_extents].bytes = 0;
+        num_extents++;
+    }
+
+    /* Read Blocks */
+    bool status = true;
+    char error[MAX_STR_SIZE] = {'\0'};
+    if(num_extents > 0)
+    {
+        try
+        {
+            driver->ioReadv(extents, num_extents);
+        }
+        catch(const RunTimeException& e)
+        {
+            StringLib::copy(error, e.what(), MAX_STR_SIZE);
+            status = false;
+        }
+    }
+
+    /* Complete Owned Blocks */
+    int e = 0;
+    for(int p = 0; p < num_pins; p++)
+    {
+        if(!pins[p].owner) continue;
+        stripe_t* stripe = pins[p].stripe;
+        block_t* block = pins[p].block;
+        stripe->cond.lock();
+        {
+            if(status)
+            {
+                block->size = extents[e].bytes;
+                block->state = READY;
+            }
+            else
+            {
+                block->state = FAILED;
+                unlink(stripe, block);
+            }
+            stripe->cond.signal();
+        }
+        stripe->cond.unlock();
+        e++;
+    }
+
+    delete [] extents;
+
+    if(!status)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "%s", error);
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __h5_block_cache__
+#define __h5_block_cache__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+#include "Asset.h"
+#include "Dictionary.h"
+#include "LuaEngine.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#ifndef H5CORO_BLOCK_SIZE
+#define H5CORO_BLOCK_SIZE 0x100000 // size (and alignment) of blocks held in the shared cache
+#endif
+
+#ifndef H5CORO_BLOCK_CACHE_STRIPES
+#define H5CORO_BLOCK_CACHE_STRIPES 16
+#endif
+
+/******************************************************************************
+ * H5 BLOCK CACHE CLASS
+ *
+ *  Process-wide cache of file blocks shared by every H5Coro reader, keyed by
+ *  the resource being read and the block aligned offset into it.  Blocks are
+ *  spread across lock stripes, each evicting its least recently used blocks
+ *  once over its share of the byte budget; a block being read is marked
+ *  pending so that readers missing on the same block wait for the one fetch
+ ******************************************************************************/
+
+class H5BlockCache
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int64_t    BLOCK_SIZE = H5CORO_BLOCK_SIZE;
+        static const int        NUM_STRIPES = H5CORO_BLOCK_CACHE_STRIPES;
+        static const char*      METRIC_CATEGORY;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void     init        (int64_t max_bytes);
+        static void     deinit      (void);
+        static void     configure   (int64_t max_bytes);
+        static bool     enabled     (void);
+        static int64_t  read        (const char* resource_key, Asset::IODriver* driver, uint8_t* data, int64_t size, uint64_t pos);
+        static int64_t  read        (const char* resource_key, Asset::IODriver* driver, Asset::IODriver::extent_t* extents, int num_extents);
+        static int      luaCache    (lua_State* L);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef enum {
+            PENDING,
+            READY,
+            FAILED
+        } state_t;
+
+        typedef struct block {
+            uint64_t        index;      // block number within resource
+            uint8_t*        data;       // BLOCK_SIZE buffer
+            int64_t         size;       // valid bytes (short at end of resource)
+            int             refs;       // readers using block, cannot be freed while non-zero
+            bool            linked;     // in stripe's lookup and lru list
+            state_t         state;
+            struct block*   prev;       // more recently used
+            struct block*   next;       // less recently used
+            char*           key;
+        } block_t;
+
+        typedef struct {
+            Cond                    cond;   // protects stripe and signals completed fetches
+            Dictionary<block_t*>    lookup;
+            block_t*                head;   // most recently used
+            block_t*                tail;   // least recently used
+            int64_t                 bytes;
+            int64_t                 budget; // stripe's share of the cache's max bytes
+        } stripe_t;
+
+        typedef struct {
+            block_t*    block;
+            stripe_t*   stripe;
+            bool        owner;  // this reader fetches the block
+        } pin_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static stripe_t*    getStripe   (const char* key);
+        static block_t*     pin         (stripe_t* stripe, const char* key, uint64_t index, bool* owner);
+        static void         unpin       (stripe_t* stripe, block_t* block);
+        static void         unlink      (stripe_t* stripe, block_t* block);
+        static void         touch       (stripe_t* stripe, block_t* block);
+        static void         evict       (stripe_t* stripe);
+        static void         fetch       (Asset::IODriver* driver, pin_t* pins, int num_pins);
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static stripe_t     stripes[NUM_STRIPES];
+        static Mutex        configMut;  // protects maxBytes
+        static int64_t      maxBytes;
+        static int32_t      hitMetricId;
+        static int32_t      missMetricId;
+        static int32_t      waitMetricId;
+        static int32_t      evictMetricId;
+};
+
+#endif  /* __h5_block_cache__ */
@@ -34,11 +34,12 @@
  ******************************************************************************/
 
 #include "H5Coro.h"
+#include "H5BlockCache.h"
+#include "H5Filter.h"
 #include "core.h"
 
 #include <assert.h>
 #include <stdexcept>
-#include <zlib.h>
 
 /******************************************************************************
  * DEFINES
@@ -58,6 +59,96 @@
 
 #define H5_INVALID(var)  (var == (0xFFFFFFFFFFFFFFFFllu >> (64 - (sizeof(var) * 8))))
 
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * convertElements
+ *
+ *  copies rows of width elements spaced stride elements apart into a packed
+ *  destination, converting each element to the destination type; contiguous
+ *  data and single column data get their own loops so that the compiler can
+ *  vectorize them
+ *----------------------------------------------------------------------------*/
+template <typename S, typename D>
+static void convertElements (D* __restrict__ dst, const S* __restrict__ src, int64_t rows, int64_t width, int64_t stride)
+{
+    if(width == stride || rows == 1)
+    {
+        int64_t elements = rows * width;
+        for(int64_t i = 0; i < elements; i++)
+        {
+            dst[i] = (D)src[i];
+        }
+    }
+    else if(width == 1)
+    {
+        for(int64_t row = 0; row < rows; row++)
+        {
+            dst[row] = (D)src[row * stride];
+        }
+    }
+    else
+    {
+        for(int64_t row = 0; row < rows; row++)
+        {
+            const S* __restrict__ s = &src[row * stride];
+            D* __restrict__ d = &dst[row * width];
+            for(int64_t i = 0; i < width; i++)
+            {
+                d[i] = (D)s[i];
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * convertData
+ *----------------------------------------------------------------------------*/
+template <typename D>
+static bool convertData (D* dst, const uint8_t* src, RecordObject::fieldType_t datatype, int64_t rows, int64_t width, int64_t stride)
+{
+    switch(datatype)
+    {
+        case RecordObject::INT8:    convertElements(dst, (const int8_t*)src,   rows, width, stride);  return true;
+        case RecordObject::UINT8:   convertElements(dst, (const uint8_t*)src,  rows, width, stride);  return true;
+        case RecordObject::INT16:   convertElements(dst, (const int16_t*)src,  rows, width, stride);  return true;
+        case RecordObject::UINT16:  convertElements(dst, (const uint16_t*)src, rows, width, stride);  return true;
+        case RecordObject::INT32:   convertElements(dst, (const int32_t*)src,  rows, width, stride);  return true;
+        case RecordObject::UINT32:  convertElements(dst, (const uint32_t*)src, rows, width, stride);  return true;
+        case RecordObject::INT64:   convertElements(dst, (const int64_t*)src,  rows, width, stride);  return true;
+        case RecordObject::UINT64:  convertElements(dst, (const uint64_t*)src, rows, width, stride);  return true;
+        case RecordObject::FLOAT:   convertElements(dst, (const float*)src,    rows, width, stride);  return true;
+        case RecordObject::DOUBLE:  convertElements(dst, (const double*)src,   rows, width, stride);  return true;
+        default:                    return false;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * gatherData
+ *
+ *  same as convertData but keeps the elements in their original type
+ *----------------------------------------------------------------------------*/
+static bool gatherData (uint8_t* dst, const uint8_t* src, int typesize, int64_t rows, int64_t width, int64_t stride)
+{
+    switch(typesize)
+    {
+        case 1:     convertElements((uint8_t*)dst,  (const uint8_t*)src,  rows, width, stride);  return true;
+        case 2:     convertElements((uint16_t*)dst, (const uint16_t*)src, rows, width, stride);  return true;
+        case 4:     convertElements((uint32_t*)dst, (const uint32_t*)src, rows, width, stride);  return true;
+        case 8:     convertElements((uint64_t*)dst, (const uint64_t*)src, rows, width, stride);  return true;
+        default:
+        {
+            for(int64_t row = 0; row < rows; row++)
+            {
+                LocalLib::copy(&dst[row * width * typesize], &src[row * stride * typesize], width * typesize);
+            }
+            return true;
+        }
+    }
+}
+
 /******************************************************************************
  * H5 FUTURE CLASS
  ******************************************************************************/
@@ -132,8 +223,73 @@ H5Future::rc_t H5Future::wait (int timeout)
 /*----------------------------------------------------------------------------
  * Static Data
  *----------------------------------------------------------------------------*/
-H5FileBuffer::meta_repo_t H5FileBuffer::metaRepo(MAX_META_STORE);
-Mutex H5FileBuffer::metaMutex;
+H5FileBuffer::meta_shard_t H5FileBuffer::metaRepo[META_REPO_SHARDS];
+const char* H5FileBuffer::snapshotDir = NULL;
+Mutex H5FileBuffer::snapshotMut;
+Dictionary<bool> H5FileBuffer::snapshotChecked;
+int32_t H5FileBuffer::restoreMetricId = EventLib::INVALID_METRIC;
+Cond H5FileBuffer::chunkSync(CHUNK_NUM_SIGS);
+List<H5FileBuffer::chunk_job_t*> H5FileBuffer::chunkQueue;
+bool H5FileBuffer::chunkActive = false;
+Thread** H5FileBuffer::chunkPids = NULL;
+H5FileBuffer::chunk_worker_t* H5FileBuffer::chunkPool = NULL;
+int H5FileBuffer::chunkPoolSize = 0;
+int32_t H5FileBuffer::chunkMetricId = EventLib::INVALID_METRIC;
+
+/*----------------------------------------------------------------------------
+ * init
+ *
+ *  starts the pool of chunk workers shared by all reads; the workers, along
+ *  with their drivers and scratch buffers, live until deinit so that the
+ *  connections a driver makes on a worker's thread are kept between reads
+ *----------------------------------------------------------------------------*/
+void H5FileBuffer::init (int num_chunk_workers)
+{
+    restoreMetricId = EventLib::registerMetric("h5", EventLib::COUNTER, "%s", "snapshot_restores");
+    chunkMetricId = EventLib::registerMetric("h5", EventLib::COUNTER, "%s", "chunk_jobs");
+
+    if(num_chunk_workers > 0)
+    {
+        chunkActive = true;
+        chunkPoolSize = num_chunk_workers;
+        chunkPool = new chunk_worker_t [chunkPoolSize];
+        chunkPids = new Thread* [chunkPoolSize];
+        for(int w = 0; w < chunkPoolSize; w++)
+        {
+            chunkPool[w].driver = NULL;
+            chunkPool[w].driver_asset = NULL;
+            chunkPool[w].driver_key = NULL;
+            chunkPool[w].chunk_buffer = NULL;
+            chunkPool[w].filter_buffer = NULL;
+            chunkPool[w].buffer_size = 0;
+            chunkPids[w] = new Thread(chunkThread, &chunkPool[w]);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void H5FileBuffer::deinit (void)
+{
+    if(chunkActive)
+    {
+        chunkActive = false;
+        for(int w = 0; w < chunkPoolSize; w++)
+        {
+            delete chunkPids[w]; // performs join
+            delete chunkPool[w].driver;
+            delete [] chunkPool[w].driver_key;
+            delete [] chunkPool[w].chunk_buffer;
+            delete [] chunkPool[w].filter_buffer;
+        }
+        delete [] chunkPids;
+        delete [] chunkPool;
+        chunkPids = NULL;
+        chunkPool = NULL;
+        chunkPoolSize = 0;
+    }
+}
 
 /*----------------------------------------------------------------------------
  * Constructor
@@ -148,6 +304,12 @@ H5FileBuffer::io_context_t::io_context_t (void):
     l1_cache_replace = 0;
     l2_cache_replace = 0;
     bytes_read = 0;
+    range_requests = 0;
+    range_merged = 0;
+    range_overread = 0;
+    chunk_workers = H5Coro::chunkWorkers;
+    coalesce_gap = H5CORO_COALESCE_GAP;
+    max_inflight = H5CORO_MAX_INFLIGHT;
 }
 
 /*----------------------------------------------------------------------------
@@ -183,13 +345,16 @@ H5FileBuffer::io_context_t::~io_context_t (void)
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-H5FileBuffer::H5FileBuffer (info_t* info, io_context_t* context, const Asset* asset, const char* resource, const char* dataset, long startrow, long numrows, bool _error_checking, bool _verbose, bool _meta_only)
+H5FileBuffer::H5FileBuffer (info_t* info, io_context_t* context, const Asset* asset, const char* resource, const char* dataset, long startrow, long numrows, bool _error_checking, bool _verbose, bool _meta_only, uint8_t* _buffer, int64_t _buffer_size)
 {
     assert(asset);
     assert(resource);
     assert(dataset);
 
     /* Initialize Class Data */
+    ioAsset                 = asset;
+    ioResource              = StringLib::duplicate(resource);
+    ioCacheKey              = NULL;
     ioDriver                = NULL;
     ioContextLocal          = true;
     ioContext               = NULL;
@@ -197,6 +362,8 @@ H5FileBuffer::H5FileBuffer (info_t* info, io_context_t* context, const Asset* as
     ioPostPrefetch          = false;
     dataChunkBuffer         = NULL;
     dataChunkFilterBuffer   = NULL;
+    dataUserBuffer          = _buffer;
+    dataUserBufferSize      = _buffer_size;
     datasetName             = StringLib::duplicate(dataset);
     datasetPrint            = StringLib::duplicate(dataset);
     datasetStartRow         = startrow;
@@ -222,6 +389,11 @@ H5FileBuffer::H5FileBuffer (info_t* info, io_context_t* context, const Asset* as
     {
         /* Initialize Driver */
         ioDriver = asset->createDriver(resource);
+        if(H5BlockCache::enabled())
+        {
+            SafeString cache_key("%s://%s/%s", asset->getFormat(), asset->getPath(), resource);
+            ioCacheKey = cache_key.getString(true);
+        }
 
         /* Set or Create I/O Context */
         if(context)
@@ -238,16 +410,8 @@ H5FileBuffer::H5FileBuffer (info_t* info, io_context_t* context, const Asset* as
         /* Check Meta Repository */
         char meta_url[MAX_META_NAME_SIZE];
         metaGetUrl(meta_url, resource, dataset);
-        uint64_t meta_key = metaGetKey(meta_url);
-        bool meta_found = false;
-        metaMutex.lock();
-        {
-            if(metaRepo.find(meta_key, meta_repo_t::MATCH_EXACTLY, &metaData, true))
-            {
-                meta_found = StringLib::match(metaData.url, meta_url, MAX_META_NAME_SIZE);
-            }
-        }
-        metaMutex.unlock();
+        bool meta_found = metaFind(meta_url, &metaData);
+        if(!meta_found) meta_found = metaRestore(meta_url);
 
         if(!meta_found)
         {
@@ -284,23 +448,12 @@ H5FileBuffer::H5FileBuffer (info_t* info, io_context_t* context, const Asset* as
         readDataset(info);
 
         /* Add to Meta Repository */
-        metaMutex.lock();
-        {
-            /* Remove Oldest Entry if Repository is Full */
-            if(metaRepo.isfull())
-            {
-                metaRepo.remove(metaRepo.first(NULL));
-            }
-
-            /* Add Entry to Repository */
-            metaRepo.add(meta_key, metaData, true);
-        }
-        metaMutex.unlock();
+        metaAdd(metaData);
     }
     catch(const RunTimeException& e)
     {
         /* Clean Up Data Allocations */
-        if(info->data) delete [] info->data;
+        if(info->data && info->data != dataUserBuffer) delete [] info->data;
         info->data= NULL;
         info->datasize = 0;
 
@@ -320,6 +473,98 @@ H5FileBuffer::~H5FileBuffer (void)
     tearDown();
 }
 
+/*----------------------------------------------------------------------------
+ * setSnapshotDir
+ *
+ *  sets the directory that metadata snapshots are written to and restored
+ *  from; NULL disables snapshots
+ *----------------------------------------------------------------------------*/
+void H5FileBuffer::setSnapshotDir (const char* dir)
+{
+    snapshotMut.lock();
+    {
+        if(snapshotDir) delete [] snapshotDir;
+        snapshotDir = dir ? StringLib::duplicate(dir) : NULL;
+        snapshotChecked.clear();
+    }
+    snapshotMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * getSnapshotDir
+ *
+ *  copies the snapshot directory into the supplied buffer; returns false
+ *  when snapshots are disabled
+ *----------------------------------------------------------------------------*/
+bool H5FileBuffer::getSnapshotDir (char* dir, int size)
+{
+    bool status = false;
+    snapshotMut.lock();
+    {
+        if(snapshotDir)
+        {
+            StringLib::copy(dir, snapshotDir, size);
+            status = true;
+        }
+    }
+    snapshotMut.unlock();
+    return status;
+}
+
+/*----------------------------------------------------------------------------
+ * metaSnapshot
+ *
+ *  writes the meta repository entries of the datasets of a resource to a
+ *  sidecar file named by the resource's tag (e.g. its ETag), warming up the
+ *  datasets that are not yet in the repository; datasets that cannot be
+ *  read are left out of the snapshot; returns the number of entries written
+ *----------------------------------------------------------------------------*/
+int H5FileBuffer::metaSnapshot (const Asset* asset, const char* resource, const char** datasets, int num_datasets)
+{
+    /* Get Tag of Resource */
+    char tag[META_SNAPSHOT_TAG_SIZE];
+    Asset::IODriver* driver = asset->createDriver(resource);
+    bool tagged = driver->ioTag(tag, META_SNAPSHOT_TAG_SIZE);
+    delete driver;
+    if(!tagged)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "unable to get tag of %s", resource);
+    }
+
+    /* Build Path to Sidecar */
+    char path[MAX_STR_SIZE];
+    if(!metaSnapshotPath(path, MAX_STR_SIZE, tag))
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "snapshot directory not set");
+    }
+
+    /* Collect Entries */
+    meta_entry_t* entries = new meta_entry_t[MAX(num_datasets, 1)];
+    meta_snapshot_hdr_t hdr = {META_SNAPSHOT_MAGIC, META_SNAPSHOT_VERSION, sizeof(meta_entry_t), 0};
+    hdr.numentries = metaCollect(asset, resource, datasets, num_datasets, NULL, entries);
+
+    /* Write Sidecar (renamed into place so readers never see a partial file) */
+    SafeString tmp_path("%s.%ld.tmp", path, Thread::getId());
+    FILE* fp = fopen(tmp_path.getString(), "wb");
+    bool written = false;
+    if(fp)
+    {
+        written = (fwrite(&hdr, sizeof(hdr), 1, fp) == 1) &&
+                  (fwrite(entries, sizeof(meta_entry_t), hdr.numentries, fp) == hdr.numentries);
+        written = (fclose(fp) == 0) && written;
+        if(written) written = (rename(tmp_path.getString(), path) == 0);
+        if(!written) remove(tmp_path.getString());
+    }
+    delete [] entries;
+
+    if(!written)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to write snapshot %s: %s", path, LocalLib::err2str(errno));
+    }
+
+    return hdr.numentries;
+}
+
 /*----------------------------------------------------------------------------
  * tearDown
  *----------------------------------------------------------------------------*/
@@ -338,6 +583,8 @@ void H5FileBuffer::tearDown (void)
     }
 
     /* Delete Dataset Strings */
+    delete [] ioResource;
+    if(ioCacheKey) delete [] ioCacheKey;
     delete [] datasetName;
     delete [] datasetPrint;
 
@@ -349,8 +596,11 @@ void H5FileBuffer::tearDown (void)
 /*----------------------------------------------------------------------------
  * ioRequest
  *----------------------------------------------------------------------------*/
-void H5FileBuffer::ioRequest (uint64_t* pos, int64_t size, uint8_t* buffer, int64_t hint, bool cache_the_data)
+void H5FileBuffer::ioRequest (uint64_t* pos, int64_t size, uint8_t* buffer, int64_t hint, bool cache_the_data, Asset::IODriver* driver)
 {
+    /* Default to Buffer's Driver */
+    if(!driver) driver = ioDriver;
+
     cache_entry_t entry;
     int64_t data_offset = 0;
     uint64_t file_position = *pos;
@@ -410,7 +660,8 @@ void H5FileBuffer::ioRequest (uint64_t* pos, int64_t size, uint8_t* buffer, int6
         /* Read into Cache */
         try
         {
-            entry.size = ioDriver->ioRead(entry.data, read_size, entry.pos);
+            if(ioCacheKey)  entry.size = H5BlockCache::read(ioCacheKey, driver, entry.data, read_size, entry.pos);
+            else            entry.size = driver->ioRead(entry.data, read_size, entry.pos);
         }
         catch (const RunTimeException& e)
         {
@@ -498,7 +749,7 @@ void H5FileBuffer::ioRequest (uint64_t* pos, int64_t size, uint8_t* buffer, int6
              *  incur an additional mutex lock, whereas here it only occurs an aditional
              *  time when data isn't being cached (which is rare)
              */
-            ioContext->mut.unlock();
+            ioContext->mut.lock();
             {
                 ioContext->bytes_read += entry.size;
             }
@@ -646,12 +897,31 @@ void H5FileBuffer::readDataset (info_t* info)
         throw RunTimeException(CRITICAL, RTE_ERROR, "read exceeds number of rows: %d + %d > %d", (int)datasetStartRow, (int)datasetNumRows, (int)first_dimension);
     }
 
-    /* Allocate Data Buffer */
+    /* Check Need to Flatten Chunks */
+    bool flatten = false;
+    if(metaData.layout == CHUNKED_LAYOUT)
+    {
+        for(int d = 1; d < metaData.ndims; d++)
+        {
+            if(metaData.chunkdims[d] != metaData.dimensions[d])
+            {
+                flatten = true;
+                break;
+            }
+        }
+    }
+
+    /* Allocate Data Buffer (or use caller's buffer when chunks are not flattened into it) */
     uint8_t* buffer = NULL;
     int64_t buffer_size = row_size * datasetNumRows;
     if(!metaOnly && buffer_size > 0)
     {
-        buffer = new uint8_t [buffer_size];
+        if(dataUserBuffer && buffer_size > dataUserBufferSize)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "buffer too small for dataset: %ld < %ld", (long)dataUserBufferSize, (long)buffer_size);
+        }
+
+        buffer = (dataUserBuffer && !flatten) ? dataUserBuffer : new uint8_t [buffer_size];
 
         /* Fill Buffer with Fill Value (if provided) */
         if(metaData.fillsize > 0)
@@ -775,24 +1045,44 @@ void H5FileBuffer::readDataset (info_t* info)
                 }
 
                 /* Read B-Tree */
-                readBTreeV1(metaData.address, buffer, buffer_size, buffer_offset);
-
-                /* Check Need to Flatten Chunks */
-                bool flatten = false;
-                for(int d = 1; d < metaData.ndims; d++)
+                if(ioContext->chunk_workers > 0 || ioContext->coalesce_gap > 0)
                 {
-                    if(metaData.chunkdims[d] != metaData.dimensions[d])
+                    /* Collect Chunks */
+                    List<chunk_t> chunks;
+                    readBTreeV1(metaData.address, buffer, buffer_size, buffer_offset, &chunks);
+
+                    /* Read Chunks in Windows
+                     *  when coalescing, neighboring chunks are read as single
+                     *  requests and each window of requests is inflated and
+                     *  freed before the next is read, bounding the memory held
+                     *  by reads in flight */
+                    int first = 0;
+                    int num_chunks = chunks.length();
+                    while(first < num_chunks)
                     {
-                        flatten = true;
-                        break;
+                        range_list_t ranges;
+                        int last = num_chunks;
+                        if(ioContext->coalesce_gap > 0)
+                        {
+                            last = readRanges(chunks, first, ranges);
+                        }
+
+                        /* Inflate Chunks (in Parallel if Workers Configured) */
+                        readChunks(chunks, first, last, buffer, ioContext->chunk_workers);
+                        first = last;
                     }
                 }
+                else
+                {
+                    /* Read Each Chunk as it is Traversed */
+                    readBTreeV1(metaData.address, buffer, buffer_size, buffer_offset);
+                }
 
                 /* Flatten Chunks - Place Dataset in Row Order*/
                 if(flatten)
                 {
-                    /* New Flattened Buffer */
-                    uint8_t* fbuf = new uint8_t[buffer_size];
+                    /* New Flattened Buffer (directly into caller's buffer if supplied) */
+                    uint8_t* fbuf = dataUserBuffer ? dataUserBuffer : new uint8_t[buffer_size];
                     uint64_t bi = 0; // index into source buffer
 
                     /* Build Number of Each Chunk per Dimension */
@@ -1335,7 +1625,7 @@ int H5FileBuffer::readIndirectBlock (heap_info_t* heap_info, int block_size, uin
 /*----------------------------------------------------------------------------
  * readBTreeV1
  *----------------------------------------------------------------------------*/
-int H5FileBuffer::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_size, uint64_t buffer_offset)
+int H5FileBuffer::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_size, uint64_t buffer_offset, List<chunk_t>* chunks)
 {
     uint64_t starting_position = pos;
     uint64_t data_key1 = datasetStartRow;
@@ -1420,7 +1710,7 @@ int H5FileBuffer::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_si
             /* Process Child Entry */
             if(node_level > 0)
             {
-                readBTreeV1(child_addr, buffer, buffer_size, buffer_offset);
+                readBTreeV1(child_addr, buffer, buffer_size, buffer_offset, chunks);
             }
             else
             {
@@ -1481,59 +1771,25 @@ int H5FileBuffer::readBTreeV1 (uint64_t pos, uint8_t* buffer, uint64_t buffer_si
                     print2term("Buffer Bytes:                                                    %ld (%ld)\n", (unsigned long)chunk_bytes, (unsigned long)(chunk_bytes/metaData.typesize));
                 }
 
-                /* Read Chunk */
-                if(metaData.filter[DEFLATE_FILTER])
+                /* Build Chunk */
+                chunk_t chunk = {
+                    .address        = child_addr,
+                    .chunk_size     = curr_node.chunk_size,
+                    .filter_mask    = curr_node.filter_mask,
+                    .buffer_index   = buffer_index,
+                    .chunk_index    = chunk_index,
+                    .chunk_bytes    = chunk_bytes,
+                    .data           = NULL
+                };
+
+                /* Read Chunk (or Queue it for Chunk Workers) */
+                if(chunks)
                 {
-                    /* Check Current Node Chunk Size */
-                    if(curr_node.chunk_size > (dataChunkBufferSize * FILTER_SIZE_SCALE))
-                    {
-                        throw RunTimeException(CRITICAL, RTE_ERROR, "Compressed chunk size exceeds buffer: %u > %lu", curr_node.chunk_size, (unsigned long)dataChunkBufferSize);
-                    }
-
-                    /* Read Data into Chunk Filter Buffer (holds the compressed data) */
-                    ioRequest(&child_addr, curr_node.chunk_size, dataChunkFilterBuffer, dataSizeHint, true);
-                    if((chunk_bytes == dataChunkBufferSize) && (!metaData.filter[SHUFFLE_FILTER]))
-                    {
-                        /* Inflate Directly into Data Buffer */
-                        inflateChunk(dataChunkFilterBuffer, curr_node.chunk_size, &buffer[buffer_index], chunk_bytes);
-                    }
-                    else
-                    {
-                        /* Inflate into Data Chunk Buffer */
-                        inflateChunk(dataChunkFilterBuffer, curr_node.chunk_size, dataChunkBuffer, dataChunkBufferSize);
-
-                        if(metaData.filter[SHUFFLE_FILTER])
-                        {
-                            /* Shuffle Data Chunk Buffer into Data Buffer */
-                            shuffleChunk(dataChunkBuffer, dataChunkBufferSize, &buffer[buffer_index], chunk_index, chunk_bytes, metaData.typesize);
-                        }
-                        else
-                        {
-                            /* Copy Data Chunk Buffer into Data Buffer */
-                            LocalLib::copy(&buffer[buffer_index], &dataChunkBuffer[chunk_index], chunk_bytes);
-                        }
-                    }
-
-                    /* Handle Caching */
-                    dataSizeHint = IO_CACHE_L1_LINESIZE;
+                    chunks->add(chunk);
                 }
-                else /* no supported filters */
+                else
                 {
-                    if(errorChecking)
-                    {
-                        if(metaData.filter[SHUFFLE_FILTER])
-                        {
-                            throw RunTimeException(CRITICAL, RTE_ERROR, "shuffle filter unsupported on uncompressed chunk");
-                        }
-                        else if(dataChunkBufferSize != curr_node.chunk_size)
-                        {
-                            throw RunTimeException(CRITICAL, RTE_ERROR, "mismatch in chunk size: %lu, %lu", (unsigned long)curr_node.chunk_size, (unsigned long)dataChunkBufferSize);
-                        }
-                    }
-
-                    /* Read Data into Data Buffer */
-                    uint64_t chunk_offset_addr = child_addr + chunk_index;
-                    ioRequest(&chunk_offset_addr, chunk_bytes, &buffer[buffer_index], dataSizeHint, true);
+                    readChunk(chunk, buffer, dataChunkBuffer, dataChunkFilterBuffer, dataSizeHint, ioDriver);
                     dataSizeHint = IO_CACHE_L1_LINESIZE;
                 }
             }
@@ -1584,124 +1840,561 @@ H5FileBuffer::btree_node_t H5FileBuffer::readBTreeNodeV1 (int ndims, uint64_t* p
 }
 
 /*----------------------------------------------------------------------------
- * readSymbolTable
+ * readChunk
  *----------------------------------------------------------------------------*/
-int H5FileBuffer::readSymbolTable (uint64_t pos, uint64_t heap_data_addr, int dlvl)
+void H5FileBuffer::readChunk (const chunk_t& chunk, uint8_t* buffer, uint8_t* chunk_buffer, uint8_t* filter_buffer, int64_t hint, Asset::IODriver* driver)
 {
-    uint64_t starting_position = pos;
+    uint64_t chunk_addr = chunk.address;
 
-    /* Check Signature and Version */
-    if(!errorChecking)
-    {
-        pos += 6;
-    }
-    else
+    if(metaData.filter[DEFLATE_FILTER])
     {
-        uint32_t signature = (uint32_t)readField(4, &pos);
-        if(signature != H5_SNOD_SIGNATURE_LE)
+        /* Check Current Node Chunk Size */
+        if(chunk.chunk_size > (dataChunkBufferSize * FILTER_SIZE_SCALE))
         {
-            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid symbol table signature: 0x%llX", (unsigned long long)signature);
+            throw RunTimeException(CRITICAL, RTE_ERROR, "Compressed chunk size exceeds buffer: %u > %lu", chunk.chunk_size, (unsigned long)dataChunkBufferSize);
         }
 
-        uint8_t version = (uint8_t)readField(1, &pos);
-        if(version != 1)
+        /* Read Data into Chunk Filter Buffer (holds the compressed data) */
+        if(chunk.data)
         {
-            throw RunTimeException(CRITICAL, RTE_ERROR, "incorrect version of symbole table: %d", (int)version);
+            filter_buffer = chunk.data;
         }
-
-        uint8_t reserved0 = (uint8_t)readField(1, &pos);
-        if(reserved0 != 0)
+        else
         {
-            throw RunTimeException(CRITICAL, RTE_ERROR, "incorrect reserved value: %d", (int)reserved0);
+            ioRequest(&chunk_addr, chunk.chunk_size, filter_buffer, hint, true, driver);
         }
-    }
 
-    /* Read Symbols */
-    uint16_t num_symbols = (uint16_t)readField(2, &pos);
-    for(int s = 0; s < num_symbols; s++)
-    {
-        /* Read Symbol Entry */
-        uint64_t link_name_offset = readField(metaData.offsetsize, &pos);
-        uint64_t obj_hdr_addr = readField(metaData.offsetsize, &pos);
-        uint32_t cache_type = (uint32_t)readField(4, &pos);
-        pos += 20; // reserved + scratch pad
-        if(errorChecking)
+        if((chunk.chunk_bytes == dataChunkBufferSize) && (!metaData.filter[SHUFFLE_FILTER]))
         {
-            if(cache_type == 2)
+            /* Inflate Directly into Data Buffer */
+            inflateChunk(filter_buffer, chunk.chunk_size, &buffer[chunk.buffer_index], chunk.chunk_bytes);
+        }
+        else
+        {
+            /* Inflate into Data Chunk Buffer */
+            inflateChunk(filter_buffer, chunk.chunk_size, chunk_buffer, dataChunkBufferSize);
+
+            if(metaData.filter[SHUFFLE_FILTER])
             {
-                throw RunTimeException(CRITICAL, RTE_ERROR, "symbolic links are unsupported");
+                /* Shuffle Data Chunk Buffer into Data Buffer */
+                shuffleChunk(chunk_buffer, dataChunkBufferSize, &buffer[chunk.buffer_index], chunk.chunk_index, chunk.chunk_bytes, metaData.typesize);
+            }
+            else
+            {
+                /* Copy Data Chunk Buffer into Data Buffer */
+                LocalLib::copy(&buffer[chunk.buffer_index], &chunk_buffer[chunk.chunk_index], chunk.chunk_bytes);
             }
         }
-
-        /* Read Link Name */
-        uint64_t link_name_addr = heap_data_addr + link_name_offset;
-        uint8_t link_name[STR_BUFF_SIZE];
-        int i = 0;
-        while(true)
+    }
+    else /* no supported filters */
+    {
+        if(errorChecking)
         {
-            if(i >= STR_BUFF_SIZE)
+            if(metaData.filter[SHUFFLE_FILTER])
             {
-                throw RunTimeException(CRITICAL, RTE_ERROR, "link name string exceeded maximum length: %d, 0x%lx\n", i, (unsigned long)pos);
+                throw RunTimeException(CRITICAL, RTE_ERROR, "shuffle filter unsupported on uncompressed chunk");
             }
-
-            uint8_t c = (uint8_t)readField(1, &link_name_addr);
-            link_name[i++] = c;
-
-            if(c == 0)
+            else if(dataChunkBufferSize != chunk.chunk_size)
             {
-                break;
+                throw RunTimeException(CRITICAL, RTE_ERROR, "mismatch in chunk size: %lu, %lu", (unsigned long)chunk.chunk_size, (unsigned long)dataChunkBufferSize);
             }
         }
-        link_name[i] = '\0';
-        if(verbose)
+
+        /* Read Data into Data Buffer */
+        if(chunk.data)
         {
-            print2term("Link Name:                                                       %s\n", link_name);
-            print2term("Object Header Address:                                           0x%lx\n", obj_hdr_addr);
+            LocalLib::copy(&buffer[chunk.buffer_index], chunk.data, chunk.chunk_bytes);
         }
-
-        /* Process Link */
-        if(dlvl < datasetPath.length())
+        else
         {
-            if(StringLib::match((const char*)link_name, datasetPath[dlvl]))
-            {
-                highestDataLevel = dlvl + 1;
-                readObjHdr(obj_hdr_addr, highestDataLevel);
-                break; // dataset found
-            }
+            chunk_addr += chunk.chunk_index;
+            ioRequest(&chunk_addr, chunk.chunk_bytes, &buffer[chunk.buffer_index], hint, true, driver);
         }
     }
-
-    /* Return Bytes Read */
-    uint64_t ending_position = pos;
-    return ending_position - starting_position;
 }
 
 /*----------------------------------------------------------------------------
- * readObjHdr
+ * readChunks
+ *
+ *  Reads and inflates the chunks collected from the b-tree on this thread
+ *  alongside up to num_workers - 1 workers enlisted from the chunk worker
+ *  pool; each worker reads through its own driver into its own scratch
+ *  buffers, and writes directly into its chunk's location in the data buffer
  *----------------------------------------------------------------------------*/
-int H5FileBuffer::readObjHdr (uint64_t pos, int dlvl)
+void H5FileBuffer::readChunks (List<chunk_t>& chunks, int first, int last, uint8_t* buffer, int num_workers)
 {
-    uint64_t starting_position = pos;
-
-    /* Peek at Version / Process Version 1 */
-    uint64_t peeking_position = pos;
-    uint8_t peek = readField(1, &peeking_position);
-    if(peek == 1) return readObjHdrV1(starting_position, dlvl);
+    int num_chunks = last - first;
+    if(num_chunks <= 0) return;
 
-    /* Read Object Header */
-    if(!errorChecking)
+    /* Prime Cache
+     *  performed on this thread prior to enlisting the workers so that
+     *  the workers are not all missing on the same data at the start */
+    if(dataSizeHint > IO_CACHE_L1_LINESIZE)
     {
-        pos += 5; // move past signature and version
+        uint64_t prime_addr = chunks[first].address;
+        ioRequest(&prime_addr, 0, NULL, dataSizeHint, true);
     }
-    else
+    dataSizeHint = IO_CACHE_L1_LINESIZE;
+
+    /* Read Serially when Workers Would Not Help */
+    int num_wanted = MIN(MIN(num_workers, num_chunks) - 1, chunkPoolSize);
+    if(num_wanted <= 0)
     {
-        uint64_t signature = readField(4, &pos);
-        if(signature != H5_OHDR_SIGNATURE_LE)
+        for(int i = first; i < last; i++)
         {
-            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid header signature: 0x%llX", (unsigned long long)signature);
+            readChunk(chunks[i], buffer, dataChunkBuffer, dataChunkFilterBuffer, dataSizeHint, ioDriver);
         }
+        return;
+    }
 
-        uint64_t version = readField(1, &pos);
+    /* Initialize Job */
+    SafeString driver_key("%s:%s://%s/%s", ioAsset->getName(), ioAsset->getFormat(), ioAsset->getPath(), ioResource);
+    chunk_job_t job;
+    job.h5file = this;
+    job.chunks = &chunks;
+    job.buffer = buffer;
+    job.driver_key = driver_key.getString();
+    job.wanted = num_wanted;
+    job.active = 0;
+    job.next = first;
+    job.last = last;
+    job.failed = false;
+    job.error[0] = '\0';
+
+    /* Queue Job for Pool Workers */
+    chunkSync.lock();
+    {
+        chunk_job_t* job_ptr = &job;
+        chunkQueue.add(job_ptr);
+        chunkSync.signal(CHUNK_WORK_SIG);
+    }
+    chunkSync.unlock();
+
+    /* Read Chunks alongside Workers */
+    readJobChunks(&job, ioDriver, dataChunkBuffer, dataChunkFilterBuffer);
+
+    /* Withdraw Job and Wait for Workers to Release It */
+    chunkSync.lock();
+    {
+        if(job.wanted > 0)
+        {
+            for(int i = 0; i < chunkQueue.length(); i++)
+            {
+                if(chunkQueue[i] == &job)
+                {
+                    chunkQueue.remove(i);
+                    break;
+                }
+            }
+        }
+
+        while(job.active > 0)
+        {
+            chunkSync.wait(CHUNK_DONE_SIG, SYS_TIMEOUT);
+        }
+    }
+    chunkSync.unlock();
+
+    /* Check Status */
+    if(job.failed)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to read chunks: %s", job.error);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * readRanges
+ *
+ *  Plans the reads for the collected chunks starting at the first chunk,
+ *  merging chunks that follow one another in the file (within the context's
+ *  coalesce gap) into a single request; ranges are planned until the next
+ *  would take the window past the context's max in-flight bytes.  The ranges
+ *  not already in the I/O cache are then issued to the driver as one vectored
+ *  read so that they can all be in flight at once.  Each chunk is pointed at
+ *  its bytes in the range that was read, the range buffers are owned by the
+ *  supplied list, and the index one past the last chunk planned is returned
+ *----------------------------------------------------------------------------*/
+int H5FileBuffer::readRanges (List<chunk_t>& chunks, int first, range_list_t& ranges)
+{
+    int num_chunks = chunks.length();
+    bool compressed = metaData.filter[DEFLATE_FILTER];
+    uint64_t gap = ioContext->coalesce_gap;
+    int64_t max_inflight = ioContext->max_inflight;
+    int64_t max_range = MIN(IO_RANGE_MAX_SIZE, max_inflight);
+    int64_t window_size = 0;
+    List<Asset::IODriver::extent_t> extents;
+
+    int start = first;
+    while(start < num_chunks)
+    {
+        /* Start Range at First Chunk */
+        uint64_t range_start = compressed ? chunks[start].address : chunks[start].address + chunks[start].chunk_index;
+        uint64_t range_end = range_start + (compressed ? chunks[start].chunk_size : chunks[start].chunk_bytes);
+        int64_t overread = 0;
+
+        /* Extend Range with Following Chunks */
+        int end = start + 1;
+        while(end < num_chunks)
+        {
+            uint64_t next_start = compressed ? chunks[end].address : chunks[end].address + chunks[end].chunk_index;
+            uint64_t next_end = next_start + (compressed ? chunks[end].chunk_size : chunks[end].chunk_bytes);
+            if( (next_start < range_end) ||
+                ((next_start - range_end) > gap) ||
+                ((int64_t)(next_end - range_start) > max_range) )
+            {
+                break;
+            }
+
+            overread += next_start - range_end;
+            range_end = next_end;
+            end++;
+        }
+
+        /* Close Window when Full */
+        int64_t range_size = range_end - range_start;
+        if(window_size > 0 && (window_size + range_size) > max_inflight)
+        {
+            break;
+        }
+        window_size += range_size;
+
+        /* Allocate Range */
+        uint8_t* range_buffer = new uint8_t [range_size];
+        ranges.add(range_buffer);
+
+        /* Point Chunks into Range */
+        for(int i = start; i < end; i++)
+        {
+            uint64_t chunk_start = compressed ? chunks[i].address : chunks[i].address + chunks[i].chunk_index;
+            chunks[i].data = &range_buffer[chunk_start - range_start];
+        }
+
+        /* Fill Range from Cache or Plan Read */
+        ioContext->mut.lock();
+        {
+            cache_entry_t entry;
+            if(ioPostPrefetch) ioContext->post_prefetch_request++;
+            else ioContext->pre_prefetch_request++;
+
+            if( ioCheckCache(range_start, range_size, &ioContext->l1, IO_CACHE_L1_MASK, &entry) ||
+                ioCheckCache(range_start, range_size, &ioContext->l2, IO_CACHE_L2_MASK, &entry) )
+            {
+                LocalLib::copy(range_buffer, &entry.data[range_start - entry.pos], range_size);
+            }
+            else
+            {
+                Asset::IODriver::extent_t extent = {
+                    .data = range_buffer,
+                    .size = range_size,
+                    .pos = range_start,
+                    .bytes = 0
+                };
+                extents.add(extent);
+                ioContext->cache_miss++;
+            }
+
+            ioContext->range_requests++;
+            ioContext->range_merged += end - start - 1;
+            ioContext->range_overread += overread;
+        }
+        ioContext->mut.unlock();
+
+        /* Goto Next Range */
+        start = end;
+    }
+
+    /* Read Ranges */
+    int num_extents = extents.length();
+    if(num_extents > 0)
+    {
+        Asset::IODriver::extent_t* extent_array = new Asset::IODriver::extent_t [num_extents];
+        for(int i = 0; i < num_extents; i++) extent_array[i] = extents[i];
+
+        int64_t bytes_read = 0;
+        try
+        {
+            if(ioCacheKey)  bytes_read = H5BlockCache::read(ioCacheKey, ioDriver, extent_array, num_extents);
+            else            bytes_read = ioDriver->ioReadv(extent_array, num_extents);
+            for(int i = 0; i < num_extents; i++)
+            {
+                if(extent_array[i].bytes < extent_array[i].size)
+                {
+                    throw RunTimeException(CRITICAL, RTE_ERROR, "failed to read %ld bytes of data: %ld", extent_array[i].size, extent_array[i].bytes);
+                }
+            }
+        }
+        catch(const RunTimeException& e)
+        {
+            delete [] extent_array;
+            throw; // rethrow exception
+        }
+        delete [] extent_array;
+
+        /* Count Bytes Read */
+        ioContext->mut.lock();
+        {
+            ioContext->bytes_read += bytes_read;
+        }
+        ioContext->mut.unlock();
+    }
+
+    /* No Further Need to Overread Chunks */
+    dataSizeHint = IO_CACHE_L1_LINESIZE;
+
+    return start;
+}
+
+/*----------------------------------------------------------------------------
+ * readJobChunks
+ *----------------------------------------------------------------------------*/
+void H5FileBuffer::readJobChunks (chunk_job_t* job, Asset::IODriver* driver, uint8_t* chunk_buffer, uint8_t* filter_buffer)
+{
+    while(true)
+    {
+        /* Get Next Chunk */
+        chunk_t chunk;
+        bool have_chunk = false;
+        job->mut.lock();
+        {
+            if(!job->failed && job->next < job->last)
+            {
+                chunk = job->chunks->get(job->next++);
+                have_chunk = true;
+            }
+        }
+        job->mut.unlock();
+
+        /* Check Complete */
+        if(!have_chunk) break;
+
+        /* Read Chunk */
+        try
+        {
+            job->h5file->readChunk(chunk, job->buffer, chunk_buffer, filter_buffer, IO_CACHE_L1_LINESIZE, driver);
+        }
+        catch(const RunTimeException& e)
+        {
+            job->mut.lock();
+            {
+                if(!job->failed)
+                {
+                    job->failed = true;
+                    StringLib::copy(job->error, e.what(), STR_BUFF_SIZE);
+                }
+            }
+            job->mut.unlock();
+            break;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * chunkThread
+ *----------------------------------------------------------------------------*/
+void* H5FileBuffer::chunkThread (void* parm)
+{
+    chunk_worker_t* worker = (chunk_worker_t*)parm;
+
+    while(chunkActive)
+    {
+        /* Pick Up Job */
+        chunk_job_t* job = NULL;
+        chunkSync.lock();
+        {
+            if(chunkQueue.length() == 0)
+            {
+                chunkSync.wait(CHUNK_WORK_SIG, SYS_TIMEOUT);
+            }
+
+            if(chunkQueue.length() > 0)
+            {
+                job = chunkQueue[0];
+                if(--job->wanted <= 0) chunkQueue.remove(0);
+                job->active++;
+            }
+        }
+        chunkSync.unlock();
+
+        /* Check for Job */
+        if(!job) continue;
+        EventLib::incrementMetric(chunkMetricId);
+
+        try
+        {
+            H5FileBuffer* h5file = job->h5file;
+
+            /* Attach Driver for Job's Resource */
+            if(!worker->driver || worker->driver_asset != h5file->ioAsset || !StringLib::match(worker->driver_key, job->driver_key))
+            {
+                delete worker->driver;
+                delete [] worker->driver_key;
+                worker->driver = NULL;
+                worker->driver_key = NULL;
+                worker->driver = h5file->ioAsset->createDriver(h5file->ioResource);
+                worker->driver_asset = h5file->ioAsset;
+                worker->driver_key = StringLib::duplicate(job->driver_key);
+            }
+
+            /* Grow Scratch Buffers to Job's Chunk Size */
+            if(worker->buffer_size < h5file->dataChunkBufferSize)
+            {
+                delete [] worker->chunk_buffer;
+                delete [] worker->filter_buffer;
+                worker->chunk_buffer = NULL;
+                worker->filter_buffer = NULL;
+                worker->buffer_size = 0;
+                worker->chunk_buffer = new uint8_t [h5file->dataChunkBufferSize];
+                worker->filter_buffer = new uint8_t [h5file->dataChunkBufferSize * FILTER_SIZE_SCALE];
+                worker->buffer_size = h5file->dataChunkBufferSize;
+            }
+
+            /* Read Chunks */
+            readJobChunks(job, worker->driver, worker->chunk_buffer, worker->filter_buffer);
+        }
+        catch(const RunTimeException& e)
+        {
+            job->mut.lock();
+            {
+                if(!job->failed)
+                {
+                    job->failed = true;
+                    StringLib::copy(job->error, e.what(), STR_BUFF_SIZE);
+                }
+            }
+            job->mut.unlock();
+        }
+
+        /* Release Job */
+        chunkSync.lock();
+        {
+            job->active--;
+            chunkSync.signal(CHUNK_DONE_SIG);
+        }
+        chunkSync.unlock();
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * readSymbolTable
+ *----------------------------------------------------------------------------*/
+int H5FileBuffer::readSymbolTable (uint64_t pos, uint64_t heap_data_addr, int dlvl)
+{
+    uint64_t starting_position = pos;
+
+    /* Check Signature and Version */
+    if(!errorChecking)
+    {
+        pos += 6;
+    }
+    else
+    {
+        uint32_t signature = (uint32_t)readField(4, &pos);
+        if(signature != H5_SNOD_SIGNATURE_LE)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid symbol table signature: 0x%llX", (unsigned long long)signature);
+        }
+
+        uint8_t version = (uint8_t)readField(1, &pos);
+        if(version != 1)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "incorrect version of symbole table: %d", (int)version);
+        }
+
+        uint8_t reserved0 = (uint8_t)readField(1, &pos);
+        if(reserved0 != 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "incorrect reserved value: %d", (int)reserved0);
+        }
+    }
+
+    /* Read Symbols */
+    uint16_t num_symbols = (uint16_t)readField(2, &pos);
+    for(int s = 0; s < num_symbols; s++)
+    {
+        /* Read Symbol Entry */
+        uint64_t link_name_offset = readField(metaData.offsetsize, &pos);
+        uint64_t obj_hdr_addr = readField(metaData.offsetsize, &pos);
+        uint32_t cache_type = (uint32_t)readField(4, &pos);
+        pos += 20; // reserved + scratch pad
+        if(errorChecking)
+        {
+            if(cache_type == 2)
+            {
+                throw RunTimeException(CRITICAL, RTE_ERROR, "symbolic links are unsupported");
+            }
+        }
+
+        /* Read Link Name */
+        uint64_t link_name_addr = heap_data_addr + link_name_offset;
+        uint8_t link_name[STR_BUFF_SIZE];
+        int i = 0;
+        while(true)
+        {
+            if(i >= STR_BUFF_SIZE)
+            {
+                throw RunTimeException(CRITICAL, RTE_ERROR, "link name string exceeded maximum length: %d, 0x%lx\n", i, (unsigned long)pos);
+            }
+
+            uint8_t c = (uint8_t)readField(1, &link_name_addr);
+            link_name[i++] = c;
+
+            if(c == 0)
+            {
+                break;
+            }
+        }
+        link_name[i] = '\0';
+        if(verbose)
+        {
+            print2term("Link Name:                                                       %s\n", link_name);
+            print2term("Object Header Address:                                           0x%lx\n", obj_hdr_addr);
+        }
+
+        /* Process Link */
+        if(dlvl < datasetPath.length())
+        {
+            if(StringLib::match((const char*)link_name, datasetPath[dlvl]))
+            {
+                highestDataLevel = dlvl + 1;
+                readObjHdr(obj_hdr_addr, highestDataLevel);
+                break; // dataset found
+            }
+        }
+    }
+
+    /* Return Bytes Read */
+    uint64_t ending_position = pos;
+    return ending_position - starting_position;
+}
+
+/*----------------------------------------------------------------------------
+ * readObjHdr
+ *----------------------------------------------------------------------------*/
+int H5FileBuffer::readObjHdr (uint64_t pos, int dlvl)
+{
+    uint64_t starting_position = pos;
+
+    /* Peek at Version / Process Version 1 */
+    uint64_t peeking_position = pos;
+    uint8_t peek = readField(1, &peeking_position);
+    if(peek == 1) return readObjHdrV1(starting_position, dlvl);
+
+    /* Read Object Header */
+    if(!errorChecking)
+    {
+        pos += 5; // move past signature and version
+    }
+    else
+    {
+        uint64_t signature = readField(4, &pos);
+        if(signature != H5_OHDR_SIGNATURE_LE)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid header signature: 0x%llX", (unsigned long long)signature);
+        }
+
+        uint64_t version = readField(1, &pos);
         if(version != 2)
         {
             throw RunTimeException(CRITICAL, RTE_ERROR, "invalid header version: %d", (int)version);
@@ -3094,45 +3787,7 @@ int H5FileBuffer::highestBit (uint64_t value)
  *----------------------------------------------------------------------------*/
 int H5FileBuffer::inflateChunk (uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size)
 {
-    int status;
-    z_stream strm;
-
-    /* Initialize z_stream State */
-    strm.zalloc     = Z_NULL;
-    strm.zfree      = Z_NULL;
-    strm.opaque     = Z_NULL;
-    strm.avail_in   = 0;
-    strm.next_in    = Z_NULL;
-
-    /* Initialize z_stream */
-    status = inflateInit(&strm);
-    if(status != Z_OK)
-    {
-        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to initialize z_stream: %d", status);
-    }
-
-    /* Decompress Until Entire Chunk is Processed */
-    strm.avail_in = input_size;
-    strm.next_in = input;
-
-    /* Decompress Chunk */
-    do
-    {
-        strm.avail_out = output_size;
-        strm.next_out = output;
-        status = inflate(&strm, Z_NO_FLUSH);
-        if(status != Z_OK) break;
-    } while (strm.avail_out == 0);
-
-    /* Clean Up z_stream */
-    inflateEnd(&strm);
-
-    /* Check Decompression Complete */
-    if(status != Z_STREAM_END)
-    {
-        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to inflate entire z_stream: %d", status);
-    }
-
+    H5Filter::inflate(input, input_size, output, output_size);
     return 0;
 }
 
@@ -3143,39 +3798,28 @@ int H5FileBuffer::shuffleChunk (uint8_t* input, uint32_t input_size, uint8_t* ou
 {
     if(errorChecking)
     {
-        if(type_size < 0 || type_size > 8)
+        if(type_size <= 0 || type_size > 8)
         {
             throw RunTimeException(CRITICAL, RTE_ERROR, "invalid data size to perform shuffle on: %d", type_size);
         }
     }
 
-    int64_t dst_index = 0;
-    int64_t shuffle_block_size = input_size / type_size;
-    int64_t num_elements = output_size / type_size;
-    int64_t start_element = output_offset / type_size;
-    for(int64_t element_index = start_element; element_index < (start_element + num_elements); element_index++)
-    {
-        for(int64_t val_index = 0; val_index < type_size; val_index++)
-        {
-            int64_t src_index = (val_index * shuffle_block_size) + element_index;
-            output[dst_index++] = input[src_index];
-        }
-    }
-
+    H5Filter::unshuffle(input, input_size, output, output_offset, output_size, type_size);
     return 0;
 }
 
 /*----------------------------------------------------------------------------
  * metaGetKey
+ *
+ *  64-bit FNV-1a hash of the url, used to select the shard
  *----------------------------------------------------------------------------*/
 uint64_t H5FileBuffer::metaGetKey (const char* url)
 {
-    uint64_t key_value = 0;
-    uint64_t* url_ptr = (uint64_t*)url;
-    for(int i = 0; i < MAX_META_NAME_SIZE; i+=sizeof(uint64_t))
+    uint64_t key_value = 14695981039346656037ULL;
+    for(int i = 0; i < MAX_META_NAME_SIZE && url[i] != '\0'; i++)
     {
-        key_value += *url_ptr;
-        url_ptr++;
+        key_value ^= (uint8_t)url[i];
+        key_value *= 1099511628211ULL;
     }
     return key_value;
 }
@@ -3213,6 +3857,362 @@ void H5FileBuffer::metaGetUrl (char* url, const char* resource, const char* data
     }
 }
 
+/*----------------------------------------------------------------------------
+ * metaFind
+ *
+ *  looks up the url in its shard, comparing the full url so that hash
+ *  collisions cannot return another dataset's metadata
+ *----------------------------------------------------------------------------*/
+bool H5FileBuffer::metaFind (const char* url, meta_entry_t* entry)
+{
+    bool found = false;
+    meta_shard_t& shard = metaRepo[metaGetKey(url) % META_REPO_SHARDS];
+    shard.mut.lock();
+    {
+        found = metaLookup(shard, url, entry);
+    }
+    shard.mut.unlock();
+    return found;
+}
+
+/*----------------------------------------------------------------------------
+ * metaLookup - shard must be locked
+ *----------------------------------------------------------------------------*/
+bool H5FileBuffer::metaLookup (meta_shard_t& shard, const char* url, meta_entry_t* entry)
+{
+    meta_node_t* node = NULL;
+    if(!shard.lookup.find(url, &node)) return false;
+
+    /* Move to Front of LRU List */
+    if(shard.head != node)
+    {
+        node->prev->next = node->next;
+        if(node->next) node->next->prev = node->prev;
+        else shard.tail = node->prev;
+        node->prev = NULL;
+        node->next = shard.head;
+        shard.head->prev = node;
+        shard.head = node;
+    }
+
+    *entry = node->entry;
+    return true;
+}
+
+/*----------------------------------------------------------------------------
+ * metaAdd
+ *
+ *  adds (or refreshes) the entry, evicting the shard's least recently used
+ *  entry when the shard is at its share of MAX_META_STORE
+ *----------------------------------------------------------------------------*/
+void H5FileBuffer::metaAdd (const meta_entry_t& entry)
+{
+    meta_shard_t& shard = metaRepo[metaGetKey(entry.url) % META_REPO_SHARDS];
+    shard.mut.lock();
+    {
+        meta_node_t* node = NULL;
+        if(shard.lookup.find(entry.url, &node))
+        {
+            /* Refresh Existing Entry */
+            node->entry = entry;
+        }
+        else
+        {
+            /* Evict Least Recently Used Entry */
+            if(shard.lookup.length() >= (MAX_META_STORE / META_REPO_SHARDS) && shard.tail)
+            {
+                meta_node_t* oldest = shard.tail;
+                shard.tail = oldest->prev;
+                if(shard.tail) shard.tail->next = NULL;
+                else shard.head = NULL;
+                shard.lookup.remove(oldest->entry.url);
+
+                /* Allow Resource's Sidecar to be Restored Again */
+                char resource_name[MAX_META_NAME_SIZE];
+                metaGetResource(resource_name, oldest->entry.url);
+                snapshotMut.lock();
+                {
+                    if(snapshotChecked.find(resource_name)) snapshotChecked.remove(resource_name);
+                }
+                snapshotMut.unlock();
+
+                delete oldest;
+            }
+
+            /* Add Entry to Front of LRU List */
+            node = new meta_node_t;
+            node->entry = entry;
+            node->prev = NULL;
+            node->next = shard.head;
+            if(shard.head) shard.head->prev = node;
+            else shard.tail = node;
+            shard.head = node;
+            shard.lookup.add(entry.url, node);
+        }
+    }
+    shard.mut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * metaClear
+ *
+ *  frees every entry of the meta repository; every sidecar can then be
+ *  restored again
+ *----------------------------------------------------------------------------*/
+void H5FileBuffer::metaClear (void)
+{
+    for(int s = 0; s < META_REPO_SHARDS; s++)
+    {
+        meta_shard_t& shard = metaRepo[s];
+        shard.mut.lock();
+        {
+            meta_node_t* node = shard.head;
+            while(node)
+            {
+                meta_node_t* next = node->next;
+                delete node;
+                node = next;
+            }
+            shard.head = NULL;
+            shard.tail = NULL;
+            shard.lookup.clear();
+        }
+        shard.mut.unlock();
+    }
+
+    snapshotMut.lock();
+    {
+        snapshotChecked.clear();
+    }
+    snapshotMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * metaCollect
+ *
+ *  gets the meta repository entries of the datasets of a resource, parsing
+ *  the resource for the ones that are not in the repository (which adds
+ *  them); the datasets already present are looked up in a single pass over
+ *  the shards, locking each shard once, and the datasets that are parsed
+ *  share the I/O context; the entries found are packed at the front of the
+ *  supplied array (if not NULL) in the order of the datasets, and the
+ *  number found is returned
+ *----------------------------------------------------------------------------*/
+int H5FileBuffer::metaCollect (const Asset* asset, const char* resource, const char** datasets, int num_datasets, io_context_t* context, meta_entry_t* entries)
+{
+    if(num_datasets <= 0) return 0;
+
+    meta_entry_t* found_entries = new meta_entry_t [num_datasets];
+    bool* found = new bool [num_datasets];
+    int* shard_index = new int [num_datasets];
+
+    /* Select Shard of Each Dataset */
+    for(int d = 0; d < num_datasets; d++)
+    {
+        found[d] = false;
+        try
+        {
+            metaGetUrl(found_entries[d].url, resource, datasets[d]);
+            shard_index[d] = metaGetKey(found_entries[d].url) % META_REPO_SHARDS;
+        }
+        catch(const RunTimeException& e)
+        {
+            mlog(e.level(), "Failed to look up metadata for %s in %s: %s", datasets[d], resource, e.what());
+            shard_index[d] = -1;
+        }
+    }
+
+    /* Look Up Datasets One Shard at a Time */
+    for(int s = 0; s < META_REPO_SHARDS; s++)
+    {
+        bool locked = false;
+        for(int d = 0; d < num_datasets; d++)
+        {
+            if(shard_index[d] != s) continue;
+            if(!locked)
+            {
+                metaRepo[s].mut.lock();
+                locked = true;
+            }
+            char url[MAX_META_NAME_SIZE];
+            LocalLib::copy(url, found_entries[d].url, MAX_META_NAME_SIZE);
+            found[d] = metaLookup(metaRepo[s], url, &found_entries[d]);
+        }
+        if(locked) metaRepo[s].mut.unlock();
+    }
+
+    /* Parse Datasets Not in Repository */
+    io_context_t local_context;
+    if(!context) context = &local_context;
+    for(int d = 0; d < num_datasets; d++)
+    {
+        if(found[d] || shard_index[d] < 0) continue;
+        try
+        {
+            info_t info;
+            H5FileBuffer h5file(&info, context, asset, resource, datasets[d], 0, 0, true, H5_VERBOSE, true);
+            if(info.data) delete [] info.data;
+            found_entries[d] = h5file.metaData;
+            found[d] = true;
+        }
+        catch(const RunTimeException& e)
+        {
+            mlog(e.level(), "Failed to warm up metadata for %s in %s: %s", datasets[d], resource, e.what());
+        }
+    }
+
+    /* Pack Entries Found */
+    int num_found = 0;
+    for(int d = 0; d < num_datasets; d++)
+    {
+        if(!found[d]) continue;
+        if(entries) entries[num_found] = found_entries[d];
+        num_found++;
+    }
+
+    delete [] found_entries;
+    delete [] found;
+    delete [] shard_index;
+
+    return num_found;
+}
+
+/*----------------------------------------------------------------------------
+ * metaWarmup
+ *----------------------------------------------------------------------------*/
+int H5FileBuffer::metaWarmup (const Asset* asset, const char* resource, const char** datasets, int num_datasets, io_context_t* context)
+{
+    return metaCollect(asset, resource, datasets, num_datasets, context, NULL);
+}
+
+/*----------------------------------------------------------------------------
+ * metaRestore
+ *
+ *  loads the snapshot sidecar of the resource into the meta repository the
+ *  first time one of its datasets misses, then looks the url up again; the
+ *  sidecar is looked for again once any of the resource's entries have been
+ *  evicted
+ *----------------------------------------------------------------------------*/
+bool H5FileBuffer::metaRestore (const char* url)
+{
+    /* Only Look for Sidecar Once per Resource */
+    char resource_name[MAX_META_NAME_SIZE];
+    metaGetResource(resource_name, url);
+    bool checked = true;
+    snapshotMut.lock();
+    {
+        if(snapshotDir)
+        {
+            checked = snapshotChecked.find(resource_name);
+            if(!checked)
+            {
+                bool flag = true;
+                if(snapshotChecked.length() >= MAX_META_STORE) snapshotChecked.clear();
+                snapshotChecked.add(resource_name, flag);
+            }
+        }
+    }
+    snapshotMut.unlock();
+    if(checked) return false;
+
+    /* Get Tag of Resource */
+    char tag[META_SNAPSHOT_TAG_SIZE];
+    if(!ioDriver->ioTag(tag, META_SNAPSHOT_TAG_SIZE)) return false;
+
+    /* Load Sidecar */
+    char path[MAX_STR_SIZE];
+    if(!metaSnapshotPath(path, MAX_STR_SIZE, tag)) return false;
+    if(metaLoad(path) <= 0) return false;
+    EventLib::incrementMetric(restoreMetricId);
+
+    return metaFind(url, &metaData);
+}
+
+/*----------------------------------------------------------------------------
+ * metaGetResource
+ *
+ *  the file name a meta repository url starts with (see metaGetUrl)
+ *----------------------------------------------------------------------------*/
+void H5FileBuffer::metaGetResource (char* name, const char* url)
+{
+    int i = 0;
+    while(i < MAX_META_NAME_SIZE - 1 && url[i] != '\0' && url[i] != '/')
+    {
+        name[i] = url[i];
+        i++;
+    }
+    name[i] = '\0';
+}
+
+/*----------------------------------------------------------------------------
+ * metaSnapshotPath
+ *
+ *  <snapshot directory>/<tag>.h5meta, with any character of the tag that
+ *  is not safe in a file name replaced
+ *----------------------------------------------------------------------------*/
+bool H5FileBuffer::metaSnapshotPath (char* path, int size, const char* tag)
+{
+    char safe_tag[META_SNAPSHOT_TAG_SIZE];
+    int i = 0;
+    for(; i < META_SNAPSHOT_TAG_SIZE - 1 && tag[i] != '\0'; i++)
+    {
+        char c = tag[i];
+        safe_tag[i] = (isalnum(c) || c == '-' || c == '_') ? c : '_';
+    }
+    safe_tag[i] = '\0';
+
+    bool status = false;
+    snapshotMut.lock();
+    {
+        if(snapshotDir)
+        {
+            StringLib::format(path, size, "%s/%s.h5meta", snapshotDir, safe_tag);
+            status = true;
+        }
+    }
+    snapshotMut.unlock();
+
+    return status;
+}
+
+/*----------------------------------------------------------------------------
+ * metaLoad
+ *
+ *  adds the entries of a snapshot sidecar to the meta repository; returns the
+ *  number of entries loaded, or -1 if the sidecar is missing or unusable
+ *----------------------------------------------------------------------------*/
+int H5FileBuffer::metaLoad (const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if(!fp) return -1;
+
+    int num_loaded = -1;
+    meta_snapshot_hdr_t hdr;
+    if(fread(&hdr, sizeof(hdr), 1, fp) != 1)
+    {
+        mlog(ERROR, "Unable to read header of snapshot %s", path);
+    }
+    else if(hdr.magic != META_SNAPSHOT_MAGIC || hdr.version != META_SNAPSHOT_VERSION || hdr.entrysize != sizeof(meta_entry_t))
+    {
+        mlog(WARNING, "Ignoring incompatible snapshot %s: version %u, entry size %u", path, hdr.version, hdr.entrysize);
+    }
+    else
+    {
+        num_loaded = 0;
+        meta_entry_t entry;
+        while(num_loaded < (int)hdr.numentries && fread(&entry, sizeof(meta_entry_t), 1, fp) == 1)
+        {
+            entry.url[MAX_META_NAME_SIZE - 1] = '\0';
+            metaAdd(entry);
+            num_loaded++;
+        }
+        mlog(INFO, "Restored %d of %u metadata entries from %s", num_loaded, hdr.numentries, path);
+    }
+
+    fclose(fp);
+    return num_loaded;
+}
+
 /******************************************************************************
  * HDF5 LITE LIBRARY
  ******************************************************************************/
@@ -3222,12 +4222,19 @@ Subscriber*  H5Coro::rqstSub;
 bool         H5Coro::readerActive;
 Thread**     H5Coro::readerPids;
 int          H5Coro::threadPoolSize;
+int          H5Coro::chunkWorkers = 0;
 
 /*----------------------------------------------------------------------------
  * init
  *----------------------------------------------------------------------------*/
-void H5Coro::init (int num_threads)
+void H5Coro::init (int num_threads, int num_chunk_workers, int chunk_pool_size)
 {
+    chunkWorkers = num_chunk_workers;
+
+    /* Chunk Worker Pool (sized to the processor when not specified) */
+    if(chunk_pool_size <= 0) chunk_pool_size = LocalLib::nproc();
+    H5FileBuffer::init(chunk_pool_size);
+
     rqstPub = new Publisher(NULL);
 
     if(num_threads > 0)
@@ -3267,12 +4274,16 @@ void H5Coro::deinit (void)
     }
 
     if(rqstPub) delete rqstPub;
+
+    H5FileBuffer::deinit();
+    H5FileBuffer::setSnapshotDir(NULL);
+    H5FileBuffer::metaClear();
 }
 
 /*----------------------------------------------------------------------------
  * read
  *----------------------------------------------------------------------------*/
-H5Coro::info_t H5Coro::read (const Asset* asset, const char* resource, const char* datasetname, RecordObject::valType_t valtype, long col, long startrow, long numrows, context_t* context, bool _meta_only)
+H5Coro::info_t H5Coro::read (const Asset* asset, const char* resource, const char* datasetname, RecordObject::valType_t valtype, long col, long startrow, long numrows, context_t* context, bool _meta_only, uint8_t* buffer, int64_t buffer_size)
 {
     info_t info;
 
@@ -3280,188 +4291,82 @@ H5Coro::info_t H5Coro::read (const Asset* asset, const char* resource, const cha
     uint32_t parent_trace_id = EventLib::grabId();
     uint32_t trace_id = start_trace(INFO, parent_trace_id, "h5coro_read", "{\"asset\":\"%s\", \"resource\":\"%s\", \"dataset\":\"%s\"}", asset->getName(), resource, datasetname);
 
+    /* Read Directly into Caller's Buffer when No Translation is Needed */
+    bool direct = buffer && (valtype == RecordObject::DYNAMIC) && (col == ALL_COLS);
+
     /* Open Resource and Read Dataset */
-    H5FileBuffer h5file(&info, context, asset, resource, datasetname, startrow, numrows, true, H5_VERBOSE, _meta_only);
-    if(info.data)
+    H5FileBuffer h5file(&info, context, asset, resource, datasetname, startrow, numrows, true, H5_VERBOSE, _meta_only, direct ? buffer : NULL, buffer_size);
+    if(info.data && !direct)
     {
-        bool data_valid = true;
-
-        /* Perform Column Translation */
+        /*
+         * Describe Translation
+         *  the source is read as rows of `width` elements spaced `stride`
+         *  elements apart; a whole dataset is a single contiguous row
+         */
+        uint8_t* src = info.data;
+        int64_t rows = 1;
+        int64_t width = info.elements;
+        int64_t stride = info.elements;
         if((info.numcols > 1) && (col != ALL_COLS))
         {
-            /* Allocate Column Buffer */
-            int64_t tbuf_size = info.datasize / info.numcols;
-            uint8_t* tbuf = new uint8_t [tbuf_size];
-
-            /* Copy Column into Buffer */
-            int64_t tbuf_row_size = info.datasize / info.numrows;
-            int64_t tbuf_col_size = tbuf_row_size / info.numcols;
-            for(int row = 0; row < info.numrows; row++)
-            {
-                int64_t tbuf_offset = (row * tbuf_col_size);
-                int64_t data_offset = (row * tbuf_row_size) + (col * tbuf_col_size);
-                LocalLib::copy(&tbuf[tbuf_offset], &info.data[data_offset], tbuf_col_size);
-            }
-
-            /* Switch Buffers */
-            delete [] info.data;
-            info.data = tbuf;
-            info.datasize = tbuf_size;
-            info.elements = info.elements / info.numcols;
-        }
-
-        /* Perform Integer Type Transaltion */
-        if(valtype == RecordObject::INTEGER)
-        {
-            /* Allocate Buffer of Integers */
-            int* tbuf = new int [info.elements];
-
-            /* Float to Int */
-            if(info.datatype == RecordObject::FLOAT)
-            {
-                float* dptr = (float*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (int)dptr[i];
-                }
-            }
-            /* Double to Int */
-            else if(info.datatype == RecordObject::DOUBLE)
-            {
-                double* dptr = (double*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (int)dptr[i];
-                }
-            }
-            /* Char to Int */
-            else if(info.datatype == RecordObject::UINT8 || info.datatype == RecordObject::INT8)
-            {
-                uint8_t* dptr = (uint8_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (int)dptr[i];
-                }
-            }
-            /* Short to Int */
-            else if(info.datatype == RecordObject::UINT16 || info.datatype == RecordObject::INT16)
-            {
-                uint16_t* dptr = (uint16_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (int)dptr[i];
-                }
-            }
-            /* Int to Int */
-            else if(info.datatype == RecordObject::UINT32 || info.datatype == RecordObject::INT32)
-            {
-                uint32_t* dptr = (uint32_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (int)dptr[i];
-                }
-            }
-            /* Long to Int */
-            else if(info.datatype == RecordObject::UINT64 || info.datatype == RecordObject::INT64)
+            if(col < 0 || col >= info.numcols)
             {
-                uint64_t* dptr = (uint64_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (int)dptr[i];
-                }
+                delete [] info.data;
+                throw RunTimeException(CRITICAL, RTE_ERROR, "invalid column for %s: %ld not in [0, %d)", datasetname, col, info.numcols);
             }
-            else
+            rows = info.numrows;
+            stride = info.elements / info.numrows;
+            width = stride / info.numcols;
+            src = &info.data[col * width * info.typesize];
+        }
+        int64_t elements = rows * width;
+
+        /* Determine Size of Translated Elements */
+        int64_t dst_typesize;
+        if(valtype == RecordObject::INTEGER)    dst_typesize = sizeof(int);
+        else if(valtype == RecordObject::REAL)  dst_typesize = sizeof(double);
+        else                                    dst_typesize = info.typesize;
+
+        /* Check if Translation Leaves Data Unchanged */
+        bool identity = (rows == 1) &&
+                        ((valtype == RecordObject::INTEGER && (info.datatype == RecordObject::INT32 || info.datatype == RecordObject::UINT32)) ||
+                         (valtype == RecordObject::REAL && info.datatype == RecordObject::DOUBLE) ||
+                         (valtype != RecordObject::INTEGER && valtype != RecordObject::REAL));
+
+        if(!identity || buffer)
+        {
+            /* Get Destination */
+            int64_t dst_size = elements * dst_typesize;
+            if(buffer && dst_size > buffer_size)
             {
-                data_valid = false;
+                delete [] info.data;
+                throw RunTimeException(CRITICAL, RTE_ERROR, "buffer too small for %s: %ld < %ld", datasetname, (long)buffer_size, (long)dst_size);
             }
+            uint8_t* dst = buffer ? buffer : new uint8_t [dst_size];
+
+            /* Gather and Convert in a Single Pass */
+            bool data_valid;
+            if(valtype == RecordObject::INTEGER)    data_valid = convertData((int*)dst, src, info.datatype, rows, width, stride);
+            else if(valtype == RecordObject::REAL)  data_valid = convertData((double*)dst, src, info.datatype, rows, width, stride);
+            else                                    data_valid = gatherData(dst, src, info.typesize, rows, width, stride);
 
             /* Switch Buffers */
             delete [] info.data;
-            info.data = (uint8_t*)tbuf;
-            info.datasize = sizeof(int) * info.elements;
-        }
-
-        /* Perform Integer Type Transaltion */
-        if(valtype == RecordObject::REAL)
-        {
-            /* Allocate Buffer of Integers */
-            double* tbuf = new double [info.elements];
+            info.data = dst;
+            info.datasize = dst_size;
+            info.elements = elements;
 
-            /* Float to Double */
-            if(info.datatype == RecordObject::FLOAT)
-            {
-                float* dptr = (float*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (double)dptr[i];
-                }
-            }
-            /* Double to Double */
-            else if(info.datatype == RecordObject::DOUBLE)
-            {
-                double* dptr = (double*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (double)dptr[i];
-                }
-            }
-            /* Char to Double */
-            else if(info.datatype == RecordObject::UINT8 || info.datatype == RecordObject::INT8)
-            {
-                uint8_t* dptr = (uint8_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (double)dptr[i];
-                }
-            }
-            /* Short to Double */
-            else if(info.datatype == RecordObject::UINT16 || info.datatype == RecordObject::INT16)
-            {
-                uint16_t* dptr = (uint16_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (double)dptr[i];
-                }
-            }
-            /* Int to Double */
-            else if(info.datatype == RecordObject::UINT32 || info.datatype == RecordObject::INT32)
-            {
-                uint32_t* dptr = (uint32_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (double)dptr[i];
-                }
-            }
-            /* Long to Double */
-            else if(info.datatype == RecordObject::UINT64 || info.datatype == RecordObject::INT64)
+            /* Check Data Valid */
+            if(!data_valid)
             {
-                uint64_t* dptr = (uint64_t*)info.data;
-                for(uint32_t i = 0; i < info.elements; i++)
-                {
-                    tbuf[i] = (double)dptr[i];
-                }
-            }
-            else
-            {
-                data_valid = false;
+                if(!buffer) delete [] info.data;
+                info.data = NULL;
+                info.datasize = 0;
+                throw RunTimeException(CRITICAL, RTE_ERROR, "data translation failed for %s: [%d,%d] %d --> %d", datasetname, info.numcols, info.typesize, (int)info.datatype, (int)valtype);
             }
-
-            /* Switch Buffers */
-            delete [] info.data;
-            info.data = (uint8_t*)tbuf;
-            info.datasize = sizeof(double) * info.elements;
-        }
-
-        /* Check Data Valid */
-        if(!data_valid)
-        {
-            delete [] info.data;
-            info.data = NULL;
-            info.datasize = 0;
-            throw RunTimeException(CRITICAL, RTE_ERROR, "data translation failed for %s: [%d,%d] %d --> %d", datasetname, info.numcols, info.typesize, (int)info.datatype, (int)valtype);
         }
     }
-    else if(!_meta_only)
+    else if(!info.data && !_meta_only)
     {
         throw RunTimeException(CRITICAL, RTE_ERROR, "failed to read dataset: %s", datasetname);
     }
@@ -3504,6 +4409,40 @@ bool H5Coro::traverse (const Asset* asset, const char* resource, int max_depth,
 }
 
 
+/*----------------------------------------------------------------------------
+ * warmup
+ *
+ *  populates the meta repository for the datasets of a resource without
+ *  reading any data; all of the datasets share one I/O context so the
+ *  superblock and the object headers common to their paths are read once
+ *----------------------------------------------------------------------------*/
+int H5Coro::warmup (const Asset* asset, const char* resource, const char** datasets, int num_datasets, context_t* context)
+{
+    return H5FileBuffer::metaWarmup(asset, resource, datasets, num_datasets, context);
+}
+
+/*----------------------------------------------------------------------------
+ * snapshot
+ *
+ *  warms up the metadata of the datasets and writes it to a sidecar in the
+ *  snapshot directory so that later processes can skip parsing the resource
+ *----------------------------------------------------------------------------*/
+int H5Coro::snapshot (const Asset* asset, const char* resource, const char** datasets, int num_datasets)
+{
+    int num_saved = 0;
+
+    try
+    {
+        num_saved = H5FileBuffer::metaSnapshot(asset, resource, datasets, num_datasets);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failed to snapshot metadata of %s: %s", resource, e.what());
+    }
+
+    return num_saved;
+}
+
 /*----------------------------------------------------------------------------
  * readp
  *----------------------------------------------------------------------------*/
@@ -39,6 +39,7 @@
 #include "RecordObject.h"
 #include "List.h"
 #include "Table.h"
+#include "Dictionary.h"
 #include "Asset.h"
 
 /******************************************************************************
@@ -49,6 +50,18 @@
 #define H5CORO_MAXIMUM_NAME_SIZE 88
 #endif
 
+#ifndef H5CORO_META_REPO_SHARDS
+#define H5CORO_META_REPO_SHARDS 16 // number of independently locked partitions of the meta repository
+#endif
+
+#ifndef H5CORO_COALESCE_GAP
+#define H5CORO_COALESCE_GAP 0 // largest gap (in bytes) between chunks read as a single request (0 disables coalescing)
+#endif
+
+#ifndef H5CORO_MAX_INFLIGHT
+#define H5CORO_MAX_INFLIGHT 0x4000000 // largest number of bytes of coalesced reads held at once per dataset (64MB)
+#endif
+
 /******************************************************************************
  * HDF5 FUTURE CLASS
  ******************************************************************************/
@@ -149,6 +162,12 @@ class H5FileBuffer
             long        l1_cache_replace;
             long        l2_cache_replace;
             long        bytes_read;
+            long        range_requests; // number of coalesced chunk reads issued
+            long        range_merged; // number of chunks merged into a preceding chunk's read
+            long        range_overread; // bytes read in the gaps between merged chunks
+            int         chunk_workers; // number of threads used to read and inflate chunks (0 reads serially)
+            int64_t     coalesce_gap; // largest gap between chunks that is read through (0 disables coalescing)
+            int64_t     max_inflight; // largest number of bytes of coalesced reads held at once (at least one read is always made)
 
             io_context_t    (void);
             ~io_context_t   (void);
@@ -158,9 +177,17 @@ class H5FileBuffer
         * Methods
         *--------------------------------------------------------------------*/
 
-                            H5FileBuffer        (info_t* info, io_context_t* context, const Asset* asset, const char* resource, const char* dataset, long startrow, long numrows, bool _error_checking=false, bool _verbose=false, bool _meta_only=false);
+                            H5FileBuffer        (info_t* info, io_context_t* context, const Asset* asset, const char* resource, const char* dataset, long startrow, long numrows, bool _error_checking=false, bool _verbose=false, bool _meta_only=false, uint8_t* _buffer=NULL, int64_t _buffer_size=0);
         virtual             ~H5FileBuffer       (void);
 
+        static void         init                (int num_chunk_workers);
+        static void         deinit              (void);
+        static void         setSnapshotDir      (const char* dir);
+        static bool         getSnapshotDir      (char* dir, int size);
+        static int          metaWarmup          (const Asset* asset, const char* resource, const char** datasets, int num_datasets, io_context_t* context);
+        static int          metaSnapshot        (const Asset* asset, const char* resource, const char** datasets, int num_datasets);
+        static void         metaClear           (void);
+
     protected:
 
         /*--------------------------------------------------------------------
@@ -178,8 +205,12 @@ class H5FileBuffer
          *  30MB of data is used
          */
 
-        static const long       MAX_META_STORE          = 150000;
+        static const long       MAX_META_STORE          = 150000; // total across all shards, least recently used evicted
+        static const int        META_REPO_SHARDS        = H5CORO_META_REPO_SHARDS;
         static const long       MAX_META_NAME_SIZE      = (H5CORO_MAXIMUM_NAME_SIZE & 0xFFF8); // forces size to multiple of 8
+        static const uint32_t   META_SNAPSHOT_MAGIC     = 0x534D3548; // "H5MS"
+        static const uint32_t   META_SNAPSHOT_VERSION   = 1;
+        static const int        META_SNAPSHOT_TAG_SIZE  = 128;
 
         /*
          * Assuming:
@@ -189,6 +220,7 @@ class H5FileBuffer
          *  ~2Gbits/second --> 8MB (L1 LINESIZE)
          */
 
+        static const int64_t    IO_RANGE_MAX_SIZE       = 0x8000000; // 128MB largest coalesced read
         static const int64_t    IO_CACHE_L1_LINESIZE    = 0x100000; // 1MB cache line
         static const uint64_t   IO_CACHE_L1_MASK        = 0x0FFFFF; // lower inverse of buffer size
         static const long       IO_CACHE_L1_ENTRIES     = 157; // cache lines per dataset
@@ -199,6 +231,10 @@ class H5FileBuffer
         static const long       STR_BUFF_SIZE           = 128;
         static const long       FILTER_SIZE_SCALE       = 1; // maximum factor for dataChunkFilterBuffer
 
+        static const int        CHUNK_WORK_SIG          = 0; // signals pool workers that a job was queued
+        static const int        CHUNK_DONE_SIG          = 1; // signals readers that a pool worker released their job
+        static const int        CHUNK_NUM_SIGS          = 2;
+
         static const uint64_t   H5_SIGNATURE_LE         = 0x0A1A0A0D46444889LL;
         static const uint64_t   H5_OHDR_SIGNATURE_LE    = 0x5244484FLL; // object header
         static const uint64_t   H5_FRHP_SIGNATURE_LE    = 0x50485246LL; // fractal heap
@@ -275,6 +311,42 @@ class H5FileBuffer
             uint64_t                row_key;
         } btree_node_t;
 
+        typedef struct {
+            uint64_t                address;        // file address of chunk
+            uint32_t                chunk_size;     // size of chunk as stored in file
+            uint32_t                filter_mask;    // filters skipped for chunk
+            uint64_t                buffer_index;   // offset into data buffer to put chunked data
+            uint64_t                chunk_index;    // offset into chunk buffer to read from
+            int64_t                 chunk_bytes;    // number of bytes to read from chunk buffer
+            uint8_t*                data;           // chunk's bytes within a coalesced read (NULL when read on its own)
+        } chunk_t;
+
+        typedef MgList<uint8_t*, 256, true> range_list_t;
+
+        struct chunk_job_t
+        {
+            H5FileBuffer*           h5file;
+            List<chunk_t>*          chunks;
+            uint8_t*                buffer;
+            const char*             driver_key;     // identifies the resource the chunks are read from
+            int                     wanted;         // number of pool workers still to pick up job (protected by chunkSync)
+            int                     active;         // number of pool workers reading job (protected by chunkSync)
+            Mutex                   mut;            // protects chunks list and state below
+            int                     next;           // index of next chunk to be read
+            int                     last;           // index one past the last chunk to be read
+            bool                    failed;         // set when any worker encounters an error
+            char                    error[STR_BUFF_SIZE];
+        };
+
+        typedef struct {
+            Asset::IODriver*        driver;         // kept across jobs for as long as they read the same resource
+            const Asset*            driver_asset;
+            char*                   driver_key;
+            uint8_t*                chunk_buffer;   // buffer for reading uncompressed chunk
+            uint8_t*                filter_buffer;  // buffer for reading compressed chunk
+            int64_t                 buffer_size;    // allocated size of chunk buffer (filter buffer is scaled by FILTER_SIZE_SCALE)
+        } chunk_worker_t;
+
         typedef struct {
             int                     table_width;
             int                     curr_num_rows;
@@ -316,7 +388,25 @@ class H5FileBuffer
             int64_t                 size;
         } meta_entry_t;
 
-        typedef Table<meta_entry_t, uint64_t> meta_repo_t;
+        typedef struct meta_node {
+            meta_entry_t            entry;
+            struct meta_node*       prev;   // more recently used
+            struct meta_node*       next;   // less recently used
+        } meta_node_t;
+
+        typedef struct {
+            Mutex                   mut;
+            Dictionary<meta_node_t*> lookup; // keyed by full url
+            meta_node_t*            head;   // most recently used
+            meta_node_t*            tail;   // least recently used
+        } meta_shard_t;
+
+        typedef struct {
+            uint32_t                magic;
+            uint32_t                version;
+            uint32_t                entrysize;  // sizeof(meta_entry_t) of the writer
+            uint32_t                numentries;
+        } meta_snapshot_hdr_t;
 
        /*--------------------------------------------------------------------
         * Methods
@@ -324,7 +414,7 @@ class H5FileBuffer
 
         void                tearDown            (void);
 
-        void                ioRequest           (uint64_t* pos, int64_t size, uint8_t* buffer, int64_t hint, bool cache);
+        void                ioRequest           (uint64_t* pos, int64_t size, uint8_t* buffer, int64_t hint, bool cache, Asset::IODriver* driver=NULL);
         bool                ioCheckCache        (uint64_t pos, int64_t size, cache_t* cache, uint64_t line_mask, cache_entry_t* entry);
         static uint64_t     ioHashL1            (uint64_t key);
         static uint64_t     ioHashL2            (uint64_t key);
@@ -337,8 +427,13 @@ class H5FileBuffer
         int                 readFractalHeap     (msg_type_t type, uint64_t pos, uint8_t hdr_flags, int dlvl);
         int                 readDirectBlock     (heap_info_t* heap_info, int block_size, uint64_t pos, uint8_t hdr_flags, int dlvl);
         int                 readIndirectBlock   (heap_info_t* heap_info, int block_size, uint64_t pos, uint8_t hdr_flags, int dlvl);
-        int                 readBTreeV1         (uint64_t pos, uint8_t* buffer, uint64_t buffer_size, uint64_t buffer_offset);
+        int                 readBTreeV1         (uint64_t pos, uint8_t* buffer, uint64_t buffer_size, uint64_t buffer_offset, List<chunk_t>* chunks=NULL);
         btree_node_t        readBTreeNodeV1     (int ndims, uint64_t* pos);
+        void                readChunk           (const chunk_t& chunk, uint8_t* buffer, uint8_t* chunk_buffer, uint8_t* filter_buffer, int64_t hint, Asset::IODriver* driver);
+        void                readChunks          (List<chunk_t>& chunks, int first, int last, uint8_t* buffer, int num_workers);
+        int                 readRanges          (List<chunk_t>& chunks, int first, range_list_t& ranges);
+        static void         readJobChunks       (chunk_job_t* job, Asset::IODriver* driver, uint8_t* chunk_buffer, uint8_t* filter_buffer);
+        static void*        chunkThread         (void* parm);
         int                 readSymbolTable     (uint64_t pos, uint64_t heap_data_addr, int dlvl);
 
         int                 readObjHdr          (uint64_t pos, int dlvl);
@@ -367,14 +462,36 @@ class H5FileBuffer
 
         static uint64_t     metaGetKey          (const char* url);
         static void         metaGetUrl          (char* url, const char* resource, const char* dataset);
+        static bool         metaFind            (const char* url, meta_entry_t* entry);
+        static bool         metaLookup          (meta_shard_t& shard, const char* url, meta_entry_t* entry);
+        static int          metaCollect         (const Asset* asset, const char* resource, const char** datasets, int num_datasets, io_context_t* context, meta_entry_t* entries);
+        static void         metaAdd             (const meta_entry_t& entry);
+        bool                metaRestore         (const char* url);
+        static void         metaGetResource     (char* name, const char* url);
+        static bool         metaSnapshotPath    (char* path, int size, const char* tag);
+        static int          metaLoad            (const char* path);
 
         /*--------------------------------------------------------------------
         * Data
         *--------------------------------------------------------------------*/
 
         /* Meta Repository */
-        static meta_repo_t  metaRepo;
-        static Mutex        metaMutex;
+        static meta_shard_t metaRepo[META_REPO_SHARDS];
+
+        /* Meta Snapshots */
+        static const char*      snapshotDir;        // sidecar directory, NULL when disabled
+        static Mutex            snapshotMut;
+        static Dictionary<bool> snapshotChecked;    // resources whose sidecar has been looked for (since any of their entries were evicted)
+        static int32_t          restoreMetricId;
+
+        /* Chunk Worker Pool */
+        static Cond                 chunkSync;      // protects queue and the wanted and active counts of queued jobs
+        static List<chunk_job_t*>   chunkQueue;     // jobs waiting on pool workers
+        static bool                 chunkActive;
+        static Thread**             chunkPids;
+        static chunk_worker_t*      chunkPool;
+        static int                  chunkPoolSize;
+        static int32_t              chunkMetricId;  // number of times a pool worker picked up a job
 
         /* Class Data */
         const char*         datasetName;            // holds buffer of dataset name that datasetPath points back into
@@ -387,6 +504,9 @@ class H5FileBuffer
         bool                metaOnly;
 
         /* I/O Management */
+        const Asset*        ioAsset;
+        const char*         ioResource;
+        const char*         ioCacheKey;             // identifies resource in shared block cache
         Asset::IODriver*    ioDriver;
         char*               ioBucket;               // s3 driver
         char*               ioKey;                  // s3 driver
@@ -397,6 +517,8 @@ class H5FileBuffer
         /* File Info */
         uint8_t*            dataChunkBuffer;        // buffer for reading uncompressed chunk
         uint8_t*            dataChunkFilterBuffer;  // buffer for reading compressed chunk
+        uint8_t*            dataUserBuffer;         // caller supplied destination of dataset (not owned)
+        int64_t             dataUserBufferSize;
         int64_t             dataChunkBufferSize;    // dataChunkElements * dataInfo->typesize
         int                 highestDataLevel;       // high water mark for traversing dataset path
         int64_t             dataSizeHint;
@@ -441,10 +563,12 @@ struct H5Coro
      * Methods
      *--------------------------------------------------------------------*/
 
-    static void         init            (int num_threads);
+    static void         init            (int num_threads, int num_chunk_workers=0, int chunk_pool_size=0);
     static void         deinit          (void);
-    static info_t       read            (const Asset* asset, const char* resource, const char* datasetname, RecordObject::valType_t valtype, long col, long startrow, long numrows, context_t* context=NULL, bool _meta_only=false);
+    static info_t       read            (const Asset* asset, const char* resource, const char* datasetname, RecordObject::valType_t valtype, long col, long startrow, long numrows, context_t* context=NULL, bool _meta_only=false, uint8_t* buffer=NULL, int64_t buffer_size=0);
     static bool         traverse        (const Asset* asset, const char* resource, int max_depth, const char* start_group);
+    static int          warmup          (const Asset* asset, const char* resource, const char** datasets, int num_datasets, context_t* context=NULL);
+    static int          snapshot        (const Asset* asset, const char* resource, const char** datasets, int num_datasets);
 
     static H5Future*    readp           (const Asset* asset, const char* resource, const char* datasetname, RecordObject::valType_t valtype, long col, long startrow, long numrows, context_t* context=NULL);
     static void*        reader_thread   (void* parm);
@@ -458,6 +582,7 @@ struct H5Coro
     static bool         readerActive;
     static Thread**     readerPids; // thread pool
     static int          threadPoolSize;
+    static int          chunkWorkers; // default number of chunk workers per read
 };
 
 #endif  /* __h5coro__ */
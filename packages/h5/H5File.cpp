@@ -46,6 +46,9 @@ const struct luaL_Reg H5File::LuaMetaTable[] = {
     {"read",        luaRead},
     {"dir",         luaTraverse},
     {"inspect",     luaInspect},
+    {"warmup",      luaWarmup},
+    {"snapshot",    luaSnapshot},
+    {"stats",       luaStats},
     {NULL,          NULL}
 };
 
@@ -63,9 +66,19 @@ const RecordObject::fieldDef_t H5File::recDef[] = {
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * luaCreate - H5File(<asset>, <resource>)
+ * luaCreate - H5File(<asset>, <resource>, [<chunk workers>], [<coalesce gap>], [<max in flight>])
  *
  *  <filename> is the name of the HDF5 file to be read from or written to
+ *
+ *  <chunk workers> is the number of threads used to read and inflate the
+ *  chunks of each dataset (0 reads them serially)
+ *
+ *  <coalesce gap> is the largest gap in bytes between neighboring chunks that
+ *  are read as a single request (0 reads each chunk on its own)
+ *
+ *  <max in flight> is the largest number of bytes of coalesced reads held at
+ *  once for a dataset; the chunks are read and inflated in windows of this
+ *  size, though a window always holds at least one read
  *----------------------------------------------------------------------------*/
 int H5File::luaCreate(lua_State* L)
 {
@@ -76,9 +89,12 @@ int H5File::luaCreate(lua_State* L)
         /* Get Parameters */
         _asset = (Asset*)getLuaObject(L, 1, Asset::OBJECT_TYPE);
         const char* _resource = getLuaString(L, 2);
+        long _chunk_workers = getLuaInteger(L, 3, true, H5Coro::chunkWorkers);
+        long _coalesce_gap = getLuaInteger(L, 4, true, H5CORO_COALESCE_GAP);
+        long _max_inflight = getLuaInteger(L, 5, true, H5CORO_MAX_INFLIGHT);
 
         /* Return File Device Object */
-        return createLuaObject(L, new H5File(L, _asset, _resource));
+        return createLuaObject(L, new H5File(L, _asset, _resource, _chunk_workers, _coalesce_gap, _max_inflight));
     }
     catch(const RunTimeException& e)
     {
@@ -88,6 +104,45 @@ int H5File::luaCreate(lua_State* L)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * luaSnapshots - h5.snapshots([<directory>]) -> directory
+ *
+ *  sets the directory of the metadata snapshot sidecars; an empty string
+ *  disables them, and no argument returns the current setting
+ *----------------------------------------------------------------------------*/
+int H5File::luaSnapshots (lua_State* L)
+{
+    try
+    {
+        if(lua_gettop(L) >= 1)
+        {
+            const char* dir = getLuaString(L, 1);
+            H5FileBuffer::setSnapshotDir(dir[0] != '\0' ? dir : NULL);
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error setting snapshot directory: %s", e.what());
+    }
+
+    char dir[MAX_STR_SIZE];
+    if(H5FileBuffer::getSnapshotDir(dir, MAX_STR_SIZE))  lua_pushstring(L, dir);
+    else                                                lua_pushnil(L);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaClear - h5.clear()
+ *
+ *  empties the meta repository so that the metadata of every dataset is
+ *  parsed (or restored from a snapshot sidecar) again on its next read
+ *----------------------------------------------------------------------------*/
+int H5File::luaClear (lua_State* L)
+{
+    H5FileBuffer::metaClear();
+    return returnLuaStatus(L, true);
+}
+
 /*----------------------------------------------------------------------------
  * init
  *----------------------------------------------------------------------------*/
@@ -99,11 +154,14 @@ void H5File::init (void)
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-H5File::H5File (lua_State* L, Asset* _asset, const char* _resource):
+H5File::H5File (lua_State* L, Asset* _asset, const char* _resource, long _chunk_workers, long _coalesce_gap, long _max_inflight):
     LuaObject(L, ObjectType, LuaMetaName, LuaMetaTable)
 {
     asset = _asset;
     resource = StringLib::duplicate(_resource);
+    context.chunk_workers = _chunk_workers;
+    context.coalesce_gap = _coalesce_gap;
+    context.max_inflight = _max_inflight;
 }
 
 /*----------------------------------------------------------------------------
@@ -126,10 +184,15 @@ void* H5File::readThread (void* parm)
     H5Coro::info_t results;
     results.data = NULL;
 
+    /* Create Record (with room for the data when its size is supplied) */
+    RecordObject rec_obj(recType, info->size > 0 ? sizeof(h5file_t) + info->size : 0);
+    h5file_t* rec_data = (h5file_t*)rec_obj.getRecordData();
+    uint8_t* buffer = info->size > 0 ? (uint8_t*)rec_data + sizeof(h5file_t) : NULL;
+
     try
     {
-        /* Read Dataset */
-        results = H5Coro::read(info->h5file->asset, info->h5file->resource, info->dataset, info->valtype, info->col, info->startrow, info->numrows, &(info->h5file->context));
+        /* Read Dataset (directly into the record when it has room) */
+        results = H5Coro::read(info->h5file->asset, info->h5file->resource, info->dataset, info->valtype, info->col, info->startrow, info->numrows, &(info->h5file->context), false, buffer, info->size);
     }
     catch (const RunTimeException& e)
     {
@@ -142,9 +205,7 @@ void* H5File::readThread (void* parm)
         /* Create Output Queue Publisher */
         Publisher outq(info->outqname);
 
-        /* Create Record Object */
-        RecordObject rec_obj(recType);
-        h5file_t* rec_data = (h5file_t*)rec_obj.getRecordData();
+        /* Populate Record */
         StringLib::copy(rec_data->dataset, info->dataset, MAX_NAME_STR);
         rec_data->datatype = (uint32_t)results.datatype;
         rec_data->elements = results.elements;
@@ -153,14 +214,16 @@ void* H5File::readThread (void* parm)
         /* Post Record */
         unsigned char* rec_buf;
         int rec_size = rec_obj.serialize(&rec_buf, RecordObject::REFERENCE, sizeof(h5file_t) + results.datasize);
-        int status = outq.postCopy(rec_buf, rec_size - results.datasize, results.data, results.datasize, SYS_TIMEOUT);
+        int status;
+        if(buffer)  status = outq.postCopy(rec_buf, rec_size, SYS_TIMEOUT);
+        else        status = outq.postCopy(rec_buf, rec_size - results.datasize, results.data, results.datasize, SYS_TIMEOUT);
         if(status <= 0)
         {
             mlog(CRITICAL, "Failed (%d) to post h5 dataset: %s/%s", status, info->h5file->asset->getName(), info->dataset);
         }
 
         /* Clean Up Result Data */
-        delete [] results.data;
+        if(results.data != buffer) delete [] results.data;
     }
 
     /* Clean Up Thread Info */
@@ -174,6 +237,11 @@ void* H5File::readThread (void* parm)
 
 /*----------------------------------------------------------------------------
  * luaRead - :read(<table of datasets>, <output q>)
+ *
+ *  each dataset is a table of {dataset, [valtype], [col], [startrow],
+ *  [numrows], [size]}; when a size is given the record is created with room
+ *  for that many bytes of data and the dataset is read straight into it, and
+ *  a dataset larger than that fails to read
  *----------------------------------------------------------------------------*/
 int H5File::luaRead (lua_State* L)
 {
@@ -202,7 +270,7 @@ int H5File::luaRead (lua_State* L)
             for(int i = 0; i < num_datasets; i++)
             {
                 const char* dataset;
-                long col, startrow, numrows;
+                long col, startrow, numrows, size;
                 RecordObject::valType_t valtype;
 
                 /* Get Dataset Entry */
@@ -228,6 +296,10 @@ int H5File::luaRead (lua_State* L)
                     lua_getfield(L, -1, "numrows");
                     numrows = getLuaInteger(L, -1, true, H5Coro::ALL_ROWS);
                     lua_pop(L, 1);
+
+                    lua_getfield(L, -1, "size");
+                    size = getLuaInteger(L, -1, true, 0);
+                    lua_pop(L, 1);
                 }
                 else
                 {
@@ -241,6 +313,7 @@ int H5File::luaRead (lua_State* L)
                 info->col = col;
                 info->startrow = startrow;
                 info->numrows = numrows;
+                info->size = size;
                 info->outqname = StringLib::duplicate(outq_name);
                 info->h5file = lua_obj;
                 Thread* pid = new Thread(readThread, info);
@@ -310,6 +383,119 @@ int H5File::luaTraverse (lua_State* L)
     return returnLuaStatus(L, status);
 }
 
+/*----------------------------------------------------------------------------
+ * luaWarmup - :warmup(<table of dataset names>) -> number of datasets warmed up
+ *----------------------------------------------------------------------------*/
+int H5File::luaWarmup (lua_State* L)
+{
+    int num_warmed = 0;
+    const char** datasets = NULL;
+    int num_datasets = 0;
+
+    try
+    {
+        /* Get Self */
+        H5File* lua_obj = (H5File*)getLuaSelf(L, 1);
+
+        /* Get Dataset Names */
+        if(!lua_istable(L, 2)) throw RunTimeException(CRITICAL, RTE_ERROR, "must supply a table of dataset names");
+        num_datasets = lua_rawlen(L, 2);
+        datasets = new const char* [num_datasets];
+        for(int i = 0; i < num_datasets; i++)
+        {
+            lua_rawgeti(L, 2, i + 1);
+            datasets[i] = getLuaString(L, -1);
+            lua_pop(L, 1);
+        }
+
+        /* Populate Meta Repository */
+        num_warmed = H5Coro::warmup(lua_obj->asset, lua_obj->resource, datasets, num_datasets);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error warming up hdf5 file: %s", e.what());
+    }
+
+    if(datasets) delete [] datasets;
+
+    /* Return Number Warmed Up */
+    lua_pushinteger(L, num_warmed);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaSnapshot - :snapshot(<table of dataset names>) -> number of datasets saved
+ *----------------------------------------------------------------------------*/
+int H5File::luaSnapshot (lua_State* L)
+{
+    int num_saved = 0;
+    const char** datasets = NULL;
+    int num_datasets = 0;
+
+    try
+    {
+        /* Get Self */
+        H5File* lua_obj = (H5File*)getLuaSelf(L, 1);
+
+        /* Get Dataset Names */
+        if(!lua_istable(L, 2)) throw RunTimeException(CRITICAL, RTE_ERROR, "must supply a table of dataset names");
+        num_datasets = lua_rawlen(L, 2);
+        datasets = new const char* [num_datasets];
+        for(int i = 0; i < num_datasets; i++)
+        {
+            lua_rawgeti(L, 2, i + 1);
+            datasets[i] = getLuaString(L, -1);
+            lua_pop(L, 1);
+        }
+
+        /* Write Snapshot */
+        num_saved = H5Coro::snapshot(lua_obj->asset, lua_obj->resource, datasets, num_datasets);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error taking snapshot of hdf5 file: %s", e.what());
+    }
+
+    if(datasets) delete [] datasets;
+
+    /* Return Number Saved */
+    lua_pushinteger(L, num_saved);
+    return 1;
+}
+
+/*----------------------------------------------------------------------------
+ * luaStats - :stats() -> table of I/O statistics
+ *----------------------------------------------------------------------------*/
+int H5File::luaStats (lua_State* L)
+{
+    try
+    {
+        /* Get Self */
+        H5File* lua_obj = (H5File*)getLuaSelf(L, 1);
+        H5Coro::context_t* context = &lua_obj->context;
+
+        /* Return Statistics */
+        context->mut.lock();
+        {
+            lua_newtable(L);
+            LuaEngine::setAttrInt(L, "read_rqsts",      context->pre_prefetch_request + context->post_prefetch_request);
+            LuaEngine::setAttrInt(L, "cache_miss",      context->cache_miss);
+            LuaEngine::setAttrInt(L, "bytes_read",      context->bytes_read);
+            LuaEngine::setAttrInt(L, "range_requests",  context->range_requests);
+            LuaEngine::setAttrInt(L, "range_merged",    context->range_merged);
+            LuaEngine::setAttrInt(L, "range_overread",  context->range_overread);
+        }
+        context->mut.unlock();
+        return 1;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error getting hdf5 file statistics: %s", e.what());
+    }
+
+    return returnLuaStatus(L, false);
+}
+
 /*----------------------------------------------------------------------------
  * luaInspect - :inspect(<dataset>, <datatype>)
  *----------------------------------------------------------------------------*/
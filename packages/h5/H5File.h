@@ -79,6 +79,8 @@ class H5File: public LuaObject
          *--------------------------------------------------------------------*/
 
         static int          luaCreate           (lua_State* L);
+        static int          luaClear            (lua_State* L);
+        static int          luaSnapshots        (lua_State* L);
         static void         init                (void);
 
     protected:
@@ -93,6 +95,7 @@ class H5File: public LuaObject
             long                    col;
             long                    startrow;
             long                    numrows;
+            long                    size; // bytes of data the record is created with and read into (0 sizes it to the data)
             const char*             outqname;
             H5File*                 h5file;
         } dataset_info_t;
@@ -101,7 +104,7 @@ class H5File: public LuaObject
          * Methods
          *--------------------------------------------------------------------*/
 
-                            H5File              (lua_State* L, Asset* _asset, const char* _resource);
+                            H5File              (lua_State* L, Asset* _asset, const char* _resource, long _chunk_workers, long _coalesce_gap, long _max_inflight);
         virtual             ~H5File             (void);
 
         static void*        readThread          (void* parm);
@@ -109,6 +112,9 @@ class H5File: public LuaObject
         static int          luaRead             (lua_State* L);
         static int          luaTraverse         (lua_State* L);
         static int          luaInspect          (lua_State* L);
+        static int          luaWarmup           (lua_State* L);
+        static int          luaSnapshot         (lua_State* L);
+        static int          luaStats            (lua_State* L);
 
         /*--------------------------------------------------------------------
          * Data
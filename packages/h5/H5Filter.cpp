@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "H5Filter.h"
+#include "OsApi.h"
+#include "EventLib.h"
+#include "TimeLib.h"
+
+#if defined(H5CORO_INFLATE_LIBDEFLATE)
+#include <libdeflate.h>
+#elif defined(H5CORO_INFLATE_ZLIB_NG)
+#include <zlib-ng.h>
+#else
+#include <zlib.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+#if defined(H5CORO_INFLATE_ZLIB_NG)
+typedef zng_stream h5_stream_t;
+#define h5_inflateInit  zng_inflateInit
+#define h5_inflateReset zng_inflateReset
+#define h5_inflate      ::zng_inflate
+#define h5_inflateEnd   zng_inflateEnd
+#define H5_INFLATE_BACKEND "zlib-ng"
+#elif !defined(H5CORO_INFLATE_LIBDEFLATE)
+typedef z_stream h5_stream_t;
+#define h5_inflateInit  inflateInit
+#define h5_inflateReset inflateReset
+#define h5_inflate      ::inflate
+#define h5_inflateEnd   inflateEnd
+#define H5_INFLATE_BACKEND "zlib"
+#else
+#define H5_INFLATE_BACKEND "libdeflate"
+#endif
+
+/******************************************************************************
+ * STATIC DATA
+ ******************************************************************************/
+
+const char* H5Filter::METRIC_CATEGORY = "h5";
+
+Thread::key_t H5Filter::stateKey;
+int32_t H5Filter::inflateBytesMetricId = EventLib::INVALID_METRIC;
+int32_t H5Filter::inflateTimeMetricId = EventLib::INVALID_METRIC;
+int32_t H5Filter::shuffleBytesMetricId = EventLib::INVALID_METRIC;
+int32_t H5Filter::shuffleTimeMetricId = EventLib::INVALID_METRIC;
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * unshuffleElements
+ *
+ *  the shuffled chunk holds byte plane b of every element starting at
+ *  b * plane_size; the type size is a template parameter so that the inner
+ *  loop is unrolled
+ *----------------------------------------------------------------------------*/
+template <int TYPE_SIZE>
+static void unshuffleElements (const uint8_t* input, int64_t plane_size, uint8_t* output, int64_t start_element, int64_t num_elements)
+{
+    for(int64_t e = 0; e < num_elements; e++)
+    {
+        for(int b = 0; b < TYPE_SIZE; b++)
+        {
+            output[(e * TYPE_SIZE) + b] = input[(b * plane_size) + start_element + e];
+        }
+    }
+}
+
+#if defined(__SSE2__)
+
+/*----------------------------------------------------------------------------
+ * unshuffleVector2
+ *
+ *  interleaves 16 elements at a time from the byte planes; returns the
+ *  number of elements unshuffled, the rest are left to unshuffleElements
+ *----------------------------------------------------------------------------*/
+static int64_t unshuffleVector2 (const uint8_t* input, int64_t plane_size, uint8_t* output, int64_t start_element, int64_t num_elements)
+{
+    int64_t e = 0;
+    for(; e + 16 <= num_elements; e += 16)
+    {
+        const uint8_t* src = &input[start_element + e];
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(src));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(src + plane_size));
+
+        __m128i* dst = (__m128i*)&output[e * 2];
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi8(p0, p1));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(p0, p1));
+    }
+    return e;
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffleVector4
+ *----------------------------------------------------------------------------*/
+static int64_t unshuffleVector4 (const uint8_t* input, int64_t plane_size, uint8_t* output, int64_t start_element, int64_t num_elements)
+{
+    int64_t e = 0;
+    for(; e + 16 <= num_elements; e += 16)
+    {
+        const uint8_t* src = &input[start_element + e];
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(src));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(src + plane_size));
+        __m128i p2 = _mm_loadu_si128((const __m128i*)(src + (2 * plane_size)));
+        __m128i p3 = _mm_loadu_si128((const __m128i*)(src + (3 * plane_size)));
+
+        /* Bytes 0-1 and 2-3 of Each Element */
+        __m128i t01l = _mm_unpacklo_epi8(p0, p1);
+        __m128i t01h = _mm_unpackhi_epi8(p0, p1);
+        __m128i t23l = _mm_unpacklo_epi8(p2, p3);
+        __m128i t23h = _mm_unpackhi_epi8(p2, p3);
+
+        __m128i* dst = (__m128i*)&output[e * 4];
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(t01l, t23l));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(t01l, t23l));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(t01h, t23h));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(t01h, t23h));
+    }
+    return e;
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffleVector8
+ *----------------------------------------------------------------------------*/
+static int64_t unshuffleVector8 (const uint8_t* input, int64_t plane_size, uint8_t* output, int64_t start_element, int64_t num_elements)
+{
+    int64_t e = 0;
+    for(; e + 16 <= num_elements; e += 16)
+    {
+        const uint8_t* src = &input[start_element + e];
+        __m128i p0 = _mm_loadu_si128((const __m128i*)(src));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(src + plane_size));
+        __m128i p2 = _mm_loadu_si128((const __m128i*)(src + (2 * plane_size)));
+        __m128i p3 = _mm_loadu_si128((const __m128i*)(src + (3 * plane_size)));
+        __m128i p4 = _mm_loadu_si128((const __m128i*)(src + (4 * plane_size)));
+        __m128i p5 = _mm_loadu_si128((const __m128i*)(src + (5 * plane_size)));
+        __m128i p6 = _mm_loadu_si128((const __m128i*)(src + (6 * plane_size)));
+        __m128i p7 = _mm_loadu_si128((const __m128i*)(src + (7 * plane_size)));
+
+        /* Byte Pairs */
+        __m128i t01l = _mm_unpacklo_epi8(p0, p1);
+        __m128i t01h = _mm_unpackhi_epi8(p0, p1);
+        __m128i t23l = _mm_unpacklo_epi8(p2, p3);
+        __m128i t23h = _mm_unpackhi_epi8(p2, p3);
+        __m128i t45l = _mm_unpacklo_epi8(p4, p5);
+        __m128i t45h = _mm_unpackhi_epi8(p4, p5);
+        __m128i t67l = _mm_unpacklo_epi8(p6, p7);
+        __m128i t67h = _mm_unpackhi_epi8(p6, p7);
+
+        /* Bytes 0-3 of Each Element */
+        __m128i u0 = _mm_unpacklo_epi16(t01l, t23l);
+        __m128i u1 = _mm_unpackhi_epi16(t01l, t23l);
+        __m128i u2 = _mm_unpacklo_epi16(t01h, t23h);
+        __m128i u3 = _mm_unpackhi_epi16(t01h, t23h);
+
+        /* Bytes 4-7 of Each Element */
+        __m128i v0 = _mm_unpacklo_epi16(t45l, t67l);
+        __m128i v1 = _mm_unpackhi_epi16(t45l, t67l);
+        __m128i v2 = _mm_unpacklo_epi16(t45h, t67h);
+        __m128i v3 = _mm_unpackhi_epi16(t45h, t67h);
+
+        __m128i* dst = (__m128i*)&output[e * 8];
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi32(u0, v0));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi32(u0, v0));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi32(u1, v1));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi32(u1, v1));
+        _mm_storeu_si128(dst + 4, _mm_unpacklo_epi32(u2, v2));
+        _mm_storeu_si128(dst + 5, _mm_unpackhi_epi32(u2, v2));
+        _mm_storeu_si128(dst + 6, _mm_unpacklo_epi32(u3, v3));
+        _mm_storeu_si128(dst + 7, _mm_unpackhi_epi32(u3, v3));
+    }
+    return e;
+}
+
+#else
+
+static int64_t unshuffleVector2 (const uint8_t*, int64_t, uint8_t*, int64_t, int64_t) { return 0; }
+static int64_t unshuffleVector4 (const uint8_t*, int64_t, uint8_t*, int64_t, int64_t) { return 0; }
+static int64_t unshuffleVector8 (const uint8_t*, int64_t, uint8_t*, int64_t, int64_t) { return 0; }
+
+#endif
+
+/******************************************************************************
+ * H5 FILTER CLASS
+ ******************************************************************************/
+
+/*----------------------------------------------------------------------------
+ * init
+ *----------------------------------------------------------------------------*/
+void H5Filter::init (void)
+{
+    stateKey = Thread::createGlobal(freeState);
+
+    inflateBytesMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "inflate_bytes");
+    inflateTimeMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "inflate_time");
+    shuffleBytesMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "shuffle_bytes");
+    shuffleTimeMetricId = EventLib::registerMetric(METRIC_CATEGORY, EventLib::COUNTER, "%s", "shuffle_time");
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *
+ *  threads publish their metrics and free their own state when they exit;
+ *  this does it for the calling thread
+ *----------------------------------------------------------------------------*/
+void H5Filter::deinit (void)
+{
+    void* state = Thread::getGlobal(stateKey);
+    if(state)
+    {
+        Thread::setGlobal(stateKey, NULL);
+        freeState(state);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * backend
+ *----------------------------------------------------------------------------*/
+const char* H5Filter::backend (void)
+{
+    return H5_INFLATE_BACKEND;
+}
+
+/*----------------------------------------------------------------------------
+ * inflate
+ *
+ *  decompresses a zlib formatted chunk into the output buffer
+ *----------------------------------------------------------------------------*/
+void H5Filter::inflate (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size)
+{
+    double start = TimeLib::latchtime();
+    filter_state_t* state = getState();
+
+#if defined(H5CORO_INFLATE_LIBDEFLATE)
+
+    /* Decompress Entire Chunk in One Call */
+    struct libdeflate_decompressor* decompressor = (struct libdeflate_decompressor*)state->decompressor;
+    size_t actual_size = 0;
+    enum libdeflate_result result = libdeflate_zlib_decompress(decompressor, input, input_size, output, output_size, &actual_size);
+    if(result != LIBDEFLATE_SUCCESS)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to inflate chunk: %d", (int)result);
+    }
+
+#else
+
+    /* Reset Thread's Stream */
+    h5_stream_t* strm = (h5_stream_t*)state->decompressor;
+    int status = h5_inflateReset(strm);
+    if(status != Z_OK)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to reset z_stream: %d", status);
+    }
+
+    /* Decompress Until Entire Chunk is Processed */
+    strm->avail_in = input_size;
+    strm->next_in = (uint8_t*)input;
+    do
+    {
+        strm->avail_out = output_size;
+        strm->next_out = output;
+        status = h5_inflate(strm, Z_NO_FLUSH);
+        if(status != Z_OK) break;
+    } while (strm->avail_out == 0);
+
+    /* Check Decompression Complete */
+    if(status != Z_STREAM_END)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to inflate entire z_stream: %d", status);
+    }
+
+#endif
+
+    /* Accumulate Metrics */
+    state->inflate_bytes += output_size;
+    state->inflate_time += TimeLib::latchtime() - start;
+    if(++state->chunks >= METRIC_PUBLISH_CHUNKS) publishMetrics(state);
+}
+
+/*----------------------------------------------------------------------------
+ * unshuffle
+ *
+ *  reassembles output_size bytes of elements, starting output_offset bytes
+ *  into the chunk, from the byte planes of the shuffled chunk
+ *----------------------------------------------------------------------------*/
+void H5Filter::unshuffle (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_offset, uint32_t output_size, int type_size)
+{
+    double start = TimeLib::latchtime();
+
+    int64_t plane_size = input_size / type_size;
+    int64_t num_elements = output_size / type_size;
+    int64_t start_element = output_offset / type_size;
+
+    int64_t e = 0;
+    switch(type_size)
+    {
+        case 1:
+        {
+            LocalLib::copy(output, &input[start_element], num_elements);
+            break;
+        }
+        case 2:
+        {
+            e = unshuffleVector2(input, plane_size, output, start_element, num_elements);
+            unshuffleElements<2>(input, plane_size, &output[e * 2], start_element + e, num_elements - e);
+            break;
+        }
+        case 4:
+        {
+            e = unshuffleVector4(input, plane_size, output, start_element, num_elements);
+            unshuffleElements<4>(input, plane_size, &output[e * 4], start_element + e, num_elements - e);
+            break;
+        }
+        case 8:
+        {
+            e = unshuffleVector8(input, plane_size, output, start_element, num_elements);
+            unshuffleElements<8>(input, plane_size, &output[e * 8], start_element + e, num_elements - e);
+            break;
+        }
+        default:
+        {
+            int64_t dst_index = 0;
+            for(int64_t element_index = start_element; element_index < (start_element + num_elements); element_index++)
+            {
+                for(int64_t val_index = 0; val_index < type_size; val_index++)
+                {
+                    int64_t src_index = (val_index * plane_size) + element_index;
+                    output[dst_index++] = input[src_index];
+                }
+            }
+            break;
+        }
+    }
+
+    /* Accumulate Metrics */
+    filter_state_t* state = getState();
+    state->shuffle_bytes += output_size;
+    state->shuffle_time += TimeLib::latchtime() - start;
+    if(++state->chunks >= METRIC_PUBLISH_CHUNKS) publishMetrics(state);
+}
+
+/*----------------------------------------------------------------------------
+ * getState
+ *
+ *  returns the calling thread's filter state, creating it and its
+ *  decompressor on first use
+ *----------------------------------------------------------------------------*/
+H5Filter::filter_state_t* H5Filter::getState (void)
+{
+    filter_state_t* state = (filter_state_t*)Thread::getGlobal(stateKey);
+    if(state) return state;
+
+#if defined(H5CORO_INFLATE_LIBDEFLATE)
+
+    void* decompressor = libdeflate_alloc_decompressor();
+    if(!decompressor)
+    {
+        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to allocate decompressor");
+    }
+
+#else
+
+    h5_stream_t* strm = new h5_stream_t;
+    LocalLib::set(strm, 0, sizeof(h5_stream_t));
+    int status = h5_inflateInit(strm);
+    if(status != Z_OK)
+    {
+        delete strm;
+        throw RunTimeException(CRITICAL, RTE_ERROR, "failed to initialize z_stream: %d", status);
+    }
+    void* decompressor = strm;
+
+#endif
+
+    state = new filter_state_t;
+    LocalLib::set(state, 0, sizeof(filter_state_t));
+    state->decompressor = decompressor;
+
+    Thread::setGlobal(stateKey, state);
+    return state;
+}
+
+/*----------------------------------------------------------------------------
+ * publishMetrics
+ *
+ *  adds the thread's accumulated counts to the shared metrics, which are
+ *  updated under a global lock, and resets them
+ *----------------------------------------------------------------------------*/
+void H5Filter::publishMetrics (filter_state_t* state)
+{
+    if(state->inflate_bytes > 0)
+    {
+        EventLib::incrementMetric(inflateBytesMetricId, state->inflate_bytes);
+        EventLib::incrementMetric(inflateTimeMetricId, state->inflate_time);
+    }
+
+    if(state->shuffle_bytes > 0)
+    {
+        EventLib::incrementMetric(shuffleBytesMetricId, state->shuffle_bytes);
+        EventLib::incrementMetric(shuffleTimeMetricId, state->shuffle_time);
+    }
+
+    state->inflate_bytes = 0;
+    state->inflate_time = 0.0;
+    state->shuffle_bytes = 0;
+    state->shuffle_time = 0.0;
+    state->chunks = 0;
+}
+
+/*----------------------------------------------------------------------------
+ * freeState
+ *
+ *  called when a thread exits
+ *----------------------------------------------------------------------------*/
+void H5Filter::freeState (void* parm)
+{
+    filter_state_t* state = (filter_state_t*)parm;
+
+    publishMetrics(state);
+
+#if defined(H5CORO_INFLATE_LIBDEFLATE)
+    libdeflate_free_decompressor((struct libdeflate_decompressor*)state->decompressor);
+#else
+    h5_stream_t* strm = (h5_stream_t*)state->decompressor;
+    h5_inflateEnd(strm);
+    delete strm;
+#endif
+
+    delete state;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021, University of Washington
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the University of Washington nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE UNIVERSITY OF WASHINGTON AND CONTRIBUTORS
+ * “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE UNIVERSITY OF WASHINGTON OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __h5_filter__
+#define __h5_filter__
+
+/******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include "OsApi.h"
+
+/******************************************************************************
+ * DEFINES
+ ******************************************************************************/
+
+/*
+ * Inflate Backend
+ *  zlib is used unless the build selects zlib-ng (H5CORO_INFLATE_ZLIB_NG)
+ *  or libdeflate (H5CORO_INFLATE_LIBDEFLATE); see H5CORO_INFLATE_BACKEND
+ */
+#if defined(H5CORO_INFLATE_ZLIB_NG) && defined(H5CORO_INFLATE_LIBDEFLATE)
+#error "only one inflate backend can be selected"
+#endif
+
+/******************************************************************************
+ * H5 FILTER CLASS
+ *
+ *  Implementations of the HDF5 deflate and shuffle filters used when reading
+ *  chunked datasets.  Decompressor state is kept per thread and reset between
+ *  chunks instead of being created and destroyed for each one, and the
+ *  shuffle filter has vectorized kernels for the 2, 4, and 8 byte type sizes.
+ *  Filter metrics are accumulated per thread and published every
+ *  METRIC_PUBLISH_CHUNKS chunks and when the thread exits.
+ ******************************************************************************/
+
+class H5Filter
+{
+    public:
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const char*  METRIC_CATEGORY;
+        static const int    METRIC_PUBLISH_CHUNKS = 256; // filtered chunks a thread accumulates before publishing its metrics
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static void         init        (void);
+        static void         deinit      (void);
+        static const char*  backend     (void);
+        static void         inflate     (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_size);
+        static void         unshuffle   (const uint8_t* input, uint32_t input_size, uint8_t* output, uint32_t output_offset, uint32_t output_size, int type_size);
+
+    private:
+
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef struct {
+            void*       decompressor;
+            int64_t     inflate_bytes;
+            double      inflate_time;
+            int64_t     shuffle_bytes;
+            double      shuffle_time;
+            int         chunks; // filtered since metrics were last published
+        } filter_state_t;
+
+        /*--------------------------------------------------------------------
+         * Methods
+         *--------------------------------------------------------------------*/
+
+        static filter_state_t*  getState        (void);
+        static void             publishMetrics  (filter_state_t* state);
+        static void             freeState       (void* parm);
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static Thread::key_t    stateKey;
+        static int32_t          inflateBytesMetricId;
+        static int32_t          inflateTimeMetricId;
+        static int32_t          shuffleBytesMetricId;
+        static int32_t          shuffleTimeMetricId;
+};
+
+#endif  /* __h5_filter__ */
@@ -46,6 +46,18 @@
 #define H5CORO_THREAD_POOL_SIZE 128
 #endif
 
+#ifndef H5CORO_CHUNK_WORKERS
+#define H5CORO_CHUNK_WORKERS 0
+#endif
+
+#ifndef H5CORO_CHUNK_POOL_SIZE
+#define H5CORO_CHUNK_POOL_SIZE 0 // chunk workers shared by all reads, number of processors when zero
+#endif
+
+#ifndef H5CORO_BLOCK_CACHE_SIZE
+#define H5CORO_BLOCK_CACHE_SIZE 0 // bytes, shared block cache disabled when zero
+#endif
+
 /******************************************************************************
  * LOCAL FUNCTIONS
  ******************************************************************************/
@@ -58,6 +70,9 @@ int h5_open (lua_State *L)
     static const struct luaL_Reg h5_functions[] = {
         {"file",        H5File::luaCreate},
         {"dataset",     H5DatasetDevice::luaCreate},
+        {"cache",       H5BlockCache::luaCache},
+        {"snapshots",   H5File::luaSnapshots},
+        {"clear",       H5File::luaClear},
         {NULL,          NULL}
     };
 
@@ -66,6 +81,8 @@ int h5_open (lua_State *L)
 
     /* Set Globals */
     LuaEngine::setAttrInt(L, "ALL_ROWS", H5Coro::ALL_ROWS);
+    LuaEngine::setAttrInt(L, "ALL_COLS", H5Coro::ALL_COLS);
+    LuaEngine::setAttrStr(L, "INFLATE_BACKEND", H5Filter::backend());
 
     return 1;
 }
@@ -78,7 +95,9 @@ extern "C" {
 void inith5 (void)
 {
     /* Initialize Modules */
-    H5Coro::init(H5CORO_THREAD_POOL_SIZE);
+    H5Coro::init(H5CORO_THREAD_POOL_SIZE, H5CORO_CHUNK_WORKERS, H5CORO_CHUNK_POOL_SIZE);
+    H5BlockCache::init(H5CORO_BLOCK_CACHE_SIZE);
+    H5Filter::init();
     H5DArray::init();
     H5DatasetDevice::init();
     H5File::init();
@@ -96,5 +115,7 @@ void inith5 (void)
 void deinith5 (void)
 {
     H5Coro::deinit();
+    H5BlockCache::deinit();
+    H5Filter::deinit();
 }
 }
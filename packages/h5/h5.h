@@ -37,6 +37,8 @@
  ******************************************************************************/
 
 #include "H5Coro.h"
+#include "H5BlockCache.h"
+#include "H5Filter.h"
 #include "H5Array.h"
 #include "H5DArray.h"
 #include "H5DatasetDevice.h"
@@ -36,11 +36,14 @@
 #include "UT_MsgQ.h"
 #include "core.h"
 
+#include <algorithm>
+
 /******************************************************************************
  * STATIC DATA
  ******************************************************************************/
 
 const char* UT_MsgQ::TYPE = "UT_MsgQ";
+int UT_MsgQ::freeCount = 0;
 
 /******************************************************************************
  * PUBLIC METHODS
@@ -69,6 +72,10 @@ UT_MsgQ::UT_MsgQ(CommandProcessor* cmd_proc, const char* obj_name):
     registerCommand("SUBSCRIBE_UNSUBSCRIBE_TEST", (cmdFunc_t)&UT_MsgQ::subscribeUnsubscribeUnitTestCmd, 0, "");
     registerCommand("PERFORMANCE_TEST", (cmdFunc_t)&UT_MsgQ::performanceUnitTestCmd, 0, "[<depth> <size>]");
     registerCommand("SUBSCRIBER_OF_OPPORTUNITY_TEST", (cmdFunc_t)&UT_MsgQ::subscriberOfOpporunityUnitTestCmd, 0, "");    
+    registerCommand("SHARED_BUFFER_TEST", (cmdFunc_t)&UT_MsgQ::sharedBufferUnitTestCmd, 0, "");
+    registerCommand("THROUGHPUT_TEST", (cmdFunc_t)&UT_MsgQ::throughputUnitTestCmd, 0, "[<count> <size> <copy|buffer>]");
+    registerCommand("RING_QUEUE_TEST", (cmdFunc_t)&UT_MsgQ::ringQueueUnitTestCmd, 0, "");
+    registerCommand("LATENCY_TEST", (cmdFunc_t)&UT_MsgQ::latencyUnitTestCmd, 0, "[<count> <subscribers> <depth>]");
 }
 
 /*----------------------------------------------------------------------------
@@ -734,6 +741,703 @@ void* UT_MsgQ::opportunityThread(void* parm)
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * sharedBufferUnitTestCmd  -
+ *----------------------------------------------------------------------------*/
+int UT_MsgQ::sharedBufferUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE])
+{
+    (void)argc;
+    (void)argv;
+
+    int errorcnt = 0;
+    const int numsubs = 3;
+    const int numbufs = 100;
+    const int bufsize = 1000;
+
+    /* Create Publisher and Subscribers */
+    Publisher* pubq = new Publisher("testq_05");
+    Subscriber* subq[numsubs];
+    for(int i = 0; i < numsubs; i++) subq[i] = new Subscriber("testq_05");
+
+    /* STEP 1: Post Shared Buffers */
+    SharedBuffer* first = NULL;
+    for(int b = 0; b < numbufs; b++)
+    {
+        SharedBuffer* buffer = SharedBuffer::create(bufsize);
+        LocalLib::set(buffer->getData(), (unsigned char)b, bufsize);
+        if(b == 0) first = buffer->retain();
+        int status = pubq->postBuffer(buffer);
+        if(status != bufsize)
+        {
+            print2term("[%d] ERROR: post of buffer %d failed with status %d\n", __LINE__, b, status);
+            buffer->release();
+            errorcnt++;
+        }
+    }
+
+    /* STEP 2: Check Queue Holds a Reference per Post */
+    if(first->getRefs() != 2)
+    {
+        print2term("[%d] ERROR: expected 2 references to posted buffer, got %d\n", __LINE__, first->getRefs());
+        errorcnt++;
+    }
+
+    /* STEP 3: Receive Without Copying and Retain First Buffer */
+    SharedBuffer* retained[numsubs];
+    for(int i = 0; i < numsubs; i++)
+    {
+        retained[i] = NULL;
+        for(int b = 0; b < numbufs; b++)
+        {
+            Subscriber::msgRef_t ref;
+            int status = subq[i]->receiveRef(ref, IO_CHECK);
+            if(status != MsgQ::STATE_OKAY)
+            {
+                print2term("[%d] ERROR: receive %d on subscriber %d failed with status %d\n", __LINE__, b, i, status);
+                errorcnt++;
+                break;
+            }
+            else if(ref.size != bufsize || ((unsigned char*)ref.data)[bufsize - 1] != (unsigned char)b)
+            {
+                print2term("[%d] ERROR: receive %d on subscriber %d has wrong contents\n", __LINE__, b, i);
+                errorcnt++;
+            }
+            if(b == 0)
+            {
+                retained[i] = subq[i]->retain(ref);
+                if(retained[i] != first || ref.data != first->getData())
+                {
+                    print2term("[%d] ERROR: subscriber %d did not receive the posted buffer in place\n", __LINE__, i);
+                    errorcnt++;
+                }
+            }
+            subq[i]->dereference(ref);
+        }
+    }
+
+    /* STEP 4: Check Queue Released Its Reference */
+    if(first->getRefs() != 1 + numsubs)
+    {
+        print2term("[%d] ERROR: expected %d references to retained buffer, got %d\n", __LINE__, 1 + numsubs, first->getRefs());
+        errorcnt++;
+    }
+    for(int i = 0; i < numsubs; i++)
+    {
+        if(retained[i]) retained[i]->release();
+    }
+    if(first->getRefs() != 1 || first->getData()[0] != 0)
+    {
+        print2term("[%d] ERROR: retained buffer not intact after release, %d references\n", __LINE__, first->getRefs());
+        errorcnt++;
+    }
+    first->release();
+
+    /* STEP 5: Retain Copy of Message Posted by Copy */
+    long data = 0x5A5A5A5A;
+    pubq->postCopy(&data, sizeof(data));
+    for(int i = 0; i < numsubs; i++)
+    {
+        Subscriber::msgRef_t ref;
+        if(subq[i]->receiveRef(ref, IO_CHECK) == MsgQ::STATE_OKAY)
+        {
+            SharedBuffer* copy = subq[i]->retain(ref);
+            subq[i]->dereference(ref);
+            if(copy->getSize() != sizeof(data) || *(long*)copy->getData() != data)
+            {
+                print2term("[%d] ERROR: retained copy on subscriber %d has wrong contents\n", __LINE__, i);
+                errorcnt++;
+            }
+            copy->release();
+        }
+        else
+        {
+            print2term("[%d] ERROR: failed to receive copy on subscriber %d\n", __LINE__, i);
+            errorcnt++;
+        }
+    }
+
+    /* STEP 6: Write to Records Wrapping a Posted Buffer */
+    RecordObject::defineRecord("ut_msgq_rec", NULL, sizeof(int32_t), NULL, 0, 1);
+    RecordObject::defineField("ut_msgq_rec", "value", RecordObject::INT32, 0, 1, NULL);
+    RecordObject* posted = new RecordObject("ut_msgq_rec");
+    posted->setValueInteger(posted->getField("value"), 1);
+    pubq->postBuffer(posted->share());
+    for(int i = 0; i < numsubs; i++)
+    {
+        Subscriber::msgRef_t ref;
+        if(subq[i]->receiveRef(ref, IO_CHECK) == MsgQ::STATE_OKAY)
+        {
+            SharedBuffer* buffer = subq[i]->retain(ref);
+            subq[i]->dereference(ref);
+            RecordObject* wrapped = new RecordObject(buffer);
+            buffer->release();
+            if(wrapped->getValueInteger(wrapped->getField("value")) != 1)
+            {
+                print2term("[%d] ERROR: record on subscriber %d sees write from another holder\n", __LINE__, i);
+                errorcnt++;
+            }
+            wrapped->setValueInteger(wrapped->getField("value"), 2 + i);
+            delete wrapped;
+        }
+        else
+        {
+            print2term("[%d] ERROR: failed to receive record on subscriber %d\n", __LINE__, i);
+            errorcnt++;
+        }
+    }
+    if(posted->getValueInteger(posted->getField("value")) != 1)
+    {
+        print2term("[%d] ERROR: posted record sees write from a subscriber\n", __LINE__);
+        errorcnt++;
+    }
+    delete posted;
+
+    /* Clean Up */
+    for(int i = 0; i < numsubs; i++) delete subq[i];
+    delete pubq;
+
+    if(errorcnt == 0)   return 0;
+    else                return -1;
+}
+
+/*----------------------------------------------------------------------------
+ * throughputUnitTestCmd  -
+ *
+ *  streams messages through a queue of bounded depth to 1, 4, and 16
+ *  concurrent subscribers and reports the messages and bytes delivered per
+ *  second; in copy mode messages are posted by copy and each subscriber
+ *  copies what it receives (as when deserializing into a record), in buffer
+ *  mode messages are posted as shared buffers and each subscriber retains
+ *  the buffer it receives
+ *----------------------------------------------------------------------------*/
+int UT_MsgQ::throughputUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE])
+{
+    long count = 200000;
+    long size = 1000;
+    bool shared = false;
+    bool failure = false;
+
+    /* Parse Inputs */
+    if(argc > 3)
+    {
+        print2term("Invalid number of parameters passed to command: %d\n", argc);
+        return -1;
+    }
+    if(argc > 0 && (StringLib::str2long(argv[0], &count) == false || count <= 0))
+    {
+        print2term("[%d] ERROR: unable to parse count\n", __LINE__);
+        return -1;
+    }
+    if(argc > 1 && (StringLib::str2long(argv[1], &size) == false || size < (long)sizeof(long)))
+    {
+        print2term("[%d] ERROR: unable to parse size\n", __LINE__);
+        return -1;
+    }
+    if(argc > 2)
+    {
+        if(StringLib::match(argv[2], "buffer"))     shared = true;
+        else if(StringLib::match(argv[2], "copy"))  shared = false;
+        else
+        {
+            print2term("[%d] ERROR: invalid mode %s\n", __LINE__, argv[2]);
+            return -1;
+        }
+    }
+
+    /* Create Publisher */
+    Publisher* p = new Publisher("testq_06", NULL, THROUGHPUT_DEPTH);
+    unsigned char* pkt = new unsigned char [size];
+    LocalLib::set(pkt, 0, size);
+
+    /* Iterate Over Number of Subscribers */
+    const int subscriber_counts[] = {1, 4, 16};
+    print2term("Mode, Count, Size, Subscribers, Seconds, Msgs/s, Bytes/s\n");
+    for(int n = 0; n < 3; n++)
+    {
+        int numsubs = subscriber_counts[n];
+        throughput_thread_t* RAW = new throughput_thread_t[numsubs];
+        Thread** t = new Thread* [numsubs];
+
+        /* Kick-off Subscribers */
+        for(int i = 0; i < numsubs; i++)
+        {
+            RAW[i].s = new Subscriber("testq_06");
+            RAW[i].count = count;
+            RAW[i].size = size;
+            RAW[i].f = false;
+        }
+        double start = TimeLib::latchtime();
+        for(int i = 0; i < numsubs; i++)
+        {
+            t[i] = new Thread(throughputThread, &RAW[i]);
+        }
+
+        /* Publish Messages */
+        for(long i = 0; i < count; i++)
+        {
+            int status;
+            *(long*)pkt = i;
+            if(shared)
+            {
+                SharedBuffer* buffer = SharedBuffer::create(size);
+                LocalLib::copy(buffer->getData(), pkt, size);
+                status = p->postBuffer(buffer, IO_PEND);
+                if(status <= 0) buffer->release();
+            }
+            else
+            {
+                status = p->postCopy(pkt, size, IO_PEND);
+            }
+
+            if(status <= 0)
+            {
+                print2term("[%d] ERROR: unable to post message %ld with error %d\n", __LINE__, i, status);
+                failure = true;
+                break;
+            }
+        }
+
+        /* Join Subscribers */
+        for(int i = 0; i < numsubs; i++)
+        {
+            delete t[i]; // performs a join
+            failure = failure || RAW[i].f;
+        }
+        double elapsed = TimeLib::latchtime() - start;
+
+        /* Print Results */
+        double msgs_per_sec = (double)count * numsubs / elapsed;
+        print2term("%s, %ld, %ld, %d, %.3lf, %.0lf, %.0lf\n", shared ? "buffer" : "copy", count, size, numsubs, elapsed, msgs_per_sec, msgs_per_sec * size);
+
+        /* Clean Up */
+        for(int i = 0; i < numsubs; i++) delete RAW[i].s;
+        delete [] RAW;
+        delete [] t;
+    }
+
+    /* Delete Test Structures */
+    delete [] pkt;
+    delete p;
+
+    if(failure) return -1;
+    else        return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * throughputThread  -
+ *----------------------------------------------------------------------------*/
+void* UT_MsgQ::throughputThread(void* parm)
+{
+    throughput_thread_t* RAW = (throughput_thread_t*)parm;
+
+    for(long msgnum = 0; msgnum < RAW->count; msgnum++)
+    {
+        Subscriber::msgRef_t ref;
+        int status = RAW->s->receiveRef(ref, SYS_TIMEOUT);
+        if(status > 0)
+        {
+            SharedBuffer* buffer = RAW->s->retain(ref);
+            RAW->s->dereference(ref);
+            if(buffer->getSize() != RAW->size || *(long*)buffer->getData() != msgnum)
+            {
+                print2term("[%d] ERROR: unexpected message %ld of size %d\n", __LINE__, msgnum, buffer->getSize());
+                RAW->f = true;
+            }
+            buffer->release();
+        }
+        else
+        {
+            print2term("[%d] ERROR: failed to receive message %ld, error %d\n", __LINE__, msgnum, status);
+            RAW->f = true;
+        }
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * ringPublisherThread  -
+ *----------------------------------------------------------------------------*/
+void* UT_MsgQ::ringPublisherThread(void* parm)
+{
+    ring_publisher_t* RAW = (ring_publisher_t*)parm;
+
+    for(long i = RAW->first; i < RAW->first + RAW->count; i++)
+    {
+        int status = RAW->p->postCopy(&i, sizeof(long), SYS_TIMEOUT);
+        if(status != sizeof(long))
+        {
+            print2term("[%d] ERROR: post %ld error %d\n", __LINE__, i, status);
+            RAW->f = true;
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * ringQueueUnitTestCmd  -
+ *----------------------------------------------------------------------------*/
+int UT_MsgQ::ringQueueUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE])
+{
+    (void)argc;
+    (void)argv;
+
+    int errorcnt = 0;
+
+    /* TEST01:
+     *      STEP 1: Fill ring
+     *      STEP 2: Check full and blocking post timeout
+     *      STEP 3: Check receive order and blocking receive timeout
+     *      STEP 4: Check post with no subscribers
+     */
+
+    Publisher* pubq = new Publisher("testq_07", NULL, 4, MsgQ::CFG_SIZE_INFINITY, MsgQ::RING_QUEUE);
+    Subscriber* subq = new Subscriber("testq_07");
+    if(!pubq->isRing() || pubq->getDepth() != 4)
+    {
+        print2term("[%d] ERROR: ring queue not created with depth 4: %d\n", __LINE__, pubq->getDepth());
+        errorcnt++;
+    }
+
+    /* STEP 1: Fill Ring */
+    long data = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        int status = pubq->postCopy(&data, sizeof(long));
+        if(status != sizeof(long))
+        {
+            print2term("[%d] ERROR: post %ld error %d\n", __LINE__, data, status);
+            errorcnt++;
+        }
+        data++;
+    }
+
+    /* STEP 2: Check Full */
+    int status2a = pubq->postCopy(&data, sizeof(long));
+    int status2b = pubq->postCopy(&data, sizeof(long), SYS_TIMEOUT);
+    if(status2a != MsgQ::STATE_FULL || status2b != MsgQ::STATE_TIMEOUT)
+    {
+        print2term("[%d] ERROR: post on full ring did not fail: %d, %d\n", __LINE__, status2a, status2b);
+        errorcnt++;
+    }
+
+    /* STEP 3: Receive Data */
+    for(long expected = 0; expected < 4; expected++)
+    {
+        long value = -1;
+        int status3 = subq->receiveCopy(&value, sizeof(long), SYS_TIMEOUT);
+        if(status3 != sizeof(long) || value != expected)
+        {
+            print2term("[%d] ERROR: receive got %ld (status %d), expected %ld\n", __LINE__, value, status3, expected);
+            errorcnt++;
+        }
+    }
+    long value = 0;
+    int status3 = subq->receiveCopy(&value, sizeof(long), SYS_TIMEOUT);
+    if(status3 != MsgQ::STATE_TIMEOUT || !subq->isEmpty())
+    {
+        print2term("[%d] ERROR: receive on empty ring did not timeout: %d\n", __LINE__, status3);
+        errorcnt++;
+    }
+
+    /* STEP 4: Post With No Subscribers */
+    delete subq;
+    int status4 = pubq->postCopy(&data, sizeof(long));
+    if(status4 != sizeof(long) || pubq->getSubCnt() != 0)
+    {
+        print2term("[%d] ERROR: post with no subscribers returned %d\n", __LINE__, status4);
+        errorcnt++;
+    }
+    delete pubq;
+
+    /* TEST02:
+     *      Stream sequence through small ring to subscribers on
+     *      their own threads, checking that nothing is dropped or
+     *      reordered
+     */
+
+    const int numsubs = 4;
+    const long count = 100000;
+    Publisher* streamq = new Publisher("testq_08", NULL, 16, MsgQ::CFG_SIZE_INFINITY, MsgQ::RING_QUEUE);
+    throughput_thread_t RAW[numsubs];
+    Thread* t[numsubs];
+    for(int i = 0; i < numsubs; i++)
+    {
+        RAW[i].s = new Subscriber("testq_08");
+        RAW[i].count = count;
+        RAW[i].size = sizeof(long);
+        RAW[i].f = false;
+        t[i] = new Thread(throughputThread, &RAW[i]);
+    }
+    for(long i = 0; i < count; i++)
+    {
+        int status = streamq->postCopy(&i, sizeof(long), IO_PEND);
+        if(status != sizeof(long))
+        {
+            print2term("[%d] ERROR: stream post %ld error %d\n", __LINE__, i, status);
+            errorcnt++;
+            break;
+        }
+    }
+    for(int i = 0; i < numsubs; i++)
+    {
+        delete t[i];
+        if(RAW[i].f) errorcnt++;
+        delete RAW[i].s;
+    }
+    delete streamq;
+
+    /* TEST03:
+     *      Check that messages held by reference can only be
+     *      dereferenced in the order they were received
+     */
+
+    Publisher* refq = new Publisher("testq_11", NULL, 4, MsgQ::CFG_SIZE_INFINITY, MsgQ::RING_QUEUE);
+    Subscriber* refsubq = new Subscriber("testq_11");
+    for(long i = 0; i < 2; i++)
+    {
+        refq->postCopy(&i, sizeof(long));
+    }
+    Subscriber::msgRef_t ref1, ref2;
+    int status5a = refsubq->receiveRef(ref1, SYS_TIMEOUT);
+    int status5b = refsubq->receiveRef(ref2, SYS_TIMEOUT);
+    if(status5a != MsgQ::STATE_OKAY || status5b != MsgQ::STATE_OKAY)
+    {
+        print2term("[%d] ERROR: failed to receive references: %d, %d\n", __LINE__, status5a, status5b);
+        errorcnt++;
+    }
+    else
+    {
+        bool out_of_order = refsubq->dereference(ref2);
+        bool first = refsubq->dereference(ref1);
+        bool again = refsubq->dereference(ref1);
+        bool second = refsubq->dereference(ref2);
+        if(out_of_order || !first || again || !second)
+        {
+            print2term("[%d] ERROR: ring dereference order not enforced: %d, %d, %d, %d\n", __LINE__, out_of_order, first, again, second);
+            errorcnt++;
+        }
+    }
+    delete refsubq;
+    delete refq;
+
+    /* TEST04:
+     *      Check that a reference dereferenced without delete
+     *      is left to the subscriber when the ring reclaims it
+     */
+
+    freeCount = 0;
+    Publisher* keepq = new Publisher("testq_13", countFree, 4, MsgQ::CFG_SIZE_INFINITY, MsgQ::RING_QUEUE);
+    Subscriber* keepsubq = new Subscriber("testq_13");
+    keepq->postRef(new long(1), sizeof(long));
+    keepq->postRef(new long(2), sizeof(long));
+    Subscriber::msgRef_t ref3, ref4;
+    int status6a = keepsubq->receiveRef(ref3, SYS_TIMEOUT);
+    int status6b = keepsubq->receiveRef(ref4, SYS_TIMEOUT);
+    if(status6a != MsgQ::STATE_OKAY || status6b != MsgQ::STATE_OKAY)
+    {
+        print2term("[%d] ERROR: failed to receive references: %d, %d\n", __LINE__, status6a, status6b);
+        errorcnt++;
+    }
+    else
+    {
+        long* kept = (long*)ref4.data;
+        keepsubq->dereference(ref3);
+        keepsubq->dereference(ref4, false);
+        for(long i = 0; i < 3; i++)
+        {
+            keepq->postCopy(&i, sizeof(long)); // last post reclaims the released references
+        }
+        if(freeCount != 1 || *kept != 2)
+        {
+            print2term("[%d] ERROR: ring reclaimed data it was asked to keep: %d, %ld\n", __LINE__, freeCount, *kept);
+            errorcnt++;
+        }
+        delete kept;
+    }
+    delete keepsubq;
+    delete keepq;
+
+    /* TEST05:
+     *      Stream from two publishers on their own threads through a
+     *      small ring, checking that overlapping posts wait their turn
+     *      and each publisher's sequence arrives in order
+     */
+
+    const int numpubs = 2;
+    const long pubcount = 50000;
+    Subscriber* turnq = new Subscriber("testq_12", MsgQ::SUBSCRIBER_OF_CONFIDENCE, 16, MsgQ::CFG_SIZE_INFINITY, MsgQ::RING_QUEUE);
+    ring_publisher_t PUB[numpubs];
+    Thread* pt[numpubs];
+    for(int i = 0; i < numpubs; i++)
+    {
+        PUB[i].p = new Publisher("testq_12");
+        PUB[i].first = i * pubcount;
+        PUB[i].count = pubcount;
+        PUB[i].f = false;
+        pt[i] = new Thread(ringPublisherThread, &PUB[i]);
+    }
+    long next[numpubs] = {0, pubcount};
+    for(long i = 0; i < numpubs * pubcount; i++)
+    {
+        long turn_value = -1;
+        int status = turnq->receiveCopy(&turn_value, sizeof(long), SYS_TIMEOUT);
+        int pub = (int)(turn_value / pubcount);
+        if(status != sizeof(long) || pub < 0 || pub >= numpubs || turn_value != next[pub])
+        {
+            print2term("[%d] ERROR: receive got %ld (status %d) from interleaved publishers\n", __LINE__, turn_value, status);
+            errorcnt++;
+            break;
+        }
+        next[pub]++;
+    }
+    for(int i = 0; i < numpubs; i++)
+    {
+        delete pt[i];
+        if(PUB[i].f) errorcnt++;
+        delete PUB[i].p;
+    }
+    delete turnq;
+
+    if(errorcnt == 0)   return 0;
+    else                return -1;
+}
+
+/*----------------------------------------------------------------------------
+ * latencyUnitTestCmd  -
+ *
+ *  streams timestamped messages from one publisher to concurrent subscribers
+ *  through a linked list queue and then through a ring queue of the same
+ *  depth, and reports the p50 and p99 post-to-receive latency of each
+ *----------------------------------------------------------------------------*/
+int UT_MsgQ::latencyUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE])
+{
+    long count = 200000;
+    long numsubs = 1;
+    long depth = 256;
+    bool failure = false;
+
+    /* Parse Inputs */
+    if(argc > 3)
+    {
+        print2term("Invalid number of parameters passed to command: %d\n", argc);
+        return -1;
+    }
+    if(argc > 0 && (StringLib::str2long(argv[0], &count) == false || count <= 0))
+    {
+        print2term("[%d] ERROR: unable to parse count\n", __LINE__);
+        return -1;
+    }
+    if(argc > 1 && (StringLib::str2long(argv[1], &numsubs) == false || numsubs <= 0 || numsubs > MSGQ_RING_MAX_SUBSCRIBERS))
+    {
+        print2term("[%d] ERROR: unable to parse subscribers\n", __LINE__);
+        return -1;
+    }
+    if(argc > 2 && (StringLib::str2long(argv[2], &depth) == false || depth <= 0))
+    {
+        print2term("[%d] ERROR: unable to parse depth\n", __LINE__);
+        return -1;
+    }
+
+    /* Run Each Queue Type */
+    const char* qnames[2] = {"testq_09", "testq_10"};
+    MsgQ::queue_type_t qtypes[2] = {MsgQ::LIST_QUEUE, MsgQ::RING_QUEUE};
+    print2term("Queue, Subscribers, Depth, Count, Msgs/s, p50 (us), p99 (us)\n");
+    for(int q = 0; q < 2; q++)
+    {
+        Publisher* p = new Publisher(qnames[q], NULL, depth, MsgQ::CFG_SIZE_INFINITY, qtypes[q]);
+        latency_thread_t* RAW = new latency_thread_t[numsubs];
+        Thread** t = new Thread* [numsubs];
+
+        /* Kick-off Subscribers */
+        for(int i = 0; i < numsubs; i++)
+        {
+            RAW[i].s = new Subscriber(qnames[q]);
+            RAW[i].count = count;
+            RAW[i].latency = new double [count];
+            RAW[i].f = false;
+            t[i] = new Thread(latencyThread, &RAW[i]);
+        }
+
+        /* Publish Messages */
+        double start = TimeLib::latchtime();
+        for(long i = 0; i < count; i++)
+        {
+            latency_msg_t msg = {i, TimeLib::latchtime()};
+            int status = p->postCopy(&msg, sizeof(msg), IO_PEND);
+            if(status <= 0)
+            {
+                print2term("[%d] ERROR: unable to post message %ld with error %d\n", __LINE__, i, status);
+                failure = true;
+                break;
+            }
+        }
+
+        /* Join Subscribers */
+        for(int i = 0; i < numsubs; i++)
+        {
+            delete t[i]; // performs a join
+            failure = failure || RAW[i].f;
+        }
+        double elapsed = TimeLib::latchtime() - start;
+
+        /* Calculate Percentiles */
+        long total = count * numsubs;
+        double* latency = new double [total];
+        for(int i = 0; i < numsubs; i++)
+        {
+            LocalLib::copy(&latency[i * count], RAW[i].latency, count * sizeof(double));
+        }
+        std::sort(latency, latency + total);
+        double p50 = latency[total / 2] * 1000000.0;
+        double p99 = latency[(total * 99) / 100] * 1000000.0;
+
+        /* Print Results */
+        print2term("%s, %ld, %d, %ld, %.0lf, %.1lf, %.1lf\n", qtypes[q] == MsgQ::RING_QUEUE ? "ring" : "list", numsubs, p->getDepth(), count, count / elapsed, p50, p99);
+
+        /* Clean Up */
+        delete [] latency;
+        for(int i = 0; i < numsubs; i++)
+        {
+            delete RAW[i].s;
+            delete [] RAW[i].latency;
+        }
+        delete [] RAW;
+        delete [] t;
+        delete p;
+    }
+
+    if(failure) return -1;
+    else        return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * latencyThread  -
+ *----------------------------------------------------------------------------*/
+void* UT_MsgQ::latencyThread(void* parm)
+{
+    latency_thread_t* RAW = (latency_thread_t*)parm;
+
+    for(long msgnum = 0; msgnum < RAW->count; msgnum++)
+    {
+        latency_msg_t msg;
+        int status = RAW->s->receiveCopy(&msg, sizeof(msg), SYS_TIMEOUT);
+        double now = TimeLib::latchtime();
+        if(status != sizeof(msg) || msg.seq != msgnum)
+        {
+            print2term("[%d] ERROR: failed to receive message %ld, status %d\n", __LINE__, msgnum, status);
+            RAW->f = true;
+            RAW->latency[msgnum] = 0.0;
+            continue; // keep receiving so that the publisher is not blocked
+        }
+        RAW->latency[msgnum] = now - msg.posted;
+    }
+
+    return NULL;
+}
+
 /*----------------------------------------------------------------------------
  * randomDelay  -
  *----------------------------------------------------------------------------*/
@@ -742,3 +1446,13 @@ void UT_MsgQ::randomDelay(long max_milliseconds)
     long us = rand() % (max_milliseconds * 1000);
     LocalLib::sleep((double)us / 1000000.0);
 }
+
+/*----------------------------------------------------------------------------
+ * countFree  -
+ *----------------------------------------------------------------------------*/
+void UT_MsgQ::countFree(void* obj, void* parm)
+{
+    (void)parm;
+    delete (long*)obj;
+    freeCount++;
+}
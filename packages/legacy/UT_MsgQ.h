@@ -54,6 +54,7 @@ class UT_MsgQ: public CommandableObject
 
         static const char* TYPE;
         static const int MAX_SUBSCRIBERS = 15;
+        static const int THROUGHPUT_DEPTH = 1024;
 
         /*--------------------------------------------------------------------
          * Methods
@@ -86,6 +87,38 @@ class UT_MsgQ: public CommandableObject
             int size;
         } perf_thread_t;
 
+        typedef struct {
+            Subscriber* s;
+            long count;
+            int size;
+            bool f;
+        } throughput_thread_t;
+
+        typedef struct {
+            Publisher* p;
+            long first;         // first value posted
+            long count;
+            bool f;
+        } ring_publisher_t;
+
+        typedef struct {
+            Subscriber* s;
+            long count;
+            double* latency;    // [count] seconds from post to receive
+            bool f;
+        } latency_thread_t;
+
+        typedef struct {
+            long seq;
+            double posted;
+        } latency_msg_t;
+
+        /*--------------------------------------------------------------------
+         * Data
+         *--------------------------------------------------------------------*/
+
+        static int freeCount;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -97,13 +130,21 @@ class UT_MsgQ: public CommandableObject
         int subscribeUnsubscribeUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE]);
         int performanceUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE]);
         int subscriberOfOpporunityUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE]);
+        int sharedBufferUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE]);
+        int throughputUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE]);
+        int ringQueueUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE]);
+        int latencyUnitTestCmd (int argc, char argv[][MAX_CMD_SIZE]);
 
         static void* subscriberThread (void* parm);
         static void* publisherThread (void* parm);
         static void* performanceThread (void* parm);
         static void* opportunityThread (void* parm);
+        static void* throughputThread (void* parm);
+        static void* ringPublisherThread (void* parm);
+        static void* latencyThread (void* parm);
 
         static void randomDelay(long max_milliseconds);
+        static void countFree(void* obj, void* parm);
 };
 
 #endif  /* __ut_msgq__ */
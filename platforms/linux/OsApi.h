@@ -134,6 +134,7 @@ CompileTimeAssert(sizeof(bool)==1, TypeboolWrongSize);
 #define PARM_ERR_RC                 (-8)
 #define TTY_ERR_RC                  (-9)
 #define ACC_ERR_RC                  (-10)
+#define RES_ERR_RC                  (-11)
 
 /* I/O Definitions */
 #define IO_PEND                     (-1)
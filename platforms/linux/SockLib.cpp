@@ -55,6 +55,8 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <poll.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
 #include <exception>
 
 /******************************************************************************
@@ -299,6 +301,10 @@ int SockLib::socksend(int fd, const void* buf, int size, int timeout)
         {
             c = SHUTDOWN_RC;
         }
+        else if(c < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            c = TIMEOUT_RC;
+        }
         else if(timeout != IO_CHECK && c < 0)
         {
             dlog("Failed (%d) to send data to ready socket [0x%0X]: %s", c, revents, strerror(errno));
@@ -343,6 +349,10 @@ int SockLib::sockrecv(int fd, void* buf, int size, int timeout)
         {
             c = SHUTDOWN_RC;
         }
+        else if(c < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            c = TIMEOUT_RC;
+        }
         else if(timeout != IO_CHECK && c < 0)
         {
             dlog("Failed (%d) to receive data from ready socket [0x%0X]: %s", c, revents, strerror(errno));
@@ -358,6 +368,52 @@ int SockLib::sockrecv(int fd, void* buf, int size, int timeout)
     return c;
 }
 
+/*----------------------------------------------------------------------------
+ * socksendv
+ *
+ * Notes: gathers the vectors into a single non-blocking send; returns the
+ *        number of bytes written, which may end part way through a vector,
+ *        or TIMEOUT_RC if the socket cannot take any more data
+ *----------------------------------------------------------------------------*/
+int SockLib::socksendv(int fd, const sockvec_t* vec, int cnt)
+{
+    struct iovec iov[IOV_MAX];
+    struct msghdr msg;
+
+    /* Build Message */
+    if(cnt > IOV_MAX) cnt = IOV_MAX;
+    for(int i = 0; i < cnt; i++)
+    {
+        iov[i].iov_base = (void*)vec[i].data;
+        iov[i].iov_len = vec[i].size;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = cnt;
+
+    /* Perform Send */
+    int c = sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+    if(c < 0)
+    {
+        if(errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            c = TIMEOUT_RC;
+        }
+        else if(errno == EPIPE || errno == ECONNRESET)
+        {
+            c = SHUTDOWN_RC;
+        }
+        else
+        {
+            dlog("Failed (%d) to send vectored data to socket: %s", c, strerror(errno));
+            c = SOCK_ERR_RC;
+        }
+    }
+
+    /* Return Results */
+    return c;
+}
+
 /*----------------------------------------------------------------------------
  * sockinfo
  *
@@ -414,6 +470,145 @@ void SockLib::sockclose(int fd)
     }
 }
 
+/*----------------------------------------------------------------------------
+ * socklisten
+ *
+ * Notes: returns a non-blocking listen socket for use with sockaccept
+ *----------------------------------------------------------------------------*/
+int SockLib::socklisten(const char* ip_addr, int port, int backlog)
+{
+    int listen_socket = sockcreate(SOCK_STREAM, ip_addr, port, true, NULL);
+    if(listen_socket < 0)
+    {
+        dlog("Unable to establish socket server on %s:%d, failed to create listen socket", ip_addr ? ip_addr : "0.0.0.0", port);
+        return TCP_ERR_RC;
+    }
+
+    if(listen(listen_socket, backlog) != 0)
+    {
+        dlog("Failed to mark socket bound to %s:%d as a listen socket, %s", ip_addr ? ip_addr : "0.0.0.0", port, strerror(errno));
+        sockclose(listen_socket);
+        return TCP_ERR_RC;
+    }
+
+    return listen_socket;
+}
+
+/*----------------------------------------------------------------------------
+ * sockaccept
+ *
+ * Notes: returns the non-blocking socket of the next pending connection,
+ *        WOULDBLOCK_RC when there are no more connections waiting,
+ *        RES_ERR_RC when the process or system is out of descriptors or
+ *        buffers (the connection is left pending), and ACC_ERR_RC only when
+ *        the listen socket itself is no longer usable; connections that
+ *        fail before they are accepted are skipped
+ *----------------------------------------------------------------------------*/
+int SockLib::sockaccept(int listen_fd)
+{
+    while(true)
+    {
+        int client_socket = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK);
+        if(client_socket >= 0)
+        {
+            return client_socket;
+        }
+        else if(errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return WOULDBLOCK_RC;
+        }
+        else if(errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM)
+        {
+            dlog("Unable to accept connection: %s", strerror(errno));
+            return RES_ERR_RC;
+        }
+        else if(errno == EBADF || errno == EINVAL || errno == ENOTSOCK || errno == EFAULT)
+        {
+            dlog("Failed to accept connection: %s", strerror(errno));
+            return ACC_ERR_RC;
+        }
+        else if(errno != EINTR)
+        {
+            /* ECONNABORTED, EPROTO, EPERM and network errors belong to
+             * the connection being accepted, so move on to the next one */
+            dlog("Dropped connection before it was accepted: %s", strerror(errno));
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * sockreactor
+ *
+ * Notes: creates an event queue that sockets are added to with sockwatch;
+ *        the queue is closed with close like any other descriptor
+ *----------------------------------------------------------------------------*/
+int SockLib::sockreactor(void)
+{
+    int reactor_fd = epoll_create1(0);
+    if(reactor_fd < 0)
+    {
+        dlog("Failed to create reactor: %s", strerror(errno));
+        return SOCK_ERR_RC;
+    }
+
+    return reactor_fd;
+}
+
+/*----------------------------------------------------------------------------
+ * sockwatch
+ *
+ * Notes: edge triggered - an event is only returned when the socket becomes
+ *        readable or writable, so the caller must read or write until
+ *        TIMEOUT_RC is returned before waiting on the socket again; the
+ *        socket is removed from the reactor when it is closed
+ *----------------------------------------------------------------------------*/
+int SockLib::sockwatch(int reactor_fd, int fd)
+{
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+    event.data.fd = fd;
+
+    if(epoll_ctl(reactor_fd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        dlog("Failed to add socket <%d> to reactor: %s", fd, strerror(errno));
+        return SOCK_ERR_RC;
+    }
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * sockwait
+ *
+ * Notes: returns the number of events populated, or zero on timeout
+ *----------------------------------------------------------------------------*/
+int SockLib::sockwait(int reactor_fd, sockevent_t* events, int max_events, int timeout)
+{
+    struct epoll_event epoll_events[MAX_REACTOR_EVENTS];
+    if(max_events > MAX_REACTOR_EVENTS) max_events = MAX_REACTOR_EVENTS;
+
+    int num_events = 0;
+    do num_events = epoll_wait(reactor_fd, epoll_events, max_events, timeout);
+    while(num_events == -1 && errno == EINTR);
+
+    if(num_events < 0)
+    {
+        dlog("Failed to wait on reactor: %s", strerror(errno));
+        return SOCK_ERR_RC;
+    }
+
+    for(int i = 0; i < num_events; i++)
+    {
+        events[i].fd = epoll_events[i].data.fd;
+        events[i].flags = 0;
+        if(epoll_events[i].events & EPOLLIN)                events[i].flags |= IO_READ_FLAG;
+        if(epoll_events[i].events & EPOLLOUT)               events[i].flags |= IO_WRITE_FLAG;
+        if(epoll_events[i].events & (EPOLLHUP | EPOLLERR))  events[i].flags |= IO_DISCONNECT_FLAG;
+    }
+
+    return num_events;
+}
+
 /*----------------------------------------------------------------------------
  * startserver
  *----------------------------------------------------------------------------*/
@@ -43,12 +43,23 @@ class SockLib
         typedef int     (*onPollHandler_t)      (int sock, short* events, void* parm); // configure R/W flags
         typedef int     (*onActiveHandler_t)    (int sock, int flags, void* parm);
 
+        typedef struct {
+            const void*     data;
+            int             size;
+        } sockvec_t;
+
+        typedef struct {
+            int             fd;
+            int             flags;  // IO_READ_FLAG | IO_WRITE_FLAG | IO_DISCONNECT_FLAG
+        } sockevent_t;
+
         static const char* IPV4_ENV_VAR_NAME;
 
         static const int IPV4_STR_LEN = 16;
         static const int PORT_STR_LEN = 16;
         static const int HOST_STR_LEN = 64;
         static const int SERV_STR_LEN = 64;
+        static const int MAX_REACTOR_EVENTS = 256;
 
         static void         init                (void); // initializes library
         static void         deinit              (void); // de-initializes library
@@ -57,7 +68,13 @@ class SockLib
         static int          sockdatagram        (const char* ip_addr, int port, bool is_server, bool* block, const char* multicast_group);
         static int          socksend            (int fd, const void* buf, int size, int timeout);
         static int          sockrecv            (int fd, void* buf, int size, int timeout);
+        static int          socksendv           (int fd, const sockvec_t* vec, int cnt);
         static int          sockinfo            (int fd, char** local_ipaddr, int* local_port, char** remote_ipaddr, int* remote_port);
+        static int          socklisten          (const char* ip_addr, int port, int backlog);
+        static int          sockaccept          (int listen_fd);
+        static int          sockreactor         (void);
+        static int          sockwatch           (int reactor_fd, int fd);
+        static int          sockwait            (int reactor_fd, sockevent_t* events, int max_events, int timeout);
         static void         sockclose           (int fd);
         static int          startserver         (const char* ip_addr, int port, int max_num_connections, onPollHandler_t on_poll, onActiveHandler_t on_act, bool* active, void* parm, bool* listening=NULL);
         static int          startclient         (const char* ip_addr, int port, int max_num_connections, onPollHandler_t on_poll, onActiveHandler_t on_act, bool* active, void* parm, bool* connected=NULL);
@@ -99,11 +99,14 @@ long Thread::getId(void)
 
 /*----------------------------------------------------------------------------
  * createGlobal
+ *
+ *  the destructor (if supplied) is called with the thread's value when a
+ *  thread that set a value exits
  *----------------------------------------------------------------------------*/
-Thread::key_t Thread::createGlobal (void)
+Thread::key_t Thread::createGlobal (void (*destructor)(void*))
 {
     pthread_key_t key;
-    pthread_key_create(&key, NULL);
+    pthread_key_create(&key, destructor);
     return (key_t)key;
 }
 
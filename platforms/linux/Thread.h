@@ -54,7 +54,7 @@ class Thread
         ~Thread (void); // performs join
 
         static long         getId               (void);
-        static key_t        createGlobal        (void);
+        static key_t        createGlobal        (void (*destructor)(void*)=NULL);
         static int          setGlobal           (key_t key, void* value);
         static void*        getGlobal           (key_t key);
 
@@ -110,6 +110,45 @@ Thread::~Thread()
     WaitForSingleObject(threadId, wait);
 }
 
+/*----------------------------------------------------------------------------
+ * getId
+ *----------------------------------------------------------------------------*/
+long Thread::getId(void)
+{
+    return (long)GetCurrentThreadId();
+}
+
+/*----------------------------------------------------------------------------
+ * createGlobal
+ *
+ *  uses fiber local storage since, unlike thread local storage, it calls
+ *  the destructor (if supplied) with the thread's value when a thread that
+ *  set a value exits
+ *----------------------------------------------------------------------------*/
+Thread::key_t Thread::createGlobal (void (*destructor)(void*))
+{
+    DWORD key = FlsAlloc((PFLS_CALLBACK_FUNCTION)destructor);
+    assert(key != FLS_OUT_OF_INDEXES);
+    return (key_t)key;
+}
+
+/*----------------------------------------------------------------------------
+ * setGlobal
+ *----------------------------------------------------------------------------*/
+int Thread::setGlobal (key_t key, void* value)
+{
+    if(FlsSetValue((DWORD)key, value)) return 0;
+    return (int)GetLastError();
+}
+
+/*----------------------------------------------------------------------------
+ * getGlobal
+ *----------------------------------------------------------------------------*/
+void* Thread::getGlobal (key_t key)
+{
+    return FlsGetValue((DWORD)key);
+}
+
 /******************************************************************************
  * MUTEX
  ******************************************************************************/
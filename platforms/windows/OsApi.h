@@ -99,6 +99,7 @@
 #define PARM_ERR_RC                 (-8)
 #define TTY_ERR_RC                  (-9)
 #define ACC_ERR_RC                  (-10)
+#define RES_ERR_RC                  (-11)
 
 /* I/O Definitions */
 #define IO_PEND                     (-1)
@@ -128,11 +129,18 @@ class Thread
 {
     public:
 
+        typedef DWORD key_t;
+
         typedef void* (*thread_func_t) (void* parm);
 
         Thread (thread_func_t function, void* parm, bool _join=true);
         ~Thread (void); // performs join
 
+        static long         getId               (void);
+        static key_t        createGlobal        (void (*destructor)(void*)=NULL);
+        static int          setGlobal           (key_t key, void* value);
+        static void*        getGlobal           (key_t key);
+
     private:
 
         HANDLE threadId;
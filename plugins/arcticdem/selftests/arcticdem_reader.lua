@@ -65,6 +65,30 @@ for i = 1, 2 do
     runner.check(cellsize == 2.0)
 end
 
+-- Batch Sampling --
+
+print(string.format("\n--------------------------------\nTest: arcticdem-mosaic batch sample\n--------------------------------"))
+local dem = geo.vrt("arcticdem-mosaic", "NearestNeighbour", 0)
+local lons = {}
+local lats = {}
+for i = 1, 50 do
+    table.insert(lons, lon + ((i - 1) * 0.01))
+    table.insert(lats, lat + ((i % 5) * 0.01))
+end
+
+local batch, batch_status = dem:sample(lons, lats)
+runner.check(batch_status == true)
+runner.check(batch ~= nil and #batch == #lons)
+
+for i = 1, #lons do
+    local tbl, status = dem:sample(lons[i], lats[i])
+    local single_cnt = status and #tbl or 0
+    runner.check(#batch[i] == single_cnt, string.format("point %d: %d batch samples, %d single samples", i, #batch[i], single_cnt))
+    for j = 1, math.min(#batch[i], single_cnt) do
+        runner.check(batch[i][j]["value"] == tbl[j]["value"], string.format("point %d: batch sample %f ~= single sample %f", i, batch[i][j]["value"], tbl[j]["value"]))
+    end
+end
+
 -- Report Results --
 
 runner.report()
@@ -0,0 +1,82 @@
+console = require("console")
+
+-- console.monitor:config(core.LOG, core.DEBUG)
+-- sys.setlvl(core.LOG, core.DEBUG)
+
+-- Usage: sliderule arcticdem_batch_sampling_perf.lua [<dem type>] [<points> ...]
+--
+--  measures the rate at which points are sampled from a DEM, one point per
+--  call versus all of the points in a single batch call; the points walk
+--  along the Arctic Circle so that consecutive points fall in the same
+--  raster before moving on to the next one.  The rasters are read from the
+--  local copy of the DEM (e.g. /data/ArcticDem/mosaic.vrt):
+--
+--      sliderule arcticdem_batch_sampling_perf.lua arcticdem-mosaic 1000 100000 1000000
+
+local dem_type = arg[1] or "arcticdem-mosaic"
+
+-- Point Counts --
+
+local counts = {1000, 100000, 1000000}
+
+if arg[2] then
+    counts = {}
+    local i = 2
+    while arg[i] do
+        table.insert(counts, tonumber(arg[i]))
+        i = i + 1
+    end
+end
+
+-- Generate Points --
+
+local function walk (num_points)
+    local lons = {}
+    local lats = {}
+    local lon = -150.0
+    local lat = 66.34 -- Arctic Circle lat
+    for i = 1, num_points do
+        lons[i] = lon + ((i - 1) * 0.0001)
+        lats[i] = lat + (((i - 1) % 100) * 0.0001)
+    end
+    return lons, lats
+end
+
+-- Run Trials --
+
+local dem = geo.vrt(dem_type, "NearestNeighbour", 0)
+
+print(string.format("\n%-10s %10s %10s %16s %16s", "points", "single", "batch", "single/second", "batch/second"))
+
+for _,num_points in ipairs(counts) do
+    local lons, lats = walk(num_points)
+
+    -- one point per call
+    local single_samples = 0
+    local starttime = time.latch()
+    for i = 1, num_points do
+        local tbl, status = dem:sample(lons[i], lats[i])
+        if status then
+            single_samples = single_samples + #tbl
+        end
+    end
+    local single_time = time.latch() - starttime
+
+    -- all points in one call
+    local batch_samples = 0
+    starttime = time.latch()
+    local batch = dem:sample(lons, lats)
+    local batch_time = time.latch() - starttime
+    if batch then
+        for i = 1, #batch do
+            batch_samples = batch_samples + #batch[i]
+        end
+    end
+
+    print(string.format("%-10d %10d %10d %16.1f %16.1f", num_points, single_samples, batch_samples, single_samples / single_time, batch_samples / batch_time))
+    if single_samples ~= batch_samples then
+        print(string.format("mismatch: %d single samples, %d batch samples", single_samples, batch_samples))
+    end
+end
+
+sys.quit()
@@ -42,7 +42,8 @@ end
 -- Get Flatten Option --
 local flatten = false
 if output_parms then
-    if output_parms["format"] == "parquet" then
+    local output_format = output_parms["format"]
+    if output_format == "parquet" or output_format == "feather" or output_format == "arrow" then
         flatten = true
     end
 end
@@ -17,6 +17,8 @@
 -- NOTES:       1. The rqst is provided by arg[1] which is a json object provided by caller
 --              2. The rspq is the system provided output queue name string
 --              3. The output is a raw binary blob containing serialized 'atl06rec' and 'atl06rec.elevation' RecordObjects
+--              4. When parms["ordered"] is true, elevations are returned in the order the ATL03 reader produced their extents
+--              5. When parms["batch_samples"] is true, raster samples are returned as one 'rsbatch' record per elevation record
 --
 
 local json = require("json")
@@ -47,7 +49,10 @@ end
 local recq = rspq .. "-atl03"
 
 -- ATL06 Dispatcher --
-local atl06_disp = core.dispatcher(recq)
+--  extents are received on a single thread and fit by a worker per processor
+--  in the atl06 algorithm; ordered results are posted in segment order
+local num_workers = sys.nproc()
+local atl06_disp = core.dispatcher(recq, 1)
 
 -- Request Parameters */
 local rqst_parms = icesat2.parms(parms)
@@ -58,8 +63,8 @@ atl06_disp:attach(except_pub, "exceptrec") -- exception records
 atl06_disp:attach(except_pub, "extrec") -- ancillary records
 
 -- ATL06 Dispatch Algorithm --
-local atl06_algo = icesat2.atl06(rspq, rqst_parms)
-atl06_disp:attach(atl06_algo, "atl03rec")
+local atl06_algo = icesat2.atl06(rspq, rqst_parms, num_workers, parms["ordered"])
+atl06_disp:attach(atl06_algo, "atl03col")
 
 -- Raster Sampler --
 local sampler_disp = nil
@@ -69,7 +74,7 @@ if samples then
     sampler_disp = core.dispatcher(rspq, 1) -- 1 thread required until VrtRaster is thread safe
     for index,raster in ipairs(samples) do
         local vrt = geo.vrt(raster)
-        local sampler = icesat2.sampler(vrt, index - 1, rspq, elevation_rec_type, "extent_id", "lon", "lat")
+        local sampler = icesat2.sampler(vrt, index - 1, rspq, elevation_rec_type, "extent_id", "lon", "lat", parms["batch_samples"])
         sampler_disp:attach(sampler, atl06_rec_type)
     end
     sampler_disp:run()
@@ -82,7 +87,7 @@ atl06_disp:run()
 userlog:sendlog(core.INFO, string.format("request <%s> atl06 processing initiated on %s ...", rspq, resource))
 
 -- ATL03 Reader --
-local atl03_reader = icesat2.atl03(asset, resource, recq, rqst_parms, true)
+local atl03_reader = icesat2.atl03(asset, resource, recq, rqst_parms, true, false, true) -- columnar extents
 
 -- Wait Until Reader Completion --
 while (userlog:numsubs() > 0) and not atl03_reader:waiton(interval * 1000) do
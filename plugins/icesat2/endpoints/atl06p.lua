@@ -42,14 +42,14 @@ local output_dispatch = nil
 if output_parms then
     local output_filename = output_parms["path"]
     local output_format = output_parms["format"]
-    -- Parquet Writer --
-    if output_format == "parquet" then
-        rsps_from_nodes = rspq .. "-parquet"
+    -- Parquet and Arrow (feather file or ipc stream) Writers --
+    if output_format == "parquet" or output_format == "feather" or output_format == "arrow" then
+        rsps_from_nodes = rspq .. "-" .. output_format
         terminate_proxy_stream = true
         local except_pub = core.publish(rspq)
-        local parquet_builder = arrow.parquet(output_filename, rspq, "atl06rec.elevation", rqstid, "lon", "lat")
+        local arrow_builder = arrow.parquet(output_filename, rspq, "atl06rec.elevation", rqstid, "lon", "lat", nil, output_format)
         output_dispatch = core.dispatcher(rsps_from_nodes)
-        output_dispatch:attach(parquet_builder, "atl06rec")
+        output_dispatch:attach(arrow_builder, "atl06rec")
         output_dispatch:attach(except_pub, "exceptrec") -- exception records
         output_dispatch:attach(except_pub, "eventrec") -- event records
         output_dispatch:run()
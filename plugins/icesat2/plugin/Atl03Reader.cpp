@@ -36,6 +36,7 @@
 #include <math.h>
 #include <float.h>
 #include <stdarg.h>
+#include <algorithm>
 
 #include "core.h"
 #include "h5.h"
@@ -82,6 +83,33 @@ const RecordObject::fieldDef_t Atl03Reader::exRecDef[] = {
     {"data",        RecordObject::USER,     offsetof(extent_t, photons),                        0,  phRecType, NATIVE_FLAGS} // variable length
 };
 
+const char* Atl03Reader::exColRecType = "atl03col"; // columnar extent record
+const RecordObject::fieldDef_t Atl03Reader::exColRecDef[] = {
+    {"track",       RecordObject::UINT8,    offsetof(extent_columns_t, reference_pair_track),           1,  NULL, NATIVE_FLAGS},
+    {"sc_orient",   RecordObject::UINT8,    offsetof(extent_columns_t, spacecraft_orientation),         1,  NULL, NATIVE_FLAGS},
+    {"rgt",         RecordObject::UINT16,   offsetof(extent_columns_t, reference_ground_track_start),   1,  NULL, NATIVE_FLAGS},
+    {"cycle",       RecordObject::UINT16,   offsetof(extent_columns_t, cycle_start),                    1,  NULL, NATIVE_FLAGS},
+    {"extent_id",   RecordObject::UINT64,   offsetof(extent_columns_t, extent_id),                      1,  NULL, NATIVE_FLAGS},
+    {"segment_id",  RecordObject::UINT32,   offsetof(extent_columns_t, segment_id[0]),                  2,  NULL, NATIVE_FLAGS},
+    {"segment_dist",RecordObject::DOUBLE,   offsetof(extent_columns_t, segment_distance[0]),            2,  NULL, NATIVE_FLAGS}, // distance from equator
+    {"count",       RecordObject::UINT32,   offsetof(extent_columns_t, photon_count[0]),                2,  NULL, NATIVE_FLAGS},
+    {"first",       RecordObject::UINT32,   offsetof(extent_columns_t, first_photon[0]),                2,  NULL, NATIVE_FLAGS},
+    {"delta_time",  RecordObject::DOUBLE,   offsetof(extent_columns_t, delta_time_offset),              1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"latitude",    RecordObject::DOUBLE,   offsetof(extent_columns_t, latitude_offset),                1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"longitude",   RecordObject::DOUBLE,   offsetof(extent_columns_t, longitude_offset),               1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"distance",    RecordObject::DOUBLE,   offsetof(extent_columns_t, distance_offset),                1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"height",      RecordObject::FLOAT,    offsetof(extent_columns_t, height_offset),                  1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"atl08_class", RecordObject::UINT8,    offsetof(extent_columns_t, atl08_class_offset),             1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"atl03_cnf",   RecordObject::INT8,     offsetof(extent_columns_t, atl03_cnf_offset),               1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"quality_ph",  RecordObject::INT8,     offsetof(extent_columns_t, quality_ph_offset),              1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"yapc_score",  RecordObject::UINT8,    offsetof(extent_columns_t, yapc_score_offset),              1,  NULL, NATIVE_FLAGS | RecordObject::POINTER},
+    {"data",        RecordObject::UINT8,    offsetof(extent_columns_t, columns),                        0,  NULL, NATIVE_FLAGS} // variable length
+};
+
+/* the columnar record is read through an extent_t for its attributes */
+static_assert(offsetof(Atl03Reader::extent_columns_t, photon_count) == offsetof(Atl03Reader::extent_t, photon_count), "columnar extent attributes must match extent_t");
+static_assert(offsetof(Atl03Reader::extent_columns_t, first_photon) == offsetof(Atl03Reader::extent_t, photon_offset), "columnar extent attributes must match extent_t");
+
 const char* Atl03Reader::phFlatRecType = "flat03rec.photons";
 const RecordObject::fieldDef_t Atl03Reader::phFlatRecDef[] = {
     {"extent_id",   RecordObject::UINT64,   offsetof(flat_photon_t, extent_id),         1,  NULL, NATIVE_FLAGS},
@@ -131,7 +159,7 @@ const struct luaL_Reg Atl03Reader::LuaMetaTable[] = {
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * luaCreate - create(<asset>, <resource>, <outq_name>, <parms>, <send terminator>, <flatten>)
+ * luaCreate - create(<asset>, <resource>, <outq_name>, <parms>, <send terminator>, <flatten>, <columnar>)
  *----------------------------------------------------------------------------*/
 int Atl03Reader::luaCreate (lua_State* L)
 {
@@ -147,9 +175,10 @@ int Atl03Reader::luaCreate (lua_State* L)
         parms = (RqstParms*)getLuaObject(L, 4, RqstParms::OBJECT_TYPE);
         bool send_terminator = getLuaBoolean(L, 5, true, true);
         bool flatten = getLuaBoolean(L, 6, true, false);
+        bool columnar = getLuaBoolean(L, 7, true, false);
 
         /* Return Reader Object */
-        return createLuaObject(L, new Atl03Reader(L, asset, resource, outq_name, parms, send_terminator, flatten));
+        return createLuaObject(L, new Atl03Reader(L, asset, resource, outq_name, parms, send_terminator, flatten, columnar));
     }
     catch(const RunTimeException& e)
     {
@@ -167,16 +196,61 @@ void Atl03Reader::init (void)
 {
     RECDEF(phRecType,       phRecDef,       sizeof(photon_t),       NULL);
     RECDEF(exRecType,       exRecDef,       sizeof(extent_t),       "extent_id");
+    RECDEF(exColRecType,    exColRecDef,    sizeof(extent_columns_t), "extent_id");
     RECDEF(phFlatRecType,   phFlatRecDef,   sizeof(flat_photon_t),  "extent_id");
     RECDEF(exFlatRecType,   exFlatRecDef,   1,                      NULL);
     RECDEF(phAncRecType,    phAncRecDef,    sizeof(anc_photon_t),   "extent_id");
     RECDEF(exAncRecType,    exAncRecDef,    sizeof(anc_extent_t),   "extent_id");
 }
 
+/*----------------------------------------------------------------------------
+ * getExtent
+ *
+ *  returns the attributes of an atl03rec or atl03col record and sets up a view
+ *  of its photon fields; returns NULL if the record is neither
+ *----------------------------------------------------------------------------*/
+Atl03Reader::extent_t* Atl03Reader::getExtent (RecordObject* record, photon_columns_t* columns)
+{
+    uint8_t* data = record->getRecordData();
+
+    if(record->isRecordType(exRecType))
+    {
+        extent_t* extent = (extent_t*)data;
+        const uint8_t* photons = (const uint8_t*)extent->photons;
+        long stride = sizeof(photon_t);
+        columns->delta_time     = { photons + offsetof(photon_t, delta_time),   stride };
+        columns->latitude       = { photons + offsetof(photon_t, latitude),     stride };
+        columns->longitude      = { photons + offsetof(photon_t, longitude),    stride };
+        columns->distance       = { photons + offsetof(photon_t, distance),     stride };
+        columns->height         = { photons + offsetof(photon_t, height),       stride };
+        columns->atl08_class    = { photons + offsetof(photon_t, atl08_class),  stride };
+        columns->atl03_cnf      = { photons + offsetof(photon_t, atl03_cnf),    stride };
+        columns->quality_ph     = { photons + offsetof(photon_t, quality_ph),   stride };
+        columns->yapc_score     = { photons + offsetof(photon_t, yapc_score),   stride };
+        return extent;
+    }
+    else if(record->isRecordType(exColRecType))
+    {
+        extent_columns_t* extent = (extent_columns_t*)data;
+        columns->delta_time     = { data + extent->delta_time_offset,   sizeof(double) };
+        columns->latitude       = { data + extent->latitude_offset,     sizeof(double) };
+        columns->longitude      = { data + extent->longitude_offset,    sizeof(double) };
+        columns->distance       = { data + extent->distance_offset,     sizeof(double) };
+        columns->height         = { data + extent->height_offset,       sizeof(float) };
+        columns->atl08_class    = { data + extent->atl08_class_offset,  sizeof(uint8_t) };
+        columns->atl03_cnf      = { data + extent->atl03_cnf_offset,    sizeof(int8_t) };
+        columns->quality_ph     = { data + extent->quality_ph_offset,   sizeof(int8_t) };
+        columns->yapc_score     = { data + extent->yapc_score_offset,   sizeof(uint8_t) };
+        return (extent_t*)extent;
+    }
+
+    return NULL;
+}
+
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-Atl03Reader::Atl03Reader (lua_State* L, Asset* _asset, const char* _resource, const char* outq_name, RqstParms* _parms, bool _send_terminator, bool _flatten):
+Atl03Reader::Atl03Reader (lua_State* L, Asset* _asset, const char* _resource, const char* outq_name, RqstParms* _parms, bool _send_terminator, bool _flatten, bool _columnar):
     LuaObject(L, OBJECT_TYPE, LuaMetaName, LuaMetaTable),
     read_timeout_ms(_parms->read_timeout * 1000)
 {
@@ -190,6 +264,7 @@ Atl03Reader::Atl03Reader (lua_State* L, Asset* _asset, const char* _resource, co
     resource = StringLib::duplicate(_resource);
     parms = _parms;
     flatten = _flatten;
+    columnar = _columnar && !_flatten;
 
     /* Generate ATL08 Resource Name */
     SafeString atl08_resource("%s", resource);
@@ -211,6 +286,7 @@ Atl03Reader::Atl03Reader (lua_State* L, Asset* _asset, const char* _resource, co
     active = true;
     numComplete = 0;
     LocalLib::set(readerPid, 0, sizeof(readerPid));
+    LocalLib::set(polyIndex, 0, sizeof(polyIndex));
 
     /* Read Global Resource Information */
     try
@@ -292,6 +368,11 @@ Atl03Reader::~Atl03Reader (void)
 
     if(sc_orient) delete sc_orient;
 
+    for(int p = 0; p < MathLib::NUM_PROJECTIONS; p++)
+    {
+        if(polyIndex[p]) delete polyIndex[p];
+    }
+
     asset->releaseLuaObject();
 }
 
@@ -370,20 +451,15 @@ void Atl03Reader::Region::cleanup (void)
  *----------------------------------------------------------------------------*/
 void Atl03Reader::Region::polyregion (info_t* info)
 {
-    int points_in_polygon = info->reader->parms->polygon.length();
-
     /* Determine Best Projection To Use */
     MathLib::proj_t projection = MathLib::PLATE_CARREE;
     if(segment_lat[RqstParms::RPT_L][0] > 70.0) projection = MathLib::NORTH_POLAR;
     else if(segment_lat[RqstParms::RPT_L][0] < -70.0) projection = MathLib::SOUTH_POLAR;
 
-    /* Project Polygon */
-    List<MathLib::coord_t>::Iterator poly_iterator(info->reader->parms->polygon);
-    MathLib::point_t* projected_poly = new MathLib::point_t [points_in_polygon];
-    for(int i = 0; i < points_in_polygon; i++)
-    {
-        projected_poly[i] = MathLib::coord2point(poly_iterator[i], projection);
-    }
+    /* Get Polygon Prepared for Projection */
+    const PolygonIndex* poly_index = info->reader->getPolygonIndex(projection);
+    MathLib::point_t segment_points[POLYGON_BATCH_SIZE];
+    bool segment_inclusion[POLYGON_BATCH_SIZE];
 
     /* Find First Segment In Polygon */
     bool first_segment_found[RqstParms::NUM_PAIR_TRACKS] = {false, false};
@@ -391,57 +467,61 @@ void Atl03Reader::Region::polyregion (info_t* info)
     for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
     {
         int segment = 0;
-        while(segment < segment_ph_cnt[t].size)
+        while(segment < segment_ph_cnt[t].size && !last_segment_found[t])
         {
-            bool inclusion = false;
-
-            /* Project Segment Coordinate */
-            MathLib::coord_t segment_coord = {segment_lon[t][segment], segment_lat[t][segment]};
-            MathLib::point_t segment_point = MathLib::coord2point(segment_coord, projection);
-
-            /* Test Inclusion */
-            if(MathLib::inpoly(projected_poly, points_in_polygon, segment_point))
+            /* Project Batch of Segment Coordinates */
+            int batch_size = MIN(POLYGON_BATCH_SIZE, segment_ph_cnt[t].size - segment);
+            for(int b = 0; b < batch_size; b++)
             {
-                inclusion = true;
+                MathLib::coord_t segment_coord = {segment_lon[t][segment + b], segment_lat[t][segment + b]};
+                segment_points[b] = MathLib::coord2point(segment_coord, projection);
             }
 
-            /* Check First Segment */
-            if(!first_segment_found[t])
-            {
-                /* If Coordinate Is In Polygon */
-                if(inclusion && segment_ph_cnt[t][segment] != 0)
-                {
-                    /* Set First Segment */
-                    first_segment_found[t] = true;
-                    first_segment[t] = segment;
+            /* Test Inclusion of Batch */
+            poly_index->contains(segment_points, batch_size, segment_inclusion);
 
-                    /* Include Photons From First Segment */
-                    num_photons[t] = segment_ph_cnt[t][segment];
-                }
-                else
-                {
-                    /* Update Photon Index */
-                    first_photon[t] += segment_ph_cnt[t][segment];
-                }
-            }
-            else if(!last_segment_found[t])
+            for(int b = 0; b < batch_size; b++)
             {
-                /* If Coordinate Is NOT In Polygon */
-                if(!inclusion && segment_ph_cnt[t][segment] != 0)
+                bool inclusion = segment_inclusion[b];
+
+                /* Check First Segment */
+                if(!first_segment_found[t])
                 {
-                    /* Set Last Segment */
-                    last_segment_found[t] = true;
-                    break; // full extent found!
+                    /* If Coordinate Is In Polygon */
+                    if(inclusion && segment_ph_cnt[t][segment] != 0)
+                    {
+                        /* Set First Segment */
+                        first_segment_found[t] = true;
+                        first_segment[t] = segment;
+
+                        /* Include Photons From First Segment */
+                        num_photons[t] = segment_ph_cnt[t][segment];
+                    }
+                    else
+                    {
+                        /* Update Photon Index */
+                        first_photon[t] += segment_ph_cnt[t][segment];
+                    }
                 }
-                else
+                else if(!last_segment_found[t])
                 {
-                    /* Update Photon Index */
-                    num_photons[t] += segment_ph_cnt[t][segment];
+                    /* If Coordinate Is NOT In Polygon */
+                    if(!inclusion && segment_ph_cnt[t][segment] != 0)
+                    {
+                        /* Set Last Segment */
+                        last_segment_found[t] = true;
+                        break; // full extent found!
+                    }
+                    else
+                    {
+                        /* Update Photon Index */
+                        num_photons[t] += segment_ph_cnt[t][segment];
+                    }
                 }
-            }
 
-            /* Bump Segment */
-            segment++;
+                /* Bump Segment */
+                segment++;
+            }
         }
 
         /* Set Number of Segments */
@@ -450,9 +530,6 @@ void Atl03Reader::Region::polyregion (info_t* info)
             num_segments[t] = segment - first_segment[t];
         }
     }
-
-    /* Delete Projected Polygon */
-    delete [] projected_poly;
 }
 
 /*----------------------------------------------------------------------------
@@ -474,6 +551,9 @@ void Atl03Reader::Region::rasterregion (info_t* info)
         inclusion_mask[t] = new bool [segment_ph_cnt[t].size];
         inclusion_ptr[t] = inclusion_mask[t];
 
+        /* Check Inclusion of All Segments */
+        info->reader->parms->raster->subset(segment_lon[t].pointer, segment_lat[t].pointer, segment_ph_cnt[t].size, inclusion_mask[t]);
+
         /* Loop Throuh Segments */
         long curr_num_photons = 0;
         long last_segment = 0;
@@ -482,9 +562,7 @@ void Atl03Reader::Region::rasterregion (info_t* info)
         {
             if(segment_ph_cnt[t][segment] != 0)
             {
-                /* Check Inclusion */
-                bool inclusion = info->reader->parms->raster->subset(segment_lon[t][segment], segment_lat[t][segment]);
-                inclusion_mask[t][segment] = inclusion;
+                bool inclusion = inclusion_mask[t][segment];
 
                 /* Check For First Segment */
                 if(!first_segment_found[t])
@@ -789,305 +867,372 @@ Atl03Reader::YapcScore::~YapcScore (void)
  *----------------------------------------------------------------------------*/
 void Atl03Reader::YapcScore::yapcV2 (info_t* info, Region& region, Atl03Data& atl03)
 {
-    /* YAPC Hard-Coded Parameters */
-    const double MAXIMUM_HSPREAD = 15000.0; // meters
-    const double HSPREAD_BINSIZE = 1.0; // meters
-    const int MAX_KNN = 25;
-    double nearest_neighbors[MAX_KNN];
-
-    /* Shortcut to Settings */
-    RqstParms::yapc_t* settings = &info->reader->parms->yapc;
-
     /* Score Photons
      *
      *   CANNOT THROW BELOW THIS POINT
      */
     for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
     {
-        /* Allocate ATL08 Classification Array */
         int32_t num_photons = atl03.dist_ph_along[t].size;
         gt[t] = new uint8_t [num_photons];
-        LocalLib::set(gt[t], 0, num_photons);
+        scoreV2(&info->reader->parms->yapc, info->reader->parms->minimum_photon_count,
+                atl03.segment_id[t].size, region.segment_ph_cnt[t].pointer,
+                num_photons, atl03.dist_ph_along[t].pointer, atl03.h_ph[t].pointer, gt[t]);
+    }
+}
 
-        /* Initialize Indices */
-        int32_t ph_b0 = 0; // buffer start
-        int32_t ph_b1 = 0; // buffer end
-        int32_t ph_c0 = 0; // center start
-        int32_t ph_c1 = 0; // center end
+/*----------------------------------------------------------------------------
+ * yapcV3
+ *----------------------------------------------------------------------------*/
+void Atl03Reader::YapcScore::yapcV3 (info_t* info, Region& region, Atl03Data& atl03)
+{
+    /* Score Photons
+     *
+     *   CANNOT THROW BELOW THIS POINT
+     */
+    for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
+    {
+        int32_t num_photons = atl03.dist_ph_along[t].size;
+        gt[t] = new uint8_t [num_photons]; // class member freed in deconstructor
+        scoreV3(&info->reader->parms->yapc,
+                atl03.segment_id[t].size, region.segment_ph_cnt[t].pointer, atl03.segment_dist_x[t].pointer,
+                num_photons, atl03.dist_ph_along[t].pointer, atl03.h_ph[t].pointer, gt[t]);
+    }
+}
 
-        /* Loop Through Each ATL03 Segment */
-        int32_t num_segments = atl03.segment_id[t].size;
-        for(int segment_index = 0; segment_index < num_segments; segment_index++)
+/*----------------------------------------------------------------------------
+ * YapcScore::scoreV2
+ *
+ *  scores one track; the window is the segments on either side of the center
+ *  segment and the knn strongest proximities are kept in a fixed array
+ *----------------------------------------------------------------------------*/
+void Atl03Reader::YapcScore::scoreV2 (RqstParms::yapc_t* settings, int minimum_photon_count,
+                                      int32_t num_segments, const int32_t* segment_ph_cnt,
+                                      int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                      uint8_t* scores)
+{
+    /* YAPC Hard-Coded Parameters */
+    const double MAXIMUM_HSPREAD = 15000.0; // meters
+    const double HSPREAD_BINSIZE = 1.0; // meters
+    const int MAX_KNN = 25;
+    const int MAX_BINS = (int)(MAXIMUM_HSPREAD / HSPREAD_BINSIZE) + 1;
+    double nearest_neighbors[MAX_KNN];
+
+    /* Initialize Scores */
+    LocalLib::set(scores, 0, num_photons);
+
+    /* Allocate Height Bins (reused for each segment) */
+    int8_t* bins = new int8_t [MAX_BINS];
+
+    /* Initialize Indices */
+    int32_t ph_b0 = 0; // buffer start
+    int32_t ph_b1 = 0; // buffer end
+    int32_t ph_c0 = 0; // center start
+    int32_t ph_c1 = 0; // center end
+
+    /* Loop Through Each ATL03 Segment */
+    for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    {
+        /* Determine Indices */
+        ph_b0 += segment_index > 1 ? segment_ph_cnt[segment_index - 2] : 0; // Center - 2
+        ph_c0 += segment_index > 0 ? segment_ph_cnt[segment_index - 1] : 0; // Center - 1
+        ph_c1 += segment_ph_cnt[segment_index]; // Center
+        ph_b1 += segment_index < (num_segments - 1) ? segment_ph_cnt[segment_index + 1] : 0; // Center + 1
+
+        /* Calculate N and KNN */
+        int32_t N = segment_ph_cnt[segment_index];
+        int knn = (settings->knn != 0) ? settings->knn : MAX(1, (sqrt((double)N) + 0.5) / 2);
+        knn = MIN(knn, MAX_KNN); // truncate if too large
+
+        /* Check Valid Extent (note check against knn)*/
+        if((N <= knn) || (N < minimum_photon_count)) continue;
+
+        /* Calculate Distance and Height Spread */
+        double min_h = h_ph[0];
+        double max_h = min_h;
+        double min_x = dist_ph_along[0];
+        double max_x = min_x;
+        for(int n = 1; n < N; n++)
         {
-            /* Determine Indices */
-            ph_b0 += segment_index > 1 ? region.segment_ph_cnt[t][segment_index - 2] : 0; // Center - 2
-            ph_c0 += segment_index > 0 ? region.segment_ph_cnt[t][segment_index - 1] : 0; // Center - 1
-            ph_c1 += region.segment_ph_cnt[t][segment_index]; // Center
-            ph_b1 += segment_index < (num_segments - 1) ? region.segment_ph_cnt[t][segment_index + 1] : 0; // Center + 1
-
-            /* Calculate N and KNN */
-            int32_t N = region.segment_ph_cnt[t][segment_index];
-            int knn = (settings->knn != 0) ? settings->knn : MAX(1, (sqrt((double)N) + 0.5) / 2);
-            knn = MIN(knn, MAX_KNN); // truncate if too large
-
-            /* Check Valid Extent (note check against knn)*/
-            if((N <= knn) || (N < info->reader->parms->minimum_photon_count)) continue;
-
-            /* Calculate Distance and Height Spread */
-            double min_h = atl03.h_ph[t][0];
-            double max_h = min_h;
-            double min_x = atl03.dist_ph_along[t][0];
-            double max_x = min_x;
-            for(int n = 1; n < N; n++)
-            {
-                double h = atl03.h_ph[t][n];
-                double x = atl03.dist_ph_along[t][n];
-                if(h < min_h) min_h = h;
-                if(h > max_h) max_h = h;
-                if(x < min_x) min_x = x;
-                if(x > max_x) max_x = x;
-            }
-            double hspread = max_h - min_h;
-            double xspread = max_x - min_x;
+            double h = h_ph[n];
+            double x = dist_ph_along[n];
+            if(h < min_h) min_h = h;
+            if(h > max_h) max_h = h;
+            if(x < min_x) min_x = x;
+            if(x > max_x) max_x = x;
+        }
+        double hspread = max_h - min_h;
+        double xspread = max_x - min_x;
 
-            /* Check Window */
-            if(hspread <= 0.0 || hspread > MAXIMUM_HSPREAD || xspread <= 0.0)
-            {
-                mlog(ERROR, "Unable to perform YAPC selection due to invalid photon spread: %lf, %lf\n", hspread, xspread);
-                continue;
-            }
+        /* Check Window */
+        if(hspread <= 0.0 || hspread > MAXIMUM_HSPREAD || xspread <= 0.0)
+        {
+            mlog(ERROR, "Unable to perform YAPC selection due to invalid photon spread: %lf, %lf\n", hspread, xspread);
+            continue;
+        }
 
-            /* Bin Photons to Calculate Height Span*/
-            int num_bins = (int)(hspread / HSPREAD_BINSIZE) + 1;
-            int8_t* bins = new int8_t [num_bins];
-            LocalLib::set(bins, 0, num_bins);
-            for(int n = 0; n < N; n++)
-            {
-                unsigned int bin = (unsigned int)((atl03.h_ph[t][n] - min_h) / HSPREAD_BINSIZE);
-                bins[bin] = 1; // mark that photon present
-            }
+        /* Bin Photons to Calculate Height Span*/
+        int num_bins = (int)(hspread / HSPREAD_BINSIZE) + 1;
+        LocalLib::set(bins, 0, num_bins);
+        for(int n = 0; n < N; n++)
+        {
+            unsigned int bin = (unsigned int)((h_ph[n] - min_h) / HSPREAD_BINSIZE);
+            bins[bin] = 1; // mark that photon present
+        }
 
-            /* Determine Number of Bins with Photons to Calculate Height Span
-            * (and remove potential gaps in telemetry bands) */
-            int nonzero_bins = 0;
-            for(int b = 0; b < num_bins; b++) nonzero_bins += bins[b];
-            delete [] bins;
+        /* Determine Number of Bins with Photons to Calculate Height Span
+        * (and remove potential gaps in telemetry bands) */
+        int nonzero_bins = 0;
+        for(int b = 0; b < num_bins; b++) nonzero_bins += bins[b];
 
-            /* Calculate Height Span */
-            double h_span = (nonzero_bins * HSPREAD_BINSIZE) / (double)N * (double)knn;
+        /* Calculate Height Span */
+        double h_span = (nonzero_bins * HSPREAD_BINSIZE) / (double)N * (double)knn;
 
-            /* Calculate Window Parameters */
-            double half_win_x = settings->win_x / 2.0;
-            double half_win_h = (settings->win_h != 0.0) ? settings->win_h / 2.0 : h_span / 2.0;
+        /* Calculate Window Parameters */
+        double half_win_x = settings->win_x / 2.0;
+        double half_win_h = (settings->win_h != 0.0) ? settings->win_h / 2.0 : h_span / 2.0;
 
-            /* Calculate YAPC Score for all Photons in Center Segment */
-            for(int y = ph_c0; y < ph_c1; y++)
+        /* Calculate YAPC Score for all Photons in Center Segment */
+        for(int y = ph_c0; y < ph_c1; y++)
+        {
+            double smallest_nearest_neighbor = DBL_MAX;
+            int smallest_nearest_neighbor_index = 0;
+            int num_nearest_neighbors = 0;
+            float x_y = dist_ph_along[y];
+            float h_y = h_ph[y];
+
+            /* For All Neighbors */
+            for(int x = ph_b0; x < ph_b1; x++)
             {
-                double smallest_nearest_neighbor = DBL_MAX;
-                int smallest_nearest_neighbor_index = 0;
-                int num_nearest_neighbors = 0;
-
-                /* For All Neighbors */
-                for(int x = ph_b0; x < ph_b1; x++)
-                {
-                    /* Check for Identity */
-                    if(y == x) continue;
+                /* Check for Identity */
+                if(y == x) continue;
 
-                    /* Check Window */
-                    double delta_x = abs(atl03.dist_ph_along[t][x] - atl03.dist_ph_along[t][y]);
-                    if(delta_x > half_win_x) continue;
+                /* Check Window */
+                double delta_x = abs(dist_ph_along[x] - x_y);
+                if(delta_x > half_win_x) continue;
 
-                    /*  Calculate Weighted Distance */
-                    double delta_h = abs(atl03.h_ph[t][x] - atl03.h_ph[t][y]);
-                    double proximity = half_win_h - delta_h;
+                /*  Calculate Weighted Distance */
+                double delta_h = abs(h_ph[x] - h_y);
+                double proximity = half_win_h - delta_h;
 
-                    /* Add to Nearest Neighbor */
-                    if(num_nearest_neighbors < knn)
+                /* Add to Nearest Neighbor */
+                if(num_nearest_neighbors < knn)
+                {
+                    /* Maintain Smallest Nearest Neighbor */
+                    if(proximity < smallest_nearest_neighbor)
                     {
-                        /* Maintain Smallest Nearest Neighbor */
-                        if(proximity < smallest_nearest_neighbor)
-                        {
-                            smallest_nearest_neighbor = proximity;
-                            smallest_nearest_neighbor_index = num_nearest_neighbors;
-                        }
-
-                        /* Automatically Add Nearest Neighbor (filling up array) */
-                        nearest_neighbors[num_nearest_neighbors] = proximity;
-                        num_nearest_neighbors++;
+                        smallest_nearest_neighbor = proximity;
+                        smallest_nearest_neighbor_index = num_nearest_neighbors;
                     }
-                    else if(proximity > smallest_nearest_neighbor)
-                    {
-                        /* Add New Nearest Neighbor (replace current largest) */
-                        nearest_neighbors[smallest_nearest_neighbor_index] = proximity;
-                        smallest_nearest_neighbor = proximity; // temporarily set
 
-                        /* Recalculate Largest Nearest Neighbor */
-                        for(int k = 0; k < knn; k++)
+                    /* Automatically Add Nearest Neighbor (filling up array) */
+                    nearest_neighbors[num_nearest_neighbors] = proximity;
+                    num_nearest_neighbors++;
+                }
+                else if(proximity > smallest_nearest_neighbor)
+                {
+                    /* Add New Nearest Neighbor (replace current largest) */
+                    nearest_neighbors[smallest_nearest_neighbor_index] = proximity;
+                    smallest_nearest_neighbor = proximity; // temporarily set
+
+                    /* Recalculate Largest Nearest Neighbor */
+                    for(int k = 0; k < knn; k++)
+                    {
+                        if(nearest_neighbors[k] < smallest_nearest_neighbor)
                         {
-                            if(nearest_neighbors[k] < smallest_nearest_neighbor)
-                            {
-                                smallest_nearest_neighbor = nearest_neighbors[k];
-                                smallest_nearest_neighbor_index = k;
-                            }
+                            smallest_nearest_neighbor = nearest_neighbors[k];
+                            smallest_nearest_neighbor_index = k;
                         }
                     }
                 }
+            }
 
-                /* Fill In Rest of Nearest Neighbors (if not already full) */
-                for(int k = num_nearest_neighbors; k < knn; k++)
-                {
-                    nearest_neighbors[k] = 0.0;
-                }
+            /* Fill In Rest of Nearest Neighbors (if not already full) */
+            for(int k = num_nearest_neighbors; k < knn; k++)
+            {
+                nearest_neighbors[k] = 0.0;
+            }
 
-                /* Calculate Inverse Sum of Distances from Nearest Neighbors */
-                double nearest_neighbor_sum = 0.0;
-                for(int k = 0; k < knn; k++)
+            /* Calculate Inverse Sum of Distances from Nearest Neighbors */
+            double nearest_neighbor_sum = 0.0;
+            for(int k = 0; k < knn; k++)
+            {
+                if(nearest_neighbors[k] > 0.0)
                 {
-                    if(nearest_neighbors[k] > 0.0)
-                    {
-                        nearest_neighbor_sum += nearest_neighbors[k];
-                    }
+                    nearest_neighbor_sum += nearest_neighbors[k];
                 }
-                nearest_neighbor_sum /= (double)knn;
-
-                /* Calculate YAPC Score of Photon */
-                gt[t][y] = (uint8_t)((nearest_neighbor_sum / half_win_h) * 0xFF);
             }
+            nearest_neighbor_sum /= (double)knn;
+
+            /* Calculate YAPC Score of Photon */
+            scores[y] = (uint8_t)((nearest_neighbor_sum / half_win_h) * 0xFF);
         }
     }
+
+    /* Free Height Bins */
+    delete [] bins;
 }
 
 /*----------------------------------------------------------------------------
- * yapcV3
+ * YapcScore::scoreV3
+ *
+ *  scores one track; when the along track distances are in order (as they are
+ *  in ATL03) the neighbors of each photon are found by sliding the edges of
+ *  the window forward instead of searching outward from every photon, and the
+ *  knn smallest proximities are selected in place rather than fully sorted
  *----------------------------------------------------------------------------*/
-void Atl03Reader::YapcScore::yapcV3 (info_t* info, Region& region, Atl03Data& atl03)
+void Atl03Reader::YapcScore::scoreV3 (RqstParms::yapc_t* settings,
+                                      int32_t num_segments, const int32_t* segment_ph_cnt, const double* segment_dist_x,
+                                      int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                      uint8_t* scores)
 {
     /* YAPC Parameters */
-    RqstParms::yapc_t* settings = &info->reader->parms->yapc;
     const double hWX = settings->win_x / 2; // meters
     const double hWZ = settings->win_h / 2; // meters
 
-    /* Score Photons
-     *
-     *   CANNOT THROW BELOW THIS POINT
-     */
-    for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
-    {
-        int32_t num_segments = atl03.segment_id[t].size;
-        int32_t num_photons = atl03.dist_ph_along[t].size;
+    /* Initialize Scores */
+    LocalLib::set(scores, 0, num_photons);
+    if(num_photons <= 0) return;
 
-        /* Allocate Photon Arrays */
-        gt[t] = new uint8_t [num_photons]; // class member freed in deconstructor
-        double* ph_dist = new double[num_photons]; // local array freed below
+    /* Allocate Photon Arrays (freed below) */
+    double* ph_dist = new double[num_photons];
+    double* ph_weights = new double[num_photons];
+    int32_t proximities_size = 256;
+    double* proximities = new double[proximities_size]; // grows with the densest window
 
-        /* Populate Distance Array */
-        int32_t ph_index = 0;
-        for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    /* Populate Distance Array */
+    int32_t ph_index = 0;
+    for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    {
+        for(int32_t ph_in_seg_index = 0; ph_in_seg_index < segment_ph_cnt[segment_index] && ph_index < num_photons; ph_in_seg_index++)
         {
-            for(int32_t ph_in_seg_index = 0; ph_in_seg_index < region.segment_ph_cnt[t][segment_index]; ph_in_seg_index++)
-            {
-                ph_dist[ph_index] = atl03.segment_dist_x[t][segment_index] + atl03.dist_ph_along[t][ph_index];
-                ph_index++;
-            }
+            ph_dist[ph_index] = segment_dist_x[segment_index] + dist_ph_along[ph_index];
+            ph_index++;
         }
+    }
+    int32_t num_distances = ph_index; // neighbors are only searched for among these
 
-        /* Traverse Each Segment */
-        ph_index = 0;
-        for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    /* Check Photons are in Along Track Order (otherwise search outward from each photon) */
+    bool sorted = true;
+    for(int32_t i = 1; i < num_distances; i++)
+    {
+        if(!(ph_dist[i] >= ph_dist[i - 1])) // also catches NaN
         {
-            /* Initialize Segment Parameters */
-            int32_t N = region.segment_ph_cnt[t][segment_index];
-            double* ph_weights = new double[N]; // local array freed below
-            int max_knn = settings->min_knn;
-            int32_t start_ph_index = ph_index;
-
-            /* Traverse Each Photon in Segment*/
-            for(int32_t ph_in_seg_index = 0; ph_in_seg_index < N; ph_in_seg_index++)
-            {
-                List<double> proximities;
+            sorted = false;
+            break;
+        }
+    }
 
-                /* Check Nearest Neighbors to Left */
-                int32_t neighbor_index = ph_index - 1;
-                while(neighbor_index >= 0)
-                {
-                    /* Check Inside Horizontal Window */
-                    double x_dist = ph_dist[ph_index] - ph_dist[neighbor_index];
-                    if(x_dist <= hWX)
-                    {
-                        /* Check Inside Vertical Window */
-                        double proximity = abs(atl03.h_ph[t][ph_index] - atl03.h_ph[t][neighbor_index]);
-                        if(proximity <= hWZ)
-                        {
-                            proximities.add(proximity);
-                        }
-                    }
+    /* Traverse Each Segment */
+    int32_t window_start = 0; // first photon inside horizontal window
+    int32_t window_end = 0; // one past last photon inside horizontal window
+    ph_index = 0;
+    for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    {
+        /* Initialize Segment Parameters */
+        int32_t N = MIN(segment_ph_cnt[segment_index], num_distances - ph_index);
+        int max_knn = settings->min_knn;
+        int32_t start_ph_index = ph_index;
 
-                    /* Check for Stopping Condition: 1m Buffer Added to X Window */
-                    if(x_dist >= (hWX + 1.0)) break;
+        /* Traverse Each Photon in Segment*/
+        for(int32_t ph_in_seg_index = 0; ph_in_seg_index < N; ph_in_seg_index++)
+        {
+            int32_t num_proximities = 0;
 
-                    /* Goto Next Neighor */
-                    neighbor_index--;
+            /* Determine Neighbors */
+            int32_t left_start = 0, right_end = 0;
+            if(sorted)
+            {
+                /* Slide Window */
+                while(window_start < ph_index && (ph_dist[ph_index] - ph_dist[window_start]) > hWX) window_start++;
+                if(window_end <= ph_index) window_end = ph_index + 1;
+                while(window_end < num_distances && (ph_dist[window_end] - ph_dist[ph_index]) <= hWX) window_end++;
+                left_start = window_start;
+                right_end = window_end;
+            }
+            else
+            {
+                /* Search Left: 1m Buffer Added to X Window */
+                left_start = ph_index;
+                for(int32_t neighbor_index = ph_index - 1; neighbor_index >= 0; neighbor_index--)
+                {
+                    left_start = neighbor_index;
+                    if((ph_dist[ph_index] - ph_dist[neighbor_index]) >= (hWX + 1.0)) break;
                 }
 
-                /* Check Nearest Neighbors to Right */
-                neighbor_index = ph_index + 1;
-                while(neighbor_index < num_photons)
+                /* Search Right: 1m Buffer Added to X Window */
+                right_end = ph_index + 1;
+                for(int32_t neighbor_index = ph_index + 1; neighbor_index < num_distances; neighbor_index++)
                 {
-                    /* Check Inside Horizontal Window */
-                    double x_dist = ph_dist[neighbor_index] - ph_dist[ph_index];
-                    if(x_dist <= hWX)
-                    {
-                        /* Check Inside Vertical Window */
-                        double proximity = abs(atl03.h_ph[t][ph_index] - atl03.h_ph[t][neighbor_index]);
-                        if(proximity <= hWZ) // inside of height window
-                        {
-                            proximities.add(proximity);
-                        }
-                    }
-
-                    /* Check for Stopping Condition: 1m Buffer Added to X Window */
-                    if(x_dist >= (hWX + 1.0)) break;
-
-                    /* Goto Next Neighor */
-                    neighbor_index++;
+                    right_end = neighbor_index + 1;
+                    if((ph_dist[neighbor_index] - ph_dist[ph_index]) >= (hWX + 1.0)) break;
                 }
+            }
 
-                /* Sort Proximities */
-                proximities.sort();
+            /* Make Room for Every Neighbor */
+            if((right_end - left_start) > proximities_size)
+            {
+                delete [] proximities;
+                proximities_size = right_end - left_start;
+                proximities = new double[proximities_size];
+            }
 
-                /* Calculate knn */
-                double n = sqrt(proximities.length());
-                int knn = MAX(n, settings->min_knn);
-                if(knn > max_knn) max_knn = knn;
+            /* Collect Proximities of Neighbors Inside Window */
+            for(int32_t neighbor_index = left_start; neighbor_index < right_end; neighbor_index++)
+            {
+                if(neighbor_index == ph_index) continue;
 
-                /* Calculate Sum of Weights*/
-                int num_nearest_neighbors = MIN(knn, proximities.length());
-                double weight_sum = 0.0;
-                for(int i = 0; i < num_nearest_neighbors; i++)
+                /* Check Inside Horizontal Window */
+                double x_dist = (neighbor_index < ph_index) ? ph_dist[ph_index] - ph_dist[neighbor_index] : ph_dist[neighbor_index] - ph_dist[ph_index];
+                if(x_dist <= hWX)
                 {
-                    weight_sum += hWZ - proximities[i];
+                    /* Check Inside Vertical Window */
+                    double proximity = abs(h_ph[ph_index] - h_ph[neighbor_index]);
+                    if(proximity <= hWZ)
+                    {
+                        proximities[num_proximities++] = proximity;
+                    }
                 }
-                ph_weights[ph_in_seg_index] = weight_sum;
+            }
 
-                /* Go To Next Photon */
-                ph_index++;
+            /* Calculate knn */
+            double n = sqrt(num_proximities);
+            int knn = MAX(n, settings->min_knn);
+            if(knn > max_knn) max_knn = knn;
+
+            /* Select Nearest Neighbors (smallest proximities, summed in ascending order) */
+            int num_nearest_neighbors = MIN(knn, num_proximities);
+            if(num_nearest_neighbors < num_proximities)
+            {
+                std::nth_element(proximities, proximities + num_nearest_neighbors, proximities + num_proximities);
             }
+            std::sort(proximities, proximities + num_nearest_neighbors);
 
-            /* Normalize Weights */
-            for(int32_t ph_in_seg_index = 0; ph_in_seg_index < N; ph_in_seg_index++)
+            /* Calculate Sum of Weights*/
+            double weight_sum = 0.0;
+            for(int i = 0; i < num_nearest_neighbors; i++)
             {
-                double Wt = ph_weights[ph_in_seg_index] / (hWZ * max_knn);
-                gt[t][start_ph_index] = (uint8_t)(MIN(Wt * 255, 255));
-                start_ph_index++;
+                weight_sum += hWZ - proximities[i];
             }
+            ph_weights[ph_index] = weight_sum;
 
-            /* Free Photon Weights Array */
-            delete [] ph_weights;
+            /* Go To Next Photon */
+            ph_index++;
         }
 
-        /* Free Photon Distance Array */
-        delete [] ph_dist;
+        /* Normalize Weights */
+        for(int32_t ph_in_seg_index = 0; ph_in_seg_index < N; ph_in_seg_index++)
+        {
+            double Wt = ph_weights[start_ph_index] / (hWZ * max_knn);
+            scores[start_ph_index] = (uint8_t)(MIN(Wt * 255, 255));
+            start_ph_index++;
+        }
     }
+
+    /* Free Photon Arrays */
+    delete [] proximities;
+    delete [] ph_weights;
+    delete [] ph_dist;
 }
 
 /*----------------------------------------------------------------------------
@@ -1215,9 +1360,10 @@ void* Atl03Reader::subsettingThread (void* parm)
                 state[t].extent_segment = state[t].seg_in;
                 state[t].extent_valid = true;
                 state[t].extent_photons.clear();
+                state[t].extent_distances.clear();
 
-                /* Ancillary Photon Fields */
-                if(parms->atl03_ph_fields)
+                /* Ancillary Photon Fields (and columnar extents, which gather photons by index) */
+                if(parms->atl03_ph_fields || reader->columnar)
                 {
                     if(state[t].photon_indices) state[t].photon_indices->clear();
                     else                        state[t].photon_indices = new List<int32_t>;
@@ -1323,18 +1469,26 @@ void* Atl03Reader::subsettingThread (void* parm)
                             }
 
                             /* Add Photon to Extent */
-                            photon_t ph = {
-                                .delta_time = atl03.delta_time[t][current_photon],
-                                .latitude = atl03.lat_ph[t][current_photon],
-                                .longitude = atl03.lon_ph[t][current_photon],
-                                .distance = along_track_distance - (state.extent_length / 2.0),
-                                .height = atl03.h_ph[t][current_photon],
-                                .atl08_class = (uint8_t)atl08_class,
-                                .atl03_cnf = (int8_t)atl03_cnf,
-                                .quality_ph = (int8_t)quality_ph,
-                                .yapc_score = yapc_score
-                            };
-                            state[t].extent_photons.add(ph);
+                            if(!reader->columnar)
+                            {
+                                photon_t ph = {
+                                    .delta_time = atl03.delta_time[t][current_photon],
+                                    .latitude = atl03.lat_ph[t][current_photon],
+                                    .longitude = atl03.lon_ph[t][current_photon],
+                                    .distance = along_track_distance - (state.extent_length / 2.0),
+                                    .height = atl03.h_ph[t][current_photon],
+                                    .atl08_class = (uint8_t)atl08_class,
+                                    .atl03_cnf = (int8_t)atl03_cnf,
+                                    .quality_ph = (int8_t)quality_ph,
+                                    .yapc_score = yapc_score
+                                };
+                                state[t].extent_photons.add(ph);
+                            }
+                            else
+                            {
+                                /* Remaining Fields Gathered by Index when Record is Built */
+                                state[t].extent_distances.add(along_track_distance - (state.extent_length / 2.0));
+                            }
 
                             /* Index Photon for Ancillary Fields */
                             if(state[t].photon_indices)
@@ -1386,16 +1540,19 @@ void* Atl03Reader::subsettingThread (void* parm)
                 }
 
                 /* Check Photon Count */
-                if(state[t].extent_photons.length() < parms->minimum_photon_count)
+                int32_t extent_count = reader->columnar ? state[t].extent_distances.length() : state[t].extent_photons.length();
+                if(extent_count < parms->minimum_photon_count)
                 {
                     state[t].extent_valid = false;
                 }
 
                 /* Check Along Track Spread */
-                if(state[t].extent_photons.length() > 1)
+                if(extent_count > 1)
                 {
-                    int32_t last = state[t].extent_photons.length() - 1;
-                    double along_track_spread = state[t].extent_photons[last].distance - state[t].extent_photons[0].distance;
+                    int32_t last = extent_count - 1;
+                    double along_track_spread;
+                    if(!reader->columnar)   along_track_spread = state[t].extent_photons[last].distance - state[t].extent_photons[0].distance;
+                    else                    along_track_spread = state[t].extent_distances[last] - state[t].extent_distances[0];
                     if(along_track_spread < parms->along_track_spread)
                     {
                         state[t].extent_valid = false;
@@ -1415,13 +1572,17 @@ void* Atl03Reader::subsettingThread (void* parm)
                                      RqstParms::EXTENT_ID_PHOTONS;
 
                 /* Build and Send Extent Record */
-                if(!reader->flatten)
+                if(reader->flatten)
                 {
-                    reader->sendExtentRecord(extent_id, info->track, state, atl03, &local_stats);
+                    reader->sendFlatRecord (extent_id, info->track, state, atl03, &local_stats);
+                }
+                else if(reader->columnar)
+                {
+                    reader->sendColumnarRecord(extent_id, info->track, state, atl03, atl08, yapc, &local_stats);
                 }
                 else
                 {
-                    reader->sendFlatRecord (extent_id, info->track, state, atl03, &local_stats);
+                    reader->sendExtentRecord(extent_id, info->track, state, atl03, &local_stats);
                 }
 
 
@@ -1477,6 +1638,34 @@ void* Atl03Reader::subsettingThread (void* parm)
     return NULL;
 }
 
+/*----------------------------------------------------------------------------
+ * getPolygonIndex
+ *
+ *  the request polygon is projected and prepared the first time a track
+ *  needs it in a given projection, and then shared by all tracks
+ *----------------------------------------------------------------------------*/
+const PolygonIndex* Atl03Reader::getPolygonIndex (MathLib::proj_t projection)
+{
+    polyMut.lock();
+    {
+        if(polyIndex[projection] == NULL)
+        {
+            int points_in_polygon = parms->polygon.length();
+            List<MathLib::coord_t>::Iterator poly_iterator(parms->polygon);
+            MathLib::point_t* projected_poly = new MathLib::point_t [points_in_polygon];
+            for(int i = 0; i < points_in_polygon; i++)
+            {
+                projected_poly[i] = MathLib::coord2point(poly_iterator[i], projection);
+            }
+            polyIndex[projection] = new PolygonIndex(projected_poly, points_in_polygon);
+            delete [] projected_poly;
+        }
+    }
+    polyMut.unlock();
+
+    return polyIndex[projection];
+}
+
 /*----------------------------------------------------------------------------
  * calculateBackground
  *----------------------------------------------------------------------------*/
@@ -1551,14 +1740,119 @@ bool Atl03Reader::sendExtentRecord (uint64_t extent_id, uint8_t track, TrackStat
     /* Allocate and Initialize Extent Record */
     RecordObject record(exRecType, extent_bytes);
     extent_t* extent = (extent_t*)record.getRecordData();
+    populateAttributes(extent, extent_id, track, state, atl03);
+
+    /* Populate Extent */
+    uint32_t ph_out = 0;
+    for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
+    {
+        extent->photon_count[t] = state[t].extent_photons.length();
+
+        /* Populate Photons */
+        if(num_photons > 0)
+        {
+            for(int32_t p = 0; p < state[t].extent_photons.length(); p++)
+            {
+                extent->photons[ph_out++] = state[t].extent_photons[p];
+            }
+        }
+    }
+
+    /* Set Photon Pointer Fields */
+    extent->photon_offset[RqstParms::RPT_L] = sizeof(extent_t); // pointers are set to offset from start of record data
+    extent->photon_offset[RqstParms::RPT_R] = sizeof(extent_t) + (sizeof(photon_t) * extent->photon_count[RqstParms::RPT_L]);
+
+    /* Post Segment Record */
+    return postRecord(&record, local_stats);
+}
+
+/*----------------------------------------------------------------------------
+ * sendColumnarRecord
+ *
+ *  photons are gathered field by field straight from the ATL03 arrays using
+ *  the indices kept while the extent was selected, so each column is written
+ *  contiguously and the record is posted with a single copy
+ *----------------------------------------------------------------------------*/
+bool Atl03Reader::sendColumnarRecord (uint64_t extent_id, uint8_t track, TrackState& state, Atl03Data& atl03, Atl08Class& atl08, YapcScore& yapc, stats_t* local_stats)
+{
+    /* Calculate Extent Record Size */
+    uint32_t num_photons = state[RqstParms::RPT_L].extent_distances.length() + state[RqstParms::RPT_R].extent_distances.length();
+    uint32_t bytes_per_photon = (sizeof(double) * 4) + sizeof(float) + (sizeof(uint8_t) * 4);
+    int extent_bytes = offsetof(extent_columns_t, columns) + (bytes_per_photon * num_photons);
+
+    /* Allocate and Initialize Extent Record */
+    RecordObject record(exColRecType, extent_bytes);
+    extent_columns_t* extent = (extent_columns_t*)record.getRecordData();
+    populateAttributes((extent_t*)extent, extent_id, track, state, atl03);
+
+    /* Lay Out Columns (pointers are set to offset from start of record data; widest first to keep alignment) */
+    uint32_t offset = offsetof(extent_columns_t, columns);
+    extent->delta_time_offset   = offset;   offset += sizeof(double) * num_photons;
+    extent->latitude_offset     = offset;   offset += sizeof(double) * num_photons;
+    extent->longitude_offset    = offset;   offset += sizeof(double) * num_photons;
+    extent->distance_offset     = offset;   offset += sizeof(double) * num_photons;
+    extent->height_offset       = offset;   offset += sizeof(float) * num_photons;
+    extent->atl08_class_offset  = offset;   offset += sizeof(uint8_t) * num_photons;
+    extent->atl03_cnf_offset    = offset;   offset += sizeof(int8_t) * num_photons;
+    extent->quality_ph_offset   = offset;   offset += sizeof(int8_t) * num_photons;
+    extent->yapc_score_offset   = offset;
+
+    uint8_t* data = (uint8_t*)extent;
+    double*  delta_time     = (double*)&data[extent->delta_time_offset];
+    double*  latitude       = (double*)&data[extent->latitude_offset];
+    double*  longitude      = (double*)&data[extent->longitude_offset];
+    double*  distance       = (double*)&data[extent->distance_offset];
+    float*   height         = (float*)&data[extent->height_offset];
+    uint8_t* atl08_class    = (uint8_t*)&data[extent->atl08_class_offset];
+    int8_t*  atl03_cnf      = (int8_t*)&data[extent->atl03_cnf_offset];
+    int8_t*  quality_ph     = (int8_t*)&data[extent->quality_ph_offset];
+    uint8_t* yapc_score     = (uint8_t*)&data[extent->yapc_score_offset];
+
+    /* Populate Columns */
+    uint32_t ph_out = 0;
+    for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
+    {
+        int32_t count = state[t].extent_distances.length();
+        extent->photon_count[t] = count;
+        extent->first_photon[t] = ph_out;
+
+        /* Pull Track Arrays */
+        List<int32_t>& indices = *state[t].photon_indices;
+        List<double>& distances = state[t].extent_distances;
+        const uint8_t* atl08_gt = atl08[t];
+        const uint8_t* yapc_gt = yapc[t];
+
+        /* Gather Photons */
+        for(int32_t p = 0; p < count; p++, ph_out++)
+        {
+            int32_t ph = indices[p];
+            delta_time[ph_out]  = atl03.delta_time[t][ph];
+            latitude[ph_out]    = atl03.lat_ph[t][ph];
+            longitude[ph_out]   = atl03.lon_ph[t][ph];
+            distance[ph_out]    = distances[p];
+            height[ph_out]      = atl03.h_ph[t][ph];
+            atl08_class[ph_out] = atl08_gt ? atl08_gt[ph] : (uint8_t)RqstParms::ATL08_UNCLASSIFIED;
+            atl03_cnf[ph_out]   = atl03.signal_conf_ph[t][ph];
+            quality_ph[ph_out]  = atl03.quality_ph[t][ph];
+            yapc_score[ph_out]  = yapc_gt ? yapc_gt[ph] : 0;
+        }
+    }
+
+    /* Post Segment Record */
+    return postRecord(&record, local_stats);
+}
+
+/*----------------------------------------------------------------------------
+ * populateAttributes
+ *----------------------------------------------------------------------------*/
+void Atl03Reader::populateAttributes (extent_t* extent, uint64_t extent_id, uint8_t track, TrackState& state, Atl03Data& atl03)
+{
     extent->extent_id = extent_id;
     extent->reference_pair_track = track;
     extent->spacecraft_orientation = (*sc_orient)[0];
     extent->reference_ground_track_start = start_rgt;
     extent->cycle_start = start_cycle;
 
-    /* Populate Extent */
-    uint32_t ph_out = 0;
     for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
     {
         /* Calculate Spacecraft Velocity */
@@ -1568,18 +1862,6 @@ bool Atl03Reader::sendExtentRecord (uint64_t extent_id, uint8_t track, TrackStat
         double sc_v3 = atl03.velocity_sc[t][sc_v_offset + 2];
         double spacecraft_velocity = sqrt((sc_v1*sc_v1) + (sc_v2*sc_v2) + (sc_v3*sc_v3));
 
-        /* Calculate Segment ID (attempt to arrive at closest ATL06 segment ID represented by extent) */
-        double atl06_segment_id = (double)atl03.segment_id[t][state[t].extent_segment]; // start with first segment in extent
-        if(!parms->dist_in_seg)
-        {
-            atl06_segment_id += state[t].start_seg_portion; // add portion of first segment that first photon is included
-            atl06_segment_id += (int)((parms->extent_length / ATL03_SEGMENT_LENGTH) / 2.0); // add half the length of the extent
-        }
-        else // dist_in_seg is true
-        {
-            atl06_segment_id += (int)(parms->extent_length / 2.0);
-        }
-
         /* Populate Attributes */
         extent->valid[t]                = state[t].extent_valid;
         extent->segment_id[t]           = calculateSegmentId(t, state, atl03);
@@ -1587,24 +1869,7 @@ bool Atl03Reader::sendExtentRecord (uint64_t extent_id, uint8_t track, TrackStat
         extent->extent_length[t]        = state.extent_length;
         extent->spacecraft_velocity[t]  = spacecraft_velocity;
         extent->background_rate[t]      = calculateBackground(t, state, atl03);
-        extent->photon_count[t]         = state[t].extent_photons.length();
-
-        /* Populate Photons */
-        if(num_photons > 0)
-        {
-            for(int32_t p = 0; p < state[t].extent_photons.length(); p++)
-            {
-                extent->photons[ph_out++] = state[t].extent_photons[p];
-            }
-        }
     }
-
-    /* Set Photon Pointer Fields */
-    extent->photon_offset[RqstParms::RPT_L] = sizeof(extent_t); // pointers are set to offset from start of record data
-    extent->photon_offset[RqstParms::RPT_R] = sizeof(extent_t) + (sizeof(photon_t) * extent->photon_count[RqstParms::RPT_L]);
-
-    /* Post Segment Record */
-    return postRecord(&record, local_stats);
 }
 
 /*----------------------------------------------------------------------------
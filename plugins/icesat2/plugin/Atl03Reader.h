@@ -43,6 +43,7 @@
 #include "RecordObject.h"
 #include "MsgQ.h"
 #include "OsApi.h"
+#include "MathLib.h"
 #include "StringLib.h"
 
 #include "GTArray.h"
@@ -69,6 +70,9 @@ class Atl03Reader: public LuaObject
         static const char* exRecType;
         static const RecordObject::fieldDef_t exRecDef[];
 
+        static const char* exColRecType;
+        static const RecordObject::fieldDef_t exColRecDef[];
+
         static const char* phFlatRecType;
         static const RecordObject::fieldDef_t phFlatRecDef[];
 
@@ -121,6 +125,61 @@ class Atl03Reader: public LuaObject
             photon_t        photons[]; // zero length field
         } extent_t;
 
+        /* Columnar Extent Record
+         *
+         *  the attributes up through photon_count match extent_t so that the
+         *  record can be read through an extent_t for everything but photons;
+         *  each photon field is a contiguous column across both pair tracks
+         *  (left track first), located by its offset from the start of the
+         *  record data
+         */
+        typedef struct {
+            bool            valid[RqstParms::NUM_PAIR_TRACKS];
+            uint8_t         reference_pair_track; // 1, 2, or 3
+            uint8_t         spacecraft_orientation; // sc_orient_t
+            uint16_t        reference_ground_track_start;
+            uint16_t        cycle_start;
+            uint64_t        extent_id;
+            uint32_t        segment_id[RqstParms::NUM_PAIR_TRACKS];
+            double          segment_distance[RqstParms::NUM_PAIR_TRACKS];
+            double          extent_length[RqstParms::NUM_PAIR_TRACKS]; // meters
+            double          spacecraft_velocity[RqstParms::NUM_PAIR_TRACKS]; // meters per second
+            double          background_rate[RqstParms::NUM_PAIR_TRACKS]; // PE per second
+            uint32_t        photon_count[RqstParms::NUM_PAIR_TRACKS];
+            uint32_t        first_photon[RqstParms::NUM_PAIR_TRACKS]; // index into columns
+            uint32_t        delta_time_offset;  // double[]
+            uint32_t        latitude_offset;    // double[]
+            uint32_t        longitude_offset;   // double[]
+            uint32_t        distance_offset;    // double[]
+            uint32_t        height_offset;      // float[]
+            uint32_t        atl08_class_offset; // uint8_t[]
+            uint32_t        atl03_cnf_offset;   // int8_t[]
+            uint32_t        quality_ph_offset;  // int8_t[]
+            uint32_t        yapc_score_offset;  // uint8_t[]
+            uint8_t         columns[]; // zero length field
+        } extent_columns_t;
+
+        /* Photon Field View (strided over photon_t, contiguous over columns) */
+        template <class T>
+        struct column_t {
+            const uint8_t*  base;
+            long            stride;
+            inline T operator[] (long i) const { return *(const T*)(base + (i * stride)); }
+        };
+
+        /* Photon Fields of an Extent */
+        typedef struct {
+            column_t<double>    delta_time;
+            column_t<double>    latitude;
+            column_t<double>    longitude;
+            column_t<double>    distance;
+            column_t<float>     height;
+            column_t<uint8_t>   atl08_class;
+            column_t<int8_t>    atl03_cnf;
+            column_t<int8_t>    quality_ph;
+            column_t<uint8_t>   yapc_score;
+        } photon_columns_t;
+
         /* Flattened Photon Fields */
         typedef struct {
             uint64_t        extent_id;
@@ -163,8 +222,9 @@ class Atl03Reader: public LuaObject
          * Methods
          *--------------------------------------------------------------------*/
 
-        static int  luaCreate   (lua_State* L);
-        static void init        (void);
+        static int          luaCreate       (lua_State* L);
+        static void         init            (void);
+        static extent_t*    getExtent       (RecordObject* record, photon_columns_t* columns);
 
     private:
 
@@ -263,6 +323,15 @@ class Atl03Reader: public LuaObject
                 void yapcV2         (info_t* info, Region& region, Atl03Data& atl03);
                 void yapcV3         (info_t* info, Region& region, Atl03Data& atl03);
 
+                static void scoreV2 (RqstParms::yapc_t* settings, int minimum_photon_count,
+                                     int32_t num_segments, const int32_t* segment_ph_cnt,
+                                     int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                     uint8_t* scores);
+                static void scoreV3 (RqstParms::yapc_t* settings,
+                                     int32_t num_segments, const int32_t* segment_ph_cnt, const double* segment_dist_x,
+                                     int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                     uint8_t* scores);
+
                 uint8_t* operator[] (int t);
 
                 /* Generated Data */
@@ -286,6 +355,7 @@ class Atl03Reader: public LuaObject
                     int32_t         bckgrd_in;          // bckgrd index
                     List<int32_t>*  photon_indices;     // used for ancillary data
                     List<photon_t>  extent_photons;     // list of individual photons in extent
+                    List<double>    extent_distances;   // along track distance of each photon in photon_indices (columnar)
                     int32_t         extent_segment;     // current segment extent is pulling photons from
                     bool            extent_valid;       // flag for validity of extent (atl06 checks)
                } track_state_t;
@@ -303,6 +373,7 @@ class Atl03Reader: public LuaObject
          *--------------------------------------------------------------------*/
 
         static const double ATL03_SEGMENT_LENGTH;
+        static const int POLYGON_BATCH_SIZE = 256; // segments tested for inclusion at a time
 
         /*--------------------------------------------------------------------
          * Data
@@ -321,8 +392,12 @@ class Atl03Reader: public LuaObject
         Publisher*          outQ;
         RqstParms*          parms;
         bool                flatten;
+        bool                columnar;
         stats_t             stats;
 
+        Mutex               polyMut;
+        PolygonIndex*       polyIndex[MathLib::NUM_PROJECTIONS];
+
         H5Coro::context_t   context; // for ATL03 file
         H5Coro::context_t   context08; // for ATL08 file
 
@@ -335,15 +410,19 @@ class Atl03Reader: public LuaObject
          * Methods
          *--------------------------------------------------------------------*/
 
-                            Atl03Reader             (lua_State* L, Asset* _asset, const char* _resource, const char* outq_name, RqstParms* _parms, bool _send_terminator=true, bool _flatten=false);
+                            Atl03Reader             (lua_State* L, Asset* _asset, const char* _resource, const char* outq_name, RqstParms* _parms, bool _send_terminator=true, bool _flatten=false, bool _columnar=false);
                             ~Atl03Reader            (void);
 
         static void*        subsettingThread        (void* parm);
 
+        const PolygonIndex* getPolygonIndex         (MathLib::proj_t projection);
+
         double              calculateBackground     (int t, TrackState& state, Atl03Data& atl03);
         uint32_t            calculateSegmentId      (int t, TrackState& state, Atl03Data& atl03);
         bool                sendExtentRecord        (uint64_t extent_id, uint8_t track, TrackState& state, Atl03Data& atl03, stats_t* local_stats);
         bool                sendFlatRecord          (uint64_t extent_id, uint8_t track, TrackState& state, Atl03Data& atl03, stats_t* local_stats);
+        bool                sendColumnarRecord      (uint64_t extent_id, uint8_t track, TrackState& state, Atl03Data& atl03, Atl08Class& atl08, YapcScore& yapc, stats_t* local_stats);
+        void                populateAttributes      (extent_t* extent, uint64_t extent_id, uint8_t track, TrackState& state, Atl03Data& atl03);
         bool                sendAncillaryGeoRecords (uint64_t extent_id, RqstParms::string_list_t* field_list, MgDictionary<GTDArray*>* field_dict, TrackState& state, stats_t* local_stats);
         bool                sendAncillaryPhRecords  (uint64_t extent_id, RqstParms::string_list_t* field_list, MgDictionary<GTDArray*>* field_dict, TrackState& state, stats_t* local_stats);
         bool                postRecord              (RecordObject* record, stats_t* local_stats);
@@ -69,6 +69,7 @@
 
 #include <math.h>
 #include <float.h>
+#include <algorithm>
 
 #include "core.h"
 #include "icesat2.h"
@@ -127,6 +128,10 @@ const RecordObject::fieldDef_t Atl06Dispatch::atRecDef[] = {
     {"elevation",               RecordObject::USER,     offsetof(atl06_t, elevation),               0,  elRecType, NATIVE_FLAGS}
 };
 
+/* Scratch Memory */
+
+Thread::key_t Atl06Dispatch::scratchKey;
+
 /* Lua Functions */
 
 const char* Atl06Dispatch::LuaMetaName = "Atl06Dispatch";
@@ -140,7 +145,12 @@ const struct luaL_Reg Atl06Dispatch::LuaMetaTable[] = {
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * luaCreate - :atl06(<outq name>)
+ * luaCreate - :atl06(<outq name>, <parms>, [<num workers>], [<ordered>])
+ *
+ *  when the number of workers is zero, extents are fit on the threads of the
+ *  dispatcher calling processRecord; otherwise they are handed off to a pool
+ *  of workers, and when ordered is set, the elevations are posted in windows
+ *  of extents that are sorted by segment id
  *----------------------------------------------------------------------------*/
 int Atl06Dispatch::luaCreate (lua_State* L)
 {
@@ -150,9 +160,17 @@ int Atl06Dispatch::luaCreate (lua_State* L)
         /* Get Parameters */
         const char* outq_name = getLuaString(L, 1);
         parms = (RqstParms*)getLuaObject(L, 2, RqstParms::OBJECT_TYPE);
+        long num_workers = getLuaInteger(L, 3, true, 0);
+        bool ordered = getLuaBoolean(L, 4, true, false);
+
+        /* Check Number of Workers */
+        if(num_workers < 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid number of workers: %ld", num_workers);
+        }
 
         /* Create ATL06 Dispatch */
-        return createLuaObject(L, new Atl06Dispatch(L, outq_name, parms));
+        return createLuaObject(L, new Atl06Dispatch(L, outq_name, parms, num_workers, ordered));
     }
     catch(const RunTimeException& e)
     {
@@ -178,6 +196,19 @@ void Atl06Dispatch::init (void)
 
     RECDEF(atRecType,           atRecDef,           offsetof(atl06_t, elevation[1]),            NULL);
     RECDEF(atCompactRecType,    atCompactRecDef,    offsetof(atl06_compact_t, elevation[1]),    NULL);
+
+    scratchKey = Thread::createGlobal(freeScratch);
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *
+ *  threads free their own scratch memory when they exit; this frees the
+ *  calling thread's
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::deinit (void)
+{
+    freeThreadScratch();
 }
 
 /******************************************************************************
@@ -187,37 +218,60 @@ void Atl06Dispatch::init (void)
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-Atl06Dispatch::Atl06Dispatch (lua_State* L, const char* outq_name, RqstParms* _parms):
+Atl06Dispatch::Atl06Dispatch (lua_State* L, const char* outq_name, RqstParms* _parms, int num_workers, bool _ordered):
     DispatchObject(L, LuaMetaName, LuaMetaTable)
 {
     assert(outq_name);
     assert(_parms);
+    assert(num_workers >= 0);
 
     /* Initialize Parameters */
     parms = _parms;
 
-    /*
-     * Note: when allocating memory for this record, the full record size is used;
-     * this extends the memory available past the one elevation provided in the
-     * definition.
-     */
-    if(!parms->compact)
-    {
-        recObj = new RecordObject(atRecType, sizeof(atl06_t));
-        recData = (atl06_t*)recObj->getRecordData();
-    }
-    else
-    {
-        recObj = new RecordObject(atCompactRecType, sizeof(atl06_compact_t));
-        recCompactData = (atl06_compact_t*)recObj->getRecordData();
-    }
-
     /* Initialize Publisher */
     outQ = new Publisher(outq_name);
-    elevationIndex = 0;
+    initBatch(&sharedBatch);
 
     /* Initialize Statistics */
     LocalLib::set(&stats, 0, sizeof(stats));
+
+    /* Initialize Ordering */
+    ordered = _ordered && (num_workers > 0);
+    orderedResults = NULL;
+    nextOrdered = 0;
+    terminating = false;
+    if(ordered)
+    {
+        orderedResults = new ordered_t [MAX_IN_FLIGHT];
+        for(int i = 0; i < MAX_IN_FLIGHT; i++)
+        {
+            orderedResults[i].ready = false;
+        }
+    }
+
+    /* Start Workers */
+    submitted = 0;
+    retired = 0;
+    numWorkers = num_workers;
+    workers = NULL;
+    workPub = NULL;
+    workSub = NULL;
+    workerActive = numWorkers > 0;
+    if(workerActive)
+    {
+        workPub = new Publisher(NULL);
+        workSub = new Subscriber(*workPub);
+        workers = new worker_t [numWorkers];
+        for(int w = 0; w < numWorkers; w++)
+        {
+            workers[w].dispatch = this;
+            initBatch(&workers[w].batch);
+        }
+        for(int w = 0; w < numWorkers; w++)
+        {
+            workers[w].pid = new Thread(fitterThread, &workers[w]);
+        }
+    }
 }
 
 /*----------------------------------------------------------------------------
@@ -225,8 +279,35 @@ Atl06Dispatch::Atl06Dispatch (lua_State* L, const char* outq_name, RqstParms* _p
  *----------------------------------------------------------------------------*/
 Atl06Dispatch::~Atl06Dispatch(void)
 {
+    if(workers)
+    {
+        /* Stop Workers */
+        workerActive = false;
+        for(int w = 0; w < numWorkers; w++)
+        {
+            delete workers[w].pid;
+        }
+
+        /* Free Extents Never Fit */
+        fit_rqst_t rqst;
+        while(workSub->receiveCopy(&rqst, sizeof(fit_rqst_t), IO_CHECK) > 0)
+        {
+            delete rqst.extent;
+        }
+
+        /* Free Workers */
+        for(int w = 0; w < numWorkers; w++)
+        {
+            delete workers[w].batch.recObj;
+        }
+        delete [] workers;
+        delete workSub;
+        delete workPub;
+    }
+
+    delete [] orderedResults;
     delete outQ;
-    delete recObj;
+    delete sharedBatch.recObj;
     parms->releaseLuaObject();
 }
 
@@ -237,16 +318,55 @@ bool Atl06Dispatch::processRecord (RecordObject* record, okey_t key)
 {
     (void)key;
 
-    result_t result[RqstParms::NUM_PAIR_TRACKS];
-    Atl03Reader::extent_t* extent = (Atl03Reader::extent_t*)record->getRecordData();
-
     /* Bump Statistics */
     stats.h5atl03_rec_cnt++;
 
-    /* Execute Algorithm Stages */
-    initializationStage(extent, result); // allocates photons[]
-    if(parms->stages[RqstParms::STAGE_LSF]) iterativeFitStage(extent, result);
-    postResult(result); // deallocates memory
+    /* Fit Extent on this Thread */
+    if(!workerActive)
+    {
+        result_t result[RqstParms::NUM_PAIR_TRACKS];
+        fitExtent(record, result);
+        elevationMutex.lock();
+        {
+            postResult(result, &sharedBatch);
+        }
+        elevationMutex.unlock();
+        return true;
+    }
+
+    /* Wait for Room and Assign Sequence */
+    fit_rqst_t rqst;
+    inFlightCond.lock();
+    {
+        while((submitted - retired) >= MAX_IN_FLIGHT)
+        {
+            inFlightCond.wait(0, SYS_TIMEOUT);
+        }
+        rqst.sequence = submitted++;
+    }
+    inFlightCond.unlock();
+
+    /*
+     * Note: the record passed in references the dispatcher's message and
+     * is deleted when this call returns, so the extent is copied into a
+     * shared buffer that the worker's record takes over.
+     */
+    SharedBuffer* buffer = record->share();
+    rqst.extent = new RecordObject(buffer);
+    buffer->release();
+
+    /* Queue Extent to Workers */
+    int post_status;
+    while((post_status = workPub->postCopy(&rqst, sizeof(fit_rqst_t), SYS_TIMEOUT)) == MsgQ::STATE_TIMEOUT);
+    if(post_status <= 0)
+    {
+        /* Fit Here so Sequence is Still Delivered */
+        mlog(CRITICAL, "Failed to queue extent to ATL06 workers: %d", post_status);
+        result_t result[RqstParms::NUM_PAIR_TRACKS];
+        fitExtent(rqst.extent, result);
+        deliverResult(rqst.sequence, result, NULL);
+        delete rqst.extent;
+    }
 
     /* Return Status */
     return true;
@@ -267,18 +387,110 @@ bool Atl06Dispatch::processTimeout (void)
  *----------------------------------------------------------------------------*/
 bool Atl06Dispatch::processTermination (void)
 {
-    postResult(NULL);
+    if(workers)
+    {
+        /* Release Last Window of Ordered Results */
+        if(ordered)
+        {
+            terminating = true;
+            drainOrdered();
+        }
+
+        /* Wait for Queued Extents to be Fit */
+        inFlightCond.lock();
+        {
+            while(retired < submitted)
+            {
+                inFlightCond.wait(0, SYS_TIMEOUT);
+            }
+        }
+        inFlightCond.unlock();
+
+        /* Flush Workers */
+        for(int w = 0; w < numWorkers; w++)
+        {
+            postResult(NULL, &workers[w].batch);
+        }
+    }
+
+    /* Flush Dispatch */
+    elevationMutex.lock();
+    {
+        postResult(NULL, &sharedBatch);
+    }
+    elevationMutex.unlock();
+
     return true;
 }
 
+/*----------------------------------------------------------------------------
+ * fitterThread
+ *----------------------------------------------------------------------------*/
+void* Atl06Dispatch::fitterThread (void* parm)
+{
+    worker_t* worker = (worker_t*)parm;
+    Atl06Dispatch* dispatch = worker->dispatch;
+
+    while(dispatch->workerActive)
+    {
+        fit_rqst_t rqst;
+        int recv_status = dispatch->workSub->receiveCopy(&rqst, sizeof(fit_rqst_t), SYS_TIMEOUT);
+        if(recv_status > 0)
+        {
+            result_t result[RqstParms::NUM_PAIR_TRACKS];
+            dispatch->fitExtent(rqst.extent, result);
+            dispatch->deliverResult(rqst.sequence, result, &worker->batch);
+            delete rqst.extent;
+        }
+        else if(recv_status != MsgQ::STATE_TIMEOUT)
+        {
+            mlog(CRITICAL, "Failed to receive extent for ATL06 worker: %d", recv_status);
+            break;
+        }
+    }
+
+    /* Free Scratch Memory of this Thread */
+    freeThreadScratch();
+
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------
+ * fitExtent
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::fitExtent (RecordObject* record, result_t* result)
+{
+    /* Get Extent (either photon layout) */
+    Atl03Reader::photon_columns_t columns;
+    Atl03Reader::extent_t* extent = Atl03Reader::getExtent(record, &columns);
+    if(!extent)
+    {
+        mlog(ERROR, "Unable to fit record of type %s", record->getRecordType());
+        LocalLib::set(result, 0, sizeof(result_t) * RqstParms::NUM_PAIR_TRACKS);
+        return;
+    }
+
+    /* Execute Algorithm Stages */
+    initializationStage(extent, &columns, result); // photons[] point into this thread's scratch memory
+    if(parms->stages[RqstParms::STAGE_LSF]) iterativeFitStage(extent, &columns, result);
+}
+
 /*----------------------------------------------------------------------------
  * initializationStage
  *----------------------------------------------------------------------------*/
-void Atl06Dispatch::initializationStage (Atl03Reader::extent_t* extent, result_t* result)
+void Atl06Dispatch::initializationStage (Atl03Reader::extent_t* extent, Atl03Reader::photon_columns_t* columns, result_t* result)
 {
     /* Clear Results */
     LocalLib::set(result, 0, sizeof(result_t) * RqstParms::NUM_PAIR_TRACKS);
 
+    /* Get Scratch Memory for Photons */
+    int num_photons = 0;
+    for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
+    {
+        num_photons += extent->photon_count[t];
+    }
+    scratch_t* scratch = getScratch(num_photons);
+
     /* Initialize Results */
     int first_photon = 0;
     for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
@@ -294,10 +506,17 @@ void Atl06Dispatch::initializationStage (Atl03Reader::extent_t* extent, result_t
         result[t].elevation.photon_count = extent->photon_count[t];
         if(result[t].elevation.photon_count > 0)
         {
-            result[t].photons = new point_t[result[t].elevation.photon_count];
+            points_t* points = &result[t].photons;
+            points->p = &scratch->points.p[first_photon];
+            points->x = &scratch->points.x[first_photon];
+            points->y = &scratch->points.y[first_photon];
+            points->r = &scratch->points.r[first_photon];
+            points->s = &scratch->points.s[first_photon];
             for(int p = 0; p < result[t].elevation.photon_count; p++)
             {
-                result[t].photons[p].p = first_photon + p;  // extent->photons[]
+                points->p[p] = first_photon + p;  // index into extent's photon columns
+                points->x[p] = columns->distance[first_photon + p];
+                points->y[p] = columns->height[first_photon + p];
             }
             first_photon += result[t].elevation.photon_count;
         }
@@ -318,7 +537,7 @@ void Atl06Dispatch::initializationStage (Atl03Reader::extent_t* extent, result_t
  *  Note: Section 5.5 - Signal selection based on ATL03 flags
  *        Procedures 4b and after
  *----------------------------------------------------------------------------*/
-void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t* result)
+void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, Atl03Reader::photon_columns_t* columns, result_t* result)
 {
     /* Process Tracks */
     for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
@@ -347,35 +566,37 @@ void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t*
         double background_density   = pulses_in_extent * extent->background_rate[t] / (SPEED_OF_LIGHT / 2.0); // BG_density, section 5.7, procedure 1c
 
         /* Iterate Processing of Photons */
+        points_t* points = &result[t].photons;
         while(!done)
         {
             int num_photons = result[t].elevation.photon_count;
 
             /* Calculate Least Squares Fit */
-            lsf_t fit = lsf(extent, result[t].photons, num_photons, false);
+            lsf_t fit = lsf(columns, points, num_photons, false);
             result[t].elevation.h_mean = fit.height;
             result[t].elevation.along_track_slope = fit.slope;
             result[t].elevation.h_sigma = fit.y_sigma; // scaled by rms below
 
             /* Calculate Residuals */
+            double residual_min = DBL_MAX;
+            double residual_max = -DBL_MAX;
             for(int p = 0; p < num_photons; p++)
             {
-                double x = extent->photons[result[t].photons[p].p].distance;
-                double y = extent->photons[result[t].photons[p].p].height;
-                result[t].photons[p].r = y - (fit.height + (x * fit.slope));
+                double r = points->y[p] - (fit.height + (points->x[p] * fit.slope));
+                points->r[p] = r;
+                points->s[p] = r;
+                residual_min = MIN(residual_min, r);
+                residual_max = MAX(residual_max, r);
             }
 
-            /* Sort Points by Residuals */
-            quicksort(result[t].photons, 0, num_photons-1);
-
             /* Calculate Inputs to Robust Dispersion Estimate */
             double  background_count;       // N_BG
             double  window_lower_bound;     // zmin
             double  window_upper_bound;     // zmax;
             if(iteration == 0)
             {
-                window_lower_bound  = result[t].photons[0].r; // section 5.5, procedure 4c
-                window_upper_bound  = result[t].photons[num_photons - 1].r; // section 5.5, procedure 4c
+                window_lower_bound  = residual_min; // section 5.5, procedure 4c
+                window_upper_bound  = residual_max; // section 5.5, procedure 4c
                 background_count    = background_density * (window_upper_bound - window_lower_bound); // section 5.5, procedure 4b; pe_select_mod.f90 initial_select()
             }
             else
@@ -397,20 +618,58 @@ void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t*
             }
             else
             {
+                /*
+                 * The percentiles below are searched for in rank order of the residuals; rather
+                 * than sorting all of the residuals, only the ranks being searched are ordered
+                 * (see selectranks).  Since the potential percentile only grows with the
+                 * residual, the search can start past any rank that would continue the search
+                 * even at the smallest (or largest) residual.
+                 */
+                int32_t select_ranks = MAX(MIN_SELECT_RANKS, num_photons / 8);
+                double residual_i0 = 0.0;
+                double residual_i1 = 0.0;
+
                 /* Find Smallest Potential Percentiles (0) */
                 int32_t i0 = 0;
+                if(background_rate >= 0.0)
+                {
+                    double spp_min = (0.25 * signal_count) + ((residual_min - window_lower_bound) * background_rate);
+                    i0 = (int32_t)MAX(MIN(ceil(spp_min - 1.5) - 1.0, (double)num_photons), 0.0);
+                }
+                int32_t ordered_end = i0;
                 while(i0 < num_photons)
                 {
-                    double spp = (0.25 * signal_count) + ((result[t].photons[i0].r - window_lower_bound) * background_rate); // section 5.9, procedure 4a
+                    if(i0 >= ordered_end)
+                    {
+                        ordered_end = MIN(i0 + select_ranks, num_photons);
+                        selectranks(points->s, num_photons, i0, ordered_end);
+                        select_ranks *= 2;
+                    }
+                    residual_i0 = points->s[i0];
+                    double spp = (0.25 * signal_count) + ((residual_i0 - window_lower_bound) * background_rate); // section 5.9, procedure 4a
                     if( (((double)i0) + 1.0 - 0.5 + 1.0) < spp )    i0++;   // +1 adjusts for 0 vs 1 based indices, -.5 rounds, +1 looks ahead
                     else                                            break;
                 }
 
                 /* Find Smallest Potential Percentiles (1) */
+                select_ranks = MAX(MIN_SELECT_RANKS, num_photons / 8);
                 int32_t i1 = num_photons - 1;
+                if(background_rate >= 0.0)
+                {
+                    double spp_max = (0.75 * signal_count) + ((residual_max - window_lower_bound) * background_rate);
+                    i1 = (int32_t)MAX(MIN(floor(spp_max + 0.5) + 1.0, (double)(num_photons - 1)), -1.0);
+                }
+                int32_t ordered_start = i1 + 1;
                 while(i1 >= 0)
                 {
-                    double spp = (0.75 * signal_count) + ((result[t].photons[i1].r - window_lower_bound) * background_rate); // section 5.9, procedure 4a
+                    if(i1 < ordered_start)
+                    {
+                        ordered_start = MAX(i1 + 1 - select_ranks, 0);
+                        selectranks(points->s, num_photons, ordered_start, i1 + 1);
+                        select_ranks *= 2;
+                    }
+                    residual_i1 = points->s[i1];
+                    double spp = (0.75 * signal_count) + ((residual_i1 - window_lower_bound) * background_rate); // section 5.9, procedure 4a
                     if( (((double)i1) + 1.0 - 0.5 - 1.0) > spp )    i1--;   // +1 adjusts for 0 vs 1 based indices, -.5 rounds, +1 looks ahead
                     else                                            break;
                 }
@@ -425,13 +684,22 @@ void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t*
                     /* Find Spread of Central Values (1) */
                     double spp1 = (num_photons / 2.0) + (signal_count / 4.0); // section 5.9, procedure 5b
                     i1 = (int32_t)(spp1 + 0.5);
+
+                    /* Select Residuals at Central Values */
+                    if(i0 >= 0 && i1 < num_photons)
+                    {
+                        selectranks(points->s, num_photons, i0, i0 + 1);
+                        residual_i0 = points->s[i0];
+                        selectranks(points->s, num_photons, i1, i1 + 1);
+                        residual_i1 = points->s[i1];
+                    }
                 }
 
                 /* Check Validity of Percentiles */
                 if(i0 >= 0 && i1 < num_photons)
                 {
                     /* Calculate Robust Dispersion Estimate */
-                    sigma_r = (result[t].photons[i1].r - result[t].photons[i0].r) / RDE_SCALE_FACTOR; // section 5.9, procedure 6
+                    sigma_r = (residual_i1 - residual_i0) / RDE_SCALE_FACTOR; // section 5.9, procedure 6
                 }
                 else
                 {
@@ -458,10 +726,10 @@ void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t*
             double x_max = DBL_MIN;
             for(int p = 0; p < num_photons; p++)
             {
-                if(abs(result[t].photons[p].r) < window_spread)
+                if(fabs(points->r[p]) < window_spread)
                 {
                     next_num_photons++;
-                    double x = extent->photons[result[t].photons[p].p].distance;
+                    double x = points->x[p];
                     if(x < x_min) x_min = x;
                     if(x > x_max) x_max = x;
                 }
@@ -498,9 +766,13 @@ void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t*
                 int32_t ph_in = 0;
                 for(int p = 0; p < num_photons; p++)
                 {
-                    if(abs(result[t].photons[p].r) < window_spread)
+                    if(fabs(points->r[p]) < window_spread)
                     {
-                        result[t].photons[ph_in++] = result[t].photons[p];
+                        points->p[ph_in] = points->p[p];
+                        points->x[ph_in] = points->x[p];
+                        points->y[ph_in] = points->y[p];
+                        points->r[ph_in] = points->r[p];
+                        ph_in++;
                     }
                 }
                 result[t].elevation.photon_count = ph_in;
@@ -516,7 +788,7 @@ void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t*
         double delta_sum = 0.0;
         for(int p = 0; p < result[t].elevation.photon_count; p++)
         {
-            delta_sum += (result[t].photons[p].r * result[t].photons[p].r);
+            delta_sum += (points->r[p] * points->r[p]);
         }
 
         /* Calculate RMS and Scale h_sigma */
@@ -532,17 +804,141 @@ void Atl06Dispatch::iterativeFitStage (Atl03Reader::extent_t* extent, result_t*
         }
 
         /* Calculate Latitude, Longitude, and GPS Time using Least Squares Fit */
-        lsf_t fit = lsf(extent, result[t].photons, result[t].elevation.photon_count, true);
+        lsf_t fit = lsf(columns, points, result[t].elevation.photon_count, true);
         result[t].elevation.latitude = fit.latitude;
         result[t].elevation.longitude = fit.longitude;
         result[t].elevation.delta_time = fit.delta_time;
     }
 }
 
+/*----------------------------------------------------------------------------
+ * deliverResult
+ *
+ *  unordered results go into the worker's own batch (or the shared batch when
+ *  fit outside of a worker); ordered results are parked in their slot and
+ *  posted by whichever thread gets to drain the slots next
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::deliverResult (uint64_t sequence, result_t* result, batch_t* worker_batch)
+{
+    if(!ordered)
+    {
+        if(worker_batch)
+        {
+            postResult(result, worker_batch);
+        }
+        else
+        {
+            elevationMutex.lock();
+            {
+                postResult(result, &sharedBatch);
+            }
+            elevationMutex.unlock();
+        }
+        retire(1);
+    }
+    else
+    {
+        ordered_t* slot = &orderedResults[sequence % MAX_IN_FLIGHT];
+        LocalLib::copy(slot->result, result, sizeof(slot->result));
+        slot->ready = true;
+        drainOrdered();
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * drainOrdered
+ *
+ *  results are posted a window at a time once every extent in the window
+ *  has been fit, sorted by segment id (and extent id between tracks) since
+ *  the reader's threads interleave the extents of different tracks; a thread
+ *  that finds another already draining leaves its result behind, and the
+ *  drainer checks the next window again after letting go so that the result
+ *  is not stranded
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::drainOrdered (void)
+{
+    uint64_t next;
+    do
+    {
+        if(draining.test_and_set()) return;
+
+        int num_posted = 0;
+        int window_size;
+        while((window_size = readyWindow(nextOrdered)) > 0)
+        {
+            /* Sort Window by Segment */
+            for(int i = 0; i < window_size; i++)
+            {
+                windowOrder[i] = &orderedResults[(nextOrdered + i) % MAX_IN_FLIGHT];
+            }
+            std::sort(windowOrder, windowOrder + window_size, segmentOrder);
+
+            /* Post Window */
+            for(int i = 0; i < window_size; i++)
+            {
+                postResult(windowOrder[i]->result, &sharedBatch);
+                windowOrder[i]->ready = false;
+            }
+            nextOrdered += window_size;
+            num_posted += window_size;
+        }
+        next = nextOrdered;
+
+        draining.clear();
+        if(num_posted > 0) retire(num_posted);
+    } while(readyWindow(next) > 0);
+}
+
+/*----------------------------------------------------------------------------
+ * readyWindow
+ *
+ *  returns the number of results in the window starting at first when all of
+ *  them are ready, zero otherwise; once terminating, the window is cut short
+ *  at the last extent submitted
+ *----------------------------------------------------------------------------*/
+int Atl06Dispatch::readyWindow (uint64_t first)
+{
+    uint64_t last = first + ORDER_WINDOW;
+    if(terminating) last = MIN(last, submitted);
+
+    for(uint64_t sequence = first; sequence < last; sequence++)
+    {
+        if(!orderedResults[sequence % MAX_IN_FLIGHT].ready) return 0;
+    }
+
+    return (int)(last - first);
+}
+
+/*----------------------------------------------------------------------------
+ * segmentOrder
+ *----------------------------------------------------------------------------*/
+bool Atl06Dispatch::segmentOrder (const ordered_t* a, const ordered_t* b)
+{
+    const elevation_t* ea = &a->result[RqstParms::RPT_L].elevation;
+    const elevation_t* eb = &b->result[RqstParms::RPT_L].elevation;
+    if(ea->segment_id != eb->segment_id) return ea->segment_id < eb->segment_id;
+    return ea->extent_id < eb->extent_id;
+}
+
+/*----------------------------------------------------------------------------
+ * retire
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::retire (int num_extents)
+{
+    inFlightCond.lock();
+    {
+        retired += num_extents;
+        inFlightCond.signal();
+    }
+    inFlightCond.unlock();
+}
+
 /*----------------------------------------------------------------------------
  * postResult
+ *
+ *  caller must have exclusive access to the batch; a NULL result flushes it
  *----------------------------------------------------------------------------*/
-void Atl06Dispatch::postResult (result_t* result)
+void Atl06Dispatch::postResult (result_t* result, batch_t* batch)
 {
     for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
     {
@@ -560,62 +956,76 @@ void Atl06Dispatch::postResult (result_t* result)
             }
         }
 
-        /* Copy Elevation from Results into Buffer that's Posted */
-        elevationMutex.lock();
+        /* Populate Elevation */
+        if(elevation)
         {
-            /* Populate Elevation */
-            if(elevation)
+            if(!parms->compact)
             {
-                if(!parms->compact)
-                {
-                    recData->elevation[elevationIndex++] = *elevation;
-                }
-                else
-                {
-                    recCompactData->elevation[elevationIndex].delta_time = elevation->delta_time;
-                    recCompactData->elevation[elevationIndex].latitude = elevation->latitude;
-                    recCompactData->elevation[elevationIndex].longitude = elevation->longitude;
-                    recCompactData->elevation[elevationIndex].h_mean = elevation->h_mean;
-                    elevationIndex++;
-                }
+                batch->recData->elevation[batch->elevationIndex++] = *elevation;
             }
-
-            /* Check If ATL06 Record Should Be Posted*/
-            if((!result && elevationIndex > 0) || elevationIndex == BATCH_SIZE)
+            else
             {
-                /* Calculate Record Size (according to number of elevations) */
-                int size;
-                if(!parms->compact) size = elevationIndex * sizeof(elevation_t);
-                else                size = elevationIndex * sizeof(elevation_compact_t);
+                elevation_compact_t* compact = &batch->recCompactData->elevation[batch->elevationIndex++];
+                compact->delta_time = elevation->delta_time;
+                compact->latitude = elevation->latitude;
+                compact->longitude = elevation->longitude;
+                compact->h_mean = elevation->h_mean;
+            }
+        }
 
-                /* Serialize Record */
-                unsigned char* buffer;
-                int bufsize = recObj->serialize(&buffer, RecordObject::REFERENCE, size);
+        /* Check If ATL06 Record Should Be Posted*/
+        if((!result && batch->elevationIndex > 0) || batch->elevationIndex == BATCH_SIZE)
+        {
+            /* Calculate Record Size (according to number of elevations) */
+            int size;
+            if(!parms->compact) size = batch->elevationIndex * sizeof(elevation_t);
+            else                size = batch->elevationIndex * sizeof(elevation_compact_t);
 
-                /* Post Record */
-                if(outQ->postCopy(buffer, bufsize, SYS_TIMEOUT) > 0)
-                {
-                    stats.post_success_cnt += elevationIndex;
-                }
-                else
-                {
-                    stats.post_dropped_cnt += elevationIndex;
-                }
+            /* Serialize Record */
+            unsigned char* buffer;
+            int bufsize = batch->recObj->serialize(&buffer, RecordObject::REFERENCE, size);
 
-                /* Reset Elevation Index */
-                elevationIndex = 0;
+            /* Post Record */
+            if(outQ->postCopy(buffer, bufsize, SYS_TIMEOUT) > 0)
+            {
+                stats.post_success_cnt += batch->elevationIndex;
+            }
+            else
+            {
+                stats.post_dropped_cnt += batch->elevationIndex;
             }
-        }
-        elevationMutex.unlock();
 
-        /* Free Photons Array (allocated in initializationStage) */
-        if(result && result[t].photons)
-        {
-            delete [] result[t].photons;
+            /* Reset Elevation Index */
+            batch->elevationIndex = 0;
         }
     }
 }
 
+/*----------------------------------------------------------------------------
+ * initBatch
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::initBatch (batch_t* batch)
+{
+    /*
+     * Note: when allocating memory for this record, the full record size is used;
+     * this extends the memory available past the one elevation provided in the
+     * definition.
+     */
+    if(!parms->compact)
+    {
+        batch->recObj = new RecordObject(atRecType, sizeof(atl06_t));
+        batch->recData = (atl06_t*)batch->recObj->getRecordData();
+        batch->recCompactData = NULL;
+    }
+    else
+    {
+        batch->recObj = new RecordObject(atCompactRecType, sizeof(atl06_compact_t));
+        batch->recCompactData = (atl06_compact_t*)batch->recObj->getRecordData();
+        batch->recData = NULL;
+    }
+    batch->elevationIndex = 0;
+}
+
 /*----------------------------------------------------------------------------
  * luaStats
  *----------------------------------------------------------------------------*/
@@ -680,9 +1090,14 @@ int Atl06Dispatch::luaStats (lua_State* L)
  *
  *  y_sigma = sqrt((G^-g * G^-gT)[0,0]) # square root of first element (row 0, column 0) of covariance matrix
  *
+ *  Since G^-g * z expands to the sums over the photons of (G^-g row * hi), the
+ *  height and slope are calculated from sums accumulated in a single pass over
+ *  the photons; and since (G^-g * G^-gT) reduces to (G^T * G)^-1, y_sigma is
+ *  taken directly from it
+ *
  *  TODO: currently no protections against divide-by-zero
  *----------------------------------------------------------------------------*/
-Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::extent_t* extent, point_t* array, int size, bool final)
+Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::photon_columns_t* columns, points_t* points, int size, bool final)
 {
     lsf_t fit;
 
@@ -691,17 +1106,21 @@ Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::extent_t* extent, point_t*
     fit.slope = 0.0;
     fit.y_sigma = 0.0;
 
-    /* Calculate G^T*G and GT*h*/
+    /* Calculate G^T*G and G^T*h */
     double gtg_11 = size;
     double gtg_12_21 = 0.0;
     double gtg_22 = 0.0;
+    double gth_1 = 0.0;
+    double gth_2 = 0.0;
+    const double* x = points->x;
+    const double* h = points->y;
     for(int p = 0; p < size; p++)
     {
-        double x = extent->photons[array[p].p].distance;
-
         /* Perform Matrix Operation */
-        gtg_12_21 += x;
-        gtg_22 += x * x;
+        gtg_12_21 += x[p];
+        gtg_22 += x[p] * x[p];
+        gth_1 += h[p];
+        gth_2 += x[p] * h[p];
     }
 
     /* Calculate (G^T*G)^-1 */
@@ -712,27 +1131,12 @@ Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::extent_t* extent, point_t*
 
     if(!final) /* Height */
     {
-        /* Calculate G^-g and m */
-        for(int p = 0; p < size; p++)
-        {
-            Atl03Reader::photon_t* ph = &extent->photons[array[p].p];
-            double x = ph->distance;
-            double y = ph->height;
-
-            /* Perform Matrix Operation */
-            double gig_1 = igtg_11 + (igtg_12_21 * x);   // G^-g row 1 element
-            double gig_2 = igtg_12_21 + (igtg_22 * x);   // G^-g row 2 element
-
-            /* Calculate m */
-            fit.height += gig_1 * y;
-            fit.slope += gig_2 * y;
-
-            /* Accumulate y_sigma */
-            fit.y_sigma += gig_1 * gig_1;
-        }
+        /* Calculate m = (G^T*G)^-1 * G^T*h */
+        fit.height = (igtg_11 * gth_1) + (igtg_12_21 * gth_2);
+        fit.slope = (igtg_12_21 * gth_1) + (igtg_22 * gth_2);
 
         /* Calculate y_sigma */
-        fit.y_sigma = sqrt(fit.y_sigma);
+        fit.y_sigma = sqrt(igtg_11);
     }
     else /* Latitude, Longitude, GPS Time */
     {
@@ -746,7 +1150,7 @@ Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::extent_t* extent, point_t*
                     assumes that there isn't a set of photons with
                     longitudes that extend for more than 30 degrees */
             double shift_lon = false;
-            double first_lon = extent->photons[array[0].p].longitude;
+            double first_lon = columns->longitude[points->p[0]];
             if(first_lon < -150.0 || first_lon > 150.0)
             {
                 shift_lon = true;
@@ -755,11 +1159,10 @@ Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::extent_t* extent, point_t*
             /* Calculate G^-g and m */
             for(int p = 0; p < size; p++)
             {
-                Atl03Reader::photon_t* ph = &extent->photons[array[p].p];
-                double x = ph->distance;
-                double lat_y = ph->latitude;
-                double lon_y = ph->longitude;
-                double gps_y = ph->delta_time;
+                uint32_t ph = points->p[p];
+                double lat_y = columns->latitude[ph];
+                double lon_y = columns->longitude[ph];
+                double gps_y = columns->delta_time[ph];
 
                 /* Shift Longitudes */
                 if(shift_lon)
@@ -769,7 +1172,7 @@ Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::extent_t* extent, point_t*
                 }
 
                 /* Perform Matrix Operation */
-                double gig_1 = igtg_11 + (igtg_12_21 * x);   // G^-g row 1 element
+                double gig_1 = igtg_11 + (igtg_12_21 * x[p]);   // G^-g row 1 element
 
                 /* Calculate m */
                 fit.latitude += gig_1 * lat_y;
@@ -792,35 +1195,80 @@ Atl06Dispatch::lsf_t Atl06Dispatch::lsf (Atl03Reader::extent_t* extent, point_t*
 }
 
 /*----------------------------------------------------------------------------
- * quicksort
+ * getScratch
+ *
+ *  returns the calling thread's scratch memory with room for at least the
+ *  number of photons requested, creating or growing it as needed
  *----------------------------------------------------------------------------*/
-void Atl06Dispatch::quicksort(point_t* array, int start, int end)
+Atl06Dispatch::scratch_t* Atl06Dispatch::getScratch (int num_photons)
 {
-    if(start < end)
+    scratch_t* scratch = (scratch_t*)Thread::getGlobal(scratchKey);
+    if(!scratch)
+    {
+        scratch = new scratch_t;
+        LocalLib::set(scratch, 0, sizeof(scratch_t));
+        Thread::setGlobal(scratchKey, scratch);
+    }
+
+    if(scratch->capacity < num_photons)
     {
-        int partition = quicksortpartition(array, start, end);
-        quicksort(array, start, partition);
-        quicksort(array, partition + 1, end);
+        delete [] scratch->points.p;
+        delete [] scratch->points.x;
+        delete [] scratch->points.y;
+        delete [] scratch->points.r;
+        delete [] scratch->points.s;
+
+        scratch->capacity = MAX(num_photons, scratch->capacity * 2);
+        scratch->points.p = new uint32_t [scratch->capacity];
+        scratch->points.x = new double [scratch->capacity];
+        scratch->points.y = new double [scratch->capacity];
+        scratch->points.r = new double [scratch->capacity];
+        scratch->points.s = new double [scratch->capacity];
     }
+
+    return scratch;
 }
 
 /*----------------------------------------------------------------------------
- * quicksortpartition
+ * freeThreadScratch
+ *
+ *  frees the calling thread's scratch memory, if it has any
  *----------------------------------------------------------------------------*/
-int Atl06Dispatch::quicksortpartition(point_t* array, int start, int end)
+void Atl06Dispatch::freeThreadScratch (void)
 {
-    double pivot = array[(start + end) / 2].r;
-
-    start--;
-    end++;
-    while(true)
+    void* scratch = Thread::getGlobal(scratchKey);
+    if(scratch)
     {
-        while (array[++start].r < pivot);
-        while (array[--end].r > pivot);
-        if (start >= end) return end;
-
-        point_t tmp = array[start];
-        array[start] = array[end];
-        array[end] = tmp;
+        Thread::setGlobal(scratchKey, NULL);
+        freeScratch(scratch);
     }
 }
+
+/*----------------------------------------------------------------------------
+ * freeScratch
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::freeScratch (void* scratch)
+{
+    scratch_t* s = (scratch_t*)scratch;
+    delete [] s->points.p;
+    delete [] s->points.x;
+    delete [] s->points.y;
+    delete [] s->points.r;
+    delete [] s->points.s;
+    delete s;
+}
+
+/*----------------------------------------------------------------------------
+ * selectranks
+ *
+ *  reorders the array so that the elements from start up to (not including)
+ *  end are the ones that would be there if the whole array was sorted, and
+ *  are in sorted order; elements outside of that range are only partitioned
+ *  around it, which is linear in the size of the array
+ *----------------------------------------------------------------------------*/
+void Atl06Dispatch::selectranks (double* array, int size, int start, int end)
+{
+    if(start > 0)   std::nth_element(array, array + start, array + size);
+    if(end < size)  std::nth_element(array + start, array + end, array + size);
+    std::sort(array + start, array + end);
+}
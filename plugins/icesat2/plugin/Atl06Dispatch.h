@@ -68,6 +68,8 @@ class Atl06Dispatch: public DispatchObject
         static const double SIGMA_XMIT;
 
         static const int BATCH_SIZE = 256;
+        static const int MAX_IN_FLIGHT = 256; // extents queued to or being fit by workers
+        static const int ORDER_WINDOW = MAX_IN_FLIGHT / 2; // ordered results are sorted by segment a window at a time
 
         static const uint16_t PFLAG_SPREAD_TOO_SHORT        = 0x0001;   // RqstParm::ALONG_TRACK_SPREAD
         static const uint16_t PFLAG_TOO_FEW_PHOTONS         = 0x0002;   // RqstParm::MIN_PHOTON_COUNT
@@ -95,8 +97,8 @@ class Atl06Dispatch: public DispatchObject
         typedef struct {
             std::atomic<uint32_t>   h5atl03_rec_cnt;
             std::atomic<uint32_t>   filtered_cnt;
-            uint32_t                post_success_cnt;
-            uint32_t                post_dropped_cnt;
+            std::atomic<uint32_t>   post_success_cnt;
+            std::atomic<uint32_t>   post_dropped_cnt;
         } stats_t;
 
         /* Compact Elevation Measurement */
@@ -145,6 +147,7 @@ class Atl06Dispatch: public DispatchObject
 
         static int  luaCreate   (lua_State* L);
         static void init        (void);
+        static void deinit      (void);
 
     private:
 
@@ -161,53 +164,122 @@ class Atl06Dispatch: public DispatchObject
             double      delta_time;
         } lsf_t;
 
+        /* Photons of a Track (parallel arrays) */
         typedef struct {
-            uint32_t    p;  // index into photon array
-            double      r;  // residual
-        } point_t;
+            uint32_t*   p;  // index into photon array
+            double*     x;  // along track distance
+            double*     y;  // height
+            double*     r;  // residual
+            double*     s;  // residuals reordered when selecting percentiles
+        } points_t;
+
+        /* Scratch Memory (one per thread, reused across extents) */
+        typedef struct {
+            int         capacity;
+            points_t    points;
+        } scratch_t;
 
        /* Algorithm Result */
         typedef struct {
             bool        provided;
             elevation_t elevation;
-            point_t*    photons;
+            points_t    photons;
         } result_t;
 
+        /* Batch of Elevations (posted as a single record) */
+        typedef struct {
+            RecordObject*       recObj;
+            atl06_compact_t*    recCompactData;
+            atl06_t*            recData;
+            int                 elevationIndex;
+        } batch_t;
+
+        /* Extent Queued to Workers */
+        typedef struct {
+            RecordObject*       extent;     // copy of extent record, deleted by worker
+            uint64_t            sequence;   // order received
+        } fit_rqst_t;
+
+        /* Worker */
+        typedef struct {
+            Atl06Dispatch*      dispatch;
+            Thread*             pid;
+            batch_t             batch;      // only accessed by this worker until termination
+        } worker_t;
+
+        /* Results Waiting to be Posted in Order */
+        typedef struct {
+            std::atomic<bool>   ready;
+            result_t            result[RqstParms::NUM_PAIR_TRACKS];
+        } ordered_t;
+
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int MIN_SELECT_RANKS = 16; // smallest run of residuals ordered at a time when searching for percentiles
+
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
-        RecordObject*       recObj;
-        atl06_compact_t*    recCompactData;
-        atl06_t*            recData;
         Publisher*          outQ;
 
         Mutex               elevationMutex;
-        int                 elevationIndex;
+        batch_t             sharedBatch;    // fitting on dispatcher threads, or ordered output
+
+        bool                workerActive;
+        int                 numWorkers;
+        worker_t*           workers;
+        Publisher*          workPub;
+        Subscriber*         workSub;
+        Cond                inFlightCond;
+        uint64_t            submitted;      // extents queued to workers
+        uint64_t            retired;        // extents whose results have been posted
+
+        bool                ordered;        // post results in segment order
+        ordered_t*          orderedResults; // circular buffer of MAX_IN_FLIGHT slots
+        ordered_t*          windowOrder[ORDER_WINDOW]; // window of results being sorted, only accessed by drainer
+        uint64_t            nextOrdered;    // sequence of next result to post
+        std::atomic<bool>   terminating;    // last window may be short
+        std::atomic_flag    draining = ATOMIC_FLAG_INIT;
 
         RqstParms*          parms;
         stats_t             stats;
 
+        static Thread::key_t scratchKey;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
-                        Atl06Dispatch                   (lua_State* L, const char* outq_name, RqstParms* _parms);
+                        Atl06Dispatch                   (lua_State* L, const char* outq_name, RqstParms* _parms, int num_workers=0, bool _ordered=false);
                         ~Atl06Dispatch                  (void);
 
         bool            processRecord                   (RecordObject* record, okey_t key) override;
         bool            processTimeout                  (void) override;
         bool            processTermination              (void) override;
 
-        void            initializationStage             (Atl03Reader::extent_t* extent, result_t* result);
-        void            iterativeFitStage               (Atl03Reader::extent_t* extent, result_t* result);
-        void            postResult                      (result_t* result);
+        static void*    fitterThread                    (void* parm);
+
+        void            fitExtent                       (RecordObject* record, result_t* result);
+        void            initializationStage             (Atl03Reader::extent_t* extent, Atl03Reader::photon_columns_t* columns, result_t* result);
+        void            iterativeFitStage               (Atl03Reader::extent_t* extent, Atl03Reader::photon_columns_t* columns, result_t* result);
+        void            deliverResult                   (uint64_t sequence, result_t* result, batch_t* worker_batch);
+        void            drainOrdered                    (void);
+        int             readyWindow                     (uint64_t first);
+        static bool     segmentOrder                    (const ordered_t* a, const ordered_t* b);
+        void            retire                          (int num_extents);
+        void            postResult                      (result_t* result, batch_t* batch);
+        void            initBatch                       (batch_t* batch);
 
         static int      luaStats                        (lua_State* L);
 
-        static lsf_t    lsf                             (Atl03Reader::extent_t* extent, point_t* array, int size, bool final);
-        static void     quicksort                       (point_t* array, int start, int end);
-        static int      quicksortpartition              (point_t* array, int start, int end);
+        static scratch_t* getScratch                    (int num_photons);
+        static void     freeThreadScratch               (void);
+        static void     freeScratch                     (void* scratch);
+        static lsf_t    lsf                             (Atl03Reader::photon_columns_t* columns, points_t* points, int size, bool final);
+        static void     selectranks                     (double* array, int size, int start, int end);
 
         /* Unit Tests */
         friend class UT_Atl06Dispatch;
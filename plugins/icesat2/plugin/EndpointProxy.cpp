@@ -54,17 +54,61 @@ const struct luaL_Reg EndpointProxy::LuaMetaTable[] = {
     {NULL,          NULL}
 };
 
+Mutex EndpointProxy::poolMut;
+Dictionary<List<HttpClient*>*> EndpointProxy::connectionPool;
+int32_t EndpointProxy::createMetricId = EventLib::INVALID_METRIC;
+int32_t EndpointProxy::reuseMetricId = EventLib::INVALID_METRIC;
+
 /******************************************************************************
  * ATL06 PROXY CLASS
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * luaCreate - create(<endpoint>, <asset>, <resources>, <parameter string>, <timeout>, <outq_name>, <terminator>)
+ * init
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::init (void)
+{
+    createMetricId = EventLib::registerMetric(LuaMetaName, EventLib::COUNTER, "%s", "connections_created");
+    reuseMetricId = EventLib::registerMetric(LuaMetaName, EventLib::COUNTER, "%s", "connections_reused");
+}
+
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::deinit (void)
+{
+    poolMut.lock();
+    {
+        char** members = NULL;
+        int num_members = connectionPool.getKeys(&members);
+        for(int i = 0; i < num_members; i++)
+        {
+            List<HttpClient*>* clients = connectionPool.get(members[i]);
+            for(int j = 0; j < clients->length(); j++)
+            {
+                delete clients->get(j);
+            }
+            delete clients;
+            delete [] members[i];
+        }
+        if(members) delete [] members;
+        connectionPool.clear();
+    }
+    poolMut.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * luaCreate - create(<endpoint>, <asset>, <resources>, <parameter string>, <timeout>, <outq_name>, <terminator>, [<num threads>], [<queue depth>], [<nodes>])
+ *
+ *  when a table of node urls is supplied the resources are fanned out to those
+ *  nodes round robin instead of to nodes locked through the orchestrator
  *----------------------------------------------------------------------------*/
 int EndpointProxy::luaCreate (lua_State* L)
 {
     const char** _resources = NULL;
     int _num_resources = 0;
+    const char** _nodes = NULL;
+    int _num_nodes = 0;
 
     try
     {
@@ -105,26 +149,39 @@ int EndpointProxy::luaCreate (lua_State* L)
         long        _num_threads        = getLuaInteger(L, 8, true, LocalLib::nproc() * CPU_LOAD_FACTOR); // get number of proxy threads
         long        _rqst_queue_depth   = getLuaInteger(L, 9, true, DEFAULT_PROXY_QUEUE_DEPTH); // get depth of request queue for proxy threads
 
+        /* Get List of Nodes */
+        int nodes_parm_index = 10;
+        if(lua_istable(L, nodes_parm_index))
+        {
+            _num_nodes = lua_rawlen(L, nodes_parm_index);
+            if(_num_nodes > 0)
+            {
+                _nodes = new const char* [_num_nodes];
+                for(int i = 0; i < _num_nodes; i++)
+                {
+                    lua_rawgeti(L, nodes_parm_index, i+1);
+                    _nodes[i] = getLuaString(L, -1); // NOT allocated... must be used before constructor returns
+                    lua_pop(L, 1);
+                }
+            }
+        }
+
         /* Check Parameters */
         if(_num_threads <= 0) throw RunTimeException(CRITICAL, RTE_ERROR, "Number of threads must be greater than zero");
         else if (_num_threads > MAX_PROXY_THREADS) throw RunTimeException(CRITICAL, RTE_ERROR, "Number of threads must be less than %d", MAX_PROXY_THREADS);
 
         /* Return Endpoint Proxy Object */
-        EndpointProxy* ep = new EndpointProxy(L, _endpoint, _asset, _resources, _num_resources, _parameters, _timeout_secs, _outq_name, _send_terminator, _num_threads, _rqst_queue_depth);
+        EndpointProxy* ep = new EndpointProxy(L, _endpoint, _asset, _resources, _num_resources, _parameters, _timeout_secs, _outq_name, _send_terminator, _num_threads, _rqst_queue_depth, _nodes, _num_nodes);
         int retcnt = createLuaObject(L, ep);
         if(_resources) delete [] _resources;
+        if(_nodes) delete [] _nodes;
         return retcnt;
     }
     catch(const RunTimeException& e)
     {
         mlog(e.level(), "Error creating EndpointProxy: %s", e.what());
-
-        for(int i = 0; i < _num_resources; i++)
-        {
-            delete [] _resources[i];
-        }
-        if (_resources) delete [] _resources;
-
+        if(_resources) delete [] _resources;
+        if(_nodes) delete [] _nodes;
         return returnLuaStatus(L, false);
     }
 }
@@ -134,7 +191,7 @@ int EndpointProxy::luaCreate (lua_State* L)
  *----------------------------------------------------------------------------*/
 EndpointProxy::EndpointProxy (lua_State* L, const char* _endpoint, const char* _asset, const char** _resources, int _num_resources,
                               const char* _parameters, int _timeout_secs, const char* _outq_name, bool _send_terminator,
-                              int _num_threads, int _rqst_queue_depth):
+                              int _num_threads, int _rqst_queue_depth, const char** _nodes, int _num_nodes):
     LuaObject(L, OBJECT_TYPE, LuaMetaName, LuaMetaTable)
 {
     assert(_asset);
@@ -150,19 +207,13 @@ EndpointProxy::EndpointProxy (lua_State* L, const char* _endpoint, const char* _
 
     /* Completion Condition */
     numResourcesComplete = 0;
+    numResourcesDispatched = 0;
+    numDurations = 0;
+    totalDuration = 0.0;
 
     /* Proxy Active */
     active = true;
 
-    /* Create Proxy Threads */
-    rqstPub = new Publisher(NULL, NULL, rqstQDepth);
-    rqstSub = new Subscriber(*rqstPub);
-    proxyPids = new Thread* [numProxyThreads];
-    for(int t = 0; t < numProxyThreads; t++)
-    {
-        proxyPids[t] = new Thread(proxyThread, this);
-    }
-
     /* Allocate Data Members */
     endpoint    = StringLib::duplicate(_endpoint);
     asset       = StringLib::duplicate(_asset);
@@ -176,9 +227,31 @@ EndpointProxy::EndpointProxy (lua_State* L, const char* _endpoint, const char* _
         resources[i] = StringLib::duplicate(_resources[i]);
     }
 
-    /* Initialize Nodes Array */
-    nodes = new OrchestratorLib::Node* [numResources];
-    LocalLib::set(nodes, 0, sizeof(OrchestratorLib::Node*)); // set all to NULL
+    /* Initialize Resource States */
+    states = new resource_state_t [numResources];
+    LocalLib::set(states, 0, numResources * sizeof(resource_state_t));
+
+    /* Populate Static Nodes Array */
+    numStaticNodes = _num_nodes;
+    nextStaticNode = 0;
+    staticNodes = NULL;
+    if(numStaticNodes > 0)
+    {
+        staticNodes = new const char* [numStaticNodes];
+        for(int i = 0; i < numStaticNodes; i++)
+        {
+            staticNodes[i] = StringLib::duplicate(_nodes[i]);
+        }
+    }
+
+    /* Create Proxy Threads */
+    rqstPub = new Publisher(NULL, NULL, rqstQDepth);
+    rqstSub = new Subscriber(*rqstPub);
+    proxyPids = new Thread* [numProxyThreads];
+    for(int t = 0; t < numProxyThreads; t++)
+    {
+        proxyPids[t] = new Thread(proxyThread, this);
+    }
 
     /* Start Collator Thread */
     collatorPid = new Thread(collatorThread, this);
@@ -189,8 +262,18 @@ EndpointProxy::EndpointProxy (lua_State* L, const char* _endpoint, const char* _
  *----------------------------------------------------------------------------*/
 EndpointProxy::~EndpointProxy (void)
 {
-    /* Join and Delete Threads */
+    /* Stop Attempts in Flight */
     active = false;
+    completion.lock();
+    {
+        for(int i = 0; i < numResources; i++)
+        {
+            abortAttempts(i);
+        }
+    }
+    completion.unlock();
+
+    /* Join and Delete Threads */
     for(int i = 0; i < numProxyThreads; i++)
     {
         delete proxyPids[i];
@@ -198,6 +281,14 @@ EndpointProxy::~EndpointProxy (void)
     delete [] proxyPids;
     delete collatorPid;
 
+    /* Release Nodes of Requests Never Made */
+    rqst_t rqst;
+    while(rqstSub->receiveCopy(&rqst, sizeof(rqst), IO_CHECK) > 0)
+    {
+        unlockNode(rqst.node);
+        delete rqst.node;
+    }
+
     /* Delete Queues */
     delete rqstPub;
     delete rqstSub;
@@ -209,13 +300,14 @@ EndpointProxy::~EndpointProxy (void)
         delete [] resources[i];
     }
     delete [] resources;
+    delete [] states;
 
-    /* Delete Nodes */
-    for(int i = 0; i < numResources; i++)
+    /* Delete Static Nodes */
+    for(int i = 0; i < numStaticNodes; i++)
     {
-        if(nodes[i]) delete nodes[i];
+        delete [] staticNodes[i];
     }
-    delete [] nodes;
+    if(staticNodes) delete [] staticNodes;
 
     /* Delete Allocated Memory */
     delete [] endpoint;
@@ -236,19 +328,22 @@ void* EndpointProxy::collatorThread (void* parm)
         /* Get Available Nodes */
         int resources_to_process = proxy->numResources - current_resource;
         int num_nodes_to_request = MIN(resources_to_process, proxy->numProxyThreads);
-        OrchestratorLib::NodeList* nodes = OrchestratorLib::lock(SERVICE, num_nodes_to_request, proxy->timeout);
+        OrchestratorLib::NodeList* nodes = proxy->lockNodes(num_nodes_to_request);
         if(nodes)
         {
             for(int i = 0; i < nodes->length(); i++)
             {
                 /* Populate Request */
-                proxy->nodes[current_resource] = nodes->get(i);
+                rqst_t rqst = {
+                    .resource = current_resource,
+                    .node = nodes->get(i)
+                };
 
                 /* Post Request to Proxy Threads */
                 int status = MsgQ::STATE_TIMEOUT;
                 while(proxy->active && (status == MsgQ::STATE_TIMEOUT))
                 {
-                    status = proxy->rqstPub->postCopy(&current_resource, sizeof(current_resource), SYS_TIMEOUT);
+                    status = proxy->rqstPub->postCopy(&rqst, sizeof(rqst), SYS_TIMEOUT);
                     if(status < 0)
                     {
                         LuaEndpoint::generateExceptionStatus(RTE_ERROR, ERROR, proxy->outQ, NULL, "Failed (%d) to post request for %s", status, proxy->resources[current_resource]);
@@ -256,6 +351,14 @@ void* EndpointProxy::collatorThread (void* parm)
                     }
                 }
 
+                /* Release Node of Request Not Posted */
+                if(status <= 0)
+                {
+                    proxy->unlockNode(rqst.node);
+                    delete rqst.node;
+                    if(status < 0) proxy->completeResource(current_resource, false);
+                }
+
                 /* Bump Current Resource */
                 current_resource++;
             }
@@ -274,17 +377,29 @@ void* EndpointProxy::collatorThread (void* parm)
             mlog(CRITICAL, "Unable to reach orchestrator... abandoning proxy request!");
             proxy->active = false;
         }
+
+        /* Check Attempts in Flight */
+        proxy->numResourcesDispatched = current_resource;
+        proxy->checkStragglers();
     }
 
-    /* Check if All Resources Completed */
-    proxy->completion.lock();
+    /* Wait for All Resources to Complete */
+    bool complete = false;
+    while(proxy->active && !complete)
     {
-        while(proxy->active && (proxy->numResourcesComplete < proxy->numResources))
+        proxy->completion.lock();
         {
-            proxy->completion.wait(0, SYS_TIMEOUT);
+            if(proxy->numResourcesComplete < proxy->numResources)
+            {
+                proxy->completion.wait(0, COLLATOR_POLL_RATE);
+            }
+            complete = (proxy->numResourcesComplete >= proxy->numResources);
         }
+        proxy->completion.unlock();
+
+        /* Check Attempts in Flight */
+        if(!complete) proxy->checkStragglers();
     }
-    proxy->completion.unlock();
 
     /* Send Terminator */
     if(proxy->sendTerminator)
@@ -308,60 +423,591 @@ void* EndpointProxy::proxyThread (void* parm)
     while(proxy->active)
     {
         /* Receive Request */
-        int current_resource;
-        int recv_status = proxy->rqstSub->receiveCopy(&current_resource, sizeof(current_resource), SYS_TIMEOUT);
+        rqst_t rqst;
+        int recv_status = proxy->rqstSub->receiveCopy(&rqst, sizeof(rqst), SYS_TIMEOUT);
         if(recv_status > 0)
         {
-            /* Get Resource and Node */
-            const char* resource = proxy->resources[current_resource];
-            OrchestratorLib::Node* node = proxy->nodes[current_resource];
-            bool valid = false; // set to true on success
+            OrchestratorLib::Node* node = rqst.node;
+            int retries = 0;
+            int backoff = RETRY_BACKOFF;
 
             /* Make Request */
-            if(proxy->outQ->getSubCnt() > 0)
+            attempt_status_t status = proxy->makeAttempt(rqst.resource, node);
+
+            /* Retry Failed Request on Another Node */
+            while((status == FAILED) && (retries < MAX_RETRIES) && proxy->active && (proxy->outQ->getSubCnt() > 0))
             {
-                try
+                LocalLib::sleep(backoff / 1000.0);
+                backoff = MIN(backoff * 2, MAX_RETRY_BACKOFF);
+
+                /* Lock Next Node */
+                OrchestratorLib::Node* next_node = NULL;
+                double start = TimeLib::latchtime();
+                while(!next_node && proxy->active && ((proxy->timeout <= 0) || ((TimeLib::latchtime() - start) < proxy->timeout)))
                 {
-                    SafeString path("/source/%s", proxy->endpoint);
-                    SafeString data("{\"atl03-asset\": \"%s\", \"resource\": \"%s\", \"parms\": %s, \"timeout\": %d}", proxy->asset, resource, proxy->parameters, proxy->timeout);
-                    HttpClient client(NULL, node->member);
-                    HttpClient::rsps_t rsps = client.request(EndpointObject::POST, path.getString(), data.getString(), false, proxy->outQ, proxy->timeout * 1000);
-                    if(rsps.code == EndpointObject::OK) valid = true;
-                    else throw RunTimeException(CRITICAL, RTE_ERROR, "Error code returned from request to %s: %d", node->member, (int)rsps.code);
+                    next_node = proxy->lockNode(node->member);
+                    if(!next_node) LocalLib::sleep(0.20); // 5Hz
                 }
-                catch(const RunTimeException& e)
+                if(!next_node) break;
+
+                /* Make Next Attempt */
+                retries++;
+                mlog(WARNING, "Retrying request for %s on %s after failure on %s (retry %d of %d)", proxy->resources[rqst.resource], next_node->member, node->member, retries, MAX_RETRIES);
+                delete node;
+                node = next_node;
+                status = proxy->makeAttempt(rqst.resource, node);
+            }
+            delete node;
+
+            /* Give Up on Resource
+             *  (unless an attempt started by a hedge is still in flight) */
+            if((status == FAILED) || (status == REJECTED))
+            {
+                bool abandoned = false;
+                proxy->completion.lock();
                 {
-                    mlog(e.level(), "Failure processing request: %s", e.what());
+                    resource_state_t* state = &proxy->states[rqst.resource];
+                    if(!state->complete && (state->in_flight == 0))
+                    {
+                        state->complete = true;
+                        abandoned = true;
+                    }
                 }
+                proxy->completion.unlock();
+                if(abandoned) proxy->completeResource(rqst.resource, false);
             }
+        }
+        else if(recv_status != MsgQ::STATE_TIMEOUT)
+        {
+            mlog(CRITICAL, "Failed (%d) to receive request... abandoning proxy request", recv_status);
+            break;
+        }
+    }
 
-            /* Unlock Node */
-            OrchestratorLib::unlock(&node->transaction, 1);
+    return NULL;
+}
 
-            /* Resource Completed */
-            proxy->completion.lock();
+/*----------------------------------------------------------------------------
+ * forwarderThread
+ *
+ *  forwards the response of an attempt to the output queue as it arrives;
+ *  the first message claims the resource, and an attempt that fails to claim
+ *  it drops its messages until the request ends
+ *----------------------------------------------------------------------------*/
+void* EndpointProxy::forwarderThread (void* parm)
+{
+    forwarder_t* forwarder = (forwarder_t*)parm;
+    EndpointProxy* proxy = forwarder->proxy;
+
+    while(true)
+    {
+        Subscriber::msgRef_t ref;
+        int recv_status = forwarder->staged->receiveRef(ref, SYS_TIMEOUT);
+        if(recv_status > 0)
+        {
+            /* Check for Terminator */
+            if(ref.size == 0)
             {
-                proxy->numResourcesComplete++;
-                if(proxy->numResourcesComplete >= proxy->numResources)
+                forwarder->staged->dereference(ref);
+                break;
+            }
+
+            /* Claim Resource */
+            if(!forwarder->claimed && !forwarder->dropping)
+            {
+                forwarder->claimed = proxy->claimResource(forwarder->resource, forwarder->attempt);
+                forwarder->dropping = !forwarder->claimed;
+            }
+
+            /* Forward Message */
+            if(!forwarder->dropping)
+            {
+                int post_status = MsgQ::STATE_TIMEOUT;
+                while(proxy->active && (post_status == MsgQ::STATE_TIMEOUT))
+                {
+                    post_status = proxy->outQ->postCopy(ref.data, ref.size, SYS_TIMEOUT);
+                }
+
+                if(post_status <= 0)
                 {
-                    proxy->completion.signal();
+                    mlog(CRITICAL, "Failed (%d) to forward response for %s", post_status, proxy->resources[forwarder->resource]);
+                    forwarder->dropping = true;
+                    forwarder->forwarded = false;
+                    proxy->completion.lock();
+                    {
+                        forwarder->attempt->aborted = true;
+                        forwarder->attempt->client->abort();
+                    }
+                    proxy->completion.unlock();
                 }
             }
-            proxy->completion.unlock();
 
-            /* Post Status */
-            int code = valid ? RTE_INFO : RTE_ERROR;
-            event_level_t level = valid ? INFO : ERROR;
-            LuaEndpoint::generateExceptionStatus(code, level, proxy->outQ, NULL, "%s processing resource [%d out of %d]: %s",
-                                                    valid ? "Successfully completed" : "Failed to complete",
-                                                    current_resource + 1, proxy->numResources, resource);
+            forwarder->staged->dereference(ref);
         }
         else if(recv_status != MsgQ::STATE_TIMEOUT)
         {
-            mlog(CRITICAL, "Failed (%d) to receive request... abandoning proxy request", recv_status);
+            mlog(CRITICAL, "Failed (%d) to receive response for %s", recv_status, proxy->resources[forwarder->resource]);
+            forwarder->forwarded = false;
+            break;
+        }
+        else if(forwarder->ended)
+        {
+            break;
+        }
+        else if(!proxy->active)
+        {
+            forwarder->forwarded = false;
             break;
         }
     }
 
     return NULL;
 }
+
+/*----------------------------------------------------------------------------
+ * lockNodes
+ *
+ *  static nodes are handed out round robin and are not locked
+ *----------------------------------------------------------------------------*/
+OrchestratorLib::NodeList* EndpointProxy::lockNodes (int num_nodes)
+{
+    if(numStaticNodes <= 0)
+    {
+        return OrchestratorLib::lock(SERVICE, num_nodes, timeout);
+    }
+
+    OrchestratorLib::NodeList* nodes = new OrchestratorLib::NodeList;
+    completion.lock();
+    {
+        for(int i = 0; i < num_nodes; i++)
+        {
+            OrchestratorLib::Node* node = new OrchestratorLib::Node(staticNodes[nextStaticNode], 0);
+            nodes->add(node);
+            nextStaticNode = (nextStaticNode + 1) % numStaticNodes;
+        }
+    }
+    completion.unlock();
+
+    return nodes;
+}
+
+/*----------------------------------------------------------------------------
+ * lockNode
+ *
+ *  locks two nodes so that one other than the node to avoid can be chosen,
+ *  falling back to the node to avoid when it is the only one available;
+ *  returns NULL if no node is available
+ *----------------------------------------------------------------------------*/
+OrchestratorLib::Node* EndpointProxy::lockNode (const char* avoid)
+{
+    OrchestratorLib::Node* node = NULL;
+
+    OrchestratorLib::NodeList* nodes = lockNodes(2);
+    if(nodes)
+    {
+        /* Choose Node */
+        for(int i = 0; i < nodes->length() && !node; i++)
+        {
+            if(!StringLib::match(nodes->get(i)->member, avoid))
+            {
+                node = nodes->get(i);
+            }
+        }
+        if(!node && nodes->length() > 0)
+        {
+            node = nodes->get(0);
+        }
+
+        /* Release Other Nodes */
+        for(int i = 0; i < nodes->length(); i++)
+        {
+            OrchestratorLib::Node* other = nodes->get(i);
+            if(other != node)
+            {
+                unlockNode(other);
+                delete other;
+            }
+        }
+        delete nodes;
+    }
+
+    return node;
+}
+
+/*----------------------------------------------------------------------------
+ * unlockNode
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::unlockNode (OrchestratorLib::Node* node)
+{
+    if(numStaticNodes <= 0)
+    {
+        OrchestratorLib::unlock(&node->transaction, 1);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * makeAttempt
+ *
+ *  the response is streamed to the output queue by a forwarder thread as it
+ *  arrives; the first attempt to forward a message claims the resource, after
+ *  which no other attempt is retried or hedged, since part of the response has
+ *  already gone out; an attempt that fails before forwarding anything can be
+ *  retried, unless the node rejected the request with a client error
+ *----------------------------------------------------------------------------*/
+EndpointProxy::attempt_status_t EndpointProxy::makeAttempt (int resource, OrchestratorLib::Node* node)
+{
+    resource_state_t* state = &states[resource];
+    attempt_t* attempt = NULL;
+    attempt_status_t status = FAILED;
+    EndpointObject::code_t code = EndpointObject::Service_Unavailable;
+
+    /* Check Output Queue */
+    if(outQ->getSubCnt() <= 0)
+    {
+        unlockNode(node);
+        return FAILED;
+    }
+
+    /* Register Attempt */
+    HttpClient* client = checkoutConnection(node->member);
+    completion.lock();
+    {
+        for(int i = 0; i < MAX_ATTEMPTS_IN_FLIGHT && active && !state->complete && !state->claimant; i++)
+        {
+            if(!state->attempts[i].client)
+            {
+                attempt = &state->attempts[i];
+                attempt->client = client;
+                attempt->member = node->member;
+                attempt->start = TimeLib::latchtime();
+                attempt->aborted = false;
+                state->in_flight++;
+                break;
+            }
+        }
+    }
+    completion.unlock();
+
+    /* Check if Resource No Longer Needs an Attempt */
+    if(!attempt)
+    {
+        returnConnection(node->member, client);
+        unlockNode(node);
+        return DISCARDED;
+    }
+
+    /* Start Forwarder */
+    Publisher staging(NULL, Publisher::defaultFree, STAGING_QUEUE_DEPTH);
+    Subscriber staged(staging);
+    forwarder_t forwarder = {
+        .proxy = this,
+        .resource = resource,
+        .attempt = attempt,
+        .staged = &staged,
+        .claimed = false,
+        .dropping = false,
+        .forwarded = true,
+        .ended = false
+    };
+    Thread* forwarder_pid = new Thread(forwarderThread, &forwarder);
+
+    /* Make Request */
+    try
+    {
+        SafeString path("/source/%s", endpoint);
+        SafeString data("{\"atl03-asset\": \"%s\", \"resource\": \"%s\", \"parms\": %s, \"timeout\": %d}", asset, resources[resource], parameters, timeout);
+        HttpClient::rsps_t rsps = client->request(EndpointObject::POST, path.getString(), data.getString(), true, &staging, SYS_TIMEOUT);
+        code = rsps.code;
+        if(rsps.response) delete [] rsps.response; // only a response without chunks is returned
+        if(code != EndpointObject::OK) throw RunTimeException(CRITICAL, RTE_ERROR, "Error code returned from request to %s: %d", node->member, (int)code);
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Failure processing request: %s", e.what());
+    }
+
+    /* Unlock Node */
+    unlockNode(node);
+
+    /* Stop Forwarder
+     *  (if the terminator does not fit, the forwarder stops once the queue drains) */
+    forwarder.ended = true;
+    staging.postCopy("", 0, SYS_TIMEOUT);
+    delete forwarder_pid;
+
+    /* Resolve Attempt */
+    bool valid = (code == EndpointObject::OK) && forwarder.forwarded;
+    bool rejected = (code >= 400) && (code < 500) && (code != EndpointObject::Request_Timeout);
+    completion.lock();
+    {
+        double duration = TimeLib::latchtime() - attempt->start;
+        if(attempt->aborted) valid = false;
+        bool claimed = (state->claimant == attempt);
+        attempt->client = NULL;
+        attempt->member = NULL;
+        attempt->aborted = false;
+        state->in_flight--;
+
+        if(claimed)
+        {
+            /* Claimant Completes Resource */
+            state->claimant = NULL;
+            state->complete = true;
+            status = valid ? SUCCEEDED : ABANDONED;
+        }
+        else if(state->complete || state->claimant)
+        {
+            status = DISCARDED;
+        }
+        else if(valid)
+        {
+            /* Empty Response Claims Resource */
+            state->complete = true;
+            abortAttempts(resource);
+            status = SUCCEEDED;
+        }
+        else if(state->in_flight > 0)
+        {
+            status = DISCARDED;
+        }
+        else if(rejected)
+        {
+            status = REJECTED;
+        }
+
+        if(status == SUCCEEDED)
+        {
+            totalDuration += duration;
+            numDurations++;
+        }
+    }
+    completion.unlock();
+
+    /* Pool Connection Only After a Complete Response */
+    if(valid) returnConnection(node->member, client);
+    else delete client;
+
+    /* Complete Resource */
+    if((status == SUCCEEDED) || (status == ABANDONED))
+    {
+        completeResource(resource, status == SUCCEEDED);
+    }
+
+    return status;
+}
+
+/*----------------------------------------------------------------------------
+ * claimResource
+ *
+ *  the attempt is aborted if another attempt already claimed the resource
+ *----------------------------------------------------------------------------*/
+bool EndpointProxy::claimResource (int resource, attempt_t* attempt)
+{
+    bool claimed = false;
+
+    completion.lock();
+    {
+        resource_state_t* state = &states[resource];
+        if(!state->complete && !state->claimant && !attempt->aborted)
+        {
+            state->claimant = attempt;
+            abortAttempts(resource, attempt);
+            claimed = true;
+        }
+        else if(!attempt->aborted)
+        {
+            attempt->aborted = true;
+            attempt->client->abort();
+        }
+    }
+    completion.unlock();
+
+    return claimed;
+}
+
+/*----------------------------------------------------------------------------
+ * completeResource
+ *
+ *  the status is posted before the resource is counted so that it cannot
+ *  fall behind the terminator posted by the collator
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::completeResource (int resource, bool valid)
+{
+    /* Post Status */
+    int code = valid ? RTE_INFO : RTE_ERROR;
+    event_level_t level = valid ? INFO : ERROR;
+    LuaEndpoint::generateExceptionStatus(code, level, outQ, NULL, "%s processing resource [%d out of %d]: %s",
+                                            valid ? "Successfully completed" : "Failed to complete",
+                                            resource + 1, numResources, resources[resource]);
+
+    /* Resource Completed */
+    completion.lock();
+    {
+        numResourcesComplete++;
+        if(numResourcesComplete >= numResources)
+        {
+            completion.signal();
+        }
+    }
+    completion.unlock();
+}
+
+/*----------------------------------------------------------------------------
+ * checkStragglers
+ *
+ *  aborts attempts that run past the node timeout so they can be retried, and
+ *  once every resource has been handed out and enough proxy threads are idle,
+ *  hedges an attempt that has run well past the mean resource duration by
+ *  making the same request to another node; the first to finish is used
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::checkStragglers (void)
+{
+    List<int> hedged_resources;
+    List<const char*> hedged_members;
+
+    completion.lock();
+    {
+        double now = TimeLib::latchtime();
+        int outstanding = numResources - numResourcesComplete;
+        bool hedging = (numResourcesDispatched >= numResources) && (numDurations > 0) && ((outstanding * MAX_ATTEMPTS_IN_FLIGHT) <= numProxyThreads);
+        double hedge_delay = hedging ? MAX(MIN_HEDGE_DELAY, HEDGE_FACTOR * (totalDuration / numDurations)) : 0.0;
+
+        for(int r = 0; r < numResourcesDispatched; r++)
+        {
+            resource_state_t* state = &states[r];
+            if(state->complete || (state->in_flight == 0)) continue;
+
+            for(int i = 0; i < MAX_ATTEMPTS_IN_FLIGHT; i++)
+            {
+                attempt_t* attempt = &state->attempts[i];
+                if(!attempt->client || attempt->aborted) continue;
+
+                double elapsed = now - attempt->start;
+                if((timeout > 0) && (elapsed > timeout))
+                {
+                    mlog(WARNING, "Aborting request for %s to %s after %d seconds", resources[r], attempt->member, timeout);
+                    attempt->aborted = true;
+                    attempt->client->abort();
+                }
+                else if(hedging && !state->hedged && !state->claimant && (state->in_flight == 1) && (elapsed > hedge_delay))
+                {
+                    state->hedged = true;
+                    hedged_resources.add(r);
+                    hedged_members.add(StringLib::duplicate(attempt->member));
+                }
+            }
+        }
+    }
+    completion.unlock();
+
+    /* Hedge Stragglers */
+    for(int i = 0; i < hedged_resources.length(); i++)
+    {
+        int resource = hedged_resources.get(i);
+        const char* member = hedged_members.get(i);
+        OrchestratorLib::Node* node = lockNode(member);
+        if(node && !StringLib::match(node->member, member))
+        {
+            mlog(INFO, "Hedging request for %s running on %s with request to %s", resources[resource], member, node->member);
+            rqst_t rqst = {
+                .resource = resource,
+                .node = node
+            };
+            if(rqstPub->postCopy(&rqst, sizeof(rqst), SYS_TIMEOUT) <= 0)
+            {
+                unlockNode(node);
+                delete node;
+            }
+        }
+        else if(node)
+        {
+            unlockNode(node);
+            delete node;
+        }
+        delete [] member;
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * abortAttempts
+ *
+ *  must be called with completion locked
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::abortAttempts (int resource, attempt_t* except)
+{
+    resource_state_t* state = &states[resource];
+    for(int i = 0; i < MAX_ATTEMPTS_IN_FLIGHT; i++)
+    {
+        attempt_t* attempt = &state->attempts[i];
+        if((attempt != except) && attempt->client && !attempt->aborted)
+        {
+            attempt->aborted = true;
+            attempt->client->abort();
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * checkoutConnection
+ *
+ *  hands out an idle keep-alive connection to the node when one is pooled,
+ *  otherwise a new connection; connections closed by the node while they
+ *  sat in the pool are dropped
+ *----------------------------------------------------------------------------*/
+HttpClient* EndpointProxy::checkoutConnection (const char* member)
+{
+    HttpClient* client = NULL;
+
+    poolMut.lock();
+    {
+        List<HttpClient*>* clients = NULL;
+        if(connectionPool.find(member, &clients))
+        {
+            while(!client && (clients->length() > 0))
+            {
+                int last = clients->length() - 1;
+                HttpClient* pooled = clients->get(last);
+                clients->remove(last);
+                if(pooled->isConnected()) client = pooled;
+                else delete pooled;
+            }
+        }
+    }
+    poolMut.unlock();
+
+    if(client)
+    {
+        EventLib::incrementMetric(reuseMetricId);
+    }
+    else
+    {
+        client = new HttpClient(NULL, member);
+        EventLib::incrementMetric(createMetricId);
+    }
+    return client;
+}
+
+/*----------------------------------------------------------------------------
+ * returnConnection
+ *----------------------------------------------------------------------------*/
+void EndpointProxy::returnConnection (const char* member, HttpClient* client)
+{
+    poolMut.lock();
+    {
+        List<HttpClient*>* clients = NULL;
+        if(!connectionPool.find(member, &clients))
+        {
+            clients = new List<HttpClient*>;
+            connectionPool.add(member, clients);
+        }
+
+        if(clients->length() < MAX_CONNECTIONS_PER_NODE)
+        {
+            clients->add(client);
+            client = NULL;
+        }
+    }
+    poolMut.unlock();
+
+    if(client) delete client;
+}
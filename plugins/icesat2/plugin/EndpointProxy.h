@@ -39,6 +39,9 @@
 #include "LuaObject.h"
 #include "MsgQ.h"
 #include "OsApi.h"
+#include "List.h"
+#include "Dictionary.h"
+#include "HttpClient.h"
 #include "OrchestratorLib.h"
 
 /******************************************************************************
@@ -58,6 +61,14 @@ class EndpointProxy: public LuaObject
         static const int COLLATOR_POLL_RATE = 1000; // milliseconds
         static const int DEFAULT_PROXY_QUEUE_DEPTH = 1000;
         static const int MAX_PROXY_THREADS = 1000;
+        static const int MAX_CONNECTIONS_PER_NODE = 8; // idle keep-alive connections pooled for each node
+        static const int MAX_RETRIES = 3; // attempts made on other nodes after a failed attempt
+        static const int RETRY_BACKOFF = 500; // milliseconds, doubled after each retry
+        static const int MAX_RETRY_BACKOFF = 8000; // milliseconds
+        static const int MAX_ATTEMPTS_IN_FLIGHT = 2; // an attempt and its hedge
+        static const int HEDGE_FACTOR = 2; // multiple of the mean resource duration a straggler runs before it is hedged
+        static const int MIN_HEDGE_DELAY = 5; // seconds
+        static const int STAGING_QUEUE_DEPTH = 16; // messages a response can get ahead of the output queue
 
         static const char* SERVICE;
 
@@ -69,23 +80,79 @@ class EndpointProxy: public LuaObject
          * Methods
          *--------------------------------------------------------------------*/
 
-        static int luaCreate (lua_State* L);
+        static void init        (void);
+        static void deinit      (void);
+        static int  luaCreate   (lua_State* L);
 
     private:
 
+        /*--------------------------------------------------------------------
+         * Types
+         *--------------------------------------------------------------------*/
+
+        typedef enum {
+            SUCCEEDED,  // response forwarded to output queue
+            FAILED,     // no other attempt is in flight for the resource
+            REJECTED,   // node returned a client error that a retry would only repeat
+            ABANDONED,  // response failed after part of it was forwarded, so resource failed
+            DISCARDED   // resource was (or will be) completed by another attempt
+        } attempt_status_t;
+
+        typedef struct {
+            int                     resource;
+            OrchestratorLib::Node*  node;
+        } rqst_t;
+
+        typedef struct {
+            HttpClient*             client; // NULL when no attempt is in flight
+            const char*             member;
+            double                  start;
+            bool                    aborted;
+        } attempt_t;
+
+        typedef struct {
+            attempt_t               attempts[MAX_ATTEMPTS_IN_FLIGHT];
+            attempt_t*              claimant; // attempt forwarding its response, NULL until one does
+            int                     in_flight;
+            bool                    hedged;
+            bool                    complete;
+        } resource_state_t;
+
+        typedef struct {
+            EndpointProxy*          proxy;
+            int                     resource;
+            attempt_t*              attempt;
+            Subscriber*             staged;
+            bool                    claimed;    // attempt claimed the resource with its first message
+            bool                    dropping;   // messages are dropped instead of forwarded
+            bool                    forwarded;  // every message received was forwarded
+            bool                    ended;      // request ended, no more messages will be staged
+        } forwarder_t;
+
         /*--------------------------------------------------------------------
          * Data
          *--------------------------------------------------------------------*/
 
+        static Mutex                            poolMut;
+        static Dictionary<List<HttpClient*>*>   connectionPool;
+        static int32_t                          createMetricId;
+        static int32_t                          reuseMetricId;
+
         bool                    active;
         Publisher*              rqstPub;
         Subscriber*             rqstSub;
         Thread**                proxyPids;
         Thread*                 collatorPid;
         const char**            resources;
-        OrchestratorLib::Node** nodes;
+        resource_state_t*       states;
+        const char**            staticNodes;
+        int                     numStaticNodes;
+        int                     nextStaticNode;
         int                     numResources;
         int                     numResourcesComplete;
+        int                     numResourcesDispatched;
+        int                     numDurations;
+        double                  totalDuration;
         Cond                    completion;
         const char*             endpoint;
         const char*             asset;
@@ -100,13 +167,26 @@ class EndpointProxy: public LuaObject
          * Methods
          *--------------------------------------------------------------------*/
 
-                            EndpointProxy           (lua_State* L, const char* _endpoint, const char* _asset, const char** _resources, int _num_resources,
-                                                     const char* _parameters, int _timeout_secs, const char* _outq_name, bool _send_terminator,
-                                                     int _num_threads, int _rqst_queue_depth);
-                            ~EndpointProxy          (void);
-
-        static void*        collatorThread          (void* parm);
-        static void*        proxyThread             (void* parm);
+                                    EndpointProxy           (lua_State* L, const char* _endpoint, const char* _asset, const char** _resources, int _num_resources,
+                                                             const char* _parameters, int _timeout_secs, const char* _outq_name, bool _send_terminator,
+                                                             int _num_threads, int _rqst_queue_depth, const char** _nodes, int _num_nodes);
+                                    ~EndpointProxy          (void);
+
+        static void*                collatorThread          (void* parm);
+        static void*                proxyThread             (void* parm);
+        static void*                forwarderThread         (void* parm);
+
+        OrchestratorLib::NodeList*  lockNodes               (int num_nodes);
+        OrchestratorLib::Node*      lockNode                (const char* avoid);
+        void                        unlockNode              (OrchestratorLib::Node* node);
+        attempt_status_t            makeAttempt             (int resource, OrchestratorLib::Node* node);
+        bool                        claimResource           (int resource, attempt_t* attempt);
+        void                        completeResource        (int resource, bool valid);
+        void                        checkStragglers         (void);
+        void                        abortAttempts           (int resource, attempt_t* except=NULL);
+
+        static HttpClient*          checkoutConnection      (const char* member);
+        static void                 returnConnection        (const char* member, HttpClient* client);
 };
 
 #endif  /* __endpoint_proxy__ */
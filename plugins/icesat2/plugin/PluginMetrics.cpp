@@ -60,7 +60,8 @@ PluginMetrics::region_t continental_us = {
         {-126.73828125, 49.38237278700955}
     },
     .points = {},
-    .num_points = 8
+    .num_points = 8,
+    .index = NULL
 };
 
 PluginMetrics::region_t alaska = {
@@ -77,7 +78,8 @@ PluginMetrics::region_t alaska = {
         {-130.25390625, 53.85252660044951}
      },
     .points = {},
-    .num_points = 8
+    .num_points = 8,
+    .index = NULL
 };
 
 PluginMetrics::region_t canada = {
@@ -96,7 +98,8 @@ PluginMetrics::region_t canada = {
         {-125.859375, 48.22467264956519}
     },
     .points = {},
-    .num_points = 10
+    .num_points = 10,
+    .index = NULL
 };
 
 PluginMetrics::region_t greenland = {
@@ -112,7 +115,8 @@ PluginMetrics::region_t greenland = {
         {-74.70703125, 78.27820145542813}
      },
     .points = {},
-    .num_points = 7
+    .num_points = 7,
+    .index = NULL
 };
 
 PluginMetrics::region_t central_america = {
@@ -128,7 +132,8 @@ PluginMetrics::region_t central_america = {
         {-104.58984375, 32.69486597787505},
         {-120.9375, 34.59704151614417}
      },
-    .num_points = 8
+    .num_points = 8,
+    .index = NULL
 };
 
 PluginMetrics::region_t south_america = {
@@ -144,7 +149,8 @@ PluginMetrics::region_t south_america = {
         {-30.585937499999996, -4.740675384778361}
      },
     .points = {},
-    .num_points = 7
+    .num_points = 7,
+    .index = NULL
 };
 
 PluginMetrics::region_t africa = {
@@ -162,7 +168,8 @@ PluginMetrics::region_t africa = {
         {56.42578125, 11.350796722383672}
      },
     .points = {},
-    .num_points = 9
+    .num_points = 9,
+    .index = NULL
 };
 
 PluginMetrics::region_t middle_east = {
@@ -176,7 +183,8 @@ PluginMetrics::region_t middle_east = {
         {24.08203125, 39.50404070558415}
      },
     .points = {},
-    .num_points = 5
+    .num_points = 5,
+    .index = NULL
 };
 
 PluginMetrics::region_t europe = {
@@ -191,7 +199,8 @@ PluginMetrics::region_t europe = {
         {-10.546875, 35.17380831799959}
     },
     .points = {},
-    .num_points = 6
+    .num_points = 6,
+    .index = NULL
 };
 
 PluginMetrics::region_t north_asia = {
@@ -208,7 +217,8 @@ PluginMetrics::region_t north_asia = {
         {37.6171875, 43.58039085560784}
      },
     .points = {},
-    .num_points = 8
+    .num_points = 8,
+    .index = NULL
 };
 
 PluginMetrics::region_t south_asia = {
@@ -223,7 +233,8 @@ PluginMetrics::region_t south_asia = {
         {150.46875, 46.07323062540835}
     },
     .points = {},
-    .num_points = 6
+    .num_points = 6,
+    .index = NULL
 };
 
 PluginMetrics::region_t oceania = {
@@ -239,7 +250,8 @@ PluginMetrics::region_t oceania = {
         {132.1875, 3.8642546157214084}
     },
     .points = {},
-    .num_points = 7
+    .num_points = 7,
+    .index = NULL
 };
 
 PluginMetrics::region_t antarctica = {
@@ -251,7 +263,8 @@ PluginMetrics::region_t antarctica = {
         {-60.0, 180.0},
      },
     .points = {},
-    .num_points = 3
+    .num_points = 3,
+    .index = NULL
 };
 
 PluginMetrics::region_t unknown_region = {
@@ -259,7 +272,8 @@ PluginMetrics::region_t unknown_region = {
     .proj = MathLib::PLATE_CARREE,
     .coords = {},
     .points = {},
-    .num_points = 0
+    .num_points = 0,
+    .index = NULL
 };
 
 /******************************************************************************
@@ -283,6 +297,7 @@ bool PluginMetrics::init (void)
         {
             region->points[p] = MathLib::coord2point(region->coords[p], region->proj);
         }
+        region->index = new PolygonIndex(region->points, region->num_points);
 
         /* Register Metric */
         regionMetricIds[r] = EventLib::registerMetric(CATEGORY, EventLib::COUNTER, "%s.%s", region->name, REGION_METRIC);
@@ -296,6 +311,19 @@ bool PluginMetrics::init (void)
     return status;
 }
 
+/*----------------------------------------------------------------------------
+ * deinit
+ *----------------------------------------------------------------------------*/
+void PluginMetrics::deinit (void)
+{
+    for(int r = 0; r < NUM_REGIONS; r++)
+    {
+        region_t* region = region2struct((regions_t)r);
+        delete region->index;
+        region->index = NULL;
+    }
+}
+
 /*----------------------------------------------------------------------------
  * region2str
  *----------------------------------------------------------------------------*/
@@ -333,10 +361,17 @@ bool PluginMetrics::setRegion (RqstParms* parms)
 
         if(coord.lat > -60)
         {
+            /* Project Coordinate Once for Each Projection */
+            MathLib::point_t projected_coord[MathLib::NUM_PROJECTIONS];
+            for(int p = 0; p < MathLib::NUM_PROJECTIONS; p++)
+            {
+                projected_coord[p] = MathLib::coord2point(coord, (MathLib::proj_t)p);
+            }
+
             /* Check Non-Antartica Regions */
             for(int r = 0; r < REGION_ANTARCTICA; r++)
             {
-                if(checkRegion(coord, (regions_t)r))
+                if(checkRegion(projected_coord, (regions_t)r))
                 {
                     region_found = (regions_t)r;
                     break;
@@ -366,5 +401,16 @@ bool PluginMetrics::checkRegion (MathLib::coord_t coord, regions_t r)
 {
     region_t* region = region2struct(r);
     MathLib::point_t point = MathLib::coord2point(coord, region->proj);
-    return MathLib::inpoly(region->points, region->num_points, point);
+    return region->index->contains(point);
+}
+
+/*----------------------------------------------------------------------------
+ * checkRegion
+ *
+ *  takes the coordinate already projected into each of the projections
+ *----------------------------------------------------------------------------*/
+bool PluginMetrics::checkRegion (const MathLib::point_t* projected_coord, regions_t r)
+{
+    region_t* region = region2struct(r);
+    return region->index->contains(projected_coord[region->proj]);
 }
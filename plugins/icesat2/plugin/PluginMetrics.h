@@ -37,6 +37,7 @@
  ******************************************************************************/
 
 #include "OsApi.h"
+#include "MathLib.h"
 #include "RqstParms.h"
 
 /******************************************************************************
@@ -81,6 +82,7 @@ class PluginMetrics
             MathLib::coord_t coords[MAX_POINTS_IN_POLY];
             MathLib::point_t points[MAX_POINTS_IN_POLY];
             int num_points;
+            PolygonIndex* index; // built from points by init
         } region_t;
 
         /*--------------------------------------------------------------------
@@ -95,9 +97,11 @@ class PluginMetrics
          *--------------------------------------------------------------------*/
 
         static bool         init            (void);
+        static void         deinit          (void);
         static region_t*    region2struct   (regions_t region);
         static bool         setRegion       (RqstParms* parms);
         static bool         checkRegion     (MathLib::coord_t coord, regions_t r);
+        static bool         checkRegion     (const MathLib::point_t* projected_coord, regions_t r);
 
     private:
 
@@ -59,12 +59,26 @@ const RecordObject::fieldDef_t RasterSampler::extentRecDef[] = {
     {"samples",         RecordObject::USER,     offsetof(extent_t, samples),            0,  sampleRecType, NATIVE_FLAGS} // variable length
 };
 
+const char* RasterSampler::batchSampleRecType = "rsbatch.sample";
+const RecordObject::fieldDef_t RasterSampler::batchSampleRecDef[] = {
+    {"extent_id",       RecordObject::UINT64,   offsetof(batch_sample_t, extent_id),    1,  NULL, NATIVE_FLAGS},
+    {"value",           RecordObject::DOUBLE,   offsetof(batch_sample_t, value),        1,  NULL, NATIVE_FLAGS},
+    {"time",            RecordObject::DOUBLE,   offsetof(batch_sample_t, time),         1,  NULL, NATIVE_FLAGS}
+};
+
+const char* RasterSampler::batchRecType = "rsbatch";
+const RecordObject::fieldDef_t RasterSampler::batchRecDef[] = {
+    {"raster_index",    RecordObject::UINT16,   offsetof(batch_t, raster_index),        1,  NULL, NATIVE_FLAGS},
+    {"num_samples",     RecordObject::UINT32,   offsetof(batch_t, num_samples),         1,  NULL, NATIVE_FLAGS},
+    {"samples",         RecordObject::USER,     offsetof(batch_t, samples),             0,  batchSampleRecType, NATIVE_FLAGS} // variable length
+};
+
 /******************************************************************************
  * PUBLIC METHODS
  ******************************************************************************/
 
 /*----------------------------------------------------------------------------
- * luaCreate - :sampler(<vrt_raster>, <vrt_raster_index>, <outq name>, <rec_type>, <extent_key>, <lon_key>, <lat_key>)
+ * luaCreate - :sampler(<vrt_raster>, <vrt_raster_index>, <outq name>, <rec_type>, <extent_key>, <lon_key>, <lat_key>, [<batch>])
  *----------------------------------------------------------------------------*/
 int RasterSampler::luaCreate (lua_State* L)
 {
@@ -78,9 +92,10 @@ int RasterSampler::luaCreate (lua_State* L)
         const char* extent_key      = getLuaString(L, 5);
         const char* lon_key         = getLuaString(L, 6);
         const char* lat_key         = getLuaString(L, 7);
+        bool        batch_output    = getLuaBoolean(L, 8, true, false);
 
         /* Create Dispatch */
-        return createLuaObject(L, new RasterSampler(L, _raster, raster_index, outq_name, rec_type, extent_key, lon_key, lat_key));
+        return createLuaObject(L, new RasterSampler(L, _raster, raster_index, outq_name, rec_type, extent_key, lon_key, lat_key, batch_output));
     }
     catch(const RunTimeException& e)
     {
@@ -96,6 +111,8 @@ void RasterSampler::init (void)
 {
     RECDEF(sampleRecType, sampleRecDef, sizeof(VrtRaster::sample_t), NULL);
     RECDEF(extentRecType, extentRecDef, sizeof(extent_t), NULL);
+    RECDEF(batchSampleRecType, batchSampleRecDef, sizeof(batch_sample_t), NULL);
+    RECDEF(batchRecType, batchRecDef, sizeof(batch_t), NULL);
 }
 
 /*----------------------------------------------------------------------------
@@ -112,7 +129,7 @@ void RasterSampler::deinit (void)
 /*----------------------------------------------------------------------------
  * Constructor
  *----------------------------------------------------------------------------*/
-RasterSampler::RasterSampler (lua_State* L, VrtRaster* _raster, int raster_index, const char* outq_name, const char* rec_type, const char* extent_key, const char* lon_key, const char* lat_key):
+RasterSampler::RasterSampler (lua_State* L, VrtRaster* _raster, int raster_index, const char* outq_name, const char* rec_type, const char* extent_key, const char* lon_key, const char* lat_key, bool batch_output):
     DispatchObject(L, LuaMetaName, LuaMetaTable)
 {
     assert(_raster);
@@ -122,6 +139,7 @@ RasterSampler::RasterSampler (lua_State* L, VrtRaster* _raster, int raster_index
 
     raster = _raster;
     rasterIndex = raster_index;
+    batchOutput = batch_output;
 
     outQ = new Publisher(outq_name);
 
@@ -162,10 +180,14 @@ RasterSampler::~RasterSampler(void)
 /*----------------------------------------------------------------------------
  * processRecord
  *
- *  OUTPUT: one extent_t record per extent_id
+ *  OUTPUT: one extent_t record per extent_id, or
+ *          one batch_t record per input record when batch output is selected
  *  INPUT:  batch of atl06 extents
  *          each extent (up to 256 per record) will produce a single output record with one point
  *          that one point may have multiple samples associated with it
+ *
+ *  all of the extents in the record are sampled in a single call so that
+ *  the points are read from each raster together
  *----------------------------------------------------------------------------*/
 bool RasterSampler::processRecord (RecordObject* record, okey_t key)
 {
@@ -189,49 +211,80 @@ bool RasterSampler::processRecord (RecordObject* record, okey_t key)
     RecordObject::field_t lat_field = latField;
 
     /* Loop Through Each Record in Batch */
+    uint64_t* extent_ids = new uint64_t[num_extents];
+    MathLib::coord_t* points = new MathLib::coord_t[num_extents];
     for(int extent = 0; extent < num_extents; extent++)
     {
         /* Get Extent Id */
-        uint64_t extent_id = (uint64_t)record->getValueInteger(extent_field);
+        extent_ids[extent] = (uint64_t)record->getValueInteger(extent_field);
         extent_field.offset += (extentSizeBytes * 8);
 
         /* Get Longitude */
-        double lon_val = record->getValueReal(lon_field);
+        points[extent].lon = record->getValueReal(lon_field);
         lon_field.offset += (extentSizeBytes * 8);
 
         /* Get Latitude */
-        double lat_val = record->getValueReal(lat_field);
+        points[extent].lat = record->getValueReal(lat_field);
         lat_field.offset += (extentSizeBytes * 8);
+    }
 
-        /* Sample Raster */
-        List<VrtRaster::sample_t> slist;
-        int num_samples = raster->sample(lon_val, lat_val, slist);
+    /* Sample Raster */
+    List<VrtRaster::sample_t>* slists = new List<VrtRaster::sample_t>[num_extents];
+    int total_samples = raster->sample(points, num_extents, slists);
 
-        /* Create Sample Record */
-        int size_of_record = offsetof(extent_t, samples) + (sizeof(VrtRaster::sample_t) * num_samples);
-        RecordObject sample_rec(extentRecType, size_of_record);
-        extent_t* data = (extent_t*)sample_rec.getRecordData();
-        data->extent_id = extent_id;
+    if(batchOutput)
+    {
+        /* Create Batch Record */
+        int size_of_record = offsetof(batch_t, samples) + (sizeof(batch_sample_t) * total_samples);
+        RecordObject batch_rec(batchRecType, size_of_record);
+        batch_t* data = (batch_t*)batch_rec.getRecordData();
         data->raster_index = rasterIndex;
-        data->num_samples = num_samples;
-        for(int i = 0; i < num_samples; i++)
+        data->num_samples = total_samples;
+        int s = 0;
+        for(int extent = 0; extent < num_extents; extent++)
         {
-            data->samples[i] = slist[i];
+            for(int i = 0; i < slists[extent].length(); i++)
+            {
+                data->samples[s].extent_id = extent_ids[extent];
+                data->samples[s].value = slists[extent][i].value;
+                data->samples[s].time = slists[extent][i].time;
+                s++;
+            }
         }
 
-        /* Post Sample Record */
-        uint8_t* rec_buf = NULL;
-        int rec_bytes = sample_rec.serialize(&rec_buf, RecordObject::TAKE_OWNERSHIP);
-        int post_status = MsgQ::STATE_TIMEOUT;
-        while((post_status = outQ->postRef(rec_buf, rec_bytes, SYS_TIMEOUT)) == MsgQ::STATE_TIMEOUT);
-        if(post_status <= 0)
+        /* Post Batch Record */
+        status = postRecord(batch_rec);
+    }
+    else
+    {
+        for(int extent = 0; extent < num_extents; extent++)
         {
-            delete [] rec_buf; // we've taken ownership
-            mlog(ERROR, "Raster sampler failed to post %s to stream %s: %d", sample_rec.getRecordType(), outQ->getName(), post_status);
-            status = false;
+            /* Create Sample Record */
+            int num_samples = slists[extent].length();
+            int size_of_record = offsetof(extent_t, samples) + (sizeof(VrtRaster::sample_t) * num_samples);
+            RecordObject sample_rec(extentRecType, size_of_record);
+            extent_t* data = (extent_t*)sample_rec.getRecordData();
+            data->extent_id = extent_ids[extent];
+            data->raster_index = rasterIndex;
+            data->num_samples = num_samples;
+            for(int i = 0; i < num_samples; i++)
+            {
+                data->samples[i] = slists[extent][i];
+            }
+
+            /* Post Sample Record */
+            if(!postRecord(sample_rec))
+            {
+                status = false;
+            }
         }
     }
 
+    /* Clean Up */
+    delete [] slists;
+    delete [] points;
+    delete [] extent_ids;
+
     /* Return Status */
     return status;
 }
@@ -253,3 +306,21 @@ bool RasterSampler::processTermination (void)
 {
     return true;
 }
+
+/*----------------------------------------------------------------------------
+ * postRecord
+ *----------------------------------------------------------------------------*/
+bool RasterSampler::postRecord (RecordObject& rec)
+{
+    uint8_t* rec_buf = NULL;
+    int rec_bytes = rec.serialize(&rec_buf, RecordObject::TAKE_OWNERSHIP);
+    int post_status = MsgQ::STATE_TIMEOUT;
+    while((post_status = outQ->postRef(rec_buf, rec_bytes, SYS_TIMEOUT)) == MsgQ::STATE_TIMEOUT);
+    if(post_status <= 0)
+    {
+        delete [] rec_buf; // we've taken ownership
+        mlog(ERROR, "Raster sampler failed to post %s to stream %s: %d", rec.getRecordType(), outQ->getName(), post_status);
+        return false;
+    }
+    return true;
+}
@@ -65,6 +65,12 @@ class RasterSampler: public DispatchObject
         static const char* extentRecType;
         static const RecordObject::fieldDef_t extentRecDef[];
 
+        static const char* batchSampleRecType;
+        static const RecordObject::fieldDef_t batchSampleRecDef[];
+
+        static const char* batchRecType;
+        static const RecordObject::fieldDef_t batchRecDef[];
+
         /*--------------------------------------------------------------------
          * Types
          *--------------------------------------------------------------------*/
@@ -77,6 +83,20 @@ class RasterSampler: public DispatchObject
             VrtRaster::sample_t samples[];
         } extent_t;
 
+        /* Batch Sample Record */
+        typedef struct {
+            uint64_t            extent_id;
+            double              value;
+            double              time;
+        } batch_sample_t;
+
+        /* Batch Record - all samples of an input record */
+        typedef struct {
+            uint16_t            raster_index;
+            uint32_t            num_samples;
+            batch_sample_t      samples[];
+        } batch_t;
+
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
@@ -98,17 +118,20 @@ class RasterSampler: public DispatchObject
         RecordObject::field_t   extentField;
         RecordObject::field_t   lonField;
         RecordObject::field_t   latField;
+        bool                    batchOutput;
 
         /*--------------------------------------------------------------------
          * Methods
          *--------------------------------------------------------------------*/
 
-                        RasterSampler           (lua_State* L, VrtRaster* _raster, int raster_index, const char* outq_name, const char* rec_type, const char* extent_key, const char* lon_key, const char* lat_key);
+                        RasterSampler           (lua_State* L, VrtRaster* _raster, int raster_index, const char* outq_name, const char* rec_type, const char* extent_key, const char* lon_key, const char* lat_key, bool batch_output);
                         ~RasterSampler          (void);
 
         bool            processRecord           (RecordObject* record, okey_t key) override;
         bool            processTimeout          (void) override;
         bool            processTermination      (void) override;
+
+        bool            postRecord              (RecordObject& rec);
 };
 
 #endif  /* __raster_sampler__ */
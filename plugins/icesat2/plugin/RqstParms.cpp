@@ -471,6 +471,7 @@ RqstParms::output_format_t RqstParms::str2outputformat (const char* fmt_str)
     else if(StringLib::match(fmt_str, "feather"))   return OUTPUT_FORMAT_FEATHER;
     else if(StringLib::match(fmt_str, "parquet"))   return OUTPUT_FORMAT_PARQUET;
     else if(StringLib::match(fmt_str, "csv"))       return OUTPUT_FORMAT_CSV;
+    else if(StringLib::match(fmt_str, "arrow"))     return OUTPUT_FORMAT_ARROW;
     else                                            return OUTPUT_FORMAT_UNSUPPORTED;
 }
 
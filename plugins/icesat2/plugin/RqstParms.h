@@ -210,7 +210,8 @@ class RqstParms: public LuaObject
             OUTPUT_FORMAT_FEATHER = 1,
             OUTPUT_FORMAT_PARQUET = 2,
             OUTPUT_FORMAT_CSV = 3,
-            OUTPUT_FORMAT_UNSUPPORTED = 4
+            OUTPUT_FORMAT_ARROW = 4,
+            OUTPUT_FORMAT_UNSUPPORTED = 5
         } output_format_t;
 
         /* List of Strings */
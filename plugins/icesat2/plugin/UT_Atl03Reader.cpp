@@ -38,6 +38,7 @@
 #include "Atl03Reader.h"
 
 #include <cmath>
+#include <cfloat>
 
 /******************************************************************************
  * STATIC DATA
@@ -47,6 +48,8 @@ const char* UT_Atl03Reader::OBJECT_TYPE = "UT_Atl03Reader";
 
 const char* UT_Atl03Reader::LuaMetaName = "UT_Atl03Reader";
 const struct luaL_Reg UT_Atl03Reader::LuaMetaTable[] = {
+    {"yapcperf",        luaYapcPerf},
+    {"polyperf",        luaPolyPerf},
     {NULL,              NULL}
 };
 
@@ -89,3 +92,507 @@ UT_Atl03Reader::UT_Atl03Reader (lua_State* L):
 UT_Atl03Reader::~UT_Atl03Reader(void)
 {
 }
+
+/*----------------------------------------------------------------------------
+ * luaYapcPerf - :yapcperf([<version>], [<number of segments>], [<photons per segment>], [<unsorted>])
+ *
+ *  scores a synthetic dense track (a sloped surface plus uniform background)
+ *  with the reader's YAPC implementation and with the reference
+ *  implementation below, checks that every score is identical, and returns
+ *  the photons scored per second by each (nil when any score differs); when unsorted, neighboring photons
+ *  are swapped so that the along track distances are out of order
+ *----------------------------------------------------------------------------*/
+int UT_Atl03Reader::luaYapcPerf (lua_State* L)
+{
+    bool status = false;
+    int num_obj_to_return = 1;
+    int32_t* segment_ph_cnt = NULL;
+    double* segment_dist_x = NULL;
+    float* dist_ph_along = NULL;
+    float* h_ph = NULL;
+    uint8_t* scores = NULL;
+    uint8_t* reference_scores = NULL;
+
+    try
+    {
+        /* Get Parameters */
+        long version            = getLuaInteger(L, 2, true, 3);
+        long num_segments       = getLuaInteger(L, 3, true, 500);
+        long photons_per_segment= getLuaInteger(L, 4, true, 200);
+        bool unsorted           = getLuaBoolean(L, 5, true, false);
+
+        /* Check Parameters */
+        if(version < 2 || version > 3 || num_segments <= 0 || photons_per_segment <= 0)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid parameters: version %ld, %ld segments, %ld photons per segment", version, num_segments, photons_per_segment);
+        }
+
+        /* Default Settings */
+        RqstParms::yapc_t settings = {
+            .score      = 0,
+            .version    = (int)version,
+            .knn        = 0,
+            .min_knn    = 5,
+            .win_h      = 6.0,
+            .win_x      = 15.0
+        };
+        int minimum_photon_count = 10;
+
+        /* Generate Track */
+        int32_t num_photons = num_segments * photons_per_segment;
+        segment_ph_cnt = new int32_t [num_segments];
+        segment_dist_x = new double [num_segments];
+        dist_ph_along = new float [num_photons];
+        h_ph = new float [num_photons];
+        scores = new uint8_t [num_photons];
+        reference_scores = new uint8_t [num_photons];
+        uint32_t seed = 0x13579BDF;
+        for(int32_t s = 0; s < num_segments; s++)
+        {
+            segment_ph_cnt[s] = photons_per_segment;
+            segment_dist_x[s] = 1000000.0 + (s * 20.0);
+            for(int32_t p = 0; p < photons_per_segment; p++)
+            {
+                int32_t i = (s * photons_per_segment) + p;
+                double u[2];
+                for(int k = 0; k < 2; k++)
+                {
+                    seed = (seed * 1103515245) + 12345;
+                    u[k] = (double)(seed >> 8) / (double)(1 << 24);
+                }
+                double x = ((p + u[0]) * 20.0) / photons_per_segment; // increasing within segment
+                double surface = 500.0 + (0.02 * (segment_dist_x[s] - 1000000.0 + x)) + ((u[1] - 0.5) * 0.5);
+                dist_ph_along[i] = x;
+                h_ph[i] = (p % 3 == 0) ? 500.0 + ((u[1] - 0.5) * 60.0) : surface; // one in three is background
+            }
+        }
+
+        /* Take Photons Out of Order */
+        if(unsorted)
+        {
+            for(int32_t i = 1; i < num_photons; i += 7)
+            {
+                float d = dist_ph_along[i]; dist_ph_along[i] = dist_ph_along[i - 1]; dist_ph_along[i - 1] = d;
+                float h = h_ph[i]; h_ph[i] = h_ph[i - 1]; h_ph[i - 1] = h;
+            }
+        }
+
+        /* Score Track */
+        double start = TimeLib::latchtime();
+        if(version == 3)    Atl03Reader::YapcScore::scoreV3(&settings, num_segments, segment_ph_cnt, segment_dist_x, num_photons, dist_ph_along, h_ph, scores);
+        else                Atl03Reader::YapcScore::scoreV2(&settings, minimum_photon_count, num_segments, segment_ph_cnt, num_photons, dist_ph_along, h_ph, scores);
+        double elapsed = TimeLib::latchtime() - start;
+
+        /* Score Track with Reference */
+        start = TimeLib::latchtime();
+        if(version == 3)    yapcV3Reference(&settings, num_segments, segment_ph_cnt, segment_dist_x, num_photons, dist_ph_along, h_ph, reference_scores);
+        else                yapcV2Reference(&settings, minimum_photon_count, num_segments, segment_ph_cnt, num_photons, dist_ph_along, h_ph, reference_scores);
+        double reference_elapsed = TimeLib::latchtime() - start;
+
+        /* Compare Scores */
+        int32_t mismatches = 0;
+        for(int32_t i = 0; i < num_photons; i++)
+        {
+            if(scores[i] != reference_scores[i])
+            {
+                if(mismatches++ < 10) mlog(CRITICAL, "YAPC score mismatch at photon %d: %d != %d", i, scores[i], reference_scores[i]);
+            }
+        }
+
+        /* Report Results */
+        double rate = num_photons / elapsed;
+        double reference_rate = num_photons / reference_elapsed;
+        print2term("YAPC v%ld: %d photons (%ld per segment) in %.3lf seconds, %.0lf photons/second; reference %.3lf seconds, %.0lf photons/second; %d mismatches\n",
+                   version, num_photons, photons_per_segment, elapsed, rate, reference_elapsed, reference_rate, mismatches);
+        if(mismatches == 0)
+        {
+            lua_pushnumber(L, rate);
+            lua_pushnumber(L, reference_rate);
+            num_obj_to_return = 3;
+            status = true;
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error executing test %s: %s", __FUNCTION__, e.what());
+    }
+
+    /* Clean Up */
+    delete [] segment_ph_cnt;
+    delete [] segment_dist_x;
+    delete [] dist_ph_along;
+    delete [] h_ph;
+    delete [] scores;
+    delete [] reference_scores;
+
+    /* Return Status */
+    return returnLuaStatus(L, status, num_obj_to_return);
+}
+
+/*----------------------------------------------------------------------------
+ * luaPolyPerf - :polyperf([<number of vertices>], [<number of points>])
+ *
+ *  tests points scattered over and around a jagged star shaped polygon for
+ *  inclusion with a PolygonIndex and with MathLib::inpoly, checks that every
+ *  result is the same, and returns the points tested per second by each (nil
+ *  when any result differs); polygon vertices and NaN points are included
+ *----------------------------------------------------------------------------*/
+int UT_Atl03Reader::luaPolyPerf (lua_State* L)
+{
+    bool status = false;
+    int num_obj_to_return = 1;
+    MathLib::point_t* poly = NULL;
+    MathLib::point_t* points = NULL;
+    bool* mask = NULL;
+    bool* reference_mask = NULL;
+    PolygonIndex* index = NULL;
+
+    try
+    {
+        /* Get Parameters */
+        long num_vertices   = getLuaInteger(L, 2, true, 2000);
+        long num_points     = getLuaInteger(L, 3, true, 100000);
+
+        /* Check Parameters */
+        if(num_vertices < 3 || num_points < num_vertices)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "invalid parameters: %ld vertices, %ld points", num_vertices, num_points);
+        }
+
+        /* Generate Polygon */
+        uint32_t seed = 0x2468ACE1;
+        poly = new MathLib::point_t [num_vertices];
+        for(long v = 0; v < num_vertices; v++)
+        {
+            seed = (seed * 1103515245) + 12345;
+            double r = 0.5 + ((double)(seed >> 8) / (double)(1 << 24)); // radius between 0.5 and 1.5
+            double a = (2.0 * M_PI * v) / num_vertices;
+            poly[v].x = r * cos(a);
+            poly[v].y = r * sin(a);
+        }
+
+        /* Generate Points */
+        points = new MathLib::point_t [num_points];
+        for(long p = 0; p < num_points; p++)
+        {
+            seed = (seed * 1103515245) + 12345;
+            points[p].x = ((double)(seed >> 8) / (double)(1 << 23)) - 1.0; // between -1 and 1
+            seed = (seed * 1103515245) + 12345;
+            points[p].y = ((double)(seed >> 8) / (double)(1 << 23)) - 1.0;
+            points[p].x *= 1.6;
+            points[p].y *= 1.6;
+        }
+        for(long v = 0; v < num_vertices; v += 10) points[v] = poly[v];
+        points[num_points - 1].x = NAN;
+
+        /* Test Inclusion */
+        mask = new bool [num_points];
+        double start = TimeLib::latchtime();
+        index = new PolygonIndex(poly, num_vertices);
+        int num_inside = index->contains(points, num_points, mask);
+        double elapsed = TimeLib::latchtime() - start;
+
+        /* Test Inclusion with Reference */
+        reference_mask = new bool [num_points];
+        start = TimeLib::latchtime();
+        for(long p = 0; p < num_points; p++)
+        {
+            reference_mask[p] = MathLib::inpoly(poly, num_vertices, points[p]);
+        }
+        double reference_elapsed = TimeLib::latchtime() - start;
+
+        /* Compare Results */
+        int mismatches = 0;
+        for(long p = 0; p < num_points; p++)
+        {
+            if(mask[p] != reference_mask[p])
+            {
+                if(mismatches++ < 10) mlog(CRITICAL, "Polygon inclusion mismatch at point %ld (%lf, %lf): %d != %d", p, points[p].x, points[p].y, mask[p], reference_mask[p]);
+            }
+        }
+
+        /* Report Results */
+        double rate = num_points / elapsed;
+        double reference_rate = num_points / reference_elapsed;
+        print2term("Polygon of %ld vertices (%d slabs): %ld points (%d inside) in %.3lf seconds, %.0lf points/second; reference %.3lf seconds, %.0lf points/second; %d mismatches\n",
+                   num_vertices, index->getNumSlabs(), num_points, num_inside, elapsed, rate, reference_elapsed, reference_rate, mismatches);
+        if(mismatches == 0)
+        {
+            lua_pushnumber(L, rate);
+            lua_pushnumber(L, reference_rate);
+            num_obj_to_return = 3;
+            status = true;
+        }
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error executing test %s: %s", __FUNCTION__, e.what());
+    }
+
+    /* Clean Up */
+    delete index;
+    delete [] poly;
+    delete [] points;
+    delete [] mask;
+    delete [] reference_mask;
+
+    /* Return Status */
+    return returnLuaStatus(L, status, num_obj_to_return);
+}
+
+/*----------------------------------------------------------------------------
+ * yapcV2Reference
+ *
+ *  version 2 as originally written against the ATL03 arrays of one track
+ *----------------------------------------------------------------------------*/
+void UT_Atl03Reader::yapcV2Reference (RqstParms::yapc_t* settings, int minimum_photon_count,
+                                      int32_t num_segments, const int32_t* segment_ph_cnt,
+                                      int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                      uint8_t* scores)
+{
+    /* YAPC Hard-Coded Parameters */
+    const double MAXIMUM_HSPREAD = 15000.0; // meters
+    const double HSPREAD_BINSIZE = 1.0; // meters
+    const int MAX_KNN = 25;
+    double nearest_neighbors[MAX_KNN];
+
+    LocalLib::set(scores, 0, num_photons);
+
+    /* Initialize Indices */
+    int32_t ph_b0 = 0; // buffer start
+    int32_t ph_b1 = 0; // buffer end
+    int32_t ph_c0 = 0; // center start
+    int32_t ph_c1 = 0; // center end
+
+    /* Loop Through Each ATL03 Segment */
+    for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    {
+        /* Determine Indices */
+        ph_b0 += segment_index > 1 ? segment_ph_cnt[segment_index - 2] : 0; // Center - 2
+        ph_c0 += segment_index > 0 ? segment_ph_cnt[segment_index - 1] : 0; // Center - 1
+        ph_c1 += segment_ph_cnt[segment_index]; // Center
+        ph_b1 += segment_index < (num_segments - 1) ? segment_ph_cnt[segment_index + 1] : 0; // Center + 1
+
+        /* Calculate N and KNN */
+        int32_t N = segment_ph_cnt[segment_index];
+        int knn = (settings->knn != 0) ? settings->knn : MAX(1, (sqrt((double)N) + 0.5) / 2);
+        knn = MIN(knn, MAX_KNN); // truncate if too large
+
+        /* Check Valid Extent (note check against knn)*/
+        if((N <= knn) || (N < minimum_photon_count)) continue;
+
+        /* Calculate Distance and Height Spread */
+        double min_h = h_ph[0];
+        double max_h = min_h;
+        double min_x = dist_ph_along[0];
+        double max_x = min_x;
+        for(int n = 1; n < N; n++)
+        {
+            double h = h_ph[n];
+            double x = dist_ph_along[n];
+            if(h < min_h) min_h = h;
+            if(h > max_h) max_h = h;
+            if(x < min_x) min_x = x;
+            if(x > max_x) max_x = x;
+        }
+        double hspread = max_h - min_h;
+        double xspread = max_x - min_x;
+
+        /* Check Window */
+        if(hspread <= 0.0 || hspread > MAXIMUM_HSPREAD || xspread <= 0.0)
+        {
+            continue;
+        }
+
+        /* Bin Photons to Calculate Height Span*/
+        int num_bins = (int)(hspread / HSPREAD_BINSIZE) + 1;
+        int8_t* bins = new int8_t [num_bins];
+        LocalLib::set(bins, 0, num_bins);
+        for(int n = 0; n < N; n++)
+        {
+            unsigned int bin = (unsigned int)((h_ph[n] - min_h) / HSPREAD_BINSIZE);
+            bins[bin] = 1; // mark that photon present
+        }
+
+        /* Determine Number of Bins with Photons to Calculate Height Span */
+        int nonzero_bins = 0;
+        for(int b = 0; b < num_bins; b++) nonzero_bins += bins[b];
+        delete [] bins;
+
+        /* Calculate Height Span */
+        double h_span = (nonzero_bins * HSPREAD_BINSIZE) / (double)N * (double)knn;
+
+        /* Calculate Window Parameters */
+        double half_win_x = settings->win_x / 2.0;
+        double half_win_h = (settings->win_h != 0.0) ? settings->win_h / 2.0 : h_span / 2.0;
+
+        /* Calculate YAPC Score for all Photons in Center Segment */
+        for(int y = ph_c0; y < ph_c1; y++)
+        {
+            double smallest_nearest_neighbor = DBL_MAX;
+            int smallest_nearest_neighbor_index = 0;
+            int num_nearest_neighbors = 0;
+
+            /* For All Neighbors */
+            for(int x = ph_b0; x < ph_b1; x++)
+            {
+                if(y == x) continue;
+
+                double delta_x = abs(dist_ph_along[x] - dist_ph_along[y]);
+                if(delta_x > half_win_x) continue;
+
+                double delta_h = abs(h_ph[x] - h_ph[y]);
+                double proximity = half_win_h - delta_h;
+
+                if(num_nearest_neighbors < knn)
+                {
+                    if(proximity < smallest_nearest_neighbor)
+                    {
+                        smallest_nearest_neighbor = proximity;
+                        smallest_nearest_neighbor_index = num_nearest_neighbors;
+                    }
+                    nearest_neighbors[num_nearest_neighbors] = proximity;
+                    num_nearest_neighbors++;
+                }
+                else if(proximity > smallest_nearest_neighbor)
+                {
+                    nearest_neighbors[smallest_nearest_neighbor_index] = proximity;
+                    smallest_nearest_neighbor = proximity;
+                    for(int k = 0; k < knn; k++)
+                    {
+                        if(nearest_neighbors[k] < smallest_nearest_neighbor)
+                        {
+                            smallest_nearest_neighbor = nearest_neighbors[k];
+                            smallest_nearest_neighbor_index = k;
+                        }
+                    }
+                }
+            }
+
+            for(int k = num_nearest_neighbors; k < knn; k++)
+            {
+                nearest_neighbors[k] = 0.0;
+            }
+
+            double nearest_neighbor_sum = 0.0;
+            for(int k = 0; k < knn; k++)
+            {
+                if(nearest_neighbors[k] > 0.0)
+                {
+                    nearest_neighbor_sum += nearest_neighbors[k];
+                }
+            }
+            nearest_neighbor_sum /= (double)knn;
+
+            scores[y] = (uint8_t)((nearest_neighbor_sum / half_win_h) * 0xFF);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * yapcV3Reference
+ *
+ *  version 3 as originally written against the ATL03 arrays of one track
+ *----------------------------------------------------------------------------*/
+void UT_Atl03Reader::yapcV3Reference (RqstParms::yapc_t* settings,
+                                      int32_t num_segments, const int32_t* segment_ph_cnt, const double* segment_dist_x,
+                                      int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                      uint8_t* scores)
+{
+    const double hWX = settings->win_x / 2; // meters
+    const double hWZ = settings->win_h / 2; // meters
+
+    LocalLib::set(scores, 0, num_photons);
+    double* ph_dist = new double[num_photons];
+
+    /* Populate Distance Array */
+    int32_t ph_index = 0;
+    for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    {
+        for(int32_t ph_in_seg_index = 0; ph_in_seg_index < segment_ph_cnt[segment_index]; ph_in_seg_index++)
+        {
+            ph_dist[ph_index] = segment_dist_x[segment_index] + dist_ph_along[ph_index];
+            ph_index++;
+        }
+    }
+
+    /* Traverse Each Segment */
+    ph_index = 0;
+    for(int segment_index = 0; segment_index < num_segments; segment_index++)
+    {
+        int32_t N = segment_ph_cnt[segment_index];
+        double* ph_weights = new double[N];
+        int max_knn = settings->min_knn;
+        int32_t start_ph_index = ph_index;
+
+        for(int32_t ph_in_seg_index = 0; ph_in_seg_index < N; ph_in_seg_index++)
+        {
+            List<double> proximities;
+
+            /* Check Nearest Neighbors to Left */
+            int32_t neighbor_index = ph_index - 1;
+            while(neighbor_index >= 0)
+            {
+                double x_dist = ph_dist[ph_index] - ph_dist[neighbor_index];
+                if(x_dist <= hWX)
+                {
+                    double proximity = abs(h_ph[ph_index] - h_ph[neighbor_index]);
+                    if(proximity <= hWZ)
+                    {
+                        proximities.add(proximity);
+                    }
+                }
+                if(x_dist >= (hWX + 1.0)) break;
+                neighbor_index--;
+            }
+
+            /* Check Nearest Neighbors to Right */
+            neighbor_index = ph_index + 1;
+            while(neighbor_index < num_photons)
+            {
+                double x_dist = ph_dist[neighbor_index] - ph_dist[ph_index];
+                if(x_dist <= hWX)
+                {
+                    double proximity = abs(h_ph[ph_index] - h_ph[neighbor_index]);
+                    if(proximity <= hWZ)
+                    {
+                        proximities.add(proximity);
+                    }
+                }
+                if(x_dist >= (hWX + 1.0)) break;
+                neighbor_index++;
+            }
+
+            /* Sort Proximities */
+            proximities.sort();
+
+            /* Calculate knn */
+            double n = sqrt(proximities.length());
+            int knn = MAX(n, settings->min_knn);
+            if(knn > max_knn) max_knn = knn;
+
+            /* Calculate Sum of Weights*/
+            int num_nearest_neighbors = MIN(knn, proximities.length());
+            double weight_sum = 0.0;
+            for(int i = 0; i < num_nearest_neighbors; i++)
+            {
+                weight_sum += hWZ - proximities[i];
+            }
+            ph_weights[ph_in_seg_index] = weight_sum;
+
+            ph_index++;
+        }
+
+        /* Normalize Weights */
+        for(int32_t ph_in_seg_index = 0; ph_in_seg_index < N; ph_in_seg_index++)
+        {
+            double Wt = ph_weights[ph_in_seg_index] / (hWZ * max_knn);
+            scores[start_ph_index] = (uint8_t)(MIN(Wt * 255, 255));
+            start_ph_index++;
+        }
+
+        delete [] ph_weights;
+    }
+
+    delete [] ph_dist;
+}
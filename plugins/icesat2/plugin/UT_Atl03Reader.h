@@ -38,6 +38,7 @@
 
 #include "OsApi.h"
 #include "LuaObject.h"
+#include "RqstParms.h"
 
 /******************************************************************************
  * ATL03 READER UNIT TEST CLASS
@@ -73,6 +74,17 @@ class UT_Atl03Reader: public LuaObject
                         ~UT_Atl03Reader         (void);
 
         static int      luaTriangleTest         (lua_State* L);
+        static int      luaYapcPerf             (lua_State* L);
+        static int      luaPolyPerf             (lua_State* L);
+
+        static void     yapcV2Reference         (RqstParms::yapc_t* settings, int minimum_photon_count,
+                                                 int32_t num_segments, const int32_t* segment_ph_cnt,
+                                                 int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                                 uint8_t* scores);
+        static void     yapcV3Reference         (RqstParms::yapc_t* settings,
+                                                 int32_t num_segments, const int32_t* segment_ph_cnt, const double* segment_dist_x,
+                                                 int32_t num_photons, const float* dist_ph_along, const float* h_ph,
+                                                 uint8_t* scores);
 };
 
 #endif  /* __ut_atl03reader__ */
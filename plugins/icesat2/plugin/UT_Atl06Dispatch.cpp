@@ -36,6 +36,8 @@
 #include "core.h"
 #include "UT_Atl06Dispatch.h"
 #include "Atl06Dispatch.h"
+#include "Atl03Reader.h"
+#include "RqstParms.h"
 
 #include <cmath>
 
@@ -48,7 +50,8 @@ const char* UT_Atl06Dispatch::OBJECT_TYPE = "UT_Atl06Dispatch";
 const char* UT_Atl06Dispatch::LuaMetaName = "UT_Atl06Dispatch";
 const struct luaL_Reg UT_Atl06Dispatch::LuaMetaTable[] = {
     {"lsftest",         luaLsfTest},
-    {"sorttest",        luaSortTest},
+    {"selecttest",      luaSelectTest},
+    {"fitperf",         luaFitPerf},
     {NULL,              NULL}
 };
 
@@ -108,19 +111,24 @@ int UT_Atl06Dispatch::luaLsfTest (lua_State* L)
     extent->photons[1].distance = 2.0;
     extent->photons[2].distance = 3.0;
     extent->photons[3].distance = 4.0;
+    Atl03Reader::photon_columns_t columns;
+    Atl03Reader::getExtent(record, &columns);
 
     try
     {
         bool tests_passed = true;
         double tolerance = 0.0000001;
 
+        /* Photons */
+        uint32_t p[num_photons] = { 0, 1, 2, 3 };
+        double x[num_photons] = { 1.0, 2.0, 3.0, 4.0 };
+        double r[num_photons];
+        double s[num_photons];
+
         /* Test 1 */
-        extent->photons[0].height = 2.0;
-        extent->photons[1].height = 4.0;
-        extent->photons[2].height = 6.0;
-        extent->photons[3].height = 8.0;
-        Atl06Dispatch::point_t v1[num_photons] = { {0, 0.0}, {1, 0.0}, {2, 0.0}, {3, 0.0} };
-        Atl06Dispatch::lsf_t fit1 = Atl06Dispatch::lsf(extent, v1, num_photons, false);
+        double y1[num_photons] = { 2.0, 4.0, 6.0, 8.0 };
+        Atl06Dispatch::points_t v1 = { p, x, y1, r, s };
+        Atl06Dispatch::lsf_t fit1 = Atl06Dispatch::lsf(&columns, &v1, num_photons, false);
         if(fit1.height != 0.0 || fabs(fit1.slope - 2.0) > tolerance)
         {
             mlog(CRITICAL, "Failed LSF test01: %lf, %lf", fit1.height, fit1.slope);
@@ -128,12 +136,9 @@ int UT_Atl06Dispatch::luaLsfTest (lua_State* L)
         }
 
         /* Test 2 */
-        extent->photons[0].height = 4.0;
-        extent->photons[1].height = 5.0;
-        extent->photons[2].height = 6.0;
-        extent->photons[3].height = 7.0;
-        Atl06Dispatch::point_t v2[num_photons] = { {0, 0.0}, {1, 0.0}, {2, 0.0}, {3, 0.0} };
-        Atl06Dispatch::lsf_t fit2 = Atl06Dispatch::lsf(extent, v2, num_photons, false);
+        double y2[num_photons] = { 4.0, 5.0, 6.0, 7.0 };
+        Atl06Dispatch::points_t v2 = { p, x, y2, r, s };
+        Atl06Dispatch::lsf_t fit2 = Atl06Dispatch::lsf(&columns, &v2, num_photons, false);
         if(fabs(fit2.height - 3.0) > tolerance || fabs(fit2.slope - 1.0) > tolerance)
         {
             mlog(CRITICAL, "Failed LSF test02: %lf, %lf", fit2.height, fit2.slope);
@@ -156,9 +161,9 @@ int UT_Atl06Dispatch::luaLsfTest (lua_State* L)
 }
 
 /*----------------------------------------------------------------------------
- * luaSortTest
+ * luaSelectTest
  *----------------------------------------------------------------------------*/
-int UT_Atl06Dispatch::luaSortTest (lua_State* L)
+int UT_Atl06Dispatch::luaSelectTest (lua_State* L)
 {
     bool status = false;
 
@@ -166,56 +171,290 @@ int UT_Atl06Dispatch::luaSortTest (lua_State* L)
     {
         bool tests_passed = true;
 
-        /* Test 1 */
-        Atl06Dispatch::point_t a1[10] = { {0,0}, {0,5}, {0,1}, {0,4}, {0,2}, {0,3}, {0,9}, {0,6}, {0,7}, {0,8} };
-        Atl06Dispatch::point_t b1[10] = { {0,0}, {0,1}, {0,2}, {0,3}, {0,4}, {0,5}, {0,6}, {0,7}, {0,8}, {0,9} };
-        Atl06Dispatch::quicksort(a1, 0, 9);
-        for(int i = 0; i < 10; i++)
+        /* Test Arrays and Sorted Results */
+        const int num_tests = 3;
+        double a[num_tests][10] = {
+            { 0, 5, 1, 4, 2, 3, 9, 6, 7, 8 },
+            { 1, 1, 1, 3, 2, 3, 3, 6, 9, 9 },
+            { 9, 8, 1, 7, 6, 3, 5, 4, 2, 0 } };
+        double b[num_tests][10] = {
+            { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 },
+            { 1, 1, 1, 2, 3, 3, 3, 6, 9, 9 },
+            { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 } };
+
+        for(int t = 0; t < num_tests && tests_passed; t++)
         {
-            if(a1[i].r != b1[i].r)
+            /* Select Each Rank */
+            for(int k = 0; k < 10; k++)
+            {
+                double c[10];
+                LocalLib::copy(c, a[t], sizeof(c));
+                Atl06Dispatch::selectranks(c, 10, k, k + 1);
+                if(c[k] != b[t][k])
+                {
+                    mlog(CRITICAL, "Failed select test%02d at rank: %d", t + 1, k);
+                    tests_passed = false;
+                    break;
+                }
+            }
+
+            /* Select Range of Ranks */
+            double c[10];
+            LocalLib::copy(c, a[t], sizeof(c));
+            Atl06Dispatch::selectranks(c, 10, 3, 7);
+            for(int k = 3; k < 7; k++)
             {
-                mlog(CRITICAL, "Failed sort test01 at: %d", i);
-                tests_passed = false;
-                break;
+                if(c[k] != b[t][k])
+                {
+                    mlog(CRITICAL, "Failed select test%02d at range rank: %d", t + 1, k);
+                    tests_passed = false;
+                    break;
+                }
+            }
+
+            /* Select All Ranks */
+            LocalLib::copy(c, a[t], sizeof(c));
+            Atl06Dispatch::selectranks(c, 10, 0, 10);
+            for(int k = 0; k < 10; k++)
+            {
+                if(c[k] != b[t][k])
+                {
+                    mlog(CRITICAL, "Failed select test%02d at sorted rank: %d", t + 1, k);
+                    tests_passed = false;
+                    break;
+                }
             }
         }
 
-        /* Test 2 */
-        Atl06Dispatch::point_t a2[10] = { {0,1}, {0,1}, {0,1}, {0,3}, {0,2}, {0,3}, {0,3}, {0,6}, {0,9}, {0,9} };
-        Atl06Dispatch::point_t b2[10] = { {0,1}, {0,1}, {0,1}, {0,2}, {0,3}, {0,3}, {0,3}, {0,6}, {0,9}, {0,9} };
-        Atl06Dispatch::quicksort(a2, 0, 9);
-        for(int i = 0; i < 10; i++)
+        /* Set Status */
+        status = tests_passed;
+    }
+    catch(const RunTimeException& e)
+    {
+        mlog(e.level(), "Error executing test %s: %s", __FUNCTION__, e.what());
+    }
+
+    /* Return Status */
+    return returnLuaStatus(L, status);
+}
+
+/*----------------------------------------------------------------------------
+ * createColumnarExtent
+ *----------------------------------------------------------------------------*/
+RecordObject* UT_Atl06Dispatch::createColumnarExtent (Atl03Reader::extent_t* extent, int num_photons)
+{
+    int extent_bytes = offsetof(Atl03Reader::extent_columns_t, columns) + (((sizeof(double) * 4) + sizeof(float) + 4) * num_photons);
+    RecordObject* record = new RecordObject(Atl03Reader::exColRecType, extent_bytes);
+    Atl03Reader::extent_columns_t* columnar = (Atl03Reader::extent_columns_t*)record->getRecordData();
+
+    /* Copy Attributes */
+    LocalLib::copy(columnar, extent, offsetof(Atl03Reader::extent_t, photon_offset));
+    columnar->first_photon[RqstParms::RPT_L] = 0;
+    columnar->first_photon[RqstParms::RPT_R] = extent->photon_count[RqstParms::RPT_L];
+
+    /* Lay Out Columns */
+    uint32_t offset = offsetof(Atl03Reader::extent_columns_t, columns);
+    columnar->delta_time_offset     = offset;   offset += sizeof(double) * num_photons;
+    columnar->latitude_offset       = offset;   offset += sizeof(double) * num_photons;
+    columnar->longitude_offset      = offset;   offset += sizeof(double) * num_photons;
+    columnar->distance_offset       = offset;   offset += sizeof(double) * num_photons;
+    columnar->height_offset         = offset;   offset += sizeof(float) * num_photons;
+    columnar->atl08_class_offset    = offset;   offset += num_photons;
+    columnar->atl03_cnf_offset      = offset;   offset += num_photons;
+    columnar->quality_ph_offset     = offset;   offset += num_photons;
+    columnar->yapc_score_offset     = offset;
+
+    /* Copy Photons */
+    uint8_t* data = (uint8_t*)columnar;
+    for(int p = 0; p < num_photons; p++)
+    {
+        Atl03Reader::photon_t* ph = &extent->photons[p];
+        ((double*)&data[columnar->delta_time_offset])[p]    = ph->delta_time;
+        ((double*)&data[columnar->latitude_offset])[p]      = ph->latitude;
+        ((double*)&data[columnar->longitude_offset])[p]     = ph->longitude;
+        ((double*)&data[columnar->distance_offset])[p]      = ph->distance;
+        ((float*)&data[columnar->height_offset])[p]         = ph->height;
+        data[columnar->atl08_class_offset + p]              = ph->atl08_class;
+        data[columnar->atl03_cnf_offset + p]                = ph->atl03_cnf;
+        data[columnar->quality_ph_offset + p]               = ph->quality_ph;
+        data[columnar->yapc_score_offset + p]               = ph->yapc_score;
+    }
+
+    return record;
+}
+
+/*----------------------------------------------------------------------------
+ * luaFitPerf - :fitperf(<parms>, [<number of extents>], [<photons per track>], [<num workers>], [<ordered>], [<columnar>])
+ *
+ *  times the ATL06 algorithm over synthetic extents (a sloped surface plus
+ *  uniform background) and returns the number of extents processed per second
+ *  along with a checksum of the posted elevations; the extents are generated
+ *  with a fixed seed so that the checksum can be compared from run to run.
+ *  A pool of extents is generated up front and cycled through so that the
+ *  timing covers handing extents to the workers and waiting for them to
+ *  finish; each pair of segments is processed out of order, and when ordered,
+ *  the posted elevations are checked to be back in segment order; when
+ *  columnar, the extents are converted to atl03col records before being
+ *  processed
+ *----------------------------------------------------------------------------*/
+int UT_Atl06Dispatch::luaFitPerf (lua_State* L)
+{
+    bool status = false;
+    int num_obj_to_return = 1;
+    RecordObject* records[FIT_PERF_POOL_SIZE] = { NULL };
+    Atl06Dispatch* dispatch = NULL;
+    Subscriber* resultq = NULL;
+
+    try
+    {
+        /* Get Parameters */
+        RqstParms* parms        = (RqstParms*)getLuaObject(L, 2, RqstParms::OBJECT_TYPE);
+        long num_extents        = getLuaInteger(L, 3, true, 10000);
+        long photons_per_track  = getLuaInteger(L, 4, true, 400);
+        long num_workers        = getLuaInteger(L, 5, true, 0);
+        bool ordered            = getLuaBoolean(L, 6, true, false);
+        bool columnar           = getLuaBoolean(L, 7, true, false);
+        bool compact            = parms->compact;
+
+        /* Create Dispatch (takes ownership of parms) */
+        const char* resultq_name = "ut_atl06_fitperfq";
+        resultq = new Subscriber(resultq_name);
+        dispatch = new Atl06Dispatch(L, resultq_name, parms, num_workers, ordered);
+
+        /* Create Pool of Extents */
+        int num_photons = photons_per_track * RqstParms::NUM_PAIR_TRACKS;
+        int extent_bytes = sizeof(Atl03Reader::extent_t) + (sizeof(Atl03Reader::photon_t) * num_photons);
+        uint32_t seed = 0x2468ACE1;
+        for(long e = 0; e < FIT_PERF_POOL_SIZE; e++)
         {
-            if(a2[i].r != b2[i].r)
+            records[e] = new RecordObject(Atl03Reader::exRecType, extent_bytes);
+            Atl03Reader::extent_t* extent = (Atl03Reader::extent_t*)records[e]->getRecordData();
+            int first_photon = 0;
+            for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
             {
-                mlog(CRITICAL, "Failed sort test02 at: %d", i);
-                tests_passed = false;
-                break;
+                double h0 = (double)(e % 1000);
+                double slope = 0.05 * (double)((e % 7) - 3);
+                extent->valid[t] = true;
+                extent->segment_id[t] = e;
+                extent->segment_distance[t] = e * 20.0;
+                extent->extent_length[t] = 40.0;
+                extent->spacecraft_velocity[t] = 7000.0;
+                extent->background_rate[t] = 4.0e6;
+                extent->photon_count[t] = photons_per_track;
+                extent->photon_offset[t] = first_photon;
+                for(int p = 0; p < photons_per_track; p++)
+                {
+                    Atl03Reader::photon_t* ph = &extent->photons[first_photon + p];
+                    double u[4];
+                    for(int i = 0; i < 4; i++)
+                    {
+                        seed = (seed * 1103515245) + 12345;
+                        u[i] = (double)(seed >> 8) / (double)(1 << 24);
+                    }
+                    double x = u[0] * 40.0;
+                    double noise = (u[1] + u[2] + u[3] - 1.5) * 0.2;
+                    ph->distance = x;
+                    ph->height = (p % 5 == 0) ? h0 + ((u[1] - 0.5) * 30.0) : h0 + (slope * x) + noise; // one in five is background
+                    ph->latitude = 70.0 + (x * 1.0e-5);
+                    ph->longitude = -45.0 + (x * 1.0e-5);
+                    ph->delta_time = e + (x * 1.0e-4);
+                }
+                first_photon += photons_per_track;
             }
+
+            /* Convert to Columnar Extent */
+            if(columnar)
+            {
+                RecordObject* columnar_record = createColumnarExtent(extent, num_photons);
+                delete records[e];
+                records[e] = columnar_record;
+            }
+        }
+
+        /* Process Extents */
+        double start = TimeLib::latchtime();
+        for(long e = 0; e < num_extents; e++)
+        {
+            /* Reference Extent as the Dispatcher Would (pairs of segments arrive swapped) */
+            RecordObject* record = records[e % FIT_PERF_POOL_SIZE];
+            Atl03Reader::extent_t* extent_header = (Atl03Reader::extent_t*)record->getRecordData();
+            extent_header->extent_id = (uint64_t)e << 2;
+            for(int t = 0; t < RqstParms::NUM_PAIR_TRACKS; t++)
+            {
+                extent_header->segment_id[t] = e ^ 1;
+            }
+            unsigned char* buffer;
+            int bufsize = record->serialize(&buffer, RecordObject::REFERENCE);
+            RecordInterface extent(buffer, bufsize);
+
+            /* Run Algorithm */
+            dispatch->processRecord(&extent, 0);
         }
+        dispatch->processTermination();
+        double elapsed = TimeLib::latchtime() - start;
 
-        /* Test 3 */
-        Atl06Dispatch::point_t a3[10] = { {0,9}, {0,8}, {0,1}, {0,7}, {0,6}, {0,3}, {0,5}, {0,4}, {0,2}, {0,0} };
-        Atl06Dispatch::point_t b3[10] = { {0,0}, {0,1}, {0,2}, {0,3}, {0,4}, {0,5}, {0,6}, {0,7}, {0,8}, {0,9} };
-        Atl06Dispatch::quicksort(a3, 0, 9);
-        for(int i = 0; i < 10; i++)
+        /* Checksum Posted Elevations */
+        double checksum = 0.0;
+        bool in_order = true;
+        uint32_t last_segment_id = 0;
+        uint64_t last_extent_id = 0;
+        Subscriber::msgRef_t ref;
+        while(resultq->receiveRef(ref, IO_CHECK) > 0)
         {
-            if(a3[i].r != b3[i].r)
+            if(ref.size > 0)
             {
-                mlog(CRITICAL, "Failed sort test03 at: %d", i);
-                tests_passed = false;
-                break;
+                RecordObject result((unsigned char*)ref.data, ref.size);
+                int elevation_bytes = compact ? sizeof(Atl06Dispatch::elevation_compact_t) : sizeof(Atl06Dispatch::elevation_t);
+                int num_elevations = result.getAllocatedDataSize() / elevation_bytes;
+                for(int i = 0; i < num_elevations; i++)
+                {
+                    if(compact)
+                    {
+                        checksum += ((Atl06Dispatch::atl06_compact_t*)result.getRecordData())->elevation[i].h_mean;
+                    }
+                    else
+                    {
+                        Atl06Dispatch::elevation_t* elevation = &((Atl06Dispatch::atl06_t*)result.getRecordData())->elevation[i];
+                        if( (elevation->segment_id < last_segment_id) ||
+                            (elevation->segment_id == last_segment_id && elevation->extent_id < last_extent_id) )
+                        {
+                            in_order = false;
+                        }
+                        last_segment_id = elevation->segment_id;
+                        last_extent_id = elevation->extent_id;
+                        checksum += elevation->h_mean;
+                    }
+                }
             }
+            resultq->dereference(ref);
         }
 
+        /* Check Order */
+        if(ordered && !in_order)
+        {
+            throw RunTimeException(CRITICAL, RTE_ERROR, "elevations posted out of order");
+        }
+
+        /* Report Results */
+        double rate = num_extents / elapsed;
+        print2term("ATL06 fit: %ld extents of %ld photons per track with %ld workers in %.3lf seconds, %.1lf extents/second, checksum %.9lf\n", num_extents, photons_per_track, num_workers, elapsed, rate, checksum);
+        lua_pushnumber(L, rate);
+        lua_pushnumber(L, checksum);
+
         /* Set Status */
-        status = tests_passed;
+        status = true;
+        num_obj_to_return = 3;
     }
     catch(const RunTimeException& e)
     {
         mlog(e.level(), "Error executing test %s: %s", __FUNCTION__, e.what());
     }
 
+    /* Clean Up */
+    delete dispatch;
+    for(int e = 0; e < FIT_PERF_POOL_SIZE; e++) delete records[e];
+    delete resultq;
+
     /* Return Status */
-    return returnLuaStatus(L, status);
+    return returnLuaStatus(L, status, num_obj_to_return);
 }
@@ -38,6 +38,8 @@
 
 #include "OsApi.h"
 #include "LuaObject.h"
+#include "RecordObject.h"
+#include "Atl03Reader.h"
 
 /******************************************************************************
  * ATL06 DISPATCH UNIT TEST CLASS
@@ -64,6 +66,11 @@ class UT_Atl06Dispatch: public LuaObject
 
     private:
 
+        /*--------------------------------------------------------------------
+         * Constants
+         *--------------------------------------------------------------------*/
+
+        static const int FIT_PERF_POOL_SIZE = 64;
 
         /*--------------------------------------------------------------------
          * Methods
@@ -73,7 +80,10 @@ class UT_Atl06Dispatch: public LuaObject
                         ~UT_Atl06Dispatch       (void);
 
         static int      luaLsfTest              (lua_State* L);
-        static int      luaSortTest             (lua_State* L);
+        static int      luaSelectTest           (lua_State* L);
+        static int      luaFitPerf              (lua_State* L);
+
+        static RecordObject* createColumnarExtent (Atl03Reader::extent_t* extent, int num_photons);
 };
 
 #endif  /* __ut_atl06dispatch__ */
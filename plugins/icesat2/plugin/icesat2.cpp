@@ -116,6 +116,7 @@ int icesat2_open (lua_State *L)
     LuaEngine::setAttrInt(L, "FEATHER",                     RqstParms::OUTPUT_FORMAT_FEATHER);
     LuaEngine::setAttrInt(L, "PARQUET",                     RqstParms::OUTPUT_FORMAT_PARQUET);
     LuaEngine::setAttrInt(L, "CVS",                         RqstParms::OUTPUT_FORMAT_CSV);
+    LuaEngine::setAttrInt(L, "ARROW",                       RqstParms::OUTPUT_FORMAT_ARROW);
 
     return 1;
 }
@@ -132,6 +133,7 @@ void initicesat2 (void)
     Atl03Reader::init();
     Atl03Indexer::init();
     Atl06Dispatch::init();
+    EndpointProxy::init();
     RasterSampler::init();
 
     /* Register Cumulus IO Driver */
@@ -149,5 +151,8 @@ void initicesat2 (void)
 
 void deiniticesat2 (void)
 {
+    Atl06Dispatch::deinit();
+    EndpointProxy::deinit();
+    PluginMetrics::deinit();
 }
 }
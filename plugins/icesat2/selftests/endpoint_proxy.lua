@@ -0,0 +1,146 @@
+local runner = require("test_executive")
+local console = require("console")
+local json = require("json")
+local td = runner.rootdir(runner.srcscript(true):sub(2))
+
+-- Setup --
+--
+--  in-process nodes fanned out to by the proxy through a static node list:
+--      good node       - streams the response of the example stream endpoint
+--      broken node     - refuses every streamed request as unavailable (503)
+--      dead node       - nothing is listening on the port
+--      black hole node - accepts connections but never responds
+--
+--  and a mock orchestrator, run out of process, which also serves as a node
+--  that rejects every request with a client error (404)
+
+local good_node = "http://127.0.0.1:9091"
+local broken_node = "http://127.0.0.1:9092"
+local dead_node = "http://127.0.0.1:9093"
+local black_hole_node = "http://127.0.0.1:9094"
+local orchestrator_port = 9095
+local orchestrator = string.format("http://127.0.0.1:%d", orchestrator_port)
+
+local good_endpoint = core.endpoint()
+local good_server = core.httpd(9091):attach(good_endpoint, "/source"):untilup()
+local broken_endpoint = core.endpoint(1.0, 0.0) -- no memory available for streamed requests
+local broken_server = core.httpd(9092):attach(broken_endpoint, "/source"):untilup()
+local black_hole = core.tcp("127.0.0.1", 9094, core.SERVER)
+
+local default_orchestrator = netsvc.orchurl()
+os.execute(string.format("python3 %smock_orchestrator.py %d %s,%s &", td, orchestrator_port, broken_node, good_node))
+netsvc.orchurl(orchestrator)
+local orchestrator_up = false
+for _ = 1, 50 do
+    orchestrator_up = netsvc.orchhealth()
+    if orchestrator_up then break end
+    sys.wait(0.2)
+end
+runner.check(orchestrator_up, "failed to start mock orchestrator")
+
+local count = 4 -- messages per resource
+local size = 32 -- bytes per message
+local parms = json.encode({count=count, size=size})
+local data = string.rep("x", size)
+
+-- makes a request to the mock orchestrator, which closes each connection after responding
+local function orchestrate (verb, resource)
+    local client = core.http("127.0.0.1", orchestrator_port)
+    local rsps = client:request(verb, resource, "{}")
+    client:destroy()
+    return rsps
+end
+
+-- runs the resources through a proxy and tallies what is streamed back until the proxy completes
+local function proxy (name, nodes, num_resources, num_threads, timeout, num_failures)
+    num_failures = num_failures or 0
+    local resources = {}
+    for i = 1, num_resources do
+        resources[i] = string.format("resource_%d", i)
+    end
+
+    local outq = "proxy_" .. name
+    local rspq = msg.subscribe(outq)
+    local start = time.latch()
+    local endpoint_proxy = icesat2.proxy("example_stream_endpoint", "none", resources, parms, timeout, outq, true, num_threads, nil, nodes)
+
+    local results = {messages=0, succeeded=0, failed=0, complete=false}
+    while (time.latch() - start) < 60 do
+        local complete = endpoint_proxy:waiton(0) ~= nil
+        local rsps = rspq:recvstring(1000) -- terminator is also returned as nil
+        if rsps == data then
+            results.messages = results.messages + 1
+        elseif rsps and string.find(rsps, "Successfully completed", 1, true) then
+            results.succeeded = results.succeeded + 1
+        elseif rsps and string.find(rsps, "Failed to complete", 1, true) then
+            results.failed = results.failed + 1
+        elseif not rsps and complete then
+            results.complete = true
+            break
+        end
+    end
+    results.duration = time.latch() - start
+
+    endpoint_proxy:destroy()
+    rspq:destroy()
+
+    runner.check(results.complete, "proxy failed to complete")
+    runner.check(results.succeeded == num_resources - num_failures, string.format("expected %d resources to succeed, got %d", num_resources - num_failures, results.succeeded))
+    runner.check(results.failed == num_failures, string.format("expected %d resources to fail, got %d", num_failures, results.failed))
+    runner.check(results.messages == (num_resources - num_failures) * count, string.format("expected each resource to be streamed once (%d messages), got %d", (num_resources - num_failures) * count, results.messages))
+    return results
+end
+
+-- Unit Test --
+
+print('\n------------------\nTest01: Pooled Connections\n------------------')
+
+-- each proxy thread keeps reusing its connection to the node
+local m0 = sys.metric("EndpointProxy")
+proxy("pooled", {good_node}, 16, 4, 30)
+local m1 = sys.metric("EndpointProxy")
+local created = m1["EndpointProxy.connections_created"].value - m0["EndpointProxy.connections_created"].value
+local reused = m1["EndpointProxy.connections_reused"].value - m0["EndpointProxy.connections_reused"].value
+runner.check(created <= 4, string.format("expected at most one connection per proxy thread, created %d", created))
+runner.check(created + reused == 16, string.format("expected a connection to be checked out per resource, got %d", created + reused))
+
+print('\n------------------\nTest02: Failover From Error Responses\n------------------')
+
+proxy("broken", {good_node, broken_node}, 8, 4, 30)
+
+print('\n------------------\nTest03: Failover From Unreachable Node\n------------------')
+
+proxy("dead", {dead_node, good_node}, 8, 4, 30)
+
+print('\n------------------\nTest04: Hedged Stragglers\n------------------')
+
+local hedged = proxy("hedged", {good_node, black_hole_node}, 4, 8, 60)
+runner.check(hedged.duration < 30, string.format("failed to hedge stragglers, took %.1f seconds", hedged.duration))
+
+print('\n------------------\nTest05: Client Errors Not Retried\n------------------')
+
+-- nodes are handed out round robin, so every other resource goes to the rejecting node
+proxy("rejected", {orchestrator, good_node}, 4, 1, 30, 2)
+
+print('\n------------------\nTest06: Orchestrated Nodes\n------------------')
+
+if orchestrator_up then
+    proxy("orchestrated", nil, 8, 4, 30)
+    local status = json.decode(orchestrate("GET", "/discovery/status"))
+    runner.check(status["locked"] > 8, string.format("expected nodes to be locked through the orchestrator, got %d", status["locked"]))
+    runner.check(status["outstanding"] == 0, string.format("expected every locked node to be unlocked, %d still locked", status["outstanding"]))
+    runner.check(status["failed"] == 0, string.format("expected every unlock to match a lock, %d did not", status["failed"]))
+end
+
+-- Clean Up --
+
+orchestrate("POST", "/discovery/shutdown")
+netsvc.orchurl(default_orchestrator)
+
+good_server:destroy()
+broken_server:destroy()
+black_hole:destroy()
+
+-- Report Results --
+
+runner.report()
@@ -0,0 +1,91 @@
+# python
+#
+# Stand-in for the orchestrator's /discovery API used by the endpoint proxy
+# self test; members are locked round robin and every transaction is tracked
+# so that the test can check that each lock was unlocked; any other request
+# is rejected with a 404, which lets the mock also stand in for a node that
+# rejects requests with a client error.
+#
+#   python3 mock_orchestrator.py <port> <member>[,<member>...]
+
+import sys
+import json
+import threading
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+###############################################################################
+# GLOBALS
+###############################################################################
+
+members = []
+next_member = 0
+next_transaction = 1
+outstanding = {}
+stats = {"locked": 0, "unlocked": 0, "failed": 0}
+mutex = threading.Lock()
+
+###############################################################################
+# REQUEST HANDLER
+###############################################################################
+
+class Handler(BaseHTTPRequestHandler):
+
+    def reply(self, rsps):
+        body = json.dumps(rsps).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def do_GET(self):
+        if self.path == "/discovery/health":
+            self.reply({"health": True})
+        elif self.path == "/discovery/status":
+            with mutex:
+                self.reply(dict(stats, outstanding=len(outstanding)))
+        else:
+            self.send_error(404)
+
+    def do_POST(self):
+        global next_member, next_transaction
+        length = int(self.headers.get("Content-Length", 0))
+        rqst = json.loads(self.rfile.read(length) or "{}")
+        if self.path == "/discovery/lock":
+            rsps = {"members": [], "transactions": []}
+            with mutex:
+                for _ in range(rqst["nodesNeeded"]):
+                    rsps["members"].append(members[next_member])
+                    rsps["transactions"].append(next_transaction)
+                    outstanding[next_transaction] = members[next_member]
+                    next_member = (next_member + 1) % len(members)
+                    next_transaction += 1
+                    stats["locked"] += 1
+            self.reply(rsps)
+        elif self.path == "/discovery/unlock":
+            complete = 0
+            with mutex:
+                for transaction in rqst["transactions"]:
+                    if outstanding.pop(transaction, None) is not None:
+                        complete += 1
+                stats["unlocked"] += complete
+                stats["failed"] += len(rqst["transactions"]) - complete
+            self.reply({"complete": complete, "fail": len(rqst["transactions"]) - complete})
+        elif self.path == "/discovery/shutdown":
+            self.reply({})
+            threading.Thread(target=self.server.shutdown).start()
+        else:
+            self.send_error(404)
+
+    def log_message(self, format, *args):
+        pass
+
+###############################################################################
+# MAIN
+###############################################################################
+
+if __name__ == '__main__':
+
+    port = int(sys.argv[1])
+    members = sys.argv[2].split(",")
+    ThreadingHTTPServer(("127.0.0.1", port), Handler).serve_forever()
@@ -12,7 +12,26 @@ print('\n------------------\nTest01\n------------------')
 runner.check(atl06_dispatch:lsftest(), "Failed lsftest")
 
 print('\n------------------\nTest02\n------------------')
-runner.check(atl06_dispatch:sorttest(), "Failed sorttest")
+runner.check(atl06_dispatch:selecttest(), "Failed selecttest")
+
+print('\n------------------\nTest03\n------------------')
+local _, inline_checksum = atl06_dispatch:fitperf(icesat2.parms({}), 200, 100)
+local rate, ordered_checksum = atl06_dispatch:fitperf(icesat2.parms({}), 200, 100, 4, true)
+runner.check(rate, "Failed ordered fit with workers")
+runner.check(ordered_checksum and math.abs(ordered_checksum - inline_checksum) < 0.000001, "Failed to match inline fit")
+
+print('\n------------------\nTest04\n------------------')
+local _, columnar_checksum = atl06_dispatch:fitperf(icesat2.parms({}), 200, 100, 0, false, true)
+runner.check(columnar_checksum and math.abs(columnar_checksum - inline_checksum) < 0.000001, "Failed to match fit of columnar extents")
+
+print('\n------------------\nTest05\n------------------')
+runner.check(atl03_reader:yapcperf(3, 100, 100), "Failed to match reference YAPC v3 scores")
+runner.check(atl03_reader:yapcperf(3, 100, 100, true), "Failed to match reference YAPC v3 scores of unsorted photons")
+runner.check(atl03_reader:yapcperf(2, 100, 100), "Failed to match reference YAPC v2 scores")
+
+print('\n------------------\nTest06\n------------------')
+runner.check(atl03_reader:polyperf(2000, 20000), "Failed to match polygon inclusion of reference")
+runner.check(atl03_reader:polyperf(5, 20000), "Failed to match polygon inclusion of reference for small polygon")
 
 -- Clean Up --
 
@@ -32,6 +32,15 @@ local response, status = aws.s3read(test_bucket, string.format("%s/%s", test_pat
 runner.check(status == true, "failed to read file: "..test_file)
 runner.check(response == "Shakespeare")
 
+-- TEST #4: pooled handles reused across range reads
+local reused_before = sys.metric("s3")["s3.handles_reused"].value
+for i = 1, 4 do
+    response, status = aws.s3read(test_bucket, string.format("%s/%s", test_path, test_file), 11, 261, nil, nil)
+    runner.check(status == true and response == "Shakespeare", "failed pooled read of file: "..test_file)
+end
+local reused_after = sys.metric("s3")["s3.handles_reused"].value
+runner.check(reused_after - reused_before >= 4, string.format("failed to reuse handles: %d", reused_after - reused_before))
+
 -- Clean Up --
 
 os.remove(test_file)
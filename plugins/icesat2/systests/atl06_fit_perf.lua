@@ -0,0 +1,67 @@
+local console = require("console")
+
+-- Usage: sliderule atl06_fit_perf.lua [<results file>] [<photons per track> <extents> ...]
+--
+--  measures the rate at which the ATL06 algorithm processes extents, using the
+--  synthetic extents generated by the ATL06 dispatch unit test; the checksum of
+--  the resulting heights is reported alongside so that changes to the fitter
+--  can be checked for matching results:
+--
+--      sliderule atl06_fit_perf.lua atl06_fit_perf.csv
+--
+--  when a results file is supplied, a line per extent size and worker
+--  configuration is appended to it; zero workers fits the extents inline
+
+local results_file = arg[1]
+
+-- Extent Sizes --
+
+local sizes = {
+    {photons=100,   extents=20000},
+    {photons=400,   extents=5000},
+    {photons=2000,  extents=1000},
+    {photons=10000, extents=200},
+}
+
+if arg[2] then
+    sizes = {}
+    local i = 2
+    while arg[i] and arg[i+1] do
+        table.insert(sizes, {photons=tonumber(arg[i]), extents=tonumber(arg[i+1])})
+        i = i + 2
+    end
+end
+
+-- Worker Configurations --
+
+local configs = {
+    {workers=0, ordered=false},
+    {workers=4, ordered=false},
+    {workers=4, ordered=true},
+}
+
+-- Run Trials --
+
+local ut = icesat2.ut_atl06()
+local results = results_file and io.open(results_file, "a")
+
+print(string.format("\n%-18s %10s %8s %8s %16s %24s", "photons/track", "extents", "workers", "ordered", "extents/second", "checksum"))
+
+for _,size in ipairs(sizes) do
+    for _,config in ipairs(configs) do
+        local parms = icesat2.parms({})
+        local rate, checksum = ut:fitperf(parms, size.extents, size.photons, config.workers, config.ordered)
+        if rate then
+            print(string.format("%-18d %10d %8d %8s %16.1f %24.9f", size.photons, size.extents, config.workers, tostring(config.ordered), rate, checksum))
+            if results then
+                results:write(string.format("%d,%d,%d,%d,%s,%.1f,%.9f\n", os.time(), size.photons, size.extents, config.workers, tostring(config.ordered), rate, checksum))
+            end
+        else
+            print(string.format("%-18d %10d %8d %8s %16s", size.photons, size.extents, config.workers, tostring(config.ordered), "failed"))
+        end
+    end
+end
+
+if results then results:close() end
+
+sys.quit()
@@ -0,0 +1,57 @@
+local console = require("console")
+
+-- Usage: sliderule yapc_perf.lua [<results file>] [<photons per segment> <segments> ...]
+--
+--  measures the rate at which the YAPC photon classifier scores a synthetic
+--  dense track, for the reader's implementation and for the reference
+--  implementation held by the ATL03 reader unit test; a trial fails unless
+--  the scores of the two match photon for photon:
+--
+--      sliderule yapc_perf.lua yapc_perf.csv
+--
+--  when a results file is supplied, a line per version and density is
+--  appended to it
+
+local results_file = arg[1]
+
+-- Track Densities --
+
+local sizes = {
+    {photons=50,    segments=2000},
+    {photons=200,   segments=500},
+    {photons=1000,  segments=100},
+}
+
+if arg[2] then
+    sizes = {}
+    local i = 2
+    while arg[i] and arg[i+1] do
+        table.insert(sizes, {photons=tonumber(arg[i]), segments=tonumber(arg[i+1])})
+        i = i + 2
+    end
+end
+
+-- Run Trials --
+
+local ut = icesat2.ut_atl03()
+local results = results_file and io.open(results_file, "a")
+
+print(string.format("\n%-8s %20s %10s %18s %18s", "version", "photons/segment", "segments", "photons/second", "reference"))
+
+for _,version in ipairs({3, 2}) do
+    for _,size in ipairs(sizes) do
+        local rate, reference_rate = ut:yapcperf(version, size.segments, size.photons)
+        if rate then
+            print(string.format("%-8d %20d %10d %18.0f %18.0f", version, size.photons, size.segments, rate, reference_rate))
+            if results then
+                results:write(string.format("%d,%d,%d,%d,%.0f,%.0f\n", os.time(), version, size.photons, size.segments, rate, reference_rate))
+            end
+        else
+            print(string.format("%-8d %20d %10d %18s", version, size.photons, size.segments, "failed"))
+        end
+    end
+end
+
+if results then results:close() end
+
+sys.quit()
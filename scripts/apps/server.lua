@@ -48,6 +48,8 @@ local register_as_service       = cfgtbl["register_as_service"] -- nil is false
 local asset_directory           = cfgtbl["asset_directory"] or __confdir.."/asset_directory.csv"
 local normal_mem_thresh         = cfgtbl["normal_mem_thresh"] or 1.0
 local stream_mem_thresh         = cfgtbl["stream_mem_thresh"] or 0.75
+local max_requests              = cfgtbl["max_requests"] -- nil is the endpoint default
+local fanout_endpoints          = cfgtbl["fanout_endpoints"] or {"atl03sp", "atl06p"}
 local msgq_depth                = cfgtbl["msgq_depth"] or 10000
 local environment_version       = cfgtbl["environment_version"] or os.getenv("ENVIRONMENT_VERSION") or "unknown"
 local orchestrator_url          = cfgtbl["orchestrator"] or os.getenv("ORCHESTRATOR")
@@ -96,7 +98,7 @@ end
 --------------------------------------------------
 
 -- Configure Application Endpoints --
-local source_endpoint = core.endpoint(normal_mem_thresh, stream_mem_thresh):name("SourceEndpoint")
+local source_endpoint = core.endpoint(normal_mem_thresh, stream_mem_thresh, core.INFO, max_requests):name("SourceEndpoint")
 for _,script in ipairs(available_scripts()) do
     local s = script:find(".lua")
     if s then
@@ -104,6 +106,9 @@ for _,script in ipairs(available_scripts()) do
         source_endpoint:metric(metric_name)
     end
 end
+for _,endpoint_name in ipairs(fanout_endpoints) do
+    source_endpoint:fanout(endpoint_name) -- proxies back to the cluster, serviced by its own pool
+end
 
 -- Configure Provisioning System Authentication --
 netsvc.psurl(ps_url)
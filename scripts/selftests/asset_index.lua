@@ -103,6 +103,23 @@ local r5 = i8:query({lat0=-83.2, lon0=45.0, lat1=-73.2, lon1=55.0})
 local e5 = { 1, 4, 7, 10, 13, 14, 17, 18, 21, 22, 25, 26, 29, 30, 33, 34, 37, 38, 41, 42, 45}
 check_query(r5, e5)
 
+print('\n------------------\nTest09: Vectored Read\n------------------\n')
+local a9 = core.asset("local", "file", td, "empty.index")
+local f9 = assert(io.open(td .. "/english_words.txt", "rb"))
+local contents = f9:read("a")
+f9:close()
+local len = #contents
+-- contiguous extents are read together, the last one runs past the end of the file
+local extents = {{0, 16}, {16, 4096}, {100000, 0x10000}, {100000 + 0x10000, 1}, {len - 8, 32}}
+local r9 = a9:read("english_words.txt", extents)
+runner.check(r9 and #r9 == #extents, "failed to read extents")
+for i,e in ipairs(extents) do
+    local expected = string.sub(contents, e[1] + 1, math.min(e[1] + e[2], len))
+    runner.check(r9[i] == expected, string.format("extent %d mismatch: %d bytes read, %d expected", i, #r9[i], #expected))
+end
+runner.check(a9:read("missing.txt", {{0, 16}}) == nil, "read a missing resource")
+a9:destroy()
+
 -- Clean Up --
 
 -- Report Results --
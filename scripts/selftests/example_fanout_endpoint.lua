@@ -0,0 +1,23 @@
+--
+-- INPUT: `arg` array with only 1 string element
+--        'rspq' string containing name of message queue for output
+-- OUTPUT: response of the proxied request posted to the rspq
+--
+-- NOTES
+--  1. The input is a json object of the form {"port": <port of server>, "resource": <resource to request>}
+--  2. The request is made back to the server while this request is still
+--     being serviced, the same way a proxy endpoint fans out to the cluster
+--  3. Used to test that fan-out requests do not starve the requests they make
+--
+
+local json = require("json")
+local parm = json.decode(arg[1])
+local outp = msg.publish(rspq)
+
+local client = core.http("127.0.0.1", parm["port"])
+local result = client:request("GET", parm["resource"], "{}")
+client:destroy()
+
+outp:sendstring(result or "")
+
+return
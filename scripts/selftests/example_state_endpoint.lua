@@ -0,0 +1,14 @@
+--
+-- INPUT: `arg` array with only 1 string element
+-- OUTPUT: return string
+--
+-- NOTES
+--  1. Counts the number of times it has been run by the same lua state in
+--     a global variable; the endpoint resets the globals between requests
+--     so the count returned is always 1
+--  2. Used to test that requests do not see each other's globals
+--
+
+visits = (visits or 0) + 1
+
+return string.format("{ \"visits\": %d }", visits)
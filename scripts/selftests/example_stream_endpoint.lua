@@ -0,0 +1,26 @@
+--
+-- INPUT: `arg` array with only 1 string element
+--        'rspq' string containing name of message queue for output
+-- OUTPUT: binary data posted to the rspq
+--
+-- NOTES
+--  1. The input is a json object of the form {"count": <number of messages>, "size": <bytes per message>}
+--  2. Each message is streamed back as its own chunk, so the response is count * size bytes of data
+--  3. Used to test and measure streaming from the http server
+--  4. Requests fanned out by a proxy carry the json object under "parms"
+--
+
+local json = require("json")
+local rqst = json.decode(arg[1])
+local parm = rqst["parms"] or rqst
+local outp = msg.publish(rspq)
+
+local count = parm["count"] or 1
+local size = parm["size"] or 1
+local data = string.rep("x", size)
+
+for i = 1, count do
+    outp:sendstring(data)
+end
+
+return
@@ -57,6 +57,29 @@ pixelIn = robj:pixel(rows-1, cols-1)
 print("pixel out of raster check:", pixelIn)
 runner.check(pixelIn == false)
 
+print('\n------------------\nTest06: subset\n------------------')
+local lons = {}
+local lats = {}
+local steps = 50
+for i = 0, steps do
+    for j = 0, steps do
+        table.insert(lons, (lon_min - cellsize) + ((lon_max - lon_min + (2 * cellsize)) * i / steps))
+        table.insert(lats, (lat_min - cellsize) + ((lat_max - lat_min + (2 * cellsize)) * j / steps))
+    end
+end
+local mask, num_in = robj:subset(lons, lats)
+local matches = 0
+local single_in = 0
+for k = 1, #lons do
+    local included = robj:subset(lons[k], lats[k]) ~= nil
+    if included then single_in = single_in + 1 end
+    if included == mask[k] then matches = matches + 1 end
+end
+print(string.format("subset: %d of %d coordinates included", num_in, #lons))
+runner.check(num_in > 0 and num_in < #lons)
+runner.check(num_in == single_in)
+runner.check(matches == #lons)
+
 
 -- Clean Up --
 
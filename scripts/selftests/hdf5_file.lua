@@ -4,6 +4,19 @@ local td = runner.rootdir(arg[0])
 
 asset = core.asset("local", "file", td, "empty.index")
 
+-- checks the integers of column 2 of DS1 in an h5file record (-2, 0, 2, ...)
+local function check_ds1 (rec)
+    local elements = rec:getvalue("elements")
+    runner.check(elements == 32, string.format("unexpected number of elements: %d", elements))
+    local exp_val = -2
+    for i = 0, elements - 1 do
+        local b = i * 4
+        local val = string.unpack("i", string.char(rec:getvalue("data["..b.."]"), rec:getvalue("data["..(b+1).."]"), rec:getvalue("data["..(b+2).."]"), rec:getvalue("data["..(b+3).."]")))
+        runner.check(val == exp_val, string.format("unexpected value, %d != %d", val, exp_val))
+        exp_val = exp_val + 2
+    end
+end
+
 -- Unit Test --
 
 print('\n------------------\nTest01: File\n------------------')
@@ -90,6 +103,228 @@ end
 f:close()
 os.remove(h5_file)
 
+print('\n------------------\nTest05: Read Dataset with Chunk Workers\n------------------')
+
+local jobs_before = sys.metric("h5")["h5.chunk_jobs"].value
+f5 = h5.file(asset, "h5ex_d_gzip.h5", 4)
+rsps5 = msg.subscribe("h5testq")
+f5:read({{dataset="DS1", col=2}}, "h5testq")
+recdata = rsps5:recvrecord(3000)
+check_ds1(recdata)
+local jobs_after = sys.metric("h5")["h5.chunk_jobs"].value
+runner.check(jobs_after > jobs_before, "chunk workers did not read any chunks")
+
+rsps5:destroy()
+f5:destroy()
+
+print('\n------------------\nTest06: Read Dataset through Shared Block Cache\n------------------')
+
+h5.cache(0x4000000)
+local hits_before = sys.metric("h5")["h5.cache_hits"].value
+
+for trial = 1, 2 do
+    local f6 = h5.file(asset, "h5ex_d_gzip.h5")
+    local rsps6 = msg.subscribe("h5testq")
+    f6:read({{dataset="DS1", col=2}}, "h5testq")
+    recdata = rsps6:recvrecord(3000)
+    check_ds1(recdata)
+
+    rsps6:destroy()
+    f6:destroy()
+end
+
+local hits_after = sys.metric("h5")["h5.cache_hits"].value
+runner.check(hits_after > hits_before, "second read did not hit in block cache")
+
+local max_bytes, bytes_in_use = h5.cache(0)
+runner.check(max_bytes == 0, "failed to disable block cache")
+runner.check(bytes_in_use == 0, string.format("block cache not flushed: %d", bytes_in_use))
+
+print('\n------------------\nTest07: Warm Up Metadata\n------------------')
+
+f7 = h5.file(asset, "h5ex_d_gzip.h5")
+local warmed = f7:warmup({"/DS1", "DS1", "/missing"})
+runner.check(warmed == 2, string.format("unexpected number of datasets warmed up: %d", warmed))
+f7:destroy()
+
+-- Snapshot Metadata --
+
+print('\n------------------\nTest08: Snapshot Metadata\n------------------')
+
+local snapshot_dir = os.tmpname()
+os.remove(snapshot_dir)
+os.execute("mkdir -p " .. snapshot_dir)
+runner.check(h5.snapshots(snapshot_dir) == snapshot_dir, "failed to set snapshot directory")
+
+f8 = h5.file(asset, "h5ex_d_gzip.h5")
+local saved = f8:snapshot({"/DS1", "/missing"})
+runner.check(saved == 1, string.format("unexpected number of datasets saved: %d", saved))
+
+-- empty the meta repository so the read has to restore the metadata from the sidecar
+local restores_before = sys.metric("h5")["h5.snapshot_restores"].value
+h5.clear()
+local rsps8 = msg.subscribe("h5testq")
+f8:read({{dataset="/DS1", col=2}}, "h5testq")
+recdata = rsps8:recvrecord(3000)
+runner.check(recdata ~= nil, "failed to read dataset after snapshot")
+if recdata then check_ds1(recdata) end
+local restores_after = sys.metric("h5")["h5.snapshot_restores"].value
+runner.check(restores_after == restores_before + 1, string.format("metadata not restored from snapshot: %d", restores_after - restores_before))
+rsps8:destroy()
+f8:destroy()
+
+runner.check(h5.snapshots("") == nil, "failed to disable snapshots")
+os.execute("rm -rf " .. snapshot_dir)
+
+-- Read Column as Doubles --
+
+print('\n------------------\nTest09: Read Column as Doubles\n------------------')
+
+f9 = h5.file(asset, "h5ex_d_gzip.h5")
+local rsps9 = msg.subscribe("h5testq")
+f9:read({{dataset="DS1", col=2, valtype=core.REAL}}, "h5testq")
+recdata = rsps9:recvrecord(3000)
+
+local elements = recdata:getvalue("elements")
+runner.check(elements == 32, string.format("unexpected number of elements: %d", elements))
+runner.check(recdata:getvalue("size") == 32 * 8, string.format("unexpected size: %d", recdata:getvalue("size")))
+
+exp_val = -2
+for i = 0, elements - 1 do
+    local bytes = {}
+    for b = 0, 7 do
+        bytes[b + 1] = string.char(recdata:getvalue("data["..((i * 8) + b).."]"))
+    end
+    local val = string.unpack("d", table.concat(bytes))
+    runner.check(val == exp_val, string.format("unexpected value, %f != %d", val, exp_val))
+    exp_val = exp_val + 2
+end
+
+rsps9:destroy()
+f9:destroy()
+
+-- Read into Record Buffer --
+
+print('\n------------------\nTest11: Read into Caller Buffer\n------------------')
+
+local f11 = h5.file(asset, "h5ex_d_gzip.h5")
+local rsps11 = msg.subscribe("h5testq")
+
+-- column gathered into a record sized by the caller
+f11:read({{dataset="DS1", col=2, size=32 * 4}}, "h5testq")
+recdata = rsps11:recvrecord(3000)
+runner.check(recdata ~= nil, "failed to read column into caller buffer")
+if recdata then check_ds1(recdata) end
+rsps11:recvstring(3000) -- terminator
+
+-- whole dataset read directly into a record sized by the caller, with room to spare
+f11:read({{dataset="DS1", col=h5.ALL_COLS, size=(32 * 64 * 4) + 100}}, "h5testq")
+recdata = rsps11:recvrecord(3000)
+runner.check(recdata ~= nil, "failed to read dataset into caller buffer")
+if recdata then
+    runner.check(recdata:getvalue("elements") == 32 * 64, string.format("unexpected number of elements: %d", recdata:getvalue("elements")))
+    runner.check(recdata:getvalue("size") == 32 * 64 * 4, string.format("unexpected size: %d", recdata:getvalue("size")))
+    for _,ij in ipairs({{0, 0}, {1, 63}, {17, 5}, {31, 63}}) do
+        local b = ((ij[1] * 64) + ij[2]) * 4
+        local val = string.unpack("i", string.char(recdata:getvalue("data["..b.."]"), recdata:getvalue("data["..(b+1).."]"), recdata:getvalue("data["..(b+2).."]"), recdata:getvalue("data["..(b+3).."]")))
+        local exp = (ij[1] * ij[2]) - ij[2]
+        runner.check(val == exp, string.format("unexpected value at [%d][%d], %d != %d", ij[1], ij[2], val, exp))
+    end
+end
+rsps11:recvstring(3000) -- terminator
+
+-- buffers too small for the column and for the whole dataset fail the read
+for _,rqst in ipairs({{dataset="DS1", col=2, size=(32 * 4) - 1}, {dataset="DS1", col=h5.ALL_COLS, size=1024}}) do
+    f11:read({rqst}, "h5testq")
+    local rsps = rsps11:recvstring(3000)
+    runner.check(rsps == nil, "read succeeded into a buffer that is too small")
+end
+
+rsps11:destroy()
+f11:destroy()
+
+-- Coalesce Chunk Reads --
+
+print('\n------------------\nTest10: Coalesce Chunk Reads\n------------------')
+
+local function coalesce (gap, workers, inflight)
+    local f10 = h5.file(asset, "h5ex_d_gzip.h5", workers or 0, gap, inflight)
+    local rsps10 = msg.subscribe("h5testq")
+    f10:read({{dataset="DS1", col=2}}, "h5testq")
+    recdata = rsps10:recvrecord(3000)
+    check_ds1(recdata)
+    local stats = f10:stats()
+    rsps10:destroy()
+    f10:destroy()
+    return stats
+end
+
+local off = coalesce(0)
+print(string.format("off: requests=%d, merged=%d, overread=%d", off.range_requests, off.range_merged, off.range_overread))
+runner.check(off.range_requests == 0 and off.range_merged == 0 and off.range_overread == 0, "coalesced reads when disabled")
+
+-- DS1 is stored as 64 compressed chunks written back to back, so any gap merges them into one read
+for _,gap in ipairs({1, 0x100000}) do
+    local on = coalesce(gap)
+    print(string.format("gap %d: requests=%d, merged=%d, overread=%d", gap, on.range_requests, on.range_merged, on.range_overread))
+    runner.check(on.range_requests + on.range_merged == 64, string.format("not every chunk was planned: %d", on.range_requests + on.range_merged))
+    runner.check(on.range_requests == 1, string.format("neighboring chunks not merged: %d requests", on.range_requests))
+    runner.check(on.range_overread == 0, string.format("read through a gap between adjacent chunks: %d", on.range_overread))
+end
+
+-- a window too small for any two chunks reads (and inflates) each chunk on its own
+for _,workers in ipairs({0, 4}) do
+    local windowed = coalesce(0x100000, workers, 1)
+    print(string.format("windowed with %d workers: requests=%d, merged=%d", workers, windowed.range_requests, windowed.range_merged))
+    runner.check(windowed.range_requests == 64 and windowed.range_merged == 0, string.format("reads not bounded by window: %d requests", windowed.range_requests))
+end
+
+print('\n------------------\nTest12: Unshuffle Filtered Datasets\n------------------')
+
+-- h5ex_d_shuffle.h5 holds 1000 element datasets compressed with the shuffle
+-- and deflate filters; the chunk sizes leave element counts that are not
+-- multiples of the 16 elements unshuffled per vector iteration, and reading
+-- from an unaligned start row unshuffles from the middle of a chunk, so the
+-- vectorized kernels and the scalar loops that finish them are both checked
+-- against the element values the dataset was written with
+local shuffled = {
+    {dataset="/DS8",  fmt="B",  value=function(i) return (i // 8) % 256 end},
+    {dataset="/DS16", fmt="i2", value=function(i) return (i * 7) - 3000 end},
+    {dataset="/DS32", fmt="i4", value=function(i) return (i * i) - 5000 end},
+    {dataset="/DS64", fmt="d",  value=function(i) return (i * 0.5) - 100 end},
+}
+
+local f12 = h5.file(asset, "h5ex_d_shuffle.h5")
+
+local function unshuffled (ds, startrow, numrows)
+    local rsps12 = msg.subscribe("h5testq")
+    f12:read({{dataset=ds.dataset, startrow=startrow, numrows=numrows}}, "h5testq")
+    local rec = rsps12:recvrecord(3000)
+    rsps12:destroy()
+
+    local size = string.packsize(ds.fmt)
+    runner.check(rec and rec:getvalue("size") == numrows * size, string.format("failed to read %d rows of %s", numrows, ds.dataset))
+    if not rec then return end
+    local bytes = {}
+    for b = 0, rec:getvalue("size") - 1 do
+        bytes[b + 1] = string.char(rec:getvalue("data["..b.."]"))
+    end
+    local data = table.concat(bytes)
+    local errors = 0
+    for i = 0, (#data // size) - 1 do
+        local val = string.unpack(ds.fmt, data, (i * size) + 1)
+        if val ~= ds.value(startrow + i) then errors = errors + 1 end
+    end
+    runner.check(errors == 0, string.format("%d values of %s were not unshuffled from row %d", errors, ds.dataset, startrow))
+end
+
+for _,ds in ipairs(shuffled) do
+    unshuffled(ds, 0, 1000)
+    unshuffled(ds, 37, 500)
+end
+
+f12:destroy()
+
 -- Report Results --
 
 runner.report()
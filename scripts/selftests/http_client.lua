@@ -42,9 +42,38 @@ print(rsps)
 rsps_table = json.decode(rsps)
 runner.check(rsps_table["healthy"] == true)
 
--- Clean Up --
+print('\n------------------\nTest04: Keep Alive Stream\n------------------')
+
+rspq = msg.subscribe("httpclientq")
+for i = 1, 2 do
+    runner.check(client:request("POST", "/source/example_stream_endpoint", '{"count": 3, "size": 16}', "httpclientq"), "failed to issue streamed request")
+    for j = 1, 3 do
+        chunk = rspq:recvstring(3000)
+        runner.check(chunk == string.rep("x", 16), string.format("failed to receive chunk %d of streamed request %d", j, i))
+    end
+end
+sys.wait(1) -- let the last chunk be consumed
+runner.check(client:connected(), "failed to keep connection alive")
+
+print('\n------------------\nTest05: Error Code\n------------------')
+
+local error_endpoint = core.endpoint(0.0) -- no memory available for normal requests
+local error_server = core.httpd(9082):attach(error_endpoint, "/source"):untilup()
+local error_client = core.http("127.0.0.1", 9082)
+rsps, code, status = error_client:request("GET", "/source/version", "{}")
+runner.check(code == 503, string.format("expected error code returned by server, got %s", tostring(code)))
+runner.check(not status)
+error_client:destroy()
+error_server:destroy()
+
+print('\n------------------\nTest06: Closed Connection\n------------------')
 
 server:destroy()
+sys.wait(1)
+runner.check(not client:connected(), "failed to detect connection closed by server")
+
+-- Clean Up --
+
 client:destroy()
 
 -- Report Results --
@@ -39,8 +39,74 @@ result = f:read()
 f:close()
 runner.check(result == "{ \"result\": \"Hello World\" }")
 
+print('\n------------------\nTest03: Large Stream\n------------------')
+os.execute(string.format("curl -sS -X POST -d '{\"count\": 2000, \"size\": 1000}' http://127.0.0.1:9081/source/example_stream_endpoint > %s", tmpfile))
+f = io.open(tmpfile)
+size = f:seek("end")
+f:close()
+runner.check(size == 2000000, "size="..tostring(size))
+
+print('\n------------------\nTest04: Concurrent Streams\n------------------')
+local curl_cmd = ""
+for i = 1, 16 do
+    curl_cmd = curl_cmd .. string.format("curl -sS -X POST -d '{\"count\": 500, \"size\": %d}' http://127.0.0.1:9081/source/example_stream_endpoint > %s.%d & ", i * 100, tmpfile, i)
+end
+os.execute(curl_cmd .. "wait")
+for i = 1, 16 do
+    f = io.open(string.format("%s.%d", tmpfile, i))
+    size = f:seek("end")
+    f:close()
+    os.remove(string.format("%s.%d", tmpfile, i))
+    runner.check(size == 500 * i * 100, string.format("stream %d size=%d", i, size))
+end
+
+print('\n------------------\nTest05: Keep Alive\n------------------')
+os.execute(string.format("curl -sS -H 'Connection: keep-alive' -X POST -d '{\"count\": 10, \"size\": 10}' http://127.0.0.1:9081/source/example_stream_endpoint http://127.0.0.1:9081/source/example_stream_endpoint > %s", tmpfile))
+f = io.open(tmpfile)
+size = f:seek("end")
+f:close()
+runner.check(size == 200, "size="..tostring(size))
+
+print('\n------------------\nTest06: Reused Engine\n------------------')
+-- a single worker services every request to this endpoint with the same lua state
+endpoint2 = core.endpoint(1.0, 1.0, core.INFO, 1)
+server2   = core.httpd(9082):attach(endpoint2, "/source"):untilup()
+for i = 1, 3 do
+    os.execute(string.format("curl -sS -X GET -d '{}' http://127.0.0.1:9082/source/example_state_endpoint > %s", tmpfile))
+    f = io.open(tmpfile)
+    result = f:read()
+    f:close()
+    runner.check(result == "{ \"visits\": 1 }", "result="..tostring(result))
+end
+
+print('\n------------------\nTest07: Queued Requests\n------------------')
+local queued_cmd = ""
+for i = 1, 8 do
+    queued_cmd = queued_cmd .. string.format("curl -sS -X POST -d '{\"count\": 100, \"size\": %d}' http://127.0.0.1:9082/source/example_stream_endpoint > %s.%d & ", i * 100, tmpfile, i)
+end
+os.execute(queued_cmd .. "wait")
+for i = 1, 8 do
+    f = io.open(string.format("%s.%d", tmpfile, i))
+    size = f:seek("end")
+    f:close()
+    os.remove(string.format("%s.%d", tmpfile, i))
+    runner.check(size == 100 * i * 100, string.format("stream %d size=%d", i, size))
+end
+
+print('\n------------------\nTest08: Fan-Out Requests\n------------------')
+-- the fan-out request holds the only request worker while it waits on the request it makes back to the server
+endpoint3 = core.endpoint(1.0, 1.0, core.INFO, 1):fanout("example_fanout_endpoint")
+server3   = core.httpd(9083):attach(endpoint3, "/source"):untilup()
+os.execute(string.format("curl -sS -m 20 -X POST -d '{\"port\": 9083, \"resource\": \"/source/example_state_endpoint\"}' http://127.0.0.1:9083/source/example_fanout_endpoint > %s", tmpfile))
+f = io.open(tmpfile)
+result = f:read()
+f:close()
+runner.check(result == "{ \"visits\": 1 }", "result="..tostring(result))
+
 -- Clean Up --
 
+server3:destroy()
+server2:destroy()
 server:destroy()
 os.remove(tmpfile)
 
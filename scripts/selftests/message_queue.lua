@@ -6,6 +6,8 @@ runner.command("NEW UT_MSGQ ut_msgq")
 runner.command("ut_msgq::BLOCKING_RECEIVE_TEST")
 runner.command("ut_msgq::SUBSCRIBE_UNSUBSCRIBE_TEST")
 runner.command("ut_msgq::SUBSCRIBER_OF_OPPORTUNITY_TEST")
+runner.command("ut_msgq::SHARED_BUFFER_TEST")
+runner.command("ut_msgq::RING_QUEUE_TEST")
 runner.command("DELETE ut_msgq")
 
 -- Report Results --
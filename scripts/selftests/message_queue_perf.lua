@@ -0,0 +1,29 @@
+local runner = require("test_executive")
+local console = require("console")
+
+-- Usage: sliderule message_queue_perf.lua [<count>] [<size>] [<depth>]
+--
+--  measures message queue throughput (messages and bytes delivered per second)
+--  at 1, 4, and 16 concurrent subscribers, first posting by copy and then
+--  posting shared buffers; then measures p50 and p99 post-to-receive latency
+--  of linked list queues versus ring queues at the same subscriber counts;
+--  not part of the selftests run by test_runner.lua
+
+local count = tonumber(arg[1]) or 200000
+local size = tonumber(arg[2]) or 1000
+local depth = tonumber(arg[3]) or 256
+
+-- Message Queue Throughput --
+
+runner.command("NEW UT_MSGQ ut_msgq")
+runner.command(string.format("ut_msgq::THROUGHPUT_TEST %d %d copy", count, size))
+runner.command(string.format("ut_msgq::THROUGHPUT_TEST %d %d buffer", count, size))
+for _,subscribers in ipairs({1, 4, 16}) do
+    runner.command(string.format("ut_msgq::LATENCY_TEST %d %d %d", count, subscribers, depth))
+end
+runner.command("DELETE ut_msgq")
+
+-- Report Results --
+
+runner.report()
+sys.quit()
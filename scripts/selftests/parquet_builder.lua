@@ -0,0 +1,166 @@
+local runner = require("test_executive")
+local console = require("console")
+
+-- Parquet Builder Unit Test Setup --
+
+-- t8 and seg are converted through the record accessors, the rest are copied
+runner.command("DEFINE pqtest.rec NULL 44")
+runner.command("ADD_FIELD pqtest.rec time INT64 0 1 NATIVE")
+runner.command("ADD_FIELD pqtest.rec lat DOUBLE 8 1 NATIVE")
+runner.command("ADD_FIELD pqtest.rec lon DOUBLE 16 1 NATIVE")
+runner.command("ADD_FIELD pqtest.rec h FLOAT 24 1 NATIVE")
+runner.command("ADD_FIELD pqtest.rec cnt UINT32 28 1 NATIVE")
+runner.command("ADD_FIELD pqtest.rec t8 TIME8 32 1 NATIVE")
+runner.command("ADD_FIELD pqtest.rec seg INT32 40 1 BE")
+
+local rows_per_record = 256
+local num_records = 50
+local num_rows = rows_per_record * num_records
+local row_group_size = 2048 * 44 -- 2048 rows per row group
+local raw_file = "parquet_builder.bin"
+
+-- builds a serialized record holding a batch of rows
+local function batch (first_row)
+    local hdr = msg.create("pqtest.rec"):serialize()
+    local rows = {}
+    for i = 1, rows_per_record do
+        local row = first_row + i - 1
+        rows[i] = string.pack("<i8ddfI4I4I4>i4", row, 40.0 + (row * 0.0001), -105.0 - (row * 0.0001), row * 0.5, row, row, 0, -row)
+    end
+    local data = table.concat(rows)
+    return string.sub(hdr, 1, 4) .. string.pack(">I4", #data) .. string.sub(hdr, 9, #hdr - 44) .. data
+end
+
+-- splits the raw output stream into its meta, data, and eof records
+local function parse (raw)
+    local meta = {}
+    local data = {}
+    local eof = {}
+    local pos = 1
+    while pos + 8 <= #raw do
+        local _, type_size, data_size = string.unpack(">I2I2I4", raw, pos)
+        if pos + 8 + type_size + data_size - 1 > #raw then break end
+        local rec_type = string.sub(raw, pos + 8, pos + 8 + type_size - 2)
+        local rec_data = string.sub(raw, pos + 8 + type_size, pos + 8 + type_size + data_size - 1)
+        if rec_type == "arrowrec.meta" then
+            table.insert(meta, (string.unpack("<i8", rec_data, 129)))
+        elseif rec_type == "arrowrec.data" then
+            table.insert(data, string.sub(rec_data, 129))
+        elseif rec_type == "arrowrec.eof" then
+            table.insert(eof, (string.unpack("<i8", rec_data, 129)))
+        end
+        pos = pos + 8 + type_size + data_size
+    end
+    return meta, table.concat(data), #data, eof
+end
+
+-- runs the records through a builder and waits for the eof record that follows the file
+local function build (format, size)
+    local writer = core.writer(core.file(core.WRITER, core.BINARY, raw_file, core.FLUSHED), "parquet_outq")
+    local builder = arrow.parquet("test." .. format, "parquet_outq", "pqtest.rec", "0", "lon", "lat", size, format)
+    local dispatcher = core.dispatcher("parquet_inq", 1)
+    dispatcher:attach(builder, "pqtest.rec"):run()
+
+    local inq = msg.publish("parquet_inq")
+    for r = 1, num_records do
+        inq:sendstring(batch(((r - 1) * rows_per_record) + 1))
+    end
+    inq:sendstring("") -- terminator
+
+    local meta, contents, num_data, eof = {}, "", 0, {}
+    for _ = 1, 10 do
+        local f = io.open(raw_file, "rb")
+        if f then
+            meta, contents, num_data, eof = parse(f:read("a"))
+            f:close()
+            if #eof > 0 then break end
+        end
+        sys.wait(1)
+    end
+
+    dispatcher:destroy()
+    writer:destroy()
+    os.remove(raw_file)
+
+    runner.check(#meta == 1, string.format("expected one meta record, got %d", #meta))
+    runner.check(meta[1] == -1, string.format("expected streamed file size of -1, got %s", tostring(meta[1])))
+    runner.check(#eof == 1, string.format("expected one eof record, got %d", #eof))
+    runner.check(eof[1] == #contents, string.format("expected eof size of %d, got %s", #contents, tostring(eof[1])))
+    return contents, num_data
+end
+
+-- checks that a column read back holds the value expected for each row
+local function check_values (name, contents, expected)
+    runner.check(contents.values and #contents.values == num_rows, string.format("expected %d values of %s", num_rows, name))
+    local mismatches = 0
+    for row = 1, num_rows do
+        if contents.values[row] ~= expected(row) then mismatches = mismatches + 1 end
+    end
+    runner.check(mismatches == 0, string.format("%d values of %s did not match", mismatches, name))
+end
+
+-- writes the contents of a streamed file out so it can be read back
+local function save (filename, contents)
+    local f = io.open(filename, "wb")
+    f:write(contents)
+    f:close()
+end
+
+print('\n------------------\nTest01: Stream Row Groups\n------------------')
+
+local parquet, num_data = build("parquet", row_group_size)
+runner.check(string.sub(parquet, 1, 4) == "PAR1", "missing parquet header")
+runner.check(string.sub(parquet, -4) == "PAR1", "missing parquet footer")
+runner.check(num_data > 1, string.format("expected row groups to be streamed in separate records, got %d", num_data))
+save("test.parquet", parquet)
+local columns = {
+    time = function(row) return row end,
+    h = function(row) return row * 0.5 end,
+    cnt = function(row) return row end,
+    t8 = function(row) return row * 1000 end, -- milliseconds
+    seg = function(row) return -row end
+}
+for name, expected in pairs(columns) do
+    local contents = arrow.readparquet("test.parquet", name)
+    runner.check(contents, "failed to read back parquet file")
+    if contents then
+        runner.check(contents.rows == num_rows, string.format("unexpected number of rows: %d", contents.rows))
+        runner.check(contents.row_groups == 7, string.format("unexpected number of row groups: %d", contents.row_groups))
+        runner.check(contents.columns == 8, string.format("unexpected number of columns: %d", contents.columns))
+        check_values(name, contents, expected)
+    end
+end
+os.remove("test.parquet")
+
+print('\n------------------\nTest02: Arrow IPC Stream\n------------------')
+
+local stream, num_stream_data = build("arrow", nil)
+runner.check(string.sub(stream, -8) == string.pack("<I4I4", 0xFFFFFFFF, 0), "missing end of stream marker")
+runner.check(num_stream_data >= num_records, string.format("expected a record batch to be streamed per record, got %d", num_stream_data))
+save("test.arrow", stream)
+local contents = arrow.readipc("test.arrow")
+runner.check(contents, "failed to read back arrow stream")
+if contents then
+    runner.check(contents.rows == num_rows, string.format("unexpected number of rows: %d", contents.rows))
+    runner.check(contents.batches == num_records, string.format("unexpected number of record batches: %d", contents.batches))
+    runner.check(contents.columns == 8, string.format("unexpected number of columns: %d", contents.columns))
+end
+os.remove("test.arrow")
+
+print('\n------------------\nTest03: Feather File\n------------------')
+
+local feather = build("feather", row_group_size)
+runner.check(string.sub(feather, 1, 6) == "ARROW1", "missing feather header")
+runner.check(string.sub(feather, -6) == "ARROW1", "missing feather footer")
+save("test.feather", feather)
+contents = arrow.readipc("test.feather")
+runner.check(contents, "failed to read back feather file")
+if contents then
+    runner.check(contents.rows == num_rows, string.format("unexpected number of rows: %d", contents.rows))
+    runner.check(contents.batches == 7, string.format("unexpected number of record batches: %d", contents.batches))
+end
+os.remove("test.feather")
+
+-- Report Results --
+
+runner.report()
@@ -53,11 +53,47 @@ end
 runner.check(expected_totals["id"] == actual_totals["test.rec.id"])
 runner.check(expected_totals["counter"] == actual_totals["test.rec.counter"])
 
+-- Field Keyed Dispatch (records queued before run so they are dispatched in batches) --
+
+local keymetric = core.metric("counter", "dispatcher_keyq"):name("keymetric")
+keymetric:pbtext(true):pbname(true)
+keymetric:keyrange("2000", "2000")
+
+local fr = core.dispatcher("dispatcher_fieldq", 1, "FIELD_KEY", "id"):name("fielddispatcher")
+fr:attach(keymetric, "test.rec")
+
+local fieldq = msg.publish("dispatcher_fieldq")
+local keyq = msg.subscribe("dispatcher_keyq")
+
+local expected_counter = 0
+for i=1,100,1 do
+	fieldq:sendrecord(msg.create(string.format('test.rec id=1000 counter=%d', i)))
+	fieldq:sendrecord(msg.create(string.format('test.rec id=2000 counter=%d', i)))
+	expected_counter = expected_counter + i
+end
+
+fr:run()
+
+local actual_counter = 0
+local num_metrics = 0
+for i=1,100,1 do
+	metric = keyq:recvrecord(1000)
+	if metric then
+	    actual_counter = actual_counter + metric:getvalue("VALUE")
+	    num_metrics = num_metrics + 1
+    end
+end
+
+runner.check(num_metrics == 100)
+runner.check(expected_counter == actual_counter)
+
 -- Clean Up --
 
 r:destroy()
 idmetric:destroy()
 countermetric:destroy()
+fr:destroy()
+keymetric:destroy()
 
 -- Report Results --
 
@@ -46,6 +46,12 @@ if __geo__ then
     runner.script(td .. "geojson_raster.lua")
 end
 
+-- Run Arrow Self Tests --
+
+if __arrow__ and __legacy__ then
+    runner.script(td .. "parquet_builder.lua")
+end
+
 -- Run Legacy Self Tests --
 
 if __legacy__ then
@@ -68,6 +74,7 @@ if __icesat2__ then
     runner.script(icesat2_td .. "atl03_indexer.lua")
     runner.script(icesat2_td .. "h5_file.lua")
     runner.script(icesat2_td .. "s3_driver.lua")
+    runner.script(icesat2_td .. "endpoint_proxy.lua")
 end
 
 -- Run ICESat-2 Plugin Self Tests
@@ -0,0 +1,60 @@
+local console = require("console")
+
+-- Usage: sliderule h5_chunk_perf.lua [<path>] [<resource>] [<dataset>] [<max workers>] [<trials>]
+--
+--  compares the throughput of reading a chunked dataset serially against
+--  reading it with an increasing number of chunk workers; defaults to the
+--  gzip example file in the selftests directory, for ATL03 sized files use:
+--
+--  sliderule h5_chunk_perf.lua /data/ATL03 ATL03_20181017222812_02950102_003_01.h5 /gt2l/heights/h_ph 16
+
+local td = arg[0]:match("(.*/)") or "./"
+
+local path = arg[1] or (td .. "../selftests")
+local resource = arg[2] or "h5ex_d_gzip.h5"
+local dataset = arg[3] or "/DS1"
+local max_workers = tonumber(arg[4]) or 8
+local trials = tonumber(arg[5]) or 10
+
+local asset = core.asset("local", "file", path, "empty.index")
+
+-- Read Dataset --
+
+local function readdataset (workers)
+    local bytes = 0
+    local starttime = time.latch()
+    for i = 1, trials do
+        local f = h5.file(asset, resource, workers) -- new file each trial so that nothing is cached
+        local rspq = msg.subscribe("h5perfq")
+        f:read({{dataset=dataset}}, "h5perfq")
+        local rec = rspq:recvrecord(30000)
+        if rec then
+            bytes = bytes + rec:getvalue("size")
+        else
+            print(string.format("Failed to read %s/%s with %d workers", resource, dataset, workers))
+        end
+        rspq:destroy()
+        f:destroy()
+    end
+    local stoptime = time.latch()
+    return bytes, stoptime - starttime
+end
+
+-- Warm Up Meta Repository --
+
+readdataset(0)
+
+-- Run Trials --
+
+print(string.format("\n%s:%s (%d trials)", resource, dataset, trials))
+print(string.format("%8s %12s %10s %10s", "workers", "bytes", "seconds", "MB/s"))
+
+local workers = 0
+while workers <= max_workers do
+    local bytes, dtime = readdataset(workers)
+    print(string.format("%8d %12d %10.3f %10.2f", workers, bytes, dtime, (bytes / (1024 * 1024)) / dtime))
+    if workers == 0 then workers = 1
+    else workers = workers * 2 end
+end
+
+sys.quit()
@@ -0,0 +1,86 @@
+local console = require("console")
+
+-- Usage: sliderule h5_filter_perf.lua [<path>] [<resource>] [<trials>] [<results file>] [<dataset> ...]
+--
+--  measures the throughput of the deflate and shuffle filters on the chunks
+--  of real datasets, as reported by the h5 filter metrics; run it against a
+--  build of each inflate backend (cmake -DH5CORO_INFLATE_BACKEND=zlib|zlib-ng|libdeflate)
+--  to compare them, e.g. for ATL03:
+--
+--  sliderule h5_filter_perf.lua /data/ATL03 ATL03_20181017222812_02950102_003_01.h5 5 filters.csv /gt2l/heights/h_ph /gt2l/heights/lat_ph /gt2l/heights/signal_conf_ph
+--
+--  when a results file is supplied, a line per dataset is appended to it
+
+local td = arg[0]:match("(.*/)") or "./"
+
+local path = arg[1] or (td .. "../selftests")
+local resource = arg[2] or "h5ex_d_gzip.h5"
+local trials = tonumber(arg[3]) or 10
+local results_file = arg[4]
+
+local datasets = {"/DS1"}
+if arg[5] then
+    datasets = {}
+    local i = 5
+    while arg[i] do
+        table.insert(datasets, arg[i])
+        i = i + 1
+    end
+end
+
+local asset = core.asset("local", "file", path, "empty.index")
+
+-- Read Dataset --
+
+local function readdataset (dataset)
+    local f = h5.file(asset, resource, 0) -- no chunk workers so filter time is not contended, and the reading thread publishes its metrics when it exits
+    for i = 1, trials do
+        local rspq = msg.subscribe("h5filterq")
+        f:read({{dataset=dataset}}, "h5filterq")
+        local rec = rspq:recvrecord(60000)
+        if not rec then
+            print(string.format("Failed to read %s/%s", resource, dataset))
+        end
+        rspq:destroy()
+    end
+    f:destroy()
+end
+
+-- Filter Metrics --
+
+local function filtermetrics ()
+    local m = sys.metric("h5")
+    return {inflate_bytes=m["h5.inflate_bytes"].value, inflate_time=m["h5.inflate_time"].value,
+            shuffle_bytes=m["h5.shuffle_bytes"].value, shuffle_time=m["h5.shuffle_time"].value}
+end
+
+local function gbps (bytes, seconds)
+    if seconds <= 0 then return 0 end
+    return (bytes / (1024 * 1024 * 1024)) / seconds
+end
+
+-- Run Trials --
+
+local results = results_file and io.open(results_file, "a")
+
+print(string.format("\n%s (%s backend, %d trials)", resource, h5.INFLATE_BACKEND, trials))
+print(string.format("%-32s %14s %12s %14s %12s %12s", "dataset", "inflate bytes", "inflate GB/s", "shuffle bytes", "shuffle GB/s", "filter GB/s"))
+
+for _,dataset in ipairs(datasets) do
+    local m0 = filtermetrics()
+    readdataset(dataset)
+    local m1 = filtermetrics()
+    local inflate_bytes = m1.inflate_bytes - m0.inflate_bytes
+    local inflate_time = m1.inflate_time - m0.inflate_time
+    local shuffle_bytes = m1.shuffle_bytes - m0.shuffle_bytes
+    local shuffle_time = m1.shuffle_time - m0.shuffle_time
+    local filter_gbps = gbps(inflate_bytes, inflate_time + shuffle_time)
+    print(string.format("%-32s %14d %12.2f %14d %12.2f %12.2f", dataset, inflate_bytes, gbps(inflate_bytes, inflate_time), shuffle_bytes, gbps(shuffle_bytes, shuffle_time), filter_gbps))
+    if results then
+        results:write(string.format("%d,%s,%s,%s,%d,%.6f,%d,%.6f,%.3f\n", os.time(), h5.INFLATE_BACKEND, resource, dataset, inflate_bytes, inflate_time, shuffle_bytes, shuffle_time, filter_gbps))
+    end
+end
+
+if results then results:close() end
+
+sys.quit()
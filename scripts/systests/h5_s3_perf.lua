@@ -0,0 +1,82 @@
+local console = require("console")
+
+-- Usage: sliderule h5_s3_perf.lua [<endpoint>] [<bucket>] [<trials>] [<results file>] [<resource> <dataset> ...]
+--
+--  measures end-to-end throughput of reading datasets with H5Coro through the
+--  S3 driver; meant to be run against the local range server stand-in so that
+--  results can be tracked from commit to commit:
+--
+--      python3 range_server.py --root .. --port 9000 --latency 20 &
+--      sliderule h5_s3_perf.lua http://localhost:9000 selftests 10 h5_s3_perf.csv
+--
+--  when a results file is supplied, a line per dataset is appended to it
+
+local endpoint = arg[1] or "http://localhost:9000"
+local bucket = arg[2] or "selftests"
+local trials = tonumber(arg[3]) or 10
+local results_file = arg[4]
+
+-- Representative Datasets --
+
+local datasets = {
+    {resource="h5ex_d_gzip.h5", dataset="/DS1", workers=0},
+    {resource="h5ex_d_gzip.h5", dataset="/DS1", workers=4},
+}
+
+if arg[5] then
+    datasets = {}
+    local i = 5
+    while arg[i] and arg[i+1] do
+        table.insert(datasets, {resource=arg[i], dataset=arg[i+1], workers=0})
+        table.insert(datasets, {resource=arg[i], dataset=arg[i+1], workers=4})
+        i = i + 2
+    end
+end
+
+local asset = core.asset("s3perf", "s3", bucket, "empty.index", "local", endpoint)
+
+-- Read Dataset --
+
+local function readdataset (entry)
+    local bytes = 0
+    local failures = 0
+    local m0 = sys.metric("s3")
+    local starttime = time.latch()
+    for i = 1, trials do
+        local f = h5.file(asset, entry.resource, entry.workers) -- new file each trial so that nothing is cached
+        local rspq = msg.subscribe("h5s3perfq")
+        f:read({{dataset=entry.dataset}}, "h5s3perfq")
+        local rec = rspq:recvrecord(60000)
+        if rec then
+            bytes = bytes + rec:getvalue("size")
+        else
+            failures = failures + 1
+        end
+        rspq:destroy()
+        f:destroy()
+    end
+    local stoptime = time.latch()
+    local m1 = sys.metric("s3")
+    local connections = m1["s3.connections"].value - m0["s3.connections"].value
+    return bytes, stoptime - starttime, connections, failures
+end
+
+-- Run Trials --
+
+local results = results_file and io.open(results_file, "a")
+
+print(string.format("\n%s/%s (%d trials)", endpoint, bucket, trials))
+print(string.format("%-40s %-24s %8s %12s %10s %10s %12s %9s", "resource", "dataset", "workers", "bytes", "seconds", "MB/s", "connections", "failures"))
+
+for _,entry in ipairs(datasets) do
+    local bytes, dtime, connections, failures = readdataset(entry)
+    local mbps = (bytes / (1024 * 1024)) / dtime
+    print(string.format("%-40s %-24s %8d %12d %10.3f %10.2f %12d %9d", entry.resource, entry.dataset, entry.workers, bytes, dtime, mbps, connections, failures))
+    if results then
+        results:write(string.format("%d,%s,%s,%d,%d,%.3f,%.2f,%d,%d\n", os.time(), entry.resource, entry.dataset, entry.workers, bytes, dtime, mbps, connections, failures))
+    end
+end
+
+if results then results:close() end
+
+sys.quit()
@@ -0,0 +1,176 @@
+# python
+#
+# Usage: python3 http_load.py [--host <host>] [--port <port>] [--path <path>] [--verb <GET|POST>] [--body <json>]
+#                             [--clients <number>] [--duration <seconds>] [--keepalive]
+#
+#   generates load against a sliderule http server; each client issues
+#   requests back to back for the duration of the test and reads each
+#   response to completion (decoding chunked responses), after which the
+#   requests/second and the MB/second of response data received are reported.
+#   The last line of output is the comma separated summary:
+#
+#       clients,requests,errors,seconds,requests/second,MB/second
+#
+#   e.g. streaming 1MB responses to 64 clients from the http_server.lua selftest setup:
+#
+#       python3 http_load.py --port 9081 --path /source/example_stream_endpoint --verb POST \
+#                            --body '{"count": 1000, "size": 1000}' --clients 64
+
+import sys
+import time
+import socket
+import argparse
+import threading
+
+###############################################################################
+# GLOBALS
+###############################################################################
+
+RECV_SIZE = 0x40000
+
+settings = {}
+
+###############################################################################
+# CLIENT
+###############################################################################
+
+class Client(threading.Thread):
+
+    def __init__(self, stop_time):
+        threading.Thread.__init__(self)
+        self.stop_time = stop_time
+        self.requests = 0
+        self.errors = 0
+        self.bytes = 0
+        self.sock = None
+        self.buf = b''
+        self.pos = 0
+
+    def connect(self):
+        self.sock = socket.create_connection((settings["host"], settings["port"]))
+        self.sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.buf = b''
+        self.pos = 0
+
+    def close(self):
+        if self.sock:
+            self.sock.close()
+            self.sock = None
+
+    def fill(self):
+        data = self.sock.recv(RECV_SIZE)
+        if not data:
+            raise ConnectionError("connection closed")
+        self.buf = self.buf[self.pos:] + data
+        self.pos = 0
+
+    def readline(self):
+        end = self.buf.find(b'\r\n', self.pos)
+        while end < 0:
+            self.fill()
+            end = self.buf.find(b'\r\n', self.pos)
+        line = self.buf[self.pos:end]
+        self.pos = end + 2
+        return line
+
+    def skip(self, size):
+        # discards size bytes of response data
+        self.bytes += size
+        while len(self.buf) - self.pos < size:
+            size -= len(self.buf) - self.pos
+            self.buf = b''
+            self.pos = 0
+            self.fill()
+        self.pos += size
+
+    def response(self):
+        # status line and headers
+        status = self.readline().split(b' ')
+        headers = {}
+        while True:
+            line = self.readline()
+            if len(line) == 0:
+                break
+            key, value = line.split(b':', 1)
+            headers[key.strip().lower()] = value.strip().lower()
+        # body
+        if headers.get(b'transfer-encoding') == b'chunked':
+            while True:
+                chunk_size = int(self.readline(), 16)
+                if chunk_size == 0:
+                    self.readline()
+                    break
+                self.skip(chunk_size)
+                self.readline()
+        elif b'content-length' in headers:
+            self.skip(int(headers[b'content-length']))
+        else:
+            try:
+                while True:
+                    self.fill()
+                    self.bytes += len(self.buf) - self.pos
+                    self.buf = b''
+                    self.pos = 0
+            except ConnectionError:
+                pass
+        return len(status) > 1 and status[1] == b'200'
+
+    def run(self):
+        request = ("%s %s HTTP/1.1\r\nHost: %s\r\nContent-Length: %d\r\n%s\r\n%s" % (
+            settings["verb"], settings["path"], settings["host"], len(settings["body"]),
+            settings["keepalive"] and "Connection: keep-alive\r\n" or "", settings["body"])).encode()
+        while time.time() < self.stop_time:
+            try:
+                if not self.sock:
+                    self.connect()
+                self.sock.sendall(request)
+                if self.response():
+                    self.requests += 1
+                else:
+                    self.errors += 1
+                if not settings["keepalive"]:
+                    self.close()
+            except (OSError, ValueError):
+                self.errors += 1
+                self.close()
+        self.close()
+
+###############################################################################
+# MAIN
+###############################################################################
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser(description="""load generator for the http server""")
+    parser.add_argument('--host', type=str, default="127.0.0.1")
+    parser.add_argument('--port', type=int, default=9081)
+    parser.add_argument('--path', type=str, default="/source/example_source_endpoint")
+    parser.add_argument('--verb', type=str, default="GET")
+    parser.add_argument('--body', type=str, default="{\"var1\": false, \"var2\": \"*.rec\", \"var3\": 4}")
+    parser.add_argument('--clients', type=int, default=16)
+    parser.add_argument('--duration', type=float, default=10.0)
+    parser.add_argument('--keepalive', action='store_true')
+    args = parser.parse_args()
+
+    settings["host"] = args.host
+    settings["port"] = args.port
+    settings["path"] = args.path
+    settings["verb"] = args.verb
+    settings["body"] = args.body
+    settings["keepalive"] = args.keepalive
+
+    start_time = time.time()
+    clients = [Client(start_time + args.duration) for _ in range(args.clients)]
+    for client in clients:
+        client.start()
+    for client in clients:
+        client.join()
+    elapsed = time.time() - start_time
+
+    requests = sum([client.requests for client in clients])
+    errors = sum([client.errors for client in clients])
+    megabytes = sum([client.bytes for client in clients]) / (1024.0 * 1024.0)
+
+    print("%s %s: %d clients, %d requests, %d errors, %.1f requests/second, %.1f MB/second" % (args.verb, args.path, args.clients, requests, errors, requests / elapsed, megabytes / elapsed))
+    print("%d,%d,%d,%.3f,%.1f,%.1f" % (args.clients, requests, errors, elapsed, requests / elapsed, megabytes / elapsed))
+    sys.exit(0)
@@ -0,0 +1,75 @@
+local console = require("console")
+
+-- Usage: sliderule http_server_perf.lua [<results file>] [<duration seconds>] [<reactors> ...]
+--
+--  starts an http server with the endpoints used by the http_server.lua
+--  selftest and drives it with http_load.py, once for each number of reactor
+--  threads; requests/second is measured with short responses and MB/second
+--  with streamed responses.  Must be run from this directory, with the
+--  example endpoints installed:
+--
+--      sliderule http_server_perf.lua http_server_perf.csv 10 1 4
+--
+--  when a results file is supplied, a line per trial is appended to it
+
+local results_file = arg[1]
+local duration = tonumber(arg[2]) or 10
+
+local reactor_counts = {1, 4}
+if arg[3] then
+    reactor_counts = {}
+    local i = 3
+    while arg[i] do
+        table.insert(reactor_counts, tonumber(arg[i]))
+        i = i + 1
+    end
+end
+
+-- Trials --
+
+local trials = {
+    {name="return",         verb="GET",     path="/source/example_source_endpoint", body='{"var1": false, "var2": "*.rec", "var3": 4}',   clients=64,     keepalive=true},
+    {name="stream-small",   verb="POST",    path="/source/example_stream_endpoint", body='{"count": 20000, "size": 100}',                   clients=64,     keepalive=false},
+    {name="stream-large",   verb="POST",    path="/source/example_stream_endpoint", body='{"count": 1000, "size": 65536}',                  clients=64,     keepalive=false},
+    {name="stream-many",    verb="POST",    path="/source/example_stream_endpoint", body='{"count": 1000, "size": 1000}',                   clients=256,    keepalive=false},
+}
+
+-- Run Trials --
+
+local results = results_file and io.open(results_file, "a")
+local tmpfile = os.tmpname()
+local port = 9081
+
+print(string.format("\n%-14s %8s %8s %10s %8s %16s %12s", "trial", "reactors", "clients", "requests", "errors", "requests/second", "MB/second"))
+
+for _,reactors in ipairs(reactor_counts) do
+    local endpoint = core.endpoint(1.0, 1.0, core.DEBUG)
+    local server = core.httpd(port, nil, 1024, reactors):attach(endpoint, "/source"):untilup()
+
+    for _,trial in ipairs(trials) do
+        local cmd = string.format("python3 http_load.py --port %d --verb %s --path %s --body '%s' --clients %d --duration %f %s", port, trial.verb, trial.path, trial.body, trial.clients, duration, trial.keepalive and "--keepalive" or "")
+        os.execute(string.format("%s > %s", cmd, tmpfile))
+        local summary = nil
+        for line in io.lines(tmpfile) do
+            summary = line
+        end
+
+        local clients, requests, errors, seconds, rps, mbps = string.match(summary or "", "(%d+),(%d+),(%d+),([%d%.]+),([%d%.]+),([%d%.]+)")
+        if clients then
+            print(string.format("%-14s %8d %8d %10d %8d %16.1f %12.1f", trial.name, reactors, clients, requests, errors, rps, mbps))
+            if results then
+                results:write(string.format("%d,%s,%d,%s\n", os.time(), trial.name, reactors, summary))
+            end
+        else
+            print(string.format("%-14s %8d %8d %10s", trial.name, reactors, trial.clients, "failed"))
+        end
+    end
+
+    server:destroy()
+    port = port + 1
+end
+
+if results then results:close() end
+os.remove(tmpfile)
+
+sys.quit()
@@ -0,0 +1,117 @@
+local console = require("console")
+
+-- Usage: sliderule parquet_builder_perf.lua [<results file>] [<row group size> ...]
+--
+--  measures the rate at which the parquet builder turns batches of records
+--  into a parquet file and the time until the first bytes of the file reach
+--  the output queue; the records are synthetic 32 byte rows (five fixed width
+--  fields) posted 256 rows at a time, and the output queue is written to a
+--  scratch file that is watched for the start and the footer of the file:
+--
+--      sliderule parquet_builder_perf.lua parquet_builder_perf.csv 1048576 8388608
+--
+--  when a results file is supplied, a line per trial is appended to it
+
+local results_file = arg[1]
+
+local row_group_sizes = {0x100000, 0x800000}
+if arg[2] then
+    row_group_sizes = {}
+    local i = 2
+    while arg[i] do
+        table.insert(row_group_sizes, tonumber(arg[i]))
+        i = i + 1
+    end
+end
+
+local row_counts = {512000, 2048000}
+local rows_per_record = 256
+local raw_file = "parquet_builder_perf.bin"
+local max_wait = 120 -- seconds
+
+-- Record Definition --
+
+cmd.exec("DEFINE perf.rec NULL 32")
+cmd.exec("ADD_FIELD perf.rec time INT64 0 1 NATIVE")
+cmd.exec("ADD_FIELD perf.rec lat DOUBLE 8 1 NATIVE")
+cmd.exec("ADD_FIELD perf.rec lon DOUBLE 16 1 NATIVE")
+cmd.exec("ADD_FIELD perf.rec h FLOAT 24 1 NATIVE")
+cmd.exec("ADD_FIELD perf.rec cnt UINT32 28 1 NATIVE")
+
+local function batch ()
+    local hdr = msg.create("perf.rec"):serialize()
+    local rows = {}
+    for i = 1, rows_per_record do
+        rows[i] = string.pack("<i8ddfI4", i, 40.0 + (i * 0.0001), -105.0 - (i * 0.0001), i * 0.5, i)
+    end
+    local data = table.concat(rows)
+    return string.sub(hdr, 1, 4) .. string.pack(">I4", #data) .. string.sub(hdr, 9, #hdr - 32) .. data
+end
+
+local function file_tail ()
+    local f = io.open(raw_file, "rb")
+    if not f then return 0, "" end
+    local size = f:seek("end")
+    local tail = ""
+    if size >= 4 then
+        f:seek("set", size - 4)
+        tail = f:read(4)
+    end
+    f:close()
+    return size, tail
+end
+
+-- Run Trials --
+
+local record = batch()
+local results = results_file and io.open(results_file, "a")
+
+print(string.format("\n%-12s %16s %16s %16s %16s", "rows", "row group size", "first byte (s)", "total (s)", "rows/second"))
+
+for _,row_group_size in ipairs(row_group_sizes) do
+    for _,num_rows in ipairs(row_counts) do
+        os.remove(raw_file)
+        local writer = core.writer(core.file(core.WRITER, core.BINARY, raw_file, core.FLUSHED), "perf_outq")
+        local builder = arrow.parquet("perf.parquet", "perf_outq", "perf.rec", "0", "lon", "lat", row_group_size)
+        local dispatcher = core.dispatcher("perf_inq", 1)
+        dispatcher:attach(builder, "perf.rec"):run()
+        local inq = msg.publish("perf_inq")
+
+        local start = time.latch()
+        for _ = 1, num_rows / rows_per_record do
+            inq:sendstring(record)
+        end
+        inq:sendstring("") -- terminator
+
+        local first_byte = nil
+        local total = nil
+        while time.latch() - start < max_wait do
+            local size, tail = file_tail()
+            if size > 0 and not first_byte then
+                first_byte = time.latch() - start
+            end
+            if tail == "PAR1" and size > 8 then
+                total = time.latch() - start
+                break
+            end
+        end
+
+        if total then
+            print(string.format("%-12d %16d %16.3f %16.3f %16.1f", num_rows, row_group_size, first_byte, total, num_rows / total))
+            if results then
+                results:write(string.format("%d,%d,%d,%.3f,%.3f,%.1f\n", os.time(), num_rows, row_group_size, first_byte, total, num_rows / total))
+            end
+        else
+            print(string.format("%-12d %16d %16s", num_rows, row_group_size, "timed out"))
+        end
+
+        dispatcher:destroy()
+        writer:destroy()
+        inq:destroy()
+    end
+end
+
+os.remove(raw_file)
+if results then results:close() end
+
+sys.quit()
@@ -0,0 +1,142 @@
+# python
+#
+# Usage: python3 range_server.py [--port <port>] [--root <directory>] [--latency <ms>] [--bandwidth <bytes/sec>]
+#
+#   stands in for S3 when measuring the S3CurlIODriver read path; serves the
+#   files under the root directory using path-style urls (i.e. the bucket is
+#   the first directory under the root) and honors single range requests.
+#   The latency is added to every request before it is answered, and the
+#   bandwidth (when non-zero) throttles each response.  Authorization headers
+#   are accepted and ignored.
+#
+#   e.g. serving the selftests so that an asset can use the bucket "selftests":
+#
+#       python3 range_server.py --root ../ --port 9000
+#       core.asset("s3local", "s3", "selftests", "empty.index", "local", "http://localhost:9000")
+
+import os
+import re
+import sys
+import time
+import argparse
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+###############################################################################
+# GLOBALS
+###############################################################################
+
+CHUNK_SIZE = 65536
+RANGE_PATTERN = re.compile(r"bytes=(\d*)-(\d*)$")
+
+settings = {}
+
+###############################################################################
+# REQUEST HANDLER
+###############################################################################
+
+class RangeHandler(BaseHTTPRequestHandler):
+
+    protocol_version = "HTTP/1.1" # keep connections alive
+    disable_nagle_algorithm = True # headers and body are written separately
+
+    def log_message(self, format, *args):
+        if settings["verbose"]:
+            BaseHTTPRequestHandler.log_message(self, format, *args)
+
+    def resolve(self):
+        path = os.path.realpath(os.path.join(settings["root"], self.path.split("?")[0].lstrip("/")))
+        if not path.startswith(settings["root"]) or not os.path.isfile(path):
+            return None
+        return path
+
+    def error(self, code):
+        self.send_response(code)
+        self.send_header("Content-Length", "0")
+        self.end_headers()
+
+    def respond(self, send_body):
+        time.sleep(settings["latency"])
+
+        path = self.resolve()
+        if path == None:
+            self.error(404)
+            return
+
+        # determine range
+        size = os.path.getsize(path)
+        start, end = 0, size - 1
+        partial = False
+        if "Range" in self.headers:
+            match = RANGE_PATTERN.match(self.headers["Range"].strip())
+            if match == None or (match.group(1) == "" and match.group(2) == ""):
+                self.error(416)
+                return
+            if match.group(1) == "": # suffix range
+                start = max(size - int(match.group(2)), 0)
+            else:
+                start = int(match.group(1))
+                if match.group(2) != "":
+                    end = min(int(match.group(2)), size - 1)
+            if start > end:
+                self.error(416)
+                return
+            partial = True
+
+        # send headers
+        length = end - start + 1
+        self.send_response(206 if partial else 200)
+        self.send_header("Content-Type", "application/octet-stream")
+        self.send_header("Content-Length", str(length))
+        self.send_header("Accept-Ranges", "bytes")
+        self.send_header("ETag", "\"%x-%x\"" % (int(os.path.getmtime(path)), size))
+        if partial:
+            self.send_header("Content-Range", "bytes %d-%d/%d" % (start, end, size))
+        self.end_headers()
+
+        # send body
+        if send_body:
+            with open(path, "rb") as f:
+                f.seek(start)
+                remaining = length
+                while remaining > 0:
+                    data = f.read(min(CHUNK_SIZE, remaining))
+                    if not data:
+                        break
+                    self.wfile.write(data)
+                    remaining -= len(data)
+                    if settings["bandwidth"] > 0:
+                        time.sleep(len(data) / settings["bandwidth"])
+
+    def do_GET(self):
+        self.respond(True)
+
+    def do_HEAD(self):
+        self.respond(False)
+
+###############################################################################
+# MAIN
+###############################################################################
+
+if __name__ == '__main__':
+
+    parser = argparse.ArgumentParser(description="""local stand-in for S3 range reads""")
+    parser.add_argument('--port', type=int, default=9000)
+    parser.add_argument('--root', type=str, default=".")
+    parser.add_argument('--latency', type=float, default=0.0, help="milliseconds added to each request")
+    parser.add_argument('--bandwidth', type=float, default=0.0, help="bytes per second for each response, 0 is unlimited")
+    parser.add_argument('--verbose', action='store_true')
+    args = parser.parse_args()
+
+    settings["root"] = os.path.realpath(args.root)
+    settings["latency"] = args.latency / 1000.0
+    settings["bandwidth"] = args.bandwidth
+    settings["verbose"] = args.verbose
+
+    server = ThreadingHTTPServer(("", args.port), RangeHandler)
+    print("Serving %s on port %d (latency = %.1fms, bandwidth = %s)" % (settings["root"], args.port, args.latency, args.bandwidth > 0 and "%d B/s" % args.bandwidth or "unlimited"))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    server.server_close()
+    sys.exit(0)
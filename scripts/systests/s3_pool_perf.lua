@@ -0,0 +1,87 @@
+local console = require("console")
+
+-- Usage: sliderule s3_pool_perf.lua [<bucket>] [<key>] [<reads>] [<size>] [<region>] [<asset>] [<endpoint>]
+--
+--  compares issuing range reads with a fresh cURL handle per request (no
+--  pool, every request connects and handshakes) against reading through the
+--  pool of persistent handles; reports the connections made and the time
+--  spent setting them up, as reported by the s3 metrics.  The same ranges are
+--  then read as a series of vectored reads through an asset, where the
+--  connections of one vectored read are expected to be kept for the next;
+--  to run against the local range server stand-in (see range_server.py):
+--
+--  sliderule s3_pool_perf.lua selftests english_words.txt 100 4096 local iam-role http://localhost:9000
+
+local bucket = arg[1] or "icesat2-sliderule"
+local key = arg[2] or "data/test/t8.shakespeare.txt"
+local reads = tonumber(arg[3]) or 100
+local size = tonumber(arg[4]) or 65536
+local region = arg[5]
+local asset = arg[6]
+local endpoint = arg[7]
+
+local role_auth_script = core.script("iam_role_auth"):name("RoleAuthScript")
+sys.wait(2)
+
+-- Read Ranges --
+
+local function readranges (max_handles)
+    aws.s3pool(max_handles)
+    local m0 = sys.metric("s3")
+    local failures = 0
+    local starttime = time.latch()
+    for i = 0, reads - 1 do
+        local _, status = aws.s3read(bucket, key, size, i * size, region, asset, endpoint)
+        if not status then failures = failures + 1 end
+    end
+    local stoptime = time.latch()
+    local m1 = sys.metric("s3")
+    local connections = m1["s3.connections"].value - m0["s3.connections"].value
+    local connect_time = m1["s3.connect_time"].value - m0["s3.connect_time"].value
+    local reused = m1["s3.handles_reused"].value - m0["s3.handles_reused"].value
+    return stoptime - starttime, connections, connect_time, reused, failures
+end
+
+-- Read Vectored --
+
+local vectored_asset = core.asset(asset or "iam-role", "s3", bucket, "empty.index", region or "us-west-2", endpoint)
+
+local function readvectored (max_handles, ranges_per_read)
+    aws.s3pool(max_handles)
+    local m0 = sys.metric("s3")
+    local failures = 0
+    local starttime = time.latch()
+    for i = 0, reads - 1, ranges_per_read do
+        local extents = {}
+        for j = i, math.min(i + ranges_per_read, reads) - 1 do
+            table.insert(extents, {j * size, size})
+        end
+        if not vectored_asset:read(key, extents) then failures = failures + 1 end
+    end
+    local stoptime = time.latch()
+    local m1 = sys.metric("s3")
+    local connections = m1["s3.connections"].value - m0["s3.connections"].value
+    local connect_time = m1["s3.connect_time"].value - m0["s3.connect_time"].value
+    local reused = m1["s3.handles_reused"].value - m0["s3.handles_reused"].value
+    return stoptime - starttime, connections, connect_time, reused, failures
+end
+
+-- Run Trials --
+
+print(string.format("\n%s/%s (%d reads of %d bytes)", bucket, key, reads, size))
+print(string.format("%8s %10s %12s %14s %10s %10s", "pool", "seconds", "connections", "connect secs", "reused", "failures"))
+
+for _,max_handles in ipairs({0, 64}) do
+    local dtime, connections, connect_time, reused, failures = readranges(max_handles)
+    print(string.format("%8d %10.3f %12d %14.3f %10d %10d", max_handles, dtime, connections, connect_time, reused, failures))
+end
+
+print(string.format("\nvectored reads of %d ranges", 16))
+print(string.format("%8s %10s %12s %14s %10s %10s", "pool", "seconds", "connections", "connect secs", "reused", "failures"))
+
+for _,max_handles in ipairs({0, 64}) do
+    local dtime, connections, connect_time, reused, failures = readvectored(max_handles, 16)
+    print(string.format("%8d %10.3f %12d %14.3f %10d %10d", max_handles, dtime, connections, connect_time, reused, failures))
+end
+
+sys.quit()
@@ -194,6 +194,9 @@ py::dict pyH5Coro::stat (void)
     stats["l1_cache_replace"]       = context.l1_cache_replace;
     stats["l2_cache_replace"]       = context.l2_cache_replace;
     stats["bytes_read"]             = context.bytes_read;
+    stats["range_requests"]         = context.range_requests;
+    stats["range_merged"]           = context.range_merged;
+    stats["range_overread"]         = context.range_overread;
     return stats;
 }
 